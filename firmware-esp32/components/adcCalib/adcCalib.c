@@ -0,0 +1,170 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   adcCalib.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Raw-to-millivolts conversion table. Read the adcCalib.h file for details
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+
+#if MOCK == 0
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_err.h"
+#include <esp_log.h>
+#endif
+
+#include <stddef.h>
+#include <adcCalib.h>
+
+uint16_t    adcCalib_table[ADCCALIB_RAWMAX + 1];
+static bool calibrated = false;
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                     P R I V A T E   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+#if MOCK == 0
+static int _adcCalib_nominal (int raw, void *ctx) {
+	//
+	// Description:
+	//	Nominal conversion, used when the chip does not provide the calibration data
+	//
+	return((raw * ADCCALIB_NOMINALMV) / ADCCALIB_RAWMAX);
+}
+
+
+static int _adcCalib_efuse (int raw, void *ctx) {
+	//
+	// Description:
+	//	eFuse based conversion (adc_cali driver)
+	//
+	int mv = 0;
+	if (adc_cali_raw_to_voltage((adc_cali_handle_t)ctx, raw, &mv) != ESP_OK)
+		mv = _adcCalib_nominal(raw, NULL);
+	return(mv);
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+werror adcCalib_initCurve (adcCalibCurve_t curve, void *ctx) {
+	//
+	// Description:
+	//	It fills the conversion table using the argument defined curve. Values out of the 0..65535 range are clipped
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG    NULL curve
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (curve == NULL)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+	else {
+		for (int raw = 0; raw <= ADCCALIB_RAWMAX; raw++) {
+			int mv = curve(raw, ctx);
+			adcCalib_table[raw] = (mv < 0) ? 0 : ((mv > UINT16_MAX) ? UINT16_MAX : mv);
+		}
+		calibrated = false;
+	}
+
+	return(ec);
+}
+
+
+#if MOCK == 0
+werror adcCalib_init (adc_unit_t unit, adc_atten_t atten) {
+	//
+	// Description:
+	//	It builds the conversion table for the argument defined unit and attenuation. All channels share the same
+	//	calibration data. When the chip has not been calibrated, the nominal conversion is used.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS             The table has been built using the eFuse calibration data
+	//	WERRCODE_WARNING_RESNOTAV    No calibration data: the table has been built using the nominal conversion
+	//	WERRCODE_ERROR_INITFAILED    The calibration driver failed
+	//
+	werror            ec     = WERRCODE_SUCCESS;
+	adc_cali_handle_t handle = NULL;
+	esp_err_t         espErr;
+
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+	adc_cali_curve_fitting_config_t caliConfig = {
+		.unit_id  = unit,
+		.chan     = ADC_CHANNEL_0,
+		.atten    = atten,
+		.bitwidth = ADC_BITWIDTH_DEFAULT
+	};
+	espErr = adc_cali_create_scheme_curve_fitting(&caliConfig, &handle);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+	adc_cali_line_fitting_config_t caliConfig = {
+		.unit_id  = unit,
+		.atten    = atten,
+		.bitwidth = ADC_BITWIDTH_DEFAULT
+	};
+	espErr = adc_cali_create_scheme_line_fitting(&caliConfig, &handle);
+#else
+	espErr = ESP_ERR_NOT_SUPPORTED;
+#endif
+
+	if (espErr == ESP_OK) {
+		adcCalib_initCurve(_adcCalib_efuse, handle);
+		calibrated = true;
+		ESP_LOGI(__FUNCTION__, "OK! A/D conversion table built using the eFuse calibration data");
+
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+		adc_cali_delete_scheme_curve_fitting(handle);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+		adc_cali_delete_scheme_line_fitting(handle);
+#endif
+
+	} else if (espErr == ESP_ERR_NOT_SUPPORTED) {
+		// WARNING!
+		ESP_LOGW(__FUNCTION__, "WARNING! No eFuse calibration data, the nominal conversion will be used");
+		adcCalib_initCurve(_adcCalib_nominal, NULL);
+		ec = WERRCODE_WARNING_RESNOTAV;
+
+	} else {
+		// ERROR!
+		ESP_LOGE(__FUNCTION__, "ERROR! A/D calibration failed: %s", esp_err_to_name(espErr));
+		adcCalib_initCurve(_adcCalib_nominal, NULL);
+		ec = WERRCODE_ERROR_INITFAILED;
+	}
+
+	return(ec);
+}
+#endif
+
+
+bool adcCalib_isCalibrated () {
+	//
+	// Description:
+	//	It returns true when the table has been built using the chip's calibration data
+	//
+	return(calibrated);
+}
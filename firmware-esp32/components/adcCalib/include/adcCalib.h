@@ -0,0 +1,82 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   adcCalib.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	This module converts the A/D converter raw values in millivolts. At boot time it builds a raw-to-millivolts table
+//	using the calibration data stored in the chip's eFuses (adc_cali driver), so every conversion is just a table load.
+//	If the chip has no calibration data, the table is built with the nominal conversion formula.
+//	In MOCK mode (host PC), the table can be built from a synthetic calibration curve only.
+//
+//	Symbols:
+//		ADCCALIB_RAWMAX        Maximum raw value (13 bits resolution on ESP32-S2)
+//		ADCCALIB_NOMINALMV     Nominal full-scale voltage (millivolts) used when no calibration data is available
+//
+//	[!] The table needs (ADCCALIB_RAWMAX + 1) * 2 bytes of RAM (16KB)
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef __ADCCALIB__
+#define __ADCCALIB__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <werror.h>
+
+#ifndef MOCK
+#define MOCK 0
+#endif
+
+#if MOCK == 0
+#include "hal/adc_types.h"
+#endif
+
+#define ADCCALIB_RAWMAX     8191
+#define ADCCALIB_NOMINALMV  2640
+
+// Synthetic calibration curve: it returns the millivolts associated to the argument defined raw value
+typedef int (*adcCalibCurve_t)(int raw, void *ctx);
+
+extern uint16_t adcCalib_table[ADCCALIB_RAWMAX + 1];
+
+#if MOCK == 0
+werror adcCalib_init      (adc_unit_t unit, adc_atten_t atten);
+#endif
+werror adcCalib_initCurve (adcCalibCurve_t curve, void *ctx);
+bool   adcCalib_isCalibrated ();
+
+
+static inline uint16_t adcCalib_toMv (int raw) {
+	//
+	// Description:
+	//	It returns the millivolts associated to the argument defined raw value
+	//
+	if      (raw < 0)               raw = 0;
+	else if (raw > ADCCALIB_RAWMAX) raw = ADCCALIB_RAWMAX;
+
+	return(adcCalib_table[raw]);
+}
+
+#endif
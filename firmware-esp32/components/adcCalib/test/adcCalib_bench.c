@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   adcCalib_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	It compares the table based conversion (adcCalib_toMv()) with the old floating point formula
+//		mv = (raw * DEFAULT_VREF) / 8191 * 2.4
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <adcCalib.h>
+
+#define BENCH_SAMPLES   (1 << 16)
+#define BENCH_ROUNDS    500
+#define DEFAULT_VREF    1100
+
+
+static double nowSec () {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+
+static int floatCurve (int raw, void *ctx) {
+	return((raw * DEFAULT_VREF) / 8191 * 2.4);
+}
+
+
+int main () {
+	int               *samples = malloc(BENCH_SAMPLES * sizeof(int));
+	volatile uint32_t sink = 0;
+	uint32_t          acc;
+	double            t0, tTable, tFloat;
+
+	srand(42);
+	for (uint32_t t=0; t<BENCH_SAMPLES; t++) samples[t] = rand() % (ADCCALIB_RAWMAX + 1);
+	adcCalib_initCurve(floatCurve, NULL);
+
+	t0 = nowSec();
+	for (uint32_t r=0; r<BENCH_ROUNDS; r++) {
+		acc = 0;
+		for (uint32_t t=0; t<BENCH_SAMPLES; t++) acc += adcCalib_toMv(samples[t]);
+		sink += acc;
+	}
+	tTable = nowSec() - t0;
+
+	t0 = nowSec();
+	for (uint32_t r=0; r<BENCH_ROUNDS; r++) {
+		acc = 0;
+		for (uint32_t t=0; t<BENCH_SAMPLES; t++) acc += (int)((samples[t] * DEFAULT_VREF) / 8191 * 2.4);
+		sink += acc;
+	}
+	tFloat = nowSec() - t0;
+
+	printf("Conversions: %d\n", BENCH_SAMPLES * BENCH_ROUNDS);
+	printf("Table lookup:     %6.2f ns/conversion\n", tTable * 1e9 / (BENCH_SAMPLES * BENCH_ROUNDS));
+	printf("Float conversion: %6.2f ns/conversion\n", tFloat * 1e9 / (BENCH_SAMPLES * BENCH_ROUNDS));
+	printf("[!] On the ESP32-S2 (no FPU) the float conversion is emulated by software, the gap is much larger\n");
+
+	free(samples);
+	return(sink == 0);
+}
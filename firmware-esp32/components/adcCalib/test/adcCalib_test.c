@@ -0,0 +1,74 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   adcCalib_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	adcCalib module's unit tests. They run on the host PC (MOCK mode) using synthetic calibration curves
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <adcCalib.h>
+#include <componentTest.h>
+
+typedef struct {
+	int gain;     // uV per raw unit
+	int offset;   // mV
+} lineCurve_t;
+
+
+static int lineCurve (int raw, void *ctx) {
+	lineCurve_t *c = (lineCurve_t*)ctx;
+	return((raw * c->gain) / 1000 + c->offset);
+}
+
+
+int main () {
+	int         err = 0;
+	bool        same = true;
+	lineCurve_t c1 = { 312, 55 };
+	lineCurve_t c2 = { 20000, -100 };
+
+	CHECK(adcCalib_initCurve(NULL, NULL) == WERRCODE_ERROR_ILLEGALARG);
+	CHECK(adcCalib_initCurve(lineCurve, &c1) == WERRCODE_SUCCESS);
+	CHECK(adcCalib_isCalibrated() == false);
+
+	for (int raw = 0; raw <= ADCCALIB_RAWMAX; raw++)
+		if (adcCalib_toMv(raw) != lineCurve(raw, &c1)) same = false;
+	CHECK(same);
+
+	// Out of range raw values
+	CHECK(adcCalib_toMv(-5) == adcCalib_toMv(0));
+	CHECK(adcCalib_toMv(ADCCALIB_RAWMAX + 100) == adcCalib_toMv(ADCCALIB_RAWMAX));
+
+	// Out of range millivolts are clipped
+	CHECK(adcCalib_initCurve(lineCurve, &c2) == WERRCODE_SUCCESS);
+	CHECK(adcCalib_toMv(0) == 0);
+	CHECK(adcCalib_toMv(ADCCALIB_RAWMAX) == UINT16_MAX);
+	CHECK(adcCalib_toMv(100) == 1900);
+
+	return(err);
+}
@@ -0,0 +1,392 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   adcScheduler.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Shared A/D converter sampling scheduler. Read the adcScheduler.h file for details
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+
+#if MOCK == 0
+#include "hal/adc_types.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_timer.h"
+#include "esp_err.h"
+#include <esp_log.h>
+#endif
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <adcScheduler.h>
+#include <adcCalib.h>
+#include <ravgFilter.h>
+
+#define ADCSCHED_NOCHANNEL 0xFF
+
+typedef struct {
+	uint8_t            channel;
+	adcSchedPrio_t     prio;
+	_Atomic uint16_t   periodMs;       // ADCSCHED_DISABLED means the channel is not sampled
+	bool               armed;          // False until the first tick after the channel enabling
+	uint32_t           nextDue;        // When the next sample has to be taken (milliseconds)
+	ravg_t             filter;
+	_Atomic int32_t    value;          // Published filtered value (mV), or -1 when it is not yet available
+	_Atomic uint32_t   samples;        // Number of taken samples
+	adcSchedCallback_t callback;       // New filtered value's callback (optional)
+} adcSchedChan_t;
+
+static adcSchedChan_t   chans[ADCSCHED_MAXCHANNELS];
+static uint8_t          chansNumb = 0;
+static adcSchedSource_t source    = NULL;
+static bool             initFlag  = false;
+
+#if MOCK == 0
+static adc_oneshot_unit_handle_t adcHandle = NULL;
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                     P R I V A T E   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+#if MOCK == 0
+static werror _adcSched_oneshotRead (uint8_t channel, int *raw) {
+	//
+	// Description:
+	//	Default source: the ADC1 unit in one-shot mode
+	//
+	return((adc_oneshot_read(adcHandle, channel, raw) == ESP_OK) ? WERRCODE_SUCCESS : WERRCODE_ERROR_IOOPERFAILED);
+}
+
+
+static void _adcSched_timerCB (void *arg) {
+	//
+	// Description:
+	//	Scheduler's timer callback
+	//
+	adcSched_tick((uint32_t)(esp_timer_get_time() / 1000));
+	return;
+}
+#endif
+
+
+static void _adcSched_sample (uint8_t chID, uint32_t nowMs) {
+	//
+	// Description:
+	//	It reads the argument defined channel, filters the value and publishes the result (the channel's callback is
+	//	called too)
+	//
+	adcSchedChan_t *ch = &chans[chID];
+	int            raw, mv;
+
+	if (wErrCode_isSuccess(source(ch->channel, &raw))) {
+		if (ravg_update(&ch->filter, &mv, adcCalib_toMv(raw)) == WERRCODE_SUCCESS) {
+			atomic_store_explicit(&ch->value, mv, memory_order_release);
+			if (ch->callback != NULL) ch->callback(chID, mv, nowMs);
+		}
+
+		atomic_fetch_add_explicit(&ch->samples, 1, memory_order_relaxed);
+	}
+	return;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+werror adcSched_init (adcSchedSource_t src) {
+	//
+	// Description:
+	//	Module's initialization. When the argument defined source is NULL, the scheduler uses the ADC1 unit (it is not
+	//	allowed in MOCK mode).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG    NULL source in MOCK mode
+	//	WERRCODE_ERROR_INITFAILED    A/D converter initialization failed
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	chansNumb = 0;
+	source    = src;
+
+	if (source == NULL) {
+#if MOCK == 0
+		adc_oneshot_unit_init_cfg_t unitConfig = {
+			.unit_id  = ADC_UNIT_1,               // ADC unit selection
+			.clk_src  = ADC_DIGI_CLK_SRC_DEFAULT, // Clock's source
+			.ulp_mode = ADC_ULP_MODE_DISABLE      // Ultra Low Power FSM coprocessor
+		};
+
+		if (adcHandle == NULL && adc_oneshot_new_unit(&unitConfig, &adcHandle) != ESP_OK) {
+			// ERROR!
+			ESP_LOGE(__FUNCTION__, "ERROR! A/D converter initialization failed");
+			ec = WERRCODE_ERROR_INITFAILED;
+		} else
+			source = _adcSched_oneshotRead;
+#else
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+#endif
+	}
+
+	initFlag = wErrCode_isSuccess(ec);
+	return(ec);
+}
+
+
+werror adcSched_add (uint8_t *chID, uint8_t channel, uint16_t periodMs, adcSchedPrio_t prio) {
+	//
+	// Description:
+	//	It adds the argument defined channel to the scheduled ones, and returns its numeric id
+	//
+	// Arguments:
+	//	chID       The channel's ID you have to use with the other functions
+	//	channel    A/D converter channel (eg. ADC_CHANNEL_0)
+	//	periodMs   Sampling period (it is rounded to the ADCSCHED_TICKMS multiple). ADCSCHED_DISABLED to stop it
+	//	prio       Priority used when the conversions required in a tick are more than ADCSCHED_MAXREADSPERTICK
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG      NULL pointer
+	//	WERRCODE_ERROR_INITFAILED      Module has not been initialized
+	//	WERRCODE_ERROR_DATAOVERFLOW    No further space for new channels
+	//	WERRCODE_ERROR_SYSCALL         Channel configuration failed
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (chID == NULL)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+
+	else if (initFlag == false)
+		// ERROR!
+		ec = WERRCODE_ERROR_INITFAILED;
+
+	else if (chansNumb == ADCSCHED_MAXCHANNELS)
+		// ERROR!
+		ec = WERRCODE_ERROR_DATAOVERFLOW;
+
+	else {
+#if MOCK == 0
+		if (source == _adcSched_oneshotRead) {
+			adc_oneshot_chan_cfg_t chanConfig = {
+				.bitwidth = ADC_BITWIDTH_DEFAULT,
+				.atten    = ADC_ATTEN_DB_12
+			};
+			if (adc_oneshot_config_channel(adcHandle, channel, &chanConfig) != ESP_OK) {
+				// ERROR!
+				ESP_LOGE(__FUNCTION__, "ERROR! A/D channel-%d configuration failed", channel);
+				ec = WERRCODE_ERROR_SYSCALL;
+			}
+		}
+#endif
+		if (wErrCode_isSuccess(ec)) {
+			adcSchedChan_t *ch = &chans[chansNumb];
+
+			ch->channel  = channel;
+			ch->prio     = prio;
+			ch->armed    = false;
+			ch->nextDue  = 0;
+			ch->callback = NULL;
+			ravg_init(&ch->filter);
+			atomic_store(&ch->value,    -1);
+			atomic_store(&ch->samples,  0);
+			atomic_store(&ch->periodMs, periodMs);
+
+			*chID = chansNumb;
+			chansNumb++;
+		}
+	}
+
+	return(ec);
+}
+
+
+werror adcSched_setPeriod (uint8_t chID, uint16_t periodMs) {
+	//
+	// Description:
+	//	It changes the sampling period of the argument defined channel. It can be called while the scheduler is
+	//	running. When a disabled channel is enabled again, its filter is reset.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG      Unknown channel
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (chID >= chansNumb)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+	else
+		atomic_store(&chans[chID].periodMs, periodMs);
+
+	return(ec);
+}
+
+
+werror adcSched_setCallback (uint8_t chID, adcSchedCallback_t callback) {
+	//
+	// Description:
+	//	It sets the function called for every new filtered value of the argument defined channel (NULL: no callback).
+	//	It has to be called before adcSched_start()
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG      Unknown channel
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (chID >= chansNumb)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+	else
+		chans[chID].callback = callback;
+
+	return(ec);
+}
+
+
+werror adcSched_get (uint8_t chID, int *mv) {
+	//
+	// Description:
+	//	It returns the last filtered value (millivolts) of the argument defined channel. It never waits for the
+	//	scheduler
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_RESNOTAV      The filtered value is not yet available
+	//	WERRCODE_ERROR_ILLEGALARG      Unknown channel or NULL pointer
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (chID >= chansNumb || mv == NULL)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+	else {
+		int32_t v = atomic_load_explicit(&chans[chID].value, memory_order_acquire);
+		if (v < 0)
+			// WARNING!
+			ec = WERRCODE_WARNING_RESNOTAV;
+		else
+			*mv = v;
+	}
+
+	return(ec);
+}
+
+
+uint32_t adcSched_samples (uint8_t chID) {
+	//
+	// Description:
+	//	It returns the number of samples taken on the argument defined channel (0 for unknown channels)
+	//
+	return((chID < chansNumb) ? atomic_load_explicit(&chans[chID].samples, memory_order_relaxed) : 0);
+}
+
+
+void adcSched_tick (uint32_t nowMs) {
+	//
+	// Description:
+	//	It performs a scheduling round: the expired channels are read, highest priority (and then oldest deadline)
+	//	first, up to ADCSCHED_MAXREADSPERTICK conversions. The not served channels will be read in the next ticks.
+	//	A channel late for more than a whole period skips the lost samples, so it never produces bursts.
+	//
+	uint32_t served = 0;
+
+	for (uint8_t reads = 0; reads < ADCSCHED_MAXREADSPERTICK; reads++) {
+		uint8_t best = ADCSCHED_NOCHANNEL;
+
+		for (uint8_t t = 0; t < chansNumb; t++) {
+			adcSchedChan_t *ch = &chans[t];
+
+			if (atomic_load_explicit(&ch->periodMs, memory_order_relaxed) == ADCSCHED_DISABLED) {
+				ch->armed = false;
+
+			} else {
+				if (ch->armed == false) {
+					// (Re)enabled channel
+					ravg_init(&ch->filter);
+					atomic_store_explicit(&ch->value, -1, memory_order_release);
+					ch->nextDue = nowMs;
+					ch->armed   = true;
+				}
+
+				if ((int32_t)(nowMs - ch->nextDue) >= 0 && (served & (1UL << t)) == 0) {
+					if (
+						best == ADCSCHED_NOCHANNEL   ||
+						ch->prio > chans[best].prio  ||
+						(ch->prio == chans[best].prio && (int32_t)(chans[best].nextDue - ch->nextDue) > 0)
+					) best = t;
+				}
+			}
+		}
+
+		if (best == ADCSCHED_NOCHANNEL) break;
+
+		_adcSched_sample(best, nowMs);
+		served |= (1UL << best);
+
+		chans[best].nextDue += atomic_load_explicit(&chans[best].periodMs, memory_order_relaxed);
+		if ((int32_t)(nowMs - chans[best].nextDue) >= 0)
+			// Lost samples skipping
+			chans[best].nextDue = nowMs + atomic_load_explicit(&chans[best].periodMs, memory_order_relaxed);
+	}
+
+	return;
+}
+
+
+#if MOCK == 0
+werror adcSched_start () {
+	//
+	// Description:
+	//	It starts the scheduler's periodic timer
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_INITFAILED    Module not initialized or timer creation failed
+	//
+	werror                  ec = WERRCODE_SUCCESS;
+	esp_timer_handle_t      timerHandle;
+	esp_timer_create_args_t timerArgs = {
+		.callback              = _adcSched_timerCB,
+		.arg                   = NULL,
+		.dispatch_method       = ESP_TIMER_TASK,
+		.name                  = "adcScheduler-proc",
+		.skip_unhandled_events = true
+	};
+
+	if (
+		initFlag == false                                                  ||
+		esp_timer_create(&timerArgs, &timerHandle)                != ESP_OK ||
+		esp_timer_start_periodic(timerHandle, ADCSCHED_TICKMS * 1000) != ESP_OK
+	) {
+		// ERROR!
+		ESP_LOGE(__FUNCTION__, "ERROR! I cannot start the scheduler's timer");
+		ec = WERRCODE_ERROR_INITFAILED;
+	}
+
+	return(ec);
+}
+#endif
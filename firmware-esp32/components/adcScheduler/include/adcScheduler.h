@@ -0,0 +1,86 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   adcScheduler.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	This module owns the A/D converter unit and shares it among all the analog channels (resistor-key, battery...).
+//	Every channel has its own sampling period and priority: a periodic timer runs the scheduler every ADCSCHED_TICKMS
+//	milliseconds, and it reads the channels whose period has expired, highest priority first, up to
+//	ADCSCHED_MAXREADSPERTICK reads per tick. The read values are converted in millivolts (adcCalib), filtered by a
+//	running average filter (ravgFilter), and published in lock-free way: readers never wait for the scheduler.
+//	A channel can have a callback too (see adcSched_setCallback()): it is called by the scheduler for every new
+//	filtered value, with the sampling time, so the consumer gets every sample whatever its own loop's period is.
+//
+//	In MOCK mode (host PC) the A/D converter is replaced by the argument defined source function, and the scheduler
+//	has to be driven by calling adcSched_tick() with a simulated time.
+//
+//	Symbols:
+//		ADCSCHED_MAXCHANNELS       Maximum number of scheduled channels
+//		ADCSCHED_TICKMS            Scheduler period (milliseconds)
+//		ADCSCHED_MAXREADSPERTICK   Maximum number of conversions in a single tick
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef __ADCSCHEDULER__
+#define __ADCSCHEDULER__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <werror.h>
+
+#ifndef MOCK
+#define MOCK 0
+#endif
+
+#define ADCSCHED_MAXCHANNELS      8
+#define ADCSCHED_TICKMS           2
+#define ADCSCHED_MAXREADSPERTICK  4
+#define ADCSCHED_DISABLED         0
+
+typedef enum {
+	ADCSCHED_PRIO_LOW,
+	ADCSCHED_PRIO_NORMAL,
+	ADCSCHED_PRIO_HIGH
+} adcSchedPrio_t;
+
+// A/D converter source: it writes in "raw" the raw value read from the argument defined channel
+typedef werror (*adcSchedSource_t)(uint8_t channel, int *raw);
+
+// New filtered value's callback (it runs in the scheduler's context: it has to be short and it must not wait)
+typedef void (*adcSchedCallback_t)(uint8_t chID, int mv, uint32_t nowMs);
+
+
+werror   adcSched_init        (adcSchedSource_t source);
+werror   adcSched_add         (uint8_t *chID, uint8_t channel, uint16_t periodMs, adcSchedPrio_t prio);
+werror   adcSched_setPeriod   (uint8_t chID, uint16_t periodMs);
+werror   adcSched_setCallback (uint8_t chID, adcSchedCallback_t callback);
+werror   adcSched_get         (uint8_t chID, int *mv);
+uint32_t adcSched_samples     (uint8_t chID);
+void     adcSched_tick        (uint32_t nowMs);
+#if MOCK == 0
+werror   adcSched_start       ();
+#endif
+
+#endif
@@ -0,0 +1,199 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   adcScheduler_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	adcScheduler module's tests. They run on the host PC (MOCK mode) using a stand-in A/D converter, and they check the
+//	achieved sampling rate of every channel against its configuration.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <adcScheduler.h>
+#include <componentTest.h>
+#include <adcCalib.h>
+#include <ravgFilter.h>
+
+#define TEST_DURATIONMS 60000
+
+typedef struct {
+	const char     *name;
+	uint8_t        channel;
+	uint16_t       periodMs;
+	adcSchedPrio_t prio;
+	uint8_t        id;
+} testChan_t;
+
+static uint32_t nowMs = 0;
+static uint32_t cbCalls = 0, cbBadTime = 0, cbBadValue = 0;
+
+
+static werror standInSource (uint8_t channel, int *raw) {
+	//
+	// Description:
+	//	Stand-in A/D converter: every channel returns 1000 * channel +/- 8 (the average is 1000 * channel)
+	//
+	static int noise = 8;
+	noise = -noise;
+	*raw = 1000 * channel + noise;
+	return(WERRCODE_SUCCESS);
+}
+
+
+static int identityCurve (int raw, void *ctx) {
+	return(raw);
+}
+
+
+static void batteryCB (uint8_t chID, int mv, uint32_t tMs) {
+	//
+	// Description:
+	//	New filtered value's callback: it is called with the sampling time and the published value
+	//
+	int published;
+
+	cbCalls++;
+	if (tMs != nowMs) cbBadTime++;
+	if (adcSched_get(chID, &published) != WERRCODE_SUCCESS || published != mv) cbBadValue++;
+	return;
+}
+
+
+static void run (uint32_t durationMs) {
+	for (uint32_t end = nowMs + durationMs; nowMs < end; nowMs += ADCSCHED_TICKMS)
+		adcSched_tick(nowMs);
+	return;
+}
+
+
+static bool rateCheck (testChan_t *c, uint32_t durationMs) {
+	//
+	// Description:
+	//	It checks the achieved sampling rate is equal to the configured one (1% tolerance)
+	//
+	uint32_t expected = durationMs / c->periodMs;
+	uint32_t achieved = adcSched_samples(c->id);
+
+	printf("       %-12s period=%4dms expected=%6lu achieved=%6lu\n", c->name, c->periodMs,
+		(unsigned long)expected, (unsigned long)achieved);
+	return(abs((int)achieved - (int)expected) <= (int)(expected / 100 + 1));
+}
+
+
+int main () {
+	int        err = 0;
+	int        mv;
+	bool       ok = true;
+	testChan_t chans[] = {
+		{ "key-X1",      0,   10, ADCSCHED_PRIO_HIGH,   0 },
+		{ "key-X2",      1,   10, ADCSCHED_PRIO_HIGH,   0 },
+		{ "key-Y1",      2,   10, ADCSCHED_PRIO_HIGH,   0 },
+		{ "key-Y2",      3,   10, ADCSCHED_PRIO_HIGH,   0 },
+		{ "battery",     4,  100, ADCSCHED_PRIO_LOW,    0 },
+		{ "current",     5,   50, ADCSCHED_PRIO_NORMAL, 0 },
+		{ "spare",       6, 1000, ADCSCHED_PRIO_LOW,    0 }
+	};
+	uint8_t    chansNumb = sizeof(chans) / sizeof(testChan_t);
+
+	adcCalib_initCurve(identityCurve, NULL);
+
+	CHECK(adcSched_init(NULL) == WERRCODE_ERROR_ILLEGALARG);
+	CHECK(adcSched_init(standInSource) == WERRCODE_SUCCESS);
+
+	for (uint8_t t=0; t<chansNumb; t++)
+		if (adcSched_add(&chans[t].id, chans[t].channel, chans[t].periodMs, chans[t].prio) != WERRCODE_SUCCESS) ok = false;
+	CHECK(ok);
+	CHECK(adcSched_get(0, &mv) == WERRCODE_WARNING_RESNOTAV);
+	CHECK(adcSched_setCallback(99, batteryCB) == WERRCODE_ERROR_ILLEGALARG);
+	CHECK(adcSched_setCallback(chans[4].id, batteryCB) == WERRCODE_SUCCESS);
+
+	//
+	// Nominal load: every channel achieves its own rate
+	//
+	run(TEST_DURATIONMS);
+	ok = true;
+	for (uint8_t t=0; t<chansNumb; t++)
+		if (rateCheck(&chans[t], TEST_DURATIONMS) == false) ok = false;
+	CHECK(ok);
+
+	// Filtered and published values
+	CHECK(adcSched_get(chans[4].id, &mv) == WERRCODE_SUCCESS && mv == 4000);
+	CHECK(adcSched_get(chans[1].id, &mv) == WERRCODE_SUCCESS && mv == 1000);
+	CHECK(adcSched_get(99, &mv) == WERRCODE_ERROR_ILLEGALARG);
+
+	// Every new filtered value has been passed to the callback, with its sampling time (the filter's first
+	// RAVG_DEEPLEVEL samples do not produce a value)
+	CHECK(cbCalls == adcSched_samples(chans[4].id) - RAVG_DEEPLEVEL);
+	CHECK(cbBadTime == 0 && cbBadValue == 0);
+
+	//
+	// Key channels disabling (authentication completed)
+	//
+	{
+		uint32_t keySamples = adcSched_samples(chans[0].id);
+		uint32_t batSamples = adcSched_samples(chans[4].id);
+
+		for (uint8_t t=0; t<4; t++) adcSched_setPeriod(chans[t].id, ADCSCHED_DISABLED);
+		run(10000);
+		CHECK(adcSched_samples(chans[0].id) == keySamples);
+		CHECK(adcSched_samples(chans[4].id) - batSamples == 10000 / chans[4].periodMs);
+
+		// Re-enabling: the filter is reset
+		adcSched_setPeriod(chans[0].id, 10);
+		run(ADCSCHED_TICKMS);
+		CHECK(adcSched_get(chans[0].id, &mv) == WERRCODE_WARNING_RESNOTAV);
+		run(100);
+		CHECK(adcSched_get(chans[0].id, &mv) == WERRCODE_SUCCESS);
+	}
+
+	//
+	// Overload: six channels at the maximum rate, only ADCSCHED_MAXREADSPERTICK conversions for every tick.
+	// The higher priority channels must keep their rate.
+	//
+	{
+		testChan_t over[] = {
+			{ "high-A",   0, ADCSCHED_TICKMS, ADCSCHED_PRIO_HIGH,   0 },
+			{ "high-B",   1, ADCSCHED_TICKMS, ADCSCHED_PRIO_HIGH,   0 },
+			{ "normal-A", 2, ADCSCHED_TICKMS, ADCSCHED_PRIO_NORMAL, 0 },
+			{ "normal-B", 3, ADCSCHED_TICKMS, ADCSCHED_PRIO_NORMAL, 0 },
+			{ "low-A",    4, ADCSCHED_TICKMS, ADCSCHED_PRIO_LOW,    0 },
+			{ "low-B",    5, ADCSCHED_TICKMS, ADCSCHED_PRIO_LOW,    0 }
+		};
+
+		adcSched_init(standInSource);
+		for (uint8_t t=0; t<6; t++)
+			adcSched_add(&over[t].id, over[t].channel, over[t].periodMs, over[t].prio);
+
+		run(TEST_DURATIONMS);
+		ok = true;
+		for (uint8_t t=0; t<ADCSCHED_MAXREADSPERTICK; t++)
+			if (rateCheck(&over[t], TEST_DURATIONMS) == false) ok = false;
+		CHECK(ok);
+		CHECK(adcSched_samples(over[4].id) + adcSched_samples(over[5].id) == 0);
+	}
+
+	return(err);
+}
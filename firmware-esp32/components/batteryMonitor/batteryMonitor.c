@@ -0,0 +1,245 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   batteryMonitor.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Battery voltage monitoring and load shedding. Look at the header file for the details.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <batteryMonitor.h>
+
+typedef struct {
+	uint8_t      priority;              // The lower priority loads are shed first
+	_Atomic bool shed;
+} battLoad_t;
+
+static battLoad_t      loads[BATTMON_MAXLOADS];
+static uint8_t         loadsNumb  = 0;
+static _Atomic uint8_t shedNumb   = 0;           // The atomic variables are read by another task (see batteryMonitor.h)
+static int32_t         decimAcc   = 0;           // Decimating filter's accumulator
+static uint8_t         decimNumb  = 0;
+static _Atomic int     voltage    = BATTMON_NOVOLTAGE;
+static bool            lowFlag    = false;
+static bool            highFlag   = false;
+static uint32_t        sinceMs    = 0;           // Time when the voltage crossed the threshold, or of the last shed/restore
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                     P R I V A T E   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+static void _batteryMonitor_shedOne () {
+	//
+	// Description:
+	//	It sheds the lowest priority load that is still on
+	//
+	uint8_t sel = BATTMON_MAXLOADS;
+
+	for (uint8_t t=0; t<loadsNumb; t++)
+		if (loads[t].shed == false && (sel == BATTMON_MAXLOADS || loads[t].priority < loads[sel].priority))
+			sel = t;
+
+	if (sel != BATTMON_MAXLOADS) {
+		loads[sel].shed = true;
+		shedNumb++;
+	}
+	return;
+}
+
+
+static void _batteryMonitor_restoreOne () {
+	//
+	// Description:
+	//	It restores the highest priority shed load
+	//
+	uint8_t sel = BATTMON_MAXLOADS;
+
+	for (uint8_t t=0; t<loadsNumb; t++)
+		if (loads[t].shed == true && (sel == BATTMON_MAXLOADS || loads[t].priority >= loads[sel].priority))
+			sel = t;
+
+	if (sel != BATTMON_MAXLOADS) {
+		loads[sel].shed = false;
+		shedNumb--;
+	}
+	return;
+}
+
+
+static void _batteryMonitor_evaluate (uint32_t nowMs) {
+	//
+	// Description:
+	//	It applies the shedding/restoring rules to the last filtered voltage value
+	//
+	if (voltage < BATTMON_SHEDMV) {
+		highFlag = false;
+		if (lowFlag == false) {
+			lowFlag = true;
+			sinceMs = nowMs;
+		} else if ((nowMs - sinceMs) >= BATTMON_SHEDHOLDMS) {
+			_batteryMonitor_shedOne();
+			sinceMs = nowMs;
+		}
+
+	} else if (voltage > BATTMON_RESTOREMV) {
+		lowFlag = false;
+		if (highFlag == false) {
+			highFlag = true;
+			sinceMs  = nowMs;
+		} else if ((nowMs - sinceMs) >= BATTMON_RESTOREHOLDMS) {
+			_batteryMonitor_restoreOne();
+			sinceMs = nowMs;
+		}
+
+	} else {
+		// Hysteresis band: nothing changes
+		lowFlag  = false;
+		highFlag = false;
+	}
+
+	return;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+werror batteryMonitor_init () {
+	//
+	// Description:
+	//	Module's initialization. All the registered loads are removed.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//
+	loadsNumb = 0;
+	shedNumb  = 0;
+	decimAcc  = 0;
+	decimNumb = 0;
+	voltage   = BATTMON_NOVOLTAGE;
+	lowFlag   = false;
+	highFlag  = false;
+
+	return(WERRCODE_SUCCESS);
+}
+
+
+werror batteryMonitor_addLoad (uint8_t *loadID, uint8_t priority) {
+	//
+	// Description:
+	//	It registers a sheddable load, and returns its numeric ID
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG      NULL pointer
+	//	WERRCODE_ERROR_DATAOVERFLOW    No further space for new loads
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (loadID == NULL)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+
+	else if (loadsNumb == BATTMON_MAXLOADS)
+		// ERROR!
+		ec = WERRCODE_ERROR_DATAOVERFLOW;
+
+	else {
+		loads[loadsNumb].priority = priority;
+		loads[loadsNumb].shed     = false;
+		*loadID = loadsNumb;
+		loadsNumb++;
+	}
+
+	return(ec);
+}
+
+
+werror batteryMonitor_update (int pinMv, uint32_t nowMs) {
+	//
+	// Description:
+	//	It adds the argument defined sample (millivolts on the A/D pin) to the decimating filter. Every
+	//	BATTMON_DECIMATION samples, the battery voltage is updated and the shedding rules are applied.
+	//
+	// Arguments:
+	//	pinMv   Voltage (mV) on the i_VBATT pin
+	//	nowMs   Current time (ms)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS              A new battery voltage value is available
+	//	WERRCODE_WARNING_RESNOTAV     The sample has been stored, but the decimation is not yet completed
+	//	WERRCODE_ERROR_ILLEGALARG     Negative voltage
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (pinMv < 0)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+
+	else {
+		decimAcc += pinMv;
+		decimNumb++;
+
+		if (decimNumb < BATTMON_DECIMATION)
+			ec = WERRCODE_WARNING_RESNOTAV;
+
+		else {
+			voltage   = (int)((decimAcc * BATTMON_DIVNUM) / (BATTMON_DECIMATION * BATTMON_DIVDEN));
+			decimAcc  = 0;
+			decimNumb = 0;
+			_batteryMonitor_evaluate(nowMs);
+		}
+	}
+
+	return(ec);
+}
+
+
+bool batteryMonitor_isAllowed (uint8_t loadID) {
+	//
+	// Description:
+	//	It returns false when the argument defined load has been shed. Unknown loads are always allowed.
+	//
+	return(loadID >= loadsNumb || loads[loadID].shed == false);
+}
+
+
+uint8_t batteryMonitor_shedLoads () {
+	//
+	// Description:
+	//	It returns the number of loads currently shed
+	//
+	return(shedNumb);
+}
+
+
+int batteryMonitor_voltage () {
+	//
+	// Description:
+	//	It returns the last filtered battery voltage (mV), or BATTMON_NOVOLTAGE when it is not yet available
+	//
+	return(voltage);
+}
@@ -0,0 +1,71 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   batteryMonitor.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	This module monitors the battery voltage, and it sheds the non-critical loads (eg. the additional light) when the
+//	voltage sags, for example while the electric starter is cranking or with all the lights on at idle. This way the
+//	starter relay and the CDI enable output keep working on a weak battery.
+//
+//	The voltage is read on the i_VBATT A/D channel through a resistor divider. The samples are reduced by a decimating
+//	filter (BATTMON_DECIMATION samples for every output value), then the following rules are applied:
+//		- voltage < BATTMON_SHEDMV for BATTMON_SHEDHOLDMS     the lowest priority load still on is shed
+//		- voltage > BATTMON_RESTOREMV for BATTMON_RESTOREHOLDMS  the highest priority shed load is restored
+//	The gap between the two thresholds (hysteresis) and the hold times prevent the loads from flapping.
+//	Pass every new A/D sample, with its sampling time, to batteryMonitor_update(): e.g. by the A/D scheduler's
+//	channel callback (see adcSched_setCallback()), so the filter and the hold times do not depend by the period of the
+//	loop that reads the loads' state. The state read by the other functions is atomic, so they can be called by
+//	another task.
+//
+//	[!] The critical outputs (o_STARTENGINE, o_ENGINEON) must never be registered as loads
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef __BATTERYMONITOR__
+#define __BATTERYMONITOR__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <werror.h>
+
+#define BATTMON_MAXLOADS       4
+#define BATTMON_DECIMATION     8        // Input samples for every filtered value
+#define BATTMON_DIVNUM         122      // Resistor divider ratio: (100K + 22K) / 22K
+#define BATTMON_DIVDEN         22
+#define BATTMON_SHEDMV         11500    // Battery voltage (mV) under that the loads are shed
+#define BATTMON_RESTOREMV      12300    // Battery voltage (mV) over that the loads are restored
+#define BATTMON_SHEDHOLDMS     200
+#define BATTMON_RESTOREHOLDMS  3000
+#define BATTMON_NOVOLTAGE      -1
+
+
+werror  batteryMonitor_init      ();
+werror  batteryMonitor_addLoad   (uint8_t *loadID, uint8_t priority);
+werror  batteryMonitor_update    (int pinMv, uint32_t nowMs);
+bool    batteryMonitor_isAllowed (uint8_t loadID);
+uint8_t batteryMonitor_shedLoads ();
+int     batteryMonitor_voltage   ();
+
+#endif
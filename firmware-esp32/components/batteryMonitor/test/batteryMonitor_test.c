@@ -0,0 +1,134 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   batteryMonitor_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	batteryMonitor module's tests. A simulated battery voltage curve is fed to the module (one sample every 10ms, as
+//	the A/D scheduler does), and the shedding/restoring of the loads is checked along the curve.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <batteryMonitor.h>
+#include <componentTest.h>
+
+#define SAMPLEMS 10
+
+static uint32_t nowMs       = 0;
+static uint8_t  addLight, upLight;
+static uint32_t transitions = 0;
+
+
+static int batteryCurve (uint32_t ms) {
+	//
+	// Description:
+	//	It returns the simulated battery voltage (mV) at the argument defined time
+	//
+	int noise = ((ms / SAMPLEMS) % 2) ? 250 : -250;
+
+	if (ms < 2000)  return(12600);                            // Resting battery
+	if (ms < 3500)  return(9800 + noise);                     // Electric starter cranking
+	if (ms < 12000) return(13800 + noise);                    // Engine running, alternator charging
+	if (ms < 20000) return(11900 + noise);                    // Idle with all the lights on (hysteresis band)
+	return(11300 + noise);                                    // Weak battery at idle
+}
+
+
+static void run (uint32_t untilMs) {
+	for (; nowMs < untilMs; nowMs += SAMPLEMS) {
+		uint8_t shed = batteryMonitor_shedLoads();
+		int     v    = batteryCurve(nowMs);
+
+		batteryMonitor_update((v * BATTMON_DIVDEN) / BATTMON_DIVNUM, nowMs);
+		if (batteryMonitor_shedLoads() != shed) transitions++;
+	}
+	return;
+}
+
+
+int main () {
+	int     err = 0;
+	uint8_t id;
+
+	CHECK(batteryMonitor_init() == WERRCODE_SUCCESS);
+	CHECK(batteryMonitor_addLoad(NULL, 0) == WERRCODE_ERROR_ILLEGALARG);
+	CHECK(batteryMonitor_voltage() == BATTMON_NOVOLTAGE);
+
+	//
+	// Decimating filter
+	//
+	{
+		werror ec = WERRCODE_SUCCESS;
+		for (uint8_t t=0; t<BATTMON_DECIMATION-1; t++)
+			if (batteryMonitor_update(2000 + ((t % 2) ? 100 : -100), 0) != WERRCODE_WARNING_RESNOTAV) ec = WERRCODE_ERROR_INVALIDDATA;
+		CHECK(ec == WERRCODE_SUCCESS);
+		CHECK(batteryMonitor_update(2100, 0) == WERRCODE_SUCCESS);
+		CHECK(batteryMonitor_voltage() == (2000 * BATTMON_DIVNUM) / BATTMON_DIVDEN);
+		CHECK(batteryMonitor_update(-1, 0) == WERRCODE_ERROR_ILLEGALARG);
+	}
+
+	//
+	// Loads registration (o_ADDLIGHT is the first one to be shed)
+	//
+	batteryMonitor_init();
+	CHECK(batteryMonitor_addLoad(&addLight, 0) == WERRCODE_SUCCESS);
+	CHECK(batteryMonitor_addLoad(&upLight,  1) == WERRCODE_SUCCESS);
+	for (uint8_t t=2; t<BATTMON_MAXLOADS; t++) batteryMonitor_addLoad(&id, 5);
+	CHECK(batteryMonitor_addLoad(&id, 5) == WERRCODE_ERROR_DATAOVERFLOW);
+	batteryMonitor_init();
+	batteryMonitor_addLoad(&addLight, 0);
+	batteryMonitor_addLoad(&upLight,  1);
+
+	//
+	// Simulated voltage curve
+	//
+	run(2000);
+	CHECK(batteryMonitor_shedLoads() == 0);
+	CHECK(batteryMonitor_voltage() > 12500 && batteryMonitor_voltage() < 12700);
+
+	run(2400);
+	CHECK(batteryMonitor_isAllowed(addLight) == false && batteryMonitor_isAllowed(upLight) == true);
+	run(3500);
+	CHECK(batteryMonitor_isAllowed(addLight) == false && batteryMonitor_isAllowed(upLight) == false);
+
+	run(3500 + BATTMON_RESTOREHOLDMS - 200);
+	CHECK(batteryMonitor_shedLoads() == 2);
+	run(3500 + BATTMON_RESTOREHOLDMS + 200);
+	CHECK(batteryMonitor_isAllowed(addLight) == false && batteryMonitor_isAllowed(upLight) == true);
+	run(12000);
+	CHECK(batteryMonitor_shedLoads() == 0);
+
+	transitions = 0;
+	run(20000);
+	CHECK(transitions == 0);
+
+	run(20400);
+	CHECK(batteryMonitor_isAllowed(addLight) == false && batteryMonitor_isAllowed(upLight) == true);
+	run(25000);
+	CHECK(batteryMonitor_shedLoads() == 2);
+	CHECK(batteryMonitor_isAllowed(99) == true);
+
+	return(err);
+}
@@ -0,0 +1,88 @@
+#-------------------------------------------------------------------------------------------------------------------------------
+#
+#  __  __       _             _     _ _          _____ _           _        _           _   ____            _
+# |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___ 
+# | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \
+# | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+# |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+#                                                                                                 |___/
+#
+# File:   componentTest.mk
+#
+# Author: Silvano Catinella <catinella@yahoo.com>
+#
+# Description:
+#	Build rules shared by the components' host tests. Every test Makefile sets its own variables and includes this file:
+#		MODULE      # The component under test (its sources are in the parent directory)
+#		DEPS        # The other components linked to the tests (optional)
+#	Every *_test.c and *_bench.c file in the test directory is built as an executable, linked to the module (built in MOCK
+#	mode) and to its dependencies.
+#		make        # It builds the tests
+#		make run    # It builds and runs the tests
+#
+# License:
+#	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+#
+#	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+#	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+#	version.
+#
+#	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+#	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+#
+#	You should have received a copy of the GNU General Public License along with this program. If not, see
+#		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+#
+#-------------------------------------------------------------------------------------------------------------------------------
+
+COMPDIR  := $(dir $(lastword $(MAKEFILE_LIST)))..
+
+srcs := $(wildcard *_test.c *_bench.c)
+exes := $(srcs:.c=)
+objs := $(MODULE).o $(addsuffix .o, $(DEPS))
+
+INCOPTS  ?= -I. -I../include -I$(COMPDIR)/werror/include -I$(COMPDIR)/componentTest $(DEPS:%=-I$(COMPDIR)/%/include)
+SYMBOLS  ?= -DMOCK=1
+GDB      ?= 0
+
+ifeq ($(GDB), 1)
+	CCOPTS = -O0 -g
+else
+	CCOPTS = -O3
+endif
+
+.PHONY: all run clean cleanall
+
+#-------------------------------------------------------------------------------------------------------------------------------
+#                                                    R U L E S
+#-------------------------------------------------------------------------------------------------------------------------------
+all:	$(exes)
+
+run:	all
+			@for t in $(exes); do echo "[ RUN ] $$t"; ./$$t || exit 1; done
+
+%.o:			%.c
+			@echo "[ CC ] $@"
+			@gcc -Wall $(CCOPTS) $(INCOPTS) $(SYMBOLS) -c $< -o $@
+
+%.o:			../%.c ../include/%.h
+			@echo "[ CC* ] $@"
+			@gcc -Wall $(CCOPTS) $(INCOPTS) $(SYMBOLS) -c $< -o $@
+
+define depRule
+$(1).o:			$(COMPDIR)/$(1)/$(1).c $(COMPDIR)/$(1)/include/$(1).h
+			@echo "[ CC* ] $$@"
+			@gcc -Wall $$(CCOPTS) $$(INCOPTS) $$(SYMBOLS) -c $$< -o $$@
+endef
+$(foreach d, $(DEPS), $(eval $(call depRule,$(d))))
+
+$(exes):	%:	%.o $(objs)
+			@echo "[ LD ] $@"
+			@gcc -Wall $(CCOPTS) $^ -o $@
+
+clean:
+			@echo "[CLEAN]"
+			@rm -fv *.o
+
+cleanall:		clean
+			@rm -fv $(exes)
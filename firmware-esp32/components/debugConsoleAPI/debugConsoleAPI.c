@@ -29,16 +29,25 @@
 //		<https://www.gnu.org/licenses/gpl-3.0.txt>.
 //
 ------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <debugConsoleAPI.h>
 
 #ifdef TARGET_AVR8
 #include <avr/io.h>
 
 #elifdef TARGET_ESP32
+#include <fcntl.h>
+#include <unistd.h>
 #include "driver/gpio.h"
 #endif
 
+#if defined(DBGCON_KEEPTRACK) && defined(TARGET_ESP32)
+#include <ptsMap.h>
+#include <pinToSymbol_map.h>          // Generated from mbesPinsMap.h at build time (see CMakeLists.txt)
+#endif
+
 static void _notify(const pinIdType pin, uint8_t value) {
 	//
 	// Description:
@@ -92,3 +101,70 @@ void keepTrack_setGPIO (const pinIdType pin, uint8_t value) {
 #endif
 	return;
 }
+
+
+void keepTrack_announce () {
+	//
+	// Description:
+	//	It sends the pin-symbol map to the debug-console (see ptsMap.h). The binary map is built only once.
+	//
+#if defined(DBGCON_KEEPTRACK) && defined(TARGET_ESP32)
+	static uint8_t  map[PTSMAP_MAXSIZE];
+	static uint32_t size = 0;
+	char            row[PTSMAP_ROWSIZE];
+
+	if (size == 0) size = ptsMap_encode(map, sizeof(map), ptsDb, PTS_MAXPINID);
+
+	if (size == 0)
+		// ERROR!
+		printf("ERROR! The pin-symbol map is too big (max %u bytes)\n\r", PTSMAP_MAXSIZE);
+	else
+		for (uint16_t t = 0; t < ptsMap_rows(size); t++) {
+			ptsMap_row(row, map, size, t);
+			printf("%s\n\r", row);
+		}
+#endif
+	return;
+}
+
+
+void keepTrack_poll () {
+	//
+	// Description:
+	//	It reads the data received by the console's UART without waiting, and it sends the pin-symbol map when a
+	//	PTSMAP_REQUEST row has been received. When the console does not support the non-blocking reads (e.g. some
+	//	USB-CDC/JTAG ones) the polling is disabled, so the main loop is never blocked: the map is sent at boot only.
+	//
+#if defined(DBGCON_KEEPTRACK) && defined(TARGET_ESP32)
+	static char    req[sizeof(PTSMAP_REQUEST)];
+	static uint8_t len     = 0;
+	static bool    init    = false;
+	static bool    enabled = false;
+	char           c;
+	int            flags;
+
+	if (init == false) {
+		flags   = fcntl(fileno(stdin), F_GETFL);
+		enabled = (
+			flags >= 0 && fcntl(fileno(stdin), F_SETFL, flags | O_NONBLOCK) == 0 &&
+			(fcntl(fileno(stdin), F_GETFL) & O_NONBLOCK) != 0
+		);
+		if (enabled == false)
+			// WARNING!
+			printf("WARNING! The console does not support the non-blocking reads: the map requests are ignored\n\r");
+		init = true;
+	}
+
+	while (enabled && read(fileno(stdin), &c, 1) == 1) {
+		if (c == '\n' || c == '\r') {
+			if (len == sizeof(req) - 1 && memcmp(req, PTSMAP_REQUEST, len) == 0) keepTrack_announce();
+			len = 0;
+		} else if (len < sizeof(req) - 1) {
+			req[len++] = c;
+		} else {
+			len = sizeof(req);            // Too long row: it is not a request
+		}
+	}
+#endif
+	return;
+}
@@ -23,6 +23,10 @@
 //	If you want enable/disable the monitoring without to change your code, define/remove the following symbol:
 //		DBGCON_KEEPTRACK
 //
+//	The debug-console decodes the pins by the firmware's own symbols: keepTrack_announce() sends the pin-symbol map
+//	(built from mbesPinsMap.h, see tools/debugConsole/ptsMap.h). Call it at boot, and call keepTrack_poll() in the
+//	main loop: it sends the map again when the debug-console asks for it.
+//
 // License:
 //	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
 //
@@ -54,8 +58,10 @@ typedef uint8_t pinIdType;
 #endif
 	
 
-uint8_t keepTrack_getGPIO (pinIdType pin);
-void    keepTrack_setGPIO (pinIdType pin, uint8_t value);
+uint8_t keepTrack_getGPIO  (pinIdType pin);
+void    keepTrack_setGPIO  (pinIdType pin, uint8_t value);
+void    keepTrack_announce ();
+void    keepTrack_poll     ();
 
 
 #endif
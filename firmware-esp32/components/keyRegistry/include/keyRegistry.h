@@ -0,0 +1,86 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   keyRegistry.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	This module keeps the list of the enrolled resistor-keys. Every key is identified by its signature: the two ratios
+//	between the voltages read on the key (X1, X2) and the internal references (Y1, Y2). Because they are ratios, the
+//	signature does not depend by the battery voltage.
+//
+//	The signatures are indexed by a quantized grid (the cell side is equal to the tolerance), so a lookup has just to
+//	check the 3x3 cells around the measured signature, whatever the number of enrolled keys is. The enrolment refuses
+//	the signatures too close to an already enrolled one, in this way every cell contains one key at most.
+//
+//	The list is stored in the NVS partition (in MOCK mode it is stored in the KEYREG_MOCKFILE file).
+//
+//	Symbols:
+//		KEYREG_MAXKEYS      Maximum number of enrolled keys
+//		KEYREG_RATIOSCALE   Fixed point scale used for the ratios (1.0 = KEYREG_RATIOSCALE)
+//		KEYREG_TOLERANCE    Maximum distance (on every ratio) between a measured signature and the enrolled one
+//		KEYREG_HASHSIZE     Grid hash-table size (it MUST be a power of two, greater than KEYREG_MAXKEYS)
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef __KEYREGISTRY__
+#define __KEYREGISTRY__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <werror.h>
+
+#ifndef MOCK
+#define MOCK 0
+#endif
+
+#define KEYREG_MAXKEYS      1024
+#define KEYREG_RATIOSCALE   4096
+#define KEYREG_HASHSIZE     2048
+#define KEYREG_NOKEY        0xFFFF
+
+#ifndef KEYREG_TOLERANCE
+#define KEYREG_TOLERANCE    96
+#endif
+
+#if MOCK == 1
+#define KEYREG_MOCKFILE     "/tmp/keyRegistry.bin"
+#else
+#define KEYREG_NVSNAMESPACE "keyreg"
+#define KEYREG_NVSKEY       "keys"
+#endif
+
+typedef struct {
+	uint16_t r1;
+	uint16_t r2;
+} keySignature_t;
+
+
+werror   keyRegistry_init      ();
+werror   keyRegistry_signature (keySignature_t *sig, int x1, int y1, int x2, int y2);
+werror   keyRegistry_lookup    (const keySignature_t *sig, uint16_t *keyID);
+werror   keyRegistry_enroll    (const keySignature_t *sig, uint16_t *keyID);
+werror   keyRegistry_clear     ();
+uint16_t keyRegistry_size      ();
+
+#endif
@@ -0,0 +1,448 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   keyRegistry.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Enrolled resistor-keys registry. Read the keyRegistry.h file for details
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+
+#if MOCK == 1
+#include <stdio.h>
+#include <errno.h>
+#else
+#include "nvs_flash.h"
+#include "nvs.h"
+#include "esp_err.h"
+#include <esp_log.h>
+#endif
+
+#include <stddef.h>
+#include <keyRegistry.h>
+
+#define KEYREG_CELL(v)  ((int32_t)(v) / KEYREG_TOLERANCE)
+
+static keySignature_t keysDb[KEYREG_MAXKEYS];
+static uint16_t       keysNumb = 0;
+static uint16_t       gridTbl[KEYREG_HASHSIZE];      // It contains the keysDb index, or KEYREG_NOKEY for empty slots
+static bool           initFlag = false;
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                     P R I V A T E   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+static uint16_t _keyRegistry_hash (int32_t cx, int32_t cy) {
+	//
+	// Description:
+	//	It returns the hash-table slot where the search of the argument defined grid cell has to start
+	//
+	uint32_t h = ((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u);
+	return(h & (KEYREG_HASHSIZE - 1));
+}
+
+
+static void _keyRegistry_gridAdd (uint16_t keyIndex) {
+	//
+	// Description:
+	//	It adds the argument defined key to the grid. The hash-table uses linear probing and it is never full, because
+	//	its size is greater than KEYREG_MAXKEYS
+	//
+	uint16_t slot = _keyRegistry_hash(KEYREG_CELL(keysDb[keyIndex].r1), KEYREG_CELL(keysDb[keyIndex].r2));
+
+	while (gridTbl[slot] != KEYREG_NOKEY)
+		slot = (slot + 1) & (KEYREG_HASHSIZE - 1);
+
+	gridTbl[slot] = keyIndex;
+	return;
+}
+
+
+static void _keyRegistry_gridBuild () {
+	//
+	// Description:
+	//	It rebuilds the whole grid starting from the keys list
+	//
+	for (uint16_t t=0; t<KEYREG_HASHSIZE; t++) gridTbl[t] = KEYREG_NOKEY;
+	for (uint16_t t=0; t<keysNumb; t++)        _keyRegistry_gridAdd(t);
+	return;
+}
+
+
+static uint16_t _keyRegistry_nearest (const keySignature_t *sig, uint16_t maxDist, uint16_t *dist) {
+	//
+	// Description:
+	//	It looks for the nearest key whose distance is lower than maxDist. The distance is the maximum difference
+	//	between the two ratios, like the old "abs(X - Y) < V_TOLERANCE" check. Only the cells that can contain such
+	//	keys are visited (3x3 cells when maxDist is equal to KEYREG_TOLERANCE).
+	//
+	// Returned value:
+	//	The keysDb index of the found key, or KEYREG_NOKEY
+	//
+	uint16_t found = KEYREG_NOKEY;
+	int32_t  cx0   = KEYREG_CELL(sig->r1 > maxDist ? sig->r1 - maxDist : 0);
+	int32_t  cy0   = KEYREG_CELL(sig->r2 > maxDist ? sig->r2 - maxDist : 0);
+	int32_t  cx1   = KEYREG_CELL((int32_t)sig->r1 + maxDist);
+	int32_t  cy1   = KEYREG_CELL((int32_t)sig->r2 + maxDist);
+
+	*dist = maxDist;
+
+	for (int32_t cx = cx0; cx <= cx1; cx++) {
+		for (int32_t cy = cy0; cy <= cy1; cy++) {
+			uint16_t slot = _keyRegistry_hash(cx, cy);
+
+			while (gridTbl[slot] != KEYREG_NOKEY) {
+				const keySignature_t *k = &keysDb[gridTbl[slot]];
+
+				if (KEYREG_CELL(k->r1) == cx && KEYREG_CELL(k->r2) == cy) {
+					uint16_t d1 = (k->r1 > sig->r1) ? (k->r1 - sig->r1) : (sig->r1 - k->r1);
+					uint16_t d2 = (k->r2 > sig->r2) ? (k->r2 - sig->r2) : (sig->r2 - k->r2);
+					uint16_t d  = (d1 > d2) ? d1 : d2;
+
+					if (d < *dist) {
+						*dist = d;
+						found = gridTbl[slot];
+					}
+				}
+				slot = (slot + 1) & (KEYREG_HASHSIZE - 1);
+			}
+		}
+	}
+
+	return(found);
+}
+
+
+static werror _keyRegistry_load () {
+	//
+	// Description:
+	//	It loads the enrolled keys list from the non-volatile memory. Only a list that has never been stored (no NVS
+	//	namespace/key, no mock file) is an empty one: any other failure is an error, so the caller cannot mistake a
+	//	lost list for a never enrolled one (the default key would be accepted again).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS               The list has been loaded (no key has ever been enrolled: empty list)
+	//	WERRCODE_ERROR_IOOPERFAILED    The storage cannot be read
+	//	WERRCODE_ERROR_INVALIDDATA     The stored data are corrupted
+	//
+	werror ec   = WERRCODE_SUCCESS;
+	size_t size = 0;
+
+	keysNumb = 0;
+
+#if MOCK == 1
+	FILE *fh = fopen(KEYREG_MOCKFILE, "rb");
+	if (fh != NULL) {
+		size = fread(keysDb, 1, sizeof(keysDb), fh);
+		if (ferror(fh))
+			// ERROR!
+			ec = WERRCODE_ERROR_IOOPERFAILED;
+		else if (fgetc(fh) != EOF)
+			// ERROR! Too many keys
+			ec = WERRCODE_ERROR_INVALIDDATA;
+		fclose(fh);
+
+	} else if (errno != ENOENT) {
+		// ERROR!
+		ec = WERRCODE_ERROR_IOOPERFAILED;
+	}
+#else
+	nvs_handle_t nvsH;
+	esp_err_t    espErr = nvs_open(KEYREG_NVSNAMESPACE, NVS_READONLY, &nvsH);
+
+	if (espErr == ESP_OK) {
+		size = sizeof(keysDb);
+		espErr = nvs_get_blob(nvsH, KEYREG_NVSKEY, keysDb, &size);
+		if (espErr == ESP_ERR_NVS_NOT_FOUND)
+			size = 0;
+		else if (espErr != ESP_OK) {
+			// ERROR!
+			ESP_LOGE(__FUNCTION__, "ERROR! nvs_get_blob() failed: %s", esp_err_to_name(espErr));
+			ec = WERRCODE_ERROR_IOOPERFAILED;
+		}
+		nvs_close(nvsH);
+
+	} else if (espErr != ESP_ERR_NVS_NOT_FOUND) {
+		// ERROR!
+		ESP_LOGE(__FUNCTION__, "ERROR! nvs_open() failed: %s", esp_err_to_name(espErr));
+		ec = WERRCODE_ERROR_IOOPERFAILED;
+	}
+#endif
+
+	if (wErrCode_isSuccess(ec)) {
+		if (size % sizeof(keySignature_t) != 0)
+			// ERROR!
+			ec = WERRCODE_ERROR_INVALIDDATA;
+		else
+			keysNumb = size / sizeof(keySignature_t);
+	}
+	if (wErrCode_isError(ec)) keysNumb = 0;
+
+	return(ec);
+}
+
+
+static werror _keyRegistry_save () {
+	//
+	// Description:
+	//	It writes the enrolled keys list in the non-volatile memory
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+#if MOCK == 1
+	FILE *fh = fopen(KEYREG_MOCKFILE, "wb");
+	if (fh == NULL)
+		// ERROR!
+		ec = WERRCODE_ERROR_IOOPERFAILED;
+	else {
+		if (fwrite(keysDb, sizeof(keySignature_t), keysNumb, fh) != keysNumb)
+			// ERROR!
+			ec = WERRCODE_ERROR_IOOPERFAILED;
+		fclose(fh);
+	}
+#else
+	nvs_handle_t nvsH;
+	esp_err_t    espErr;
+
+	if ((espErr = nvs_open(KEYREG_NVSNAMESPACE, NVS_READWRITE, &nvsH)) != ESP_OK) {
+		// ERROR!
+		ESP_LOGE(__FUNCTION__, "ERROR! nvs_open() failed: %s", esp_err_to_name(espErr));
+		ec = WERRCODE_ERROR_IOOPERFAILED;
+
+	} else {
+		if (keysNumb == 0)
+			espErr = nvs_erase_key(nvsH, KEYREG_NVSKEY);
+		else
+			espErr = nvs_set_blob(nvsH, KEYREG_NVSKEY, keysDb, keysNumb * sizeof(keySignature_t));
+
+		if ((espErr != ESP_OK && espErr != ESP_ERR_NVS_NOT_FOUND) || nvs_commit(nvsH) != ESP_OK) {
+			// ERROR!
+			ESP_LOGE(__FUNCTION__, "ERROR! the keys list cannot be saved: %s", esp_err_to_name(espErr));
+			ec = WERRCODE_ERROR_IOOPERFAILED;
+		}
+		nvs_close(nvsH);
+	}
+#endif
+
+	return(ec);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+werror keyRegistry_init () {
+	//
+	// Description:
+	//	Module's initialization: it loads the enrolled keys from the non-volatile memory and builds the lookup grid.
+	//	This is the first function the user has to call. When it fails, the module refuses every lookup and enrolment.
+	//	[!] The NVS partition is never erased: it stores the enrolled keys, so a truncated partition or a new NVS
+	//	format (ESP_ERR_NVS_NO_FREE_PAGES, ESP_ERR_NVS_NEW_VERSION_FOUND) is an initialization failure.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS             Module successfully initialized
+	//	WERRCODE_ERROR_INITFAILED    NVS partition initialization failed
+	//	_keyRegistry_load() error codes
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+#if MOCK == 0
+	esp_err_t espErr = nvs_flash_init();
+
+	if (espErr != ESP_OK) {
+		// ERROR!
+		ESP_LOGE(__FUNCTION__, "ERROR! nvs_flash_init() failed: %s", esp_err_to_name(espErr));
+		ec = WERRCODE_ERROR_INITFAILED;
+	}
+#endif
+
+	if (wErrCode_isSuccess(ec))
+		ec = _keyRegistry_load();
+
+	_keyRegistry_gridBuild();
+	initFlag = wErrCode_isSuccess(ec);
+
+	return(ec);
+}
+
+
+werror keyRegistry_signature (keySignature_t *sig, int x1, int y1, int x2, int y2) {
+	//
+	// Description:
+	//	It calculates the signature of a key using the voltages read on the key (x1, x2) and on the references (y1, y2)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG    NULL pointer
+	//	WERRCODE_ERROR_INVALIDDATA   Negative values or null references (eg. unplugged key)
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (sig == NULL)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+
+	else if (x1 < 0 || x2 < 0 || y1 <= 0 || y2 <= 0)
+		// ERROR!
+		ec = WERRCODE_ERROR_INVALIDDATA;
+
+	else {
+		uint32_t r1 = ((uint32_t)x1 * KEYREG_RATIOSCALE) / (uint32_t)y1;
+		uint32_t r2 = ((uint32_t)x2 * KEYREG_RATIOSCALE) / (uint32_t)y2;
+
+		sig->r1 = (r1 > UINT16_MAX) ? UINT16_MAX : r1;
+		sig->r2 = (r2 > UINT16_MAX) ? UINT16_MAX : r2;
+	}
+
+	return(ec);
+}
+
+
+werror keyRegistry_lookup (const keySignature_t *sig, uint16_t *keyID) {
+	//
+	// Description:
+	//	It looks for the enrolled key matching the argument defined signature. When more keys match, the nearest one
+	//	is returned
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS               A key has been found and its ID has been written in keyID
+	//	WERRCODE_WARNING_ITNOTFOUND    No enrolled key matches the signature
+	//	WERRCODE_ERROR_ILLEGALARG      NULL pointers are not allowed
+	//	WERRCODE_ERROR_INITFAILED      Module has not been initialized
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (sig == NULL || keyID == NULL)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+
+	else if (initFlag == false)
+		// ERROR!
+		ec = WERRCODE_ERROR_INITFAILED;
+
+	else {
+		uint16_t dist;
+
+		*keyID = _keyRegistry_nearest(sig, KEYREG_TOLERANCE, &dist);
+		if (*keyID == KEYREG_NOKEY)
+			// WARNING!
+			ec = WERRCODE_WARNING_ITNOTFOUND;
+	}
+
+	return(ec);
+}
+
+
+werror keyRegistry_enroll (const keySignature_t *sig, uint16_t *keyID) {
+	//
+	// Description:
+	//	It adds the argument defined signature to the enrolled keys, and saves the list in the non-volatile memory.
+	//	Signatures too close to an enrolled key (less than two tolerances) are refused, because the two keys could be
+	//	mistaken each other.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS               The key has been enrolled, keyID contains its ID
+	//	WERRCODE_WARNING_ITEXISTS      The key is too similar to an enrolled one (keyID contains the ID of that key)
+	//	WERRCODE_ERROR_DATAOVERFLOW    No further space for new keys
+	//	WERRCODE_ERROR_ILLEGALARG      NULL pointers are not allowed
+	//	WERRCODE_ERROR_INITFAILED      Module has not been initialized
+	//	_keyRegistry_save() error codes
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (sig == NULL || keyID == NULL)
+		// ERROR!
+		ec = WERRCODE_ERROR_ILLEGALARG;
+
+	else if (initFlag == false)
+		// ERROR!
+		ec = WERRCODE_ERROR_INITFAILED;
+
+	else if (keysNumb == KEYREG_MAXKEYS)
+		// ERROR!
+		ec = WERRCODE_ERROR_DATAOVERFLOW;
+
+	else {
+		uint16_t dist;
+
+		*keyID = _keyRegistry_nearest(sig, 2 * KEYREG_TOLERANCE, &dist);
+		if (*keyID != KEYREG_NOKEY)
+			// WARNING!
+			ec = WERRCODE_WARNING_ITEXISTS;
+
+		else {
+			keysDb[keysNumb] = *sig;
+			*keyID = keysNumb;
+			keysNumb++;
+			_keyRegistry_gridAdd(*keyID);
+
+			if (wErrCode_isError(ec = _keyRegistry_save())) {
+				// ERROR!
+				// The RAM copy has to reflect the stored one
+				keysNumb--;
+				_keyRegistry_gridBuild();
+				*keyID = KEYREG_NOKEY;
+			}
+		}
+	}
+
+	return(ec);
+}
+
+
+werror keyRegistry_clear () {
+	//
+	// Description:
+	//	It removes all enrolled keys
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_INITFAILED      Module has not been initialized
+	//	_keyRegistry_save() error codes
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	if (initFlag == false)
+		// ERROR!
+		ec = WERRCODE_ERROR_INITFAILED;
+	else {
+		keysNumb = 0;
+		_keyRegistry_gridBuild();
+		ec = _keyRegistry_save();
+	}
+
+	return(ec);
+}
+
+
+uint16_t keyRegistry_size () {
+	//
+	// Description:
+	//	It returns the number of the enrolled keys
+	//
+	return(keysNumb);
+}
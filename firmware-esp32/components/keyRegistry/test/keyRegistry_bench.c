@@ -0,0 +1,121 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   keyRegistry_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	It measures the keyRegistry_lookup() speed with 1000 enrolled keys, and compares it with a simple linear scan
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <keyRegistry.h>
+
+#define BENCH_KEYS     1000
+#define BENCH_LOOKUPS  1000000
+
+static keySignature_t keys[BENCH_KEYS];
+
+
+static double nowSec () {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+
+static uint16_t linearLookup (const keySignature_t *sig) {
+	//
+	// Description:
+	//	Reference implementation: every enrolled key is checked
+	//
+	uint16_t found = KEYREG_NOKEY, best = KEYREG_TOLERANCE;
+	for (uint16_t t=0; t<BENCH_KEYS; t++) {
+		uint16_t d1 = abs(keys[t].r1 - sig->r1);
+		uint16_t d2 = abs(keys[t].r2 - sig->r2);
+		uint16_t d  = d1 > d2 ? d1 : d2;
+		if (d < best) {
+			best  = d;
+			found = t;
+		}
+	}
+	return(found);
+}
+
+
+int main () {
+	keySignature_t  *probes = malloc(BENCH_LOOKUPS * sizeof(keySignature_t));
+	uint16_t        id;
+	uint32_t        hits = 0, mismatch = 0;
+	double          t0, tGrid, tLinear;
+
+	remove(KEYREG_MOCKFILE);
+	keyRegistry_init();
+	srand(1234);
+
+	// Registry filling (random keys, the too similar ones are refused by the registry itself)
+	for (uint16_t t=0; t<BENCH_KEYS; ) {
+		keySignature_t sig = { rand() % KEYREG_RATIOSCALE * 2, rand() % KEYREG_RATIOSCALE * 2 };
+		if (keyRegistry_enroll(&sig, &id) == WERRCODE_SUCCESS) {
+			keys[t] = sig;
+			t++;
+		}
+	}
+
+	// Half probes are near an enrolled key, the others are random ones
+	for (uint32_t t=0; t<BENCH_LOOKUPS; t++) {
+		if (t % 2) {
+			probes[t] = keys[rand() % BENCH_KEYS];
+			probes[t].r1 += rand() % KEYREG_TOLERANCE / 2;
+			probes[t].r2 -= rand() % KEYREG_TOLERANCE / 2;
+		} else {
+			probes[t].r1 = rand() % KEYREG_RATIOSCALE * 2;
+			probes[t].r2 = rand() % KEYREG_RATIOSCALE * 2;
+		}
+	}
+
+	t0 = nowSec();
+	for (uint32_t t=0; t<BENCH_LOOKUPS; t++)
+		if (keyRegistry_lookup(&probes[t], &id) == WERRCODE_SUCCESS) hits++;
+	tGrid = nowSec() - t0;
+
+	t0 = nowSec();
+	for (uint32_t t=0; t<BENCH_LOOKUPS; t++) {
+		uint16_t lid = linearLookup(&probes[t]);
+		keyRegistry_lookup(&probes[t], &id);
+		if (lid != (id == KEYREG_NOKEY ? KEYREG_NOKEY : id)) mismatch++;
+	}
+	tLinear = nowSec() - t0 - tGrid;
+
+	printf("Keys: %d, lookups: %d, hits: %lu, mismatches: %lu\n", BENCH_KEYS, BENCH_LOOKUPS,
+		(unsigned long)hits, (unsigned long)mismatch);
+	printf("Grid lookup:   %8.1f ns/lookup\n", tGrid   * 1e9 / BENCH_LOOKUPS);
+	printf("Linear lookup: %8.1f ns/lookup\n", tLinear * 1e9 / BENCH_LOOKUPS);
+
+	free(probes);
+	remove(KEYREG_MOCKFILE);
+	return(mismatch == 0 ? 0 : 1);
+}
@@ -0,0 +1,110 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   keyRegistry_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	keyRegistry module's unit tests. They run on the host PC (MOCK mode)
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <keyRegistry.h>
+#include <componentTest.h>
+
+int main () {
+	int            err = 0;
+	uint16_t       id1, id2, id;
+	keySignature_t sig, a, b;
+	FILE           *fh;
+
+	remove(KEYREG_MOCKFILE);
+	CHECK(keyRegistry_lookup(&sig, &id) == WERRCODE_ERROR_INITFAILED);
+	CHECK(keyRegistry_init() == WERRCODE_SUCCESS);
+	CHECK(keyRegistry_size() == 0);
+
+	// Signature calculation
+	CHECK(keyRegistry_signature(&sig, 2000, 4000, 1000, 4000) == WERRCODE_SUCCESS);
+	CHECK(sig.r1 == KEYREG_RATIOSCALE / 2 && sig.r2 == KEYREG_RATIOSCALE / 4);
+	CHECK(keyRegistry_signature(&sig, 2000, 0, 1000, 4000) == WERRCODE_ERROR_INVALIDDATA);
+	CHECK(keyRegistry_signature(NULL, 2000, 4000, 1000, 4000) == WERRCODE_ERROR_ILLEGALARG);
+
+	// Enrolment
+	a.r1 = 2048; a.r2 = 1024;
+	b.r1 = 3000; b.r2 = 1024;
+	CHECK(keyRegistry_lookup(&a, &id) == WERRCODE_WARNING_ITNOTFOUND);
+	CHECK(keyRegistry_enroll(&a, &id1) == WERRCODE_SUCCESS && id1 == 0);
+	CHECK(keyRegistry_enroll(&b, &id2) == WERRCODE_SUCCESS && id2 == 1);
+	CHECK(keyRegistry_size() == 2);
+
+	// Too similar keys are refused
+	sig.r1 = a.r1 + KEYREG_TOLERANCE; sig.r2 = a.r2 - 10;
+	CHECK(keyRegistry_enroll(&sig, &id) == WERRCODE_WARNING_ITEXISTS && id == id1);
+	CHECK(keyRegistry_size() == 2);
+
+	// Lookup inside and outside the tolerance
+	sig.r1 = a.r1 + KEYREG_TOLERANCE - 1; sig.r2 = a.r2 - KEYREG_TOLERANCE + 1;
+	CHECK(keyRegistry_lookup(&sig, &id) == WERRCODE_SUCCESS && id == id1);
+	sig.r1 = a.r1 + KEYREG_TOLERANCE; sig.r2 = a.r2;
+	CHECK(keyRegistry_lookup(&sig, &id) == WERRCODE_WARNING_ITNOTFOUND);
+	sig.r1 = b.r1 - 5; sig.r2 = b.r2 + 7;
+	CHECK(keyRegistry_lookup(&sig, &id) == WERRCODE_SUCCESS && id == id2);
+
+	// Keys near the origin (no negative cells)
+	sig.r1 = 5; sig.r2 = 5;
+	CHECK(keyRegistry_enroll(&sig, &id) == WERRCODE_SUCCESS);
+	sig.r1 = 0; sig.r2 = 0;
+	CHECK(keyRegistry_lookup(&sig, &id) == WERRCODE_SUCCESS && id == 2);
+
+	// Persistence
+	CHECK(keyRegistry_init() == WERRCODE_SUCCESS);
+	CHECK(keyRegistry_size() == 3);
+	CHECK(keyRegistry_lookup(&a, &id) == WERRCODE_SUCCESS && id == id1);
+
+	// Full registry
+	CHECK(keyRegistry_clear() == WERRCODE_SUCCESS && keyRegistry_size() == 0);
+	for (uint16_t t=0; t<KEYREG_MAXKEYS; t++) {
+		sig.r1 = (t % 32) * 3 * KEYREG_TOLERANCE;
+		sig.r2 = (t / 32) * 3 * KEYREG_TOLERANCE;
+		if (keyRegistry_enroll(&sig, &id) != WERRCODE_SUCCESS) break;
+	}
+	CHECK(keyRegistry_size() == KEYREG_MAXKEYS);
+	sig.r1 = 0xFFFF; sig.r2 = 0xFFFF;
+	CHECK(keyRegistry_enroll(&sig, &id) == WERRCODE_ERROR_DATAOVERFLOW);
+	sig.r1 = 17 * 3 * KEYREG_TOLERANCE + 3; sig.r2 = 9 * 3 * KEYREG_TOLERANCE - 3;
+	CHECK(keyRegistry_lookup(&sig, &id) == WERRCODE_SUCCESS && id == 9 * 32 + 17);
+
+	// A corrupted list is not an empty one: the module refuses the lookups (no fallback to the default key)
+	if ((fh = fopen(KEYREG_MOCKFILE, "ab")) != NULL) {
+		fputc(0, fh);
+		fclose(fh);
+	}
+	CHECK(keyRegistry_init() == WERRCODE_ERROR_INVALIDDATA);
+	CHECK(keyRegistry_lookup(&a, &id) == WERRCODE_ERROR_INITFAILED);
+	CHECK(keyRegistry_enroll(&a, &id) == WERRCODE_ERROR_INITFAILED);
+
+	remove(KEYREG_MOCKFILE);
+	return(err);
+}
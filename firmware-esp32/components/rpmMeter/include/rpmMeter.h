@@ -0,0 +1,80 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   rpmMeter.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	This module measures the engine speed counting the ignition pulses by the PCNT peripheral, so no CPU time is spent
+//	for every pulse. A periodic timer reads the counter every RPM_WINDOWMS, and the RPM value is computed on the last
+//	RPM_WINDOWS windows. The engine state is derived from the RPM value:
+//
+//		RPM_STOPPED   --(rpm >= RPM_CRANKMIN)-->                       RPM_CRANKING
+//		RPM_CRANKING  --(rpm >= RPM_RUNMIN for RPM_RUNWINDOWS)-->      RPM_RUNNING
+//		RPM_CRANKING  --(rpm <  RPM_CRANKMIN for RPM_STALLWINDOWS)-->  RPM_STOPPED   (starting failed)
+//		RPM_RUNNING   --(rpm <  RPM_STALLRPM for RPM_STALLWINDOWS)-->  RPM_STALLED
+//		RPM_STALLED   --(rpm >= RPM_CRANKMIN)-->                       RPM_CRANKING
+//
+//	In MOCK mode there is no counter: the pulses are passed to rpmMeter_window() by the caller (host tests).
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef __RPMMETER__
+#define __RPMMETER__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <werror.h>
+
+#ifndef MOCK
+#define MOCK 0
+#endif
+
+#define RPM_WINDOWMS        100
+#define RPM_WINDOWS         5         // The RPM value is computed on the last RPM_WINDOWS windows
+#define RPM_PULSESPERREV    1         // Ignition pulses for every crankshaft revolution
+#define RPM_CRANKMIN        200       // Minimum speed of the electric starter
+#define RPM_RUNMIN          1000      // Minimum speed of the running engine (idle)
+#define RPM_STALLRPM        400
+#define RPM_RUNWINDOWS      3
+#define RPM_STALLWINDOWS    3
+#define RPM_PCNTLIMIT       30000
+#define RPM_GLITCHNS        1000      // Shorter pulses are ignored
+
+typedef enum {
+	RPM_STOPPED,
+	RPM_CRANKING,
+	RPM_RUNNING,
+	RPM_STALLED
+} rpmState_t;
+
+
+werror     rpmMeter_init   (int gpio);
+void       rpmMeter_window (uint32_t pulses);
+uint16_t   rpmMeter_rpm    ();
+rpmState_t rpmMeter_state  ();
+#if MOCK == 0
+werror     rpmMeter_start  ();
+#endif
+
+#endif
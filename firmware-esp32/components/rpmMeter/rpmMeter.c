@@ -0,0 +1,233 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   rpmMeter.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Engine speed measurement by the PCNT peripheral. Look at the header file for the details.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+
+#if MOCK == 0
+#include "driver/pulse_cnt.h"
+#include "esp_timer.h"
+#include "esp_err.h"
+#include <esp_log.h>
+#endif
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <rpmMeter.h>
+
+static uint16_t            counts[RPM_WINDOWS];      // Pulses counted in the last windows
+static uint8_t             countsIndx = 0;
+static uint32_t            countsSum  = 0;
+static uint8_t             runWindows = 0;
+static uint8_t             lowWindows = 0;
+static _Atomic uint16_t    rpm        = 0;
+static _Atomic rpmState_t  state      = RPM_STOPPED;
+
+#if MOCK == 0
+static pcnt_unit_handle_t  pcntUnit   = NULL;
+static int                 lastCount  = 0;
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                     P R I V A T E   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+#if MOCK == 0
+static void _rpmMeter_timerCB (void *arg) {
+	//
+	// Description:
+	//	Window's timer callback: it reads the pulses counted since the previous call. When the counter reaches
+	//	RPM_PCNTLIMIT it restarts from zero, so the difference is computed modulo RPM_PCNTLIMIT.
+	//
+	int count = 0;
+
+	if (pcnt_unit_get_count(pcntUnit, &count) == ESP_OK) {
+		rpmMeter_window((uint32_t)((count - lastCount + RPM_PCNTLIMIT) % RPM_PCNTLIMIT));
+		lastCount = count;
+	}
+	return;
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+werror rpmMeter_init (int gpio) {
+	//
+	// Description:
+	//	Module's initialization. It configures the PCNT unit to count the rising edges on the argument defined GPIO (the
+	//	argument is ignored in MOCK mode).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_INITFAILED    PCNT unit configuration failed
+	//
+	werror ec = WERRCODE_SUCCESS;
+
+	for (uint8_t t=0; t<RPM_WINDOWS; t++) counts[t] = 0;
+	countsIndx = 0;
+	countsSum  = 0;
+	runWindows = 0;
+	lowWindows = 0;
+	atomic_store(&rpm,   0);
+	atomic_store(&state, RPM_STOPPED);
+
+#if MOCK == 0
+	if (pcntUnit == NULL) {
+		pcnt_unit_config_t          unitConfig   = { .low_limit = -1, .high_limit = RPM_PCNTLIMIT };
+		pcnt_chan_config_t          chanConfig   = { .edge_gpio_num = gpio, .level_gpio_num = -1 };
+		pcnt_glitch_filter_config_t filterConfig = { .max_glitch_ns = RPM_GLITCHNS };
+		pcnt_channel_handle_t       pcntChan     = NULL;
+
+		if (
+			pcnt_new_unit(&unitConfig, &pcntUnit)                    != ESP_OK ||
+			pcnt_unit_set_glitch_filter(pcntUnit, &filterConfig)     != ESP_OK ||
+			pcnt_new_channel(pcntUnit, &chanConfig, &pcntChan)       != ESP_OK ||
+			pcnt_channel_set_edge_action(
+				pcntChan, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD
+			)                                                        != ESP_OK ||
+			pcnt_unit_enable(pcntUnit)                               != ESP_OK ||
+			pcnt_unit_clear_count(pcntUnit)                          != ESP_OK ||
+			pcnt_unit_start(pcntUnit)                                != ESP_OK
+		) {
+			// ERROR!
+			ESP_LOGE(__FUNCTION__, "ERROR! PCNT unit configuration failed");
+			ec = WERRCODE_ERROR_INITFAILED;
+		}
+		lastCount = 0;
+	}
+#endif
+
+	return(ec);
+}
+
+
+void rpmMeter_window (uint32_t pulses) {
+	//
+	// Description:
+	//	It processes the pulses counted in a RPM_WINDOWMS window: the RPM value and the engine state are updated.
+	//	On the target it is called by the module's timer, in MOCK mode it is called by the pulse source.
+	//
+	uint16_t   r;
+	rpmState_t st = atomic_load(&state);
+
+	if (pulses > UINT16_MAX) pulses = UINT16_MAX;
+
+	countsSum -= counts[countsIndx];
+	counts[countsIndx] = (uint16_t)pulses;
+	countsSum += pulses;
+	countsIndx = (countsIndx + 1) % RPM_WINDOWS;
+
+	r = (uint16_t)((countsSum * 60000) / (RPM_WINDOWS * RPM_WINDOWMS * RPM_PULSESPERREV));
+
+	switch (st) {
+		case RPM_STOPPED:
+		case RPM_STALLED: {
+			if (r >= RPM_CRANKMIN) {
+				st         = RPM_CRANKING;
+				runWindows = 0;
+				lowWindows = 0;
+			}
+		} break;
+
+		case RPM_CRANKING: {
+			runWindows = (r >= RPM_RUNMIN)   ? runWindows + 1 : 0;
+			lowWindows = (r <  RPM_CRANKMIN) ? lowWindows + 1 : 0;
+
+			if (runWindows >= RPM_RUNWINDOWS) {
+				st         = RPM_RUNNING;
+				lowWindows = 0;
+			} else if (lowWindows >= RPM_STALLWINDOWS)
+				// The engine has not started
+				st = RPM_STOPPED;
+		} break;
+
+		case RPM_RUNNING: {
+			lowWindows = (r < RPM_STALLRPM) ? lowWindows + 1 : 0;
+			if (lowWindows >= RPM_STALLWINDOWS)
+				st = RPM_STALLED;
+		} break;
+	}
+
+	atomic_store(&rpm,   r);
+	atomic_store(&state, st);
+	return;
+}
+
+
+uint16_t rpmMeter_rpm () {
+	//
+	// Description:
+	//	It returns the last computed engine speed (revolutions per minute)
+	//
+	return(atomic_load(&rpm));
+}
+
+
+rpmState_t rpmMeter_state () {
+	//
+	// Description:
+	//	It returns the current engine state
+	//
+	return(atomic_load(&state));
+}
+
+
+#if MOCK == 0
+werror rpmMeter_start () {
+	//
+	// Description:
+	//	It starts the window's periodic timer
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_INITFAILED    PCNT unit not configured or timer creation failed
+	//
+	werror                  ec = WERRCODE_SUCCESS;
+	esp_timer_handle_t      timerHandle;
+	esp_timer_create_args_t timerArgs = {
+		.callback              = _rpmMeter_timerCB,
+		.arg                   = NULL,
+		.dispatch_method       = ESP_TIMER_TASK,
+		.name                  = "rpmMeter-proc",
+		.skip_unhandled_events = true
+	};
+
+	if (
+		pcntUnit == NULL                                                 ||
+		esp_timer_create(&timerArgs, &timerHandle)              != ESP_OK ||
+		esp_timer_start_periodic(timerHandle, RPM_WINDOWMS * 1000) != ESP_OK
+	) {
+		// ERROR!
+		ESP_LOGE(__FUNCTION__, "ERROR! I cannot start the RPM window's timer");
+		ec = WERRCODE_ERROR_INITFAILED;
+	}
+
+	return(ec);
+}
+#endif
@@ -0,0 +1,134 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   rpmMeter_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	rpmMeter module's tests. A mock pulse source converts simulated engine speed profiles (cranking, starting, idle,
+//	stall) to the pulses counted in every RPM_WINDOWMS window, and the engine state transitions are checked.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <rpmMeter.h>
+#include <componentTest.h>
+
+#define NOTREACHED 0xFFFFFFFF
+
+static uint32_t nowMs      = 0;
+static uint32_t fracPulses = 0;        // Pulses fraction (1/60000 units) not yet delivered
+
+
+static void pulseSource (uint16_t engineRpm, uint32_t durationMs) {
+	//
+	// Description:
+	//	Mock pulse source: it delivers to the module the ignition pulses generated by an engine running at the argument
+	//	defined speed, one window at a time
+	//
+	for (uint32_t end = nowMs + durationMs; nowMs < end; nowMs += RPM_WINDOWMS) {
+		fracPulses += (uint32_t)engineRpm * RPM_PULSESPERREV * RPM_WINDOWMS;
+		rpmMeter_window(fracPulses / 60000);
+		fracPulses %= 60000;
+	}
+	return;
+}
+
+
+static uint32_t waitFor (rpmState_t st, uint16_t engineRpm, uint32_t maxMs) {
+	//
+	// Description:
+	//	It runs the engine at the argument defined speed until the meter reaches the argument defined state, and it
+	//	returns the elapsed time (ms), or NOTREACHED
+	//
+	for (uint32_t elapsed = 0; elapsed <= maxMs; elapsed += RPM_WINDOWMS) {
+		if (rpmMeter_state() == st) return(elapsed);
+		pulseSource(engineRpm, RPM_WINDOWMS);
+	}
+	return(NOTREACHED);
+}
+
+
+static bool keepsState (rpmState_t st, uint16_t engineRpm, uint32_t durationMs) {
+	//
+	// Description:
+	//	It returns true if the meter keeps the argument defined state for all the time
+	//
+	for (uint32_t elapsed = 0; elapsed < durationMs; elapsed += RPM_WINDOWMS) {
+		pulseSource(engineRpm, RPM_WINDOWMS);
+		if (rpmMeter_state() != st) return(false);
+	}
+	return(true);
+}
+
+
+int main () {
+	int      err = 0;
+	uint32_t ms;
+
+	CHECK(rpmMeter_init(0) == WERRCODE_SUCCESS);
+	CHECK(keepsState(RPM_STOPPED, 0, 2000));
+
+	//
+	// Electric start: cranking, then the engine fires
+	//
+	ms = waitFor(RPM_CRANKING, 300, 1000);
+	printf("       cranking detected in %lums\n", (unsigned long)ms);
+	CHECK(ms != NOTREACHED && ms <= 500);
+	CHECK(keepsState(RPM_CRANKING, 300, 1500));
+
+	ms = waitFor(RPM_RUNNING, 1300, 2000);
+	printf("       start detected in %lums\n", (unsigned long)ms);
+	CHECK(ms != NOTREACHED && ms <= 1000);
+	CHECK(rpmMeter_rpm() >= 1200 && rpmMeter_rpm() <= 1400);
+
+	//
+	// Running: a short dip does not mean a stall
+	//
+	CHECK(keepsState(RPM_RUNNING, 1100, 5000));
+	pulseSource(300, RPM_WINDOWMS);
+	CHECK(keepsState(RPM_RUNNING, 1100, 2000));
+
+	//
+	// Stall
+	//
+	ms = waitFor(RPM_STALLED, 0, 2000);
+	printf("       stall detected in %lums\n", (unsigned long)ms);
+	CHECK(ms != NOTREACHED && ms <= 1000);
+	CHECK(keepsState(RPM_STALLED, 0, 2000));
+
+	//
+	// Failed start: the starter is released before the engine fires
+	//
+	CHECK(waitFor(RPM_CRANKING, 300, 1000) != NOTREACHED);
+	ms = waitFor(RPM_STOPPED, 0, 2000);
+	printf("       failed start detected in %lums\n", (unsigned long)ms);
+	CHECK(ms != NOTREACHED && ms <= 1000);
+
+	//
+	// Push start (no cranking phase)
+	//
+	CHECK(waitFor(RPM_RUNNING, 1500, 2000) != NOTREACHED);
+
+	return(err);
+}
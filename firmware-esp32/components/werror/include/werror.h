@@ -62,6 +62,7 @@ typedef enum {
 	WERRCODE_WARNING_EMPTYLIST  = 67,
 	WERRCODE_WARNING_ITNOTFOUND = 69,
 	WERRCODE_WARNING_RESNOTAV   = 71,
+	WERRCODE_WARNING_ITEXISTS   = 73,
 	
 	//
 	// ERRORS
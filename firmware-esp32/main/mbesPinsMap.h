@@ -22,6 +22,10 @@
 //		| i_VREF1       |  internal link   | first voltage reference                             |
 //		| i_VREF2       |                  | second  "         "                                 |
 //		+---------------+------------------+-----------------------------------------------------+
+//		| i_VBATT       |  internal link   | battery voltage (through a 100K/22K divider)        |
+//		+---------------+------------------+-----------------------------------------------------+
+//		| i_RPM         | from CDI         | ignition pulses (one for every revolution)          |
+//		+---------------+------------------+-----------------------------------------------------+
 //		| i_NEUTRAL     | from gearbox     | it is 0 when the gear is in neutral position        |
 //		+---------------+------------------+-----------------------------------------------------+
 //		| i_DECOMPRESS  | from decompress. | it is 0 when decompressor has been pushes           |
@@ -83,7 +87,7 @@
 #define i_VX2            ADC_CHANNEL_1
 #define i_VY1            ADC_CHANNEL_2
 #define i_VY2            ADC_CHANNEL_3
-// ==== available ====   GPIO5/ADC1_CH4
+#define i_VBATT          ADC_CHANNEL_4
 // ==== available ====   GPIO6/ADC1_CH5
 // ==== available ====   GPIO7/ADC1_CH6
 #define i_LEFTARROW      GPIO_NUM_8
@@ -105,7 +109,7 @@
 #define o_ADDLIGHT       GPIO_NUM_34
 #define i_DOWNLIGHT      GPIO_NUM_35
 #define i_UPLIGHT        GPIO_NUM_36
-// ==== available ====   GPIO_NUM_37   Many problems met to use it as output, in the ESP32 it was just an input pin
+#define i_RPM            GPIO_NUM_37   // Many problems met to use it as output, in the ESP32 it was just an input pin
 #define o_DOWNLIGHT      GPIO_NUM_38
 #define o_RIGHTARROW     GPIO_NUM_39
 #define o_STARTENGINE    GPIO_NUM_40
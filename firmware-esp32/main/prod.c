@@ -15,9 +15,10 @@
 //	This file contains all software needed by the ESP32 to manage your motorbike's services (eg. start, stop, lights...)
 //
 //	Configurable parameters:
-//		V_TOLERANCE  <n> // Tollerance in key authentication
+//		V_TOLERANCE  <n> // Tollerance in key authentication (millivolts)
 //		DEBUG        <n> // Debug level (0 = no-messages)
 //		NOAUTH           // Define this symbol to skip the key authentication step
+//		KEYSETTING   <n> // Set to 1 to get a firmware that enrols the plugged keys
 //
 // License:
 //	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
@@ -38,10 +39,10 @@
 #include "esp_timer.h"
 #include "driver/gpio.h"
 #include "hal/adc_types.h"
-#include "esp_adc/adc_oneshot.h"
 
 // Higher level libs
 #include <stdio.h>
+#include <stdlib.h>
 #include "esp_log.h"
 #include "esp_err.h"
 #include <freertos/FreeRTOS.h>
@@ -52,7 +53,11 @@
 #include <mbesPinsMap.h>
 #include <iInputInterface.h>
 #include <debugConsoleAPI.h>
-#include <ravgFilter.h>
+#include <keyRegistry.h>
+#include <adcCalib.h>
+#include <adcScheduler.h>
+#include <batteryMonitor.h>
+#include <rpmMeter.h>
 
 
 #define OUTPUTPINS_LIST { \
@@ -69,13 +74,14 @@
 }
 
 #define BLINK_PERIOD pdMS_TO_TICKS(200)
+#define RKEY_SAMPLINGMS 10           // Resistor key's channels sampling period (ms)
 
 //
 // Configurable parameters
 //
 
 #ifndef V_TOLERANCE
-#define V_TOLERANCE 100
+#define V_TOLERANCE 32
 #endif
 
 #ifndef DEBUG
@@ -94,6 +100,25 @@
 #define KEYSETTING 0
 #endif
 
+#ifndef KEYSETTING_STABLECYCLES
+#define KEYSETTING_STABLECYCLES 20   // Number of stable readings (100ms each) required to enrol a key
+#endif
+
+#ifndef BATTMONITOR
+#define BATTMONITOR 0
+#endif
+
+#ifndef RPMSENSOR
+#define RPMSENSOR 0
+#endif
+
+#if BATTMONITOR == 1
+#define VBATT_SAMPLINGMS 25          // Battery channel sampling period (ms): a voltage value every 200ms (BATTMON_DECIMATION)
+#define LOAD_ALLOWED(id) batteryMonitor_isAllowed(id)
+#else
+#define LOAD_ALLOWED(id) true
+#endif
+
 
 //
 // Custom datatypes
@@ -150,16 +175,85 @@ void tickerCB(TimerHandle_t xTimer) {
 	blinker(BLINKER_TICK);
 }
 
-/*
-uint16_t normalizz (uint16_t raw) {
+#if BATTMONITOR == 1
+void vbattCB (uint8_t chID, int mv, uint32_t nowMs) {
+	//
+	// A/D scheduler's callback: every new battery sample is passed to the monitor with its sampling time, so the
+	// decimation and the hold times do not depend by the main loop's delay
+	//
+	batteryMonitor_update(mv, nowMs);
+}
+#endif
+
+void keyEnrolment (int X1, int Y1, int X2, int Y2) {
 	//
 	// Description:
-	//	It convert the read-from-ADC raw data in millivolts. This function is useful when you are setting the key and
-	//	for debug
+	//	Key setting mode: the plugged key is enrolled when its signature has been stable for KEYSETTING_STABLECYCLES
+	//	readings. Already enrolled keys are just reported.
 	//
-	return((raw * DEFAULT_VREF) / 8191 * 2.4);
+	static keySignature_t enrolSig;
+	static uint8_t        stableCounter = 0;
+	keySignature_t        keySig;
+	uint16_t              keyID;
+	werror                ec;
+
+	ESP_LOGI("MAIN", "Current values: (%d/%d) (%d/%d) mV", X1, Y1, X2, Y2);
+
+	if (wErrCode_isError(keyRegistry_signature(&keySig, X1, Y1, X2, Y2))) {
+		// Key unplugged
+		stableCounter = 0;
+
+	} else if (keyRegistry_lookup(&keySig, &keyID) == WERRCODE_SUCCESS) {
+		ESP_LOGI("MAIN", "This key has already been enrolled (key-%d)", keyID);
+		stableCounter = 0;
+
+	} else if (
+		stableCounter == 0 ||
+		abs(keySig.r1 - enrolSig.r1) >= KEYREG_TOLERANCE / 2 ||
+		abs(keySig.r2 - enrolSig.r2) >= KEYREG_TOLERANCE / 2
+	) {
+		// New key or not yet stable values
+		enrolSig      = keySig;
+		stableCounter = 1;
+
+	} else if (++stableCounter == KEYSETTING_STABLECYCLES) {
+		ec = keyRegistry_enroll(&enrolSig, &keyID);
+		if (ec == WERRCODE_SUCCESS)
+			ESP_LOGI("MAIN", "[ OK ] key-%d has been enrolled (%d/%d)", keyID, enrolSig.r1, enrolSig.r2);
+		else if (ec == WERRCODE_WARNING_ITEXISTS)
+			// WARNING!
+			ESP_LOGW("MAIN", "WARNING! the key is too similar to the key-%d, it cannot be enrolled", keyID);
+		else
+			// ERROR!
+			ESP_LOGE("MAIN", "ERROR! key enrolment failed (%d)", ec);
+
+		stableCounter = 0;
+	}
+
+	return;
 }
-*/
+
+bool keyCheck (int X1, int Y1, int X2, int Y2, uint16_t *keyID) {
+	//
+	// Description:
+	//	It returns true if the plugged key is an enrolled one. When no key has ever been enrolled, the default key (the
+	//	one whose values are equal to the references) is accepted. It is never called when the enrolled keys cannot be
+	//	loaded (HW_FAILURE state)
+	//
+	bool           accepted = false;
+	keySignature_t keySig;
+
+	*keyID = KEYREG_NOKEY;
+
+	if (keyRegistry_size() == 0)
+		accepted = (abs(X1 - Y1) < V_TOLERANCE && abs(X2 - Y2) < V_TOLERANCE);
+
+	else if (wErrCode_isSuccess(keyRegistry_signature(&keySig, X1, Y1, X2, Y2)))
+		accepted = (keyRegistry_lookup(&keySig, keyID) == WERRCODE_SUCCESS);
+
+	return(accepted);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 //                                                      M A I N
 //------------------------------------------------------------------------------------------------------------------------------
@@ -195,8 +289,13 @@ int app_main(void) {
 	unsigned int  pkCounter = 0;
 
 	// --- Resistive key controls ---
-	adc_oneshot_unit_handle_t adc_handle;
-	ravg_t  ravg_rawX1, ravg_rawX2, ravg_rawY1, ravg_rawY2;
+	uint8_t       adcX1, adcX2, adcY1, adcY2;                                                     // Scheduled A/D channels
+
+	// --- Battery monitoring ---
+#if BATTMONITOR == 1
+	uint8_t       adcVBatt, addLightLoad, upLightLoad;
+	uint8_t       shedLoads = 0;
+#endif
 
 #if DEBUG > 0
 	pkCounter = 10;
@@ -205,46 +304,74 @@ int app_main(void) {
 #endif
 	
 	//
-	// Running Averrage filters initialization...
+	// Enrolled keys loading...
 	//
-	ravg_init(&ravg_rawX1);
-	ravg_init(&ravg_rawX2);
-	ravg_init(&ravg_rawY1);
-	ravg_init(&ravg_rawY2);
+	// [!] A list that cannot be loaded is not an empty one: the default key must not be accepted, the authentication
+	//     is refused
+	if (wErrCode_isError(keyRegistry_init())) {
+		// ERROR!
+		ESP_LOGE("MAIN", "ERROR! The enrolled keys cannot be loaded");
+#if NOAUTH == 0
+		FSM = HW_FAILURE;
+#endif
+	} else
+		ESP_LOGI("MAIN", "%d enrolled keys", keyRegistry_size());
 
 
 	//
-	// A/D converter configuration
+	// A/D converter configuration: the key's channels are sampled by the scheduler, with the highest priority
 	//
-	{
-		adc_oneshot_chan_cfg_t config = {
-			.bitwidth = ADC_BITWIDTH_DEFAULT,
-			.atten    = ADC_ATTEN_DB_12
-		};
-		adc_oneshot_unit_init_cfg_t init_config1 = {
-			.unit_id  = ADC_UNIT_1,               // ADC unit selection
-			.clk_src  = ADC_DIGI_CLK_SRC_DEFAULT, // Clock's source
-			.ulp_mode = ADC_ULP_MODE_DISABLE     // Ultra Low Power FSM coprocessor
-		};
+	if (wErrCode_isError(adcSched_init(NULL))) {
+		ESP_LOGE("MAIN", "A/D converter initialization failed");
+		FSM = HW_FAILURE;
 
-		// A/D converter initialization
-		if (adc_oneshot_new_unit(&init_config1, &adc_handle) != ESP_OK) {
-			ESP_LOGE("MAIN", "A/D converter initialization failed");
-			FSM = HW_FAILURE;
-	
-		// Channel configuration
-		} else if (
-			adc_oneshot_config_channel(adc_handle, i_VX1, &config) != ESP_OK ||
-			adc_oneshot_config_channel(adc_handle, i_VX2, &config) != ESP_OK ||
-			adc_oneshot_config_channel(adc_handle, i_VY1, &config) != ESP_OK ||
-			adc_oneshot_config_channel(adc_handle, i_VY2, &config) != ESP_OK
+	} else if (
+		wErrCode_isError(adcSched_add(&adcX1, i_VX1, RKEY_SAMPLINGMS, ADCSCHED_PRIO_HIGH)) ||
+		wErrCode_isError(adcSched_add(&adcX2, i_VX2, RKEY_SAMPLINGMS, ADCSCHED_PRIO_HIGH)) ||
+		wErrCode_isError(adcSched_add(&adcY1, i_VY1, RKEY_SAMPLINGMS, ADCSCHED_PRIO_HIGH)) ||
+		wErrCode_isError(adcSched_add(&adcY2, i_VY2, RKEY_SAMPLINGMS, ADCSCHED_PRIO_HIGH))
+	) {
+		ESP_LOGE("MAIN", "A/D channel configuration failed");
+		FSM = HW_FAILURE;
+
+	} else {
+		// Raw-to-millivolts conversion table building
+		if (wErrCode_isError(adcCalib_init(ADC_UNIT_1, ADC_ATTEN_DB_12)))
+			// WARNING!
+			ESP_LOGW("MAIN", "WARNING! A/D calibration failed, the nominal conversion will be used");
+
+#if BATTMONITOR == 1
+		// Battery voltage channel and sheddable loads (o_ADDLIGHT is the first one to be shed)
+		if (
+			wErrCode_isError(adcSched_add(&adcVBatt, i_VBATT, VBATT_SAMPLINGMS, ADCSCHED_PRIO_LOW)) ||
+			wErrCode_isError(adcSched_setCallback(adcVBatt, vbattCB))                              ||
+			wErrCode_isError(batteryMonitor_init())                                                ||
+			wErrCode_isError(batteryMonitor_addLoad(&addLightLoad, 0))                             ||
+			wErrCode_isError(batteryMonitor_addLoad(&upLightLoad,  1))
 		) {
-			ESP_LOGE("MAIN", "A/D channel configuration failed");
+			ESP_LOGE("MAIN", "Battery monitor initialization failed");
+			FSM = HW_FAILURE;
+
+		} else
+#endif
+		if (wErrCode_isError(adcSched_start())) {
+			ESP_LOGE("MAIN", "A/D scheduler starting failed");
 			FSM = HW_FAILURE;
 		}
 	}
 
 
+#if RPMSENSOR == 1
+	//
+	// RPM sensor configuration
+	//
+	if (FSM != HW_FAILURE && (wErrCode_isError(rpmMeter_init(i_RPM)) || wErrCode_isError(rpmMeter_start()))) {
+		ESP_LOGE("MAIN", "RPM sensor initialization failed");
+		FSM = HW_FAILURE;
+	}
+
+
+#endif
 	//
 	// Output pins configuration
 	//
@@ -319,6 +446,9 @@ int app_main(void) {
 		keepTrack_setGPIO(o_ENGINEON,    0);
 		keepTrack_setGPIO(o_ENGINEREADY, 0);
 
+		// The debug-console decodes the pins by this firmware's symbols
+		keepTrack_announce();
+
 		xBlinkTimer = xTimerCreate("BlinkTimer", BLINK_PERIOD, pdTRUE, (void *)0, tickerCB);
 
 		if (xBlinkTimer != NULL)
@@ -355,36 +485,36 @@ int app_main(void) {
 			//
 			// Resistor keys evaluation
 			//
-			int adc_rawX1,  adc_rawX2,  adc_rawY1,  adc_rawY2;
 			int X1, X2, Y1, Y2;
+			uint16_t keyID;
 			
 			if (
-				adc_oneshot_read(adc_handle, i_VX1, &adc_rawX1) != ESP_OK ||
-				adc_oneshot_read(adc_handle, i_VX2, &adc_rawX2) != ESP_OK ||
-				adc_oneshot_read(adc_handle, i_VY1, &adc_rawY1) != ESP_OK ||
-				adc_oneshot_read(adc_handle, i_VY2, &adc_rawY2) != ESP_OK
+				adcSched_get(adcX1, &X1) != WERRCODE_SUCCESS ||
+				adcSched_get(adcX2, &X2) != WERRCODE_SUCCESS ||
+				adcSched_get(adcY1, &Y1) != WERRCODE_SUCCESS ||
+				adcSched_get(adcY2, &Y2) != WERRCODE_SUCCESS
 			) {
-				// ERROR!
-				ESP_LOGE("MAIN", "ERROR! adc_oneshot_read() failed");
-			
-			} else if (
-				ravg_update (&ravg_rawX1, &X1, adc_rawX1) != WERRCODE_SUCCESS ||
-				ravg_update (&ravg_rawX2, &X2, adc_rawX2) != WERRCODE_SUCCESS ||
-				ravg_update (&ravg_rawY1, &Y1, adc_rawY1) != WERRCODE_SUCCESS ||
-				ravg_update (&ravg_rawY2, &Y2, adc_rawY2) != WERRCODE_SUCCESS
-			) {
-				// ERROR!
-				ESP_LOGE("MAIN", "WARNING! filtered values are not available");
+				// WARNING!
+				ESP_LOGW("MAIN", "WARNING! filtered values are not available");
 			
 			} else if (KEYSETTING == 1) {
-				ESP_LOGI("MAIN", "Current values: (%d/%d) (%d/%d)", X1, Y1, X2, Y2);
+				keyEnrolment(X1, Y1, X2, Y2);
 
-			} else if (abs(X1 - Y1) < V_TOLERANCE && abs(X2 - Y2) < V_TOLERANCE) {
+			} else if (keyCheck(X1, Y1, X2, Y2, &keyID)) {
 				// The keyword has been authenicated, you can unplug it
 				keepTrack_setGPIO(o_KEEPALIVE, 1);
 				FSM = MAIN_LOOP;
-				ESP_LOGI("MAIN", "OK: (%d/%d) (%d/%d)", X1, Y1, X2, Y2);
-				ESP_LOGI("MAIN", "[ OK ] key has been accepted");
+
+				// The key's channels are no longer needed
+				adcSched_setPeriod(adcX1, ADCSCHED_DISABLED);
+				adcSched_setPeriod(adcX2, ADCSCHED_DISABLED);
+				adcSched_setPeriod(adcY1, ADCSCHED_DISABLED);
+				adcSched_setPeriod(adcY2, ADCSCHED_DISABLED);
+				ESP_LOGI("MAIN", "OK: (%d/%d) (%d/%d) mV", X1, Y1, X2, Y2);
+				if (keyID == KEYREG_NOKEY)
+					ESP_LOGI("MAIN", "[ OK ] default key has been accepted");
+				else
+					ESP_LOGI("MAIN", "[ OK ] key-%d has been accepted", keyID);
 
 			} else {
 				// I keep everything OFF!!
@@ -394,7 +524,7 @@ int app_main(void) {
 				keepTrack_setGPIO(o_UPLIGHT,     0);
 				keepTrack_setGPIO(o_ADDLIGHT,    0);
 				
-				ESP_LOGI("MAIN", "Authentication: (%d/%d) (%d/%d)", X1, Y1, X2, Y2);
+				ESP_LOGI("MAIN", "Authentication: (%d/%d) (%d/%d) mV", X1, Y1, X2, Y2);
 			}
 			
 			// [!] The following delay is used to prevent brutal-force attack (when ready_flag == 0) and to allow
@@ -426,6 +556,18 @@ int app_main(void) {
 				FSM =  HW_FAILURE;
 				
 			} else {
+#if BATTMONITOR == 1
+				//
+				// Battery monitoring: the high current loads are shed when the voltage sags (the samples are passed
+				// to the monitor by vbattCB())
+				//
+				if (batteryMonitor_shedLoads() != shedLoads) {
+					shedLoads = batteryMonitor_shedLoads();
+					// WARNING!
+					ESP_LOGW("MAIN", "WARNING! battery: %d mV, %d shed loads", batteryMonitor_voltage(), shedLoads);
+				}
+#endif
+
 				//
 				// Lights
 				//
@@ -436,8 +578,8 @@ int app_main(void) {
 					keepTrack_setGPIO(o_DOWNLIGHT, 1);
 					//ESP_LOGI("MAIN", "Low beam lighn is ON");
 #endif
-					keepTrack_setGPIO(o_UPLIGHT,  uLight_value   ? 1 : 0);
-					keepTrack_setGPIO(o_ADDLIGHT, addLight_value ? 1 : 0);
+					keepTrack_setGPIO(o_UPLIGHT,  (uLight_value   && LOAD_ALLOWED(upLightLoad))  ? 1 : 0);
+					keepTrack_setGPIO(o_ADDLIGHT, (addLight_value && LOAD_ALLOWED(addLightLoad)) ? 1 : 0);
 						
 				} else {
 					keepTrack_setGPIO(o_DOWNLIGHT, 0);
@@ -542,7 +684,11 @@ int app_main(void) {
 						keepTrack_setGPIO(o_ENGINEON,    1);                 // Engine no more locked by CDI
 						keepTrack_setGPIO(o_ENGINEREADY, 1);                 // LED: mtb is ready to start
 						
+#if RPMSENSOR == 1
+						if (rpmMeter_state() == RPM_RUNNING) {
+#else
 						if (neutral_value == false && clutch_value == false) {
+#endif
 							decompPushed = false;                    // The mtb has been started manually
 							mtbState = MTB_RUNNIG_ST;
 							keepTrack_setGPIO(o_ENGINEREADY, 0);
@@ -565,18 +711,34 @@ int app_main(void) {
 						//
 						ESP_LOGI("MAIN", "MTB_ELSTARTING_ST");
 						keepTrack_setGPIO(o_STARTENGINE, engStart_value);  // i_STARTBUTTON
+#if RPMSENSOR == 1
+						if (rpmMeter_state() == RPM_RUNNING) {
+							// The engine is running: the starter is stopped, also if the button is still pushed
+							keepTrack_setGPIO(o_STARTENGINE, 0);
+							mtbState = MTB_RUNNIG_ST;
+							ESP_LOGI("MAIN", "Engine started (%d rpm)", rpmMeter_rpm());
+							ESP_LOGI("MAIN", "MTB_RUNNIG_ST");
+
+						} else if (engStart_value == false) {
+							// The starter has been released before the engine start
+							mtbState = MTB_WFR_ST;
+							ESP_LOGI("MAIN", "MTB_WFR_ST");
+						}
+#else
 						if (engStart_value == false) {
 							mtbState = MTB_RUNNIG_ST;
 							ESP_LOGI("MAIN", "MTB_RUNNIG_ST");
 						}
+#endif
 					} break;
 	
 	
 					case MTB_RUNNIG_ST: {
 						//
 						// The motorbike's engine is running....
-						// Unfortunately, because the MCU does not know the real eng status (by RPM signal), to
-						// come back in the MTB_STOPPED_ST status, the driver MUST set the engine-on switch to off
+						// Unfortunately, without the RPM sensor (RPMSENSOR == 0) the MCU does not know the real eng
+						// status, so to come back in the MTB_STOPPED_ST status, the driver MUST set the engine-on
+						// switch to off. With the RPM sensor, a stall brings the FSM in MTB_STOPPED_ST.
 						//
 						// If the ebgine stops to run for so,e reason, ad the driver will push the decompressor
 						// control, then the engine will be immediately ready to be started again. Also if the
@@ -591,6 +753,15 @@ int app_main(void) {
 							vTaskDelay(1000 / portTICK_PERIOD_MS); // I wait (1s) for the engine stop
 							ESP_LOGI("MAIN", "MTB_STOPPED_ST");
 						}
+#if RPMSENSOR == 1
+						else if (rpmMeter_state() == RPM_STALLED) {
+							// WARNING!
+							ESP_LOGW("MAIN", "WARNING! the engine has stalled");
+							mtbState = MTB_STOPPED_ST;
+							keepTrack_setGPIO(o_ENGINEON, 0);           // Engine locking request to CDI
+							ESP_LOGI("MAIN", "MTB_STOPPED_ST");
+						}
+#endif
 					} break;
 				} // === mtbstate switch ===
 			}
@@ -612,6 +783,9 @@ int app_main(void) {
 		}
 
 
+		// Pin-symbol map request by the debug-console
+		keepTrack_poll();
+
 		// delay
 		#if DEBUG > 0
 		vTaskDelay(200 / portTICK_PERIOD_MS);
@@ -56,8 +56,7 @@
 #include <freertos/task.h>
 
 #include <mbesPinsMap.h>
-
-#define DEFAULT_VREF 1100           // Tensione di riferimento predefinita (in mV)
+#include <adcCalib.h>
 
 void app_main(void) {
 	adc_oneshot_chan_cfg_t      config;
@@ -90,10 +89,12 @@ void app_main(void) {
 		ESP_LOGE(__FUNCTION__, "ERROR! adc_oneshot_config_channel() failed");
 	
 	else {
+		// Raw-to-millivolts table (eFuse calibration data)
+		adcCalib_init(ADC_UNIT_1, config.atten);
 
 		while (1) {
 			if (adc_oneshot_read(adc1_handle, i_VX1, &adc_raw) == ESP_OK) {
-				mv = (adc_raw * DEFAULT_VREF) / 8191 * 2.4;
+				mv = adcCalib_toMv(adc_raw);
 				printf("Valore grezzo ADC: %d\tTensione: %d mV\n", adc_raw, mv);
 			} else
 				// ERROR!
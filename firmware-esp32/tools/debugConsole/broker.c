@@ -0,0 +1,399 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: broker.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Fan-out server of the raw serial stream on a Unix domain socket: the console that owns the serial port reads it
+//	once, and any number of viewers/recorders (other debugConsole instances started with "-c <socket>") receive the
+//	same bytes.
+//	The parser thread appends every chunk to a shared byte ring (BROKER_RINGSIZE), and it never waits for the
+//	clients. The broker thread keeps a cursor per client, and it writes the pending bytes (up to two iovecs, the
+//	ring can wrap) on the non-blocking client sockets when they are writable. A client whose lag exceeds
+//	BROKER_MAXLAG bytes is dropped (disconnected), so a slow client can neither block the reader nor read bytes
+//	already overwritten by the parser. The clients are connected to the live stream (no history).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <syslog.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
+#include <broker.h>
+
+#if (BROKER_RINGSIZE & (BROKER_RINGSIZE - 1)) != 0
+#error "BROKER_RINGSIZE has to be a power of 2"
+#endif
+
+#define BROKER_RINGMASK  (BROKER_RINGSIZE - 1)
+
+// Client's descriptor
+typedef struct {
+	int      fd;                      // -1: free slot
+	uint64_t rdPos;                   // Next byte to send (ring's absolute position)
+} brkClient_t;
+
+static char             *ring     = NULL;
+static _Atomic uint64_t wrPos     = 0;        // Ring's absolute write position (published bytes)
+static _Atomic uint64_t wrBegin   = 0;        // End of the write in progress (it is updated before the copy)
+static brkClient_t      clients[BROKER_MAXCLIENTS];
+static int              listenFd  = -1;
+static int              dataFd    = -1;       // New data (eventfd)
+static int              stopFd    = -1;       // Stop request (eventfd)
+static char             sockPath[sizeof(((struct sockaddr_un*)0)->sun_path)];
+static pthread_t        brokerTh;
+static _Atomic bool     running   = false;
+static _Atomic uint64_t sent      = 0;
+static _Atomic uint32_t connected = 0;
+static _Atomic uint32_t accepted  = 0;
+static _Atomic uint32_t dropped   = 0;
+
+
+static void clientClosing (brkClient_t *cl) {
+	close(cl->fd);
+	cl->fd = -1;
+	connected--;
+
+	return;
+}
+
+
+static void clientAccepting () {
+	//
+	// Description:
+	//	It accepts the new connection; the client will receive the data published from now on
+	//
+	int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	int t  = 0;
+
+	if (fd >= 0) {
+		while (t < BROKER_MAXCLIENTS && clients[t].fd >= 0) t++;
+
+		if (t == BROKER_MAXCLIENTS) {
+			// WARNING! Too many clients
+			syslog(LOG_WARNING, "WARNING(%d)! Too many broker clients", __LINE__);
+			close(fd);
+		} else {
+			clients[t].fd    = fd;
+			clients[t].rdPos = wrPos;
+			connected++;
+			accepted++;
+		}
+	}
+
+	return;
+}
+
+
+static void clientSending (brkClient_t *cl) {
+	//
+	// Description:
+	//	It sends the pending bytes to the argument defined client. The clients too slow are dropped.
+	//
+	uint64_t     end = atomic_load_explicit(&wrPos, memory_order_acquire);
+	uint64_t     len = end - cl->rdPos;
+	uint32_t     off = cl->rdPos & BROKER_RINGMASK;
+	struct iovec iov[2];
+	ssize_t      nb;
+
+	if (len > BROKER_MAXLAG) {
+		// WARNING! Too slow client
+		dropped++;
+		clientClosing(cl);
+
+	} else if (len > 0) {
+		iov[0].iov_base = ring + off;
+		iov[0].iov_len  = (off + len > BROKER_RINGSIZE) ? BROKER_RINGSIZE - off : len;
+		iov[1].iov_base = ring;
+		iov[1].iov_len  = len - iov[0].iov_len;
+
+		nb = writev(cl->fd, iov, (iov[1].iov_len > 0) ? 2 : 1);
+		if (nb > 0) {
+			cl->rdPos += nb;
+			sent      += nb;
+
+			// The sent bytes could have been overwritten during the writing (the client was too late): a copy still
+			// in progress is considered too, its end is published before the copy starts
+			atomic_thread_fence(memory_order_acquire);
+			if (atomic_load_explicit(&wrBegin, memory_order_relaxed) - (cl->rdPos - nb) > BROKER_RINGSIZE) {
+				dropped++;
+				clientClosing(cl);
+			}
+
+		} else if (nb < 0 && errno != EAGAIN && errno != EINTR)
+			// The client has gone
+			clientClosing(cl);
+	}
+
+	return;
+}
+
+
+static void* brokerThread (void *arg) {
+	//
+	// Description:
+	//	It accepts the clients and it sends them the published data
+	//
+	struct pollfd pfds[3 + BROKER_MAXCLIENTS];
+	brkClient_t   *map[BROKER_MAXCLIENTS];
+	bool          loop = true;
+
+	while (loop) {
+		uint64_t end = wrPos;
+		int      n   = 3;
+		char     trash[256];
+
+		pfds[0] = (struct pollfd){ stopFd,   POLLIN, 0 };
+		pfds[1] = (struct pollfd){ dataFd,   POLLIN, 0 };
+		pfds[2] = (struct pollfd){ listenFd, POLLIN, 0 };
+		for (int t = 0; t < BROKER_MAXCLIENTS; t++) {
+			if (clients[t].fd >= 0) {
+				// POLLOUT only when there are pending bytes (POLLIN reports the hang-ups)
+				pfds[n] = (struct pollfd){ clients[t].fd, (clients[t].rdPos != end) ? POLLIN | POLLOUT : POLLIN, 0 };
+				map[n - 3] = &clients[t];
+				n++;
+			}
+		}
+
+		if (poll(pfds, n, -1) < 0) {
+			if (errno != EINTR) {
+				// ERROR!
+				syslog(LOG_ERR, "ERROR(%d)! poll() failed: %s", __LINE__, strerror(errno));
+				loop = false;
+			}
+
+		} else if (pfds[0].revents & POLLIN) {
+			loop = false;
+
+		} else {
+			if (pfds[1].revents & POLLIN) {
+				eventfd_t cnt;
+				eventfd_read(dataFd, &cnt);
+			}
+			if (pfds[2].revents & POLLIN) clientAccepting();
+
+			for (int t = 3; t < n; t++) {
+				brkClient_t *cl = map[t - 3];
+
+				if ((pfds[t].revents & POLLIN) && read(cl->fd, trash, sizeof(trash)) <= 0)
+					// The client has gone (its data are ignored)
+					clientClosing(cl);
+
+				else if (pfds[t].revents & (POLLERR | POLLHUP))
+					clientClosing(cl);
+
+				else if (pfds[t].revents & POLLOUT)
+					clientSending(cl);
+			}
+			// The clients connected (or already writable) have to be served without waiting for POLLOUT
+			for (int t = 0; t < BROKER_MAXCLIENTS; t++)
+				if (clients[t].fd >= 0 && clients[t].rdPos != wrPos) clientSending(&clients[t]);
+		}
+	}
+
+	return(NULL);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+werror broker_start (const char *path) {
+	//
+	// Description:
+	//	It creates the argument defined Unix domain socket (a stale one is removed), and it starts the broker thread
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG     Too long path
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//	WERRCODE_ERROR_SYSCALL
+	//
+	werror             err  = WERRCODE_SUCCESS;
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+	for (int t = 0; t < BROKER_MAXCLIENTS; t++) clients[t].fd = -1;
+	wrPos = wrBegin = sent = 0;
+	connected = accepted = dropped = 0;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Too long socket path: \"%s\"\n", path);
+		err = WERRCODE_ERROR_ILLEGALARG;
+
+	} else if ((ring = malloc(BROKER_RINGSIZE)) == NULL) {
+		// ERROR!
+		err = WERRCODE_ERROR_OUTOFMEMORY;
+
+	} else {
+		strcpy(addr.sun_path, path);
+		strcpy(sockPath, path);
+		unlink(path);
+
+		if ((listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0 ||
+		    bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, BROKER_MAXCLIENTS) < 0 ||
+		    (dataFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0 || (stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+			// ERROR!
+			fprintf(stderr, "ERROR! I cannot create the \"%s\" socket: %s\n", path, strerror(errno));
+			err = WERRCODE_ERROR_SYSCALL;
+
+		} else if (pthread_create(&brokerTh, NULL, brokerThread, NULL) != 0) {
+			// ERROR!
+			fprintf(stderr, "ERROR! I cannot create the broker thread\n");
+			err = WERRCODE_ERROR_SYSCALL;
+
+		} else
+			running = true;
+	}
+
+	if (wErrCode_isError(err)) {
+		if (listenFd >= 0) close(listenFd);
+		if (dataFd >= 0)   close(dataFd);
+		if (stopFd >= 0)   close(stopFd);
+		free(ring);
+		listenFd = dataFd = stopFd = -1;
+		ring     = NULL;
+	}
+
+	return(err);
+}
+
+
+void broker_publish (const char *data, uint32_t size) {
+	//
+	// Description:
+	//	It appends the argument defined data to the ring, and it wakes the broker thread up. It never waits, and it
+	//	does nothing when the broker has not been started.
+	//
+	uint64_t pos = atomic_load_explicit(&wrPos, memory_order_relaxed);
+
+	if (running && size > 0) {
+		// Only the ring's last BROKER_RINGSIZE bytes can be sent
+		if (size > BROKER_RINGSIZE) {
+			pos  += size - BROKER_RINGSIZE;
+			data += size - BROKER_RINGSIZE;
+			size  = BROKER_RINGSIZE;
+		}
+		atomic_store_explicit(&wrBegin, pos + size, memory_order_relaxed);
+		atomic_thread_fence(memory_order_release);
+		for (uint32_t done = 0; done < size;) {
+			uint32_t off = (pos + done) & BROKER_RINGMASK;
+			uint32_t n   = (size - done < BROKER_RINGSIZE - off) ? size - done : BROKER_RINGSIZE - off;
+
+			memcpy(ring + off, data + done, n);
+			done += n;
+		}
+		atomic_store_explicit(&wrPos, pos + size, memory_order_release);
+		eventfd_write(dataFd, 1);
+	}
+
+	return;
+}
+
+
+void broker_stop () {
+	//
+	// Description:
+	//	It stops the broker thread, it disconnects the clients and it removes the socket
+	//
+	if (running) {
+		eventfd_write(stopFd, 1);
+		pthread_join(brokerTh, NULL);
+		running = false;
+
+		for (int t = 0; t < BROKER_MAXCLIENTS; t++)
+			if (clients[t].fd >= 0) clientClosing(&clients[t]);
+		close(listenFd);
+		close(dataFd);
+		close(stopFd);
+		unlink(sockPath);
+		free(ring);
+		listenFd = dataFd = stopFd = -1;
+		ring     = NULL;
+	}
+
+	return;
+}
+
+
+void broker_stats (brokerStats_t *stats) {
+	//
+	// Description:
+	//	It returns the broker's counters
+	//
+	clockid_t       cid;
+	struct timespec ts = {0, 0};
+
+	stats->published = wrPos;
+	stats->sent      = sent;
+	stats->clients   = connected;
+	stats->accepted  = accepted;
+	stats->dropped   = dropped;
+	if (running && pthread_getcpuclockid(brokerTh, &cid) == 0) clock_gettime(cid, &ts);
+	stats->cpuUs     = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+	return;
+}
+
+
+werror broker_connect (const char *path, int *fd) {
+	//
+	// Description:
+	//	It connects to the argument defined broker's socket. The returned fd is non-blocking, and it can take the
+	//	serial port's place (see ttyPipeline_start()).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG     Too long path
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror             err  = WERRCODE_SUCCESS;
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Too long socket path: \"%s\"\n", path);
+		err = WERRCODE_ERROR_ILLEGALARG;
+
+	} else if (strcpy(addr.sun_path, path), (*fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0 ||
+	           connect(*fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || fcntl(*fd, F_SETFL, O_NONBLOCK) < 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! I cannot connect to the \"%s\" broker: %s\n", path, strerror(errno));
+		if (*fd >= 0) close(*fd);
+		*fd = -1;
+		err = WERRCODE_ERROR_IOOPERFAILED;
+	}
+
+	return(err);
+}
@@ -0,0 +1,65 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: broker.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Fan-out server of the raw serial stream on a Unix domain socket: the console that owns the serial port reads it
+//	once, and any number of viewers/recorders (other debugConsole instances started with "-c <socket>") receive the
+//	same bytes.
+//	The parser thread appends every chunk to a shared byte ring (BROKER_RINGSIZE), and it never waits for the
+//	clients. The broker thread keeps a cursor per client, and it writes the pending bytes (up to two iovecs, the
+//	ring can wrap) on the non-blocking client sockets when they are writable. A client whose lag exceeds
+//	BROKER_MAXLAG bytes is dropped (disconnected), so a slow client can neither block the reader nor read bytes
+//	already overwritten by the parser. The clients are connected to the live stream (no history).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef BROKER_UT
+#define BROKER_UT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <werror.h>
+
+#define BROKER_RINGSIZE   (1024 * 1024)                 // It has to be a power of 2
+#define BROKER_MAXLAG     (BROKER_RINGSIZE / 2)
+#define BROKER_MAXCLIENTS 64
+
+// Broker's counters
+typedef struct {
+	uint64_t published;               // Bytes appended to the ring
+	uint64_t sent;                    // Bytes sent to all the clients
+	uint32_t clients;                 // Connected clients
+	uint32_t accepted;                // Accepted clients (since the start)
+	uint32_t dropped;                 // Clients dropped because too slow
+	uint64_t cpuUs;                   // Broker thread's CPU time (us)
+} brokerStats_t;
+
+werror broker_start   (const char *path);
+void   broker_publish (const char *data, uint32_t size);
+void   broker_stop    ();
+void   broker_stats   (brokerStats_t *stats);
+werror broker_connect (const char *path, int *fd);
+
+#endif
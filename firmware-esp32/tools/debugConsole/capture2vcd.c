@@ -0,0 +1,402 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: capture2vcd.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Capture file to VCD (Value Change Dump, IEEE 1364) converter: the pins' changes recorded by a capture file (see
+//	captureFile.h) can be displayed by GTKWave, or by any other waveform viewer.
+//	The capture is streamed through the console's row builder and pin parser, and the value changes are written as
+//	they are found. The VCD header (the used pins, declared by their symbols or by their labels, and their widths) is
+//	known at the end only, so CONV_HDRSIZE bytes are reserved at the file's beginning, and the header is written there
+//	at the end (the unused space is a $comment section). When the output cannot be seeked (e.g. a pipe) the capture
+//	is streamed twice: the first pass finds the used pins.
+//	The pins' symbols are the ones of the map announced by the firmware (see ptsCache.h), or the ones of the local
+//	checkout's mbesPinsMap.h when the capture has no announcement.
+//	The memory usage does not depend on the capture's size: the capture's pages already read are released (see
+//	capturePlayer_drop()) and the output is written by CONV_OUTSIZE bytes blocks.
+//
+//	Use: capture2vcd <capture file> [<VCD file>]        (the standard output is used by default)
+//
+//	VCD details:
+//		- the time unit is 1 ms, and the time zero is the capture's one ($date is its wall-clock time)
+//		- the 0/1 pins are declared as 1 bit wires; the pins with greater values (e.g. ADC channels) as 32 bits
+//		  registers. All the value changes are written in the vector format (e.g. "b1 !")
+//		- a pin's value is written only when it changes; its value is unknown ('x') before its first row
+//
+//	Symbols:
+//		CONV_OUTSIZE     Output buffer's size
+//		CONV_HDRSIZE     Space reserved to the VCD header (seekable output)
+//		CONV_DROPSIZE    Capture's bytes read between two pages releases
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+
+#include <pinToSymbol.h>
+#include <ptsCache.h>
+#include <stringBuilder.h>
+#include <captureFile.h>
+#include <capturePlayer.h>
+#include <timeUtils.h>
+
+#define CONV_OUTSIZE     (1024 * 1024)
+#define CONV_HDRSIZE     (PTS_MAXPINID * 96 + 1024)
+#define CONV_DROPSIZE    (16 * 1024 * 1024)
+#define CONV_MAXCHUNK    4096               // Max bytes added to the row builder by a single call
+#define CONV_IDFIRST     '!'                // VCD identifiers' characters (printable ASCII)
+#define CONV_IDCHARS     ('~' - '!' + 1)
+
+// Pin's row handler
+typedef werror (*pinHandler_t)(pinId_t pin, uint32_t value, uint32_t tstamp);
+
+// Pin's state
+typedef struct {
+	bool     used;                    // The capture has at least a row of the pin (it has an identifier)
+	bool     wide;                    // Values greater than 1 have been found (32 bits register)
+	bool     known;                   // A value has been written
+	uint32_t value;                   // Last written value
+	char     id[4];                   // VCD identifier
+} convPin_t;
+
+// Global vars
+static convPin_t pins[PTS_MAXPINID];
+static uint32_t  used     = 0;             // Number of used pins
+static char      outBuff[CONV_OUTSIZE];
+static uint32_t  outUsed  = 0;
+static int       outFd    = STDOUT_FILENO;
+static int64_t   lastTime = 0;             // Last written time (the header ends by "#0")
+static uint64_t  rows     = 0;             // Pins' rows
+static uint64_t  changes  = 0;             // Written value changes
+static uint64_t  parsed   = 0;             // Capture's bytes parsed
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                                  F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+
+werror outFlushing () {
+	//
+	// Description:
+	//	It writes the output buffer's contents
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror   err = WERRCODE_SUCCESS;
+	uint32_t done = 0;
+	ssize_t  n;
+
+	while (done < outUsed && err == WERRCODE_SUCCESS) {
+		if ((n = write(outFd, outBuff + done, outUsed - done)) > 0)
+			done += n;
+		else if (n < 0 && errno != EINTR) {
+			// ERROR!
+			fprintf(stderr, "ERROR! I cannot write the VCD file: %s\n", strerror(errno));
+			err = WERRCODE_ERROR_IOOPERFAILED;
+		}
+	}
+	outUsed = 0;
+
+	return(err);
+}
+
+
+void outPrinting (const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+void outPrinting (const char *fmt, ...) {
+	//
+	// Description:
+	//	It appends the argument defined formatted text to the output buffer (header's lines, the buffer is never
+	//	flushed by this function)
+	//
+	va_list args;
+	int     n;
+
+	va_start(args, fmt);
+	n = vsnprintf(outBuff + outUsed, CONV_OUTSIZE - outUsed, fmt, args);
+	va_end(args);
+	if (n > 0) outUsed += (n < (int)(CONV_OUTSIZE - outUsed)) ? n : CONV_OUTSIZE - outUsed - 1;
+
+	return;
+}
+
+
+void pinUsing (pinId_t pin) {
+	//
+	// Description:
+	//	It marks the argument defined pin as used, and it assigns its VCD identifier (base-94 printable characters)
+	//
+	uint32_t code = used++;
+	uint8_t  len  = 0;
+
+	do {
+		pins[pin].id[len++] = CONV_IDFIRST + code % CONV_IDCHARS;
+		code /= CONV_IDCHARS;
+	} while (code > 0);
+	pins[pin].id[len] = '\0';
+	pins[pin].used    = true;
+
+	return;
+}
+
+
+werror captureParsing (pinHandler_t handler) {
+	//
+	// Description:
+	//	It streams the whole capture through the row builder and the pin parser, and it calls the argument defined
+	//	handler for every pin's row (the log messages are ignored). The symbols map announcement's rows are passed to
+	//	the symbols cache.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//	Any error returned by the handler
+	//
+	werror        err  = WERRCODE_SUCCESS;
+	uint64_t      read = 0;
+	uint32_t      tstamp, size;
+	const uint8_t *data;
+	builderView_t row;
+	pinId_t       pin;
+	int           value;
+	bool          loaded;
+
+	stringBuilder_close();
+	capturePlayer_seek(0);
+	while (err == WERRCODE_SUCCESS && capturePlayer_next(&tstamp, &data, &size) == WERRCODE_SUCCESS) {
+		for (uint32_t done = 0; done < size && err == WERRCODE_SUCCESS; done += CONV_MAXCHUNK) {
+			uint32_t n = (size - done < CONV_MAXCHUNK) ? size - done : CONV_MAXCHUNK;
+
+			if (wErrCode_isError(stringBuilder_put((const char*)data + done, n)))
+				// ERROR!
+				err = WERRCODE_ERROR_OUTOFMEMORY;
+
+			// The rows are zero-copy views, valid until the next stringBuilder_put() call
+			while (err == WERRCODE_SUCCESS && stringBuilder_getView(&row) == WERRCODE_SUCCESS) {
+				if (ptsCache_row(row.str, &loaded) != WERRCODE_WARNING_ITNOTFOUND) {
+					// Symbols map announcement
+
+				} else if (pinDef_get(row.str, &pin, &value) == WERRCODE_SUCCESS && value >= 0)
+					err = handler(pin, value, tstamp);
+			}
+		}
+
+		// The released pages keep the memory usage constant
+		parsed += size;
+		if ((read += size) >= CONV_DROPSIZE) {
+			capturePlayer_drop();
+			read = 0;
+		}
+	}
+	capturePlayer_drop();
+
+	return(err);
+}
+
+
+werror pinFinding (pinId_t pin, uint32_t value, uint32_t tstamp) {
+	//
+	// Description:
+	//	First pass' handler (not seekable output): it marks the used pins, and it detects their width
+	//
+	if (pins[pin].used == false) pinUsing(pin);
+	pins[pin].wide |= (value > 1);
+
+	return(WERRCODE_SUCCESS);
+}
+
+
+werror changeWriting (pinId_t pin, uint32_t value, uint32_t tstamp) {
+	//
+	// Description:
+	//	It writes the pin's value when it has changed (preceded by the time, when it has changed too)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror    err = WERRCODE_SUCCESS;
+	convPin_t *p  = &pins[pin];
+	char      *ptr;
+	int8_t    bit = 31;
+
+	if (p->used == false) pinUsing(pin);
+	p->wide |= (value > 1);
+	rows++;
+
+	if (p->known == false || p->value != value) {
+		if (outUsed + 64 > CONV_OUTSIZE) err = outFlushing();
+
+		ptr = outBuff + outUsed;
+		if (tstamp != lastTime) {
+			ptr     += sprintf(ptr, "#%u\n", tstamp);
+			lastTime = tstamp;
+		}
+
+		// Binary value without leading zeros
+		*ptr++ = 'b';
+		while (bit > 0 && ((value >> bit) & 1) == 0) bit--;
+		for (; bit >= 0; bit--) *ptr++ = '0' + ((value >> bit) & 1);
+		*ptr++ = ' ';
+		for (const char *id = p->id; *id != '\0'; id++) *ptr++ = *id;
+		*ptr++ = '\n';
+
+		outUsed  = ptr - outBuff;
+		p->known = true;
+		p->value = value;
+		changes++;
+	}
+
+	return(err);
+}
+
+
+void headerPrinting (const captHeader_t *hdr) {
+	//
+	// Description:
+	//	It writes the VCD header in the output buffer: the used pins are declared by their symbols (by their labels
+	//	when they have no symbols), and their initial value is unknown
+	//
+	time_t     wall = hdr->wallClock / 1000;
+	char       date[64], label[PTS_PINLABSIZE];
+	const char *name;
+	struct tm  tm;
+
+	strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime_r(&wall, &tm));
+	outPrinting(
+		"$date %s $end\n$version debugConsole capture2vcd $end\n$comment %.8s target, %u bps $end\n$timescale 1 ms $end\n"
+		"$scope module %.8s $end\n", date, hdr->target, hdr->ttySpeed, hdr->target
+	);
+
+	for (pinId_t pin = 0; pin < PTS_MAXPINID; pin++) {
+		if (pins[pin].used) {
+			if (pinToSymbol_getById(&name, pin) != WERRCODE_SUCCESS) {
+				pinId_toLabel(label, pin);
+				name = label;
+			}
+			outPrinting("$var %s %u %s %s $end\n", pins[pin].wide ? "reg" : "wire", pins[pin].wide ? 32 : 1, pins[pin].id, name);
+		}
+	}
+
+	outPrinting("$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+	for (pinId_t pin = 0; pin < PTS_MAXPINID; pin++)
+		if (pins[pin].used) outPrinting(pins[pin].wide ? "bx %s\n" : "x%s\n", pins[pin].id);
+	outPrinting("$end\n");
+
+	return;
+}
+
+
+werror converting (const captHeader_t *hdr) {
+	//
+	// Description:
+	//	It converts the whole capture. When the output is seekable, the capture is read once, and the header is
+	//	written in the reserved space at the end; otherwise the used pins are found by a first pass.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror err      = WERRCODE_SUCCESS;
+	bool   seekable = (lseek(outFd, CONV_HDRSIZE, SEEK_SET) == CONV_HDRSIZE);
+
+	if (seekable == false && (err = captureParsing(pinFinding)) == WERRCODE_SUCCESS) {
+		headerPrinting(hdr);
+		parsed = 0;
+	}
+
+	if (err == WERRCODE_SUCCESS && (err = captureParsing(changeWriting)) == WERRCODE_SUCCESS)
+		err = outFlushing();
+
+	if (err == WERRCODE_SUCCESS && seekable) {
+		// Header and padding comment (the VCD tokens are separated by any amount of white space)
+		headerPrinting(hdr);
+		outPrinting("$comment");
+		memset(outBuff + outUsed, ' ', CONV_HDRSIZE - outUsed);
+		memcpy(outBuff + CONV_HDRSIZE - 6, "$end\n\n", 6);
+
+		if (pwrite(outFd, outBuff, CONV_HDRSIZE, 0) != CONV_HDRSIZE) {
+			// ERROR!
+			fprintf(stderr, "ERROR! I cannot write the VCD header: %s\n", strerror(errno));
+			err = WERRCODE_ERROR_IOOPERFAILED;
+		}
+	}
+
+	return(err);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                                     M A I N
+//------------------------------------------------------------------------------------------------------------------------------
+int main (int argc, char *argv[]) {
+	werror       err = WERRCODE_SUCCESS;
+	captHeader_t hdr;
+	uint64_t     start = monotonicMs();
+	double       secs;
+
+	if (argc < 2 || argc > 3) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Use: %s <capture file> [<VCD file>]\n", argv[0]);
+		err = WERRCODE_ERROR_MISSINGARG;
+
+	} else if (wErrCode_isError(capturePlayer_open(argv[1], &hdr))) {
+		// ERROR!
+		err = WERRCODE_ERROR_INVALIDDATA;
+
+	} else if (argc == 3 && (outFd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! I cannot create the \"%s\" file: %s\n", argv[2], strerror(errno));
+		err = WERRCODE_ERROR_IOOPERFAILED;
+
+	} else {
+		if (wErrCode_isError(err = converting(&hdr))) {
+			// ERROR!
+			fprintf(stderr, "ERROR! The conversion failed\n");
+
+		} else {
+			secs = (monotonicMs() - start) / 1000.0;
+			fprintf(
+				stderr, "%lu pin rows, %lu value changes, %u ms long capture: %.1f MB in %.2f s (%.0f MB/s)\n",
+				(unsigned long)rows, (unsigned long)changes, capturePlayer_duration(), parsed / 1e6, secs,
+				(secs > 0) ? parsed / 1e6 / secs : 0
+			);
+		}
+		if (argc == 3 && close(outFd) < 0) err = WERRCODE_ERROR_IOOPERFAILED;
+	}
+	capturePlayer_close();
+
+	return(wErrCodeToShell(err));
+}
@@ -0,0 +1,326 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: captureFile.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Binary capture file of the raw serial stream. Every received chunk is appended as a compact record, so the field
+//	sessions can be analysed (or replayed) later, without anyone watching the console. File layout:
+//
+//		+--------------+---------+---------+-----+---------+-------------+--------------+
+//		| captHeader_t | record  | record  | ... | record  | captIndex_t | captFooter_t |
+//		|              |         |         |     |         | array       |              |
+//		+--------------+---------+---------+-----+---------+-------------+--------------+
+//
+//		record:  <time-stamp delta (ms)> <size> <size bytes>      (delta and size are LEB128 varints)
+//
+//	The record's time-stamp is the previous record's one plus its delta (the first record's delta is relative to the
+//	time zero of getMyEpoch(), whose wall-clock time is in the header). The sparse time index has an entry every
+//	CAPT_INDEXMS milliseconds, and it is written, with the footer, by captureFile_close(). When the footer is missing
+//	(e.g. the console has been killed) the index can be rebuilt by scanning the records.
+//	The records are collected in a CAPT_BUFFSIZE bytes buffer, and they are written by a single writev() call when
+//	it is full (or before every index entry, so a crash can lose no more than CAPT_INDEXMS of data).
+//	All the integers are in the host's byte order.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <syslog.h>
+#include <sys/uio.h>
+#include <sys/time.h>
+#include <timeUtils.h>
+#include <captureFile.h>
+
+#define CAPT_INDEXSTEP   1024               // Index's growing step (entries)
+
+static int         captFd     = -1;
+static uint8_t     *buff      = NULL;        // Records buffer
+static uint32_t    used       = 0;           // Bytes in the buffer
+static uint64_t    offset     = 0;           // Bytes written to the file
+static uint32_t    lastTime   = 0;           // Last record's time-stamp
+static uint32_t    records    = 0;
+static captIndex_t *timeIdx   = NULL;        // Sparse time index
+static uint32_t    entries    = 0;
+static uint32_t    maxEntries = 0;
+
+
+static werror fileWriting (const void *data, uint32_t size) {
+	//
+	// Description:
+	//	It writes the buffered records followed by the argument defined data (if any) with a single writev() call
+	//	(the partial writings are completed)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	struct iovec iov[2] = { { buff, used }, { (void*)data, size } };
+	struct iovec *ptr   = iov;
+	int          cnt    = (size > 0) ? 2 : 1;
+	werror       err    = WERRCODE_SUCCESS;
+
+	while (cnt > 0 && err == WERRCODE_SUCCESS) {
+		ssize_t nb = writev(captFd, ptr, cnt);
+
+		if (nb < 0) {
+			if (errno != EINTR) {
+				// ERROR!
+				syslog(LOG_ERR, "ERROR(%d)! Capture file writing failed: %s", __LINE__, strerror(errno));
+				err = WERRCODE_ERROR_IOOPERFAILED;
+			}
+		} else {
+			offset += nb;
+			while (cnt > 0 && (size_t)nb >= ptr->iov_len) {
+				nb -= ptr->iov_len;
+				ptr++;
+				cnt--;
+			}
+			if (cnt > 0) {
+				ptr->iov_base  = (uint8_t*)ptr->iov_base + nb;
+				ptr->iov_len  -= nb;
+			}
+		}
+	}
+	used = 0;
+
+	return(err);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+uint8_t varint_put (uint8_t *ptr, uint32_t value) {
+	//
+	// Description:
+	//	It writes the argument defined value as LEB128 varint (7 bits per byte, the MSB is the "more bytes" flag)
+	//
+	// Returned value:
+	//	The number of written bytes (1..5)
+	//
+	uint8_t n = 0;
+
+	while (value >= 0x80) {
+		ptr[n++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	ptr[n++] = value;
+
+	return(n);
+}
+
+
+uint8_t varint_get (const uint8_t *ptr, uint64_t size, uint32_t *value) {
+	//
+	// Description:
+	//	It reads a LEB128 varint from the argument defined buffer (no more than size bytes are read)
+	//
+	// Returned value:
+	//	The number of read bytes (1..5), or 0 when the varint is truncated or too long
+	//
+	uint8_t n = 0;
+
+	*value = 0;
+	while (n < size && n < 5 && (ptr[n] & 0x80)) {
+		*value |= (uint32_t)(ptr[n] & 0x7F) << (7 * n);
+		n++;
+	}
+	if (n < size && n < 5) {
+		*value |= (uint32_t)ptr[n] << (7 * n);
+		n++;
+	} else
+		n = 0;
+
+	return(n);
+}
+
+
+werror captureFile_open (const char *path, uint32_t ttySpeed, const char *target) {
+	//
+	// Description:
+	//	It creates (or truncates) the argument defined capture file, and it writes the header
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror         err = WERRCODE_SUCCESS;
+	captHeader_t   hdr;
+	struct timeval tv;
+	uint32_t       now = 0;
+
+	memset(&hdr, 0, sizeof(hdr));
+	strcpy(hdr.magic, CAPT_MAGIC);
+	hdr.version  = CAPT_VERSION;
+	hdr.hdrSize  = sizeof(hdr);
+	hdr.ttySpeed = ttySpeed;
+	strncpy(hdr.target, target, sizeof(hdr.target) - 1);
+	getMyEpoch(&now);
+	gettimeofday(&tv, NULL);
+	hdr.wallClock = ((uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000) - now;
+
+	used = records = entries = 0;
+	offset = 0;
+	lastTime = 0;
+
+	if ((buff = malloc(CAPT_BUFFSIZE)) == NULL) {
+		// ERROR!
+		err = WERRCODE_ERROR_OUTOFMEMORY;
+
+	} else if ((captFd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! I cannot create the \"%s\" capture file: %s\n", path, strerror(errno));
+		err = WERRCODE_ERROR_IOOPERFAILED;
+
+	} else {
+		memcpy(buff, &hdr, sizeof(hdr));
+		used = sizeof(hdr);
+		err  = fileWriting(NULL, 0);
+	}
+
+	if (wErrCode_isError(err)) {
+		if (captFd >= 0) close(captFd);
+		free(buff);
+		captFd = -1;
+		buff   = NULL;
+	}
+
+	return(err);
+}
+
+
+werror captureFile_add (uint32_t tstamp, const char *data, uint32_t size) {
+	//
+	// Description:
+	//	It appends the argument defined chunk as a new record. Nothing is done when no capture file has been opened.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror  err = WERRCODE_SUCCESS;
+	uint8_t recHdr[CAPT_MAXRECHDR];
+	uint8_t n;
+
+	if (captFd < 0 || size == 0) {
+		// Nothing to do
+
+	} else {
+		// Sparse time index updating (the buffer is flushed, so the entry points to a record in the file)
+		if (records == 0 || (tstamp - timeIdx[entries - 1].tstamp) >= CAPT_INDEXMS) {
+			if (entries == maxEntries) {
+				captIndex_t *ptr = realloc(timeIdx, (maxEntries + CAPT_INDEXSTEP) * sizeof(captIndex_t));
+
+				if (ptr == NULL) {
+					// ERROR!
+					err = WERRCODE_ERROR_OUTOFMEMORY;
+				} else {
+					timeIdx     = ptr;
+					maxEntries += CAPT_INDEXSTEP;
+				}
+			}
+			if (err == WERRCODE_SUCCESS && (used == 0 || (err = fileWriting(NULL, 0)) == WERRCODE_SUCCESS)) {
+				timeIdx[entries].tstamp  = tstamp;
+				timeIdx[entries].records = records;
+				timeIdx[entries].offset  = offset;
+				entries++;
+			}
+		}
+
+		if (err == WERRCODE_SUCCESS) {
+			n  = varint_put(recHdr, tstamp - lastTime);
+			n += varint_put(recHdr + n, size);
+
+			if ((used + n + size) <= CAPT_BUFFSIZE) {
+				memcpy(buff + used, recHdr, n);
+				memcpy(buff + used + n, data, size);
+				used += n + size;
+
+			} else {
+				// The buffer is full: the buffered records, the new record's header and its data are written
+				// together (no copies)
+				if ((used + n) > CAPT_BUFFSIZE) err = fileWriting(NULL, 0);
+				if (err == WERRCODE_SUCCESS) {
+					memcpy(buff + used, recHdr, n);
+					used += n;
+					err = fileWriting(data, size);
+				}
+			}
+			lastTime = tstamp;
+			records++;
+		}
+	}
+
+	return(err);
+}
+
+
+werror captureFile_close () {
+	//
+	// Description:
+	//	It writes the buffered records, the sparse time index and the footer, then the file is closed
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror       err = WERRCODE_SUCCESS;
+	captFooter_t ftr;
+
+	if (captFd >= 0) {
+		memset(&ftr, 0, sizeof(ftr));
+		strcpy(ftr.magic, CAPT_IDXMAGIC);
+		ftr.entries = entries;
+		ftr.records = records;
+
+		if ((err = fileWriting(NULL, 0)) == WERRCODE_SUCCESS) {
+			ftr.offset = offset;
+			if (entries > 0) err = fileWriting(timeIdx, entries * sizeof(captIndex_t));
+		}
+		if (err == WERRCODE_SUCCESS) err = fileWriting(&ftr, sizeof(ftr));
+
+		if (close(captFd) < 0) {
+			// ERROR!
+			err = WERRCODE_ERROR_IOOPERFAILED;
+		}
+		free(buff);
+		free(timeIdx);
+		captFd     = -1;
+		buff       = NULL;
+		timeIdx    = NULL;
+		maxEntries = 0;
+	}
+
+	return(err);
+}
+
+
+bool captureFile_isOpen () {
+	return(captFd >= 0);
+}
@@ -0,0 +1,94 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: captureFile.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Binary capture file of the raw serial stream. Every received chunk is appended as a compact record, so the field
+//	sessions can be analysed (or replayed) later, without anyone watching the console. File layout:
+//
+//		+--------------+---------+---------+-----+---------+-------------+--------------+
+//		| captHeader_t | record  | record  | ... | record  | captIndex_t | captFooter_t |
+//		|              |         |         |     |         | array       |              |
+//		+--------------+---------+---------+-----+---------+-------------+--------------+
+//
+//		record:  <time-stamp delta (ms)> <size> <size bytes>      (delta and size are LEB128 varints)
+//
+//	The record's time-stamp is the previous record's one plus its delta (the first record's delta is relative to the
+//	time zero of getMyEpoch(), whose wall-clock time is in the header). The sparse time index has an entry every
+//	CAPT_INDEXMS milliseconds, and it is written, with the footer, by captureFile_close(). When the footer is missing
+//	(e.g. the console has been killed) the index can be rebuilt by scanning the records.
+//	The records are collected in a CAPT_BUFFSIZE bytes buffer, and they are written by a single writev() call when
+//	it is full (or before every index entry, so a crash can lose no more than CAPT_INDEXMS of data).
+//	All the integers are in the host's byte order.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef CAPTUREFILE_UT
+#define CAPTUREFILE_UT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <werror.h>
+
+#define CAPT_MAGIC       "DBGCAPT"          // Header's magic string (8 bytes, '\0' included)
+#define CAPT_IDXMAGIC    "DBGCIDX"          // Footer's magic string
+#define CAPT_VERSION     1
+#define CAPT_BUFFSIZE    (256 * 1024)
+#define CAPT_INDEXMS     1000               // Time distance between two index entries (ms)
+#define CAPT_MAXRECHDR   10                 // Max size of the record's header (two 32-bits varints)
+
+// File header
+typedef struct {
+	char     magic[8];
+	uint16_t version;
+	uint16_t hdrSize;                 // sizeof(captHeader_t)
+	uint32_t ttySpeed;                // Serial port's speed (bps)
+	char     target[8];               // Target MCU family ("ESP32", "AVR8")
+	uint64_t wallClock;               // Epoch time (ms) of the time-stamps' zero
+} captHeader_t;
+
+// Sparse time index's entry
+typedef struct {
+	uint32_t tstamp;                  // Time-stamp of the indexed record (ms)
+	uint32_t records;                 // Number of records before the indexed one
+	uint64_t offset;                  // Record's file offset
+} captIndex_t;
+
+// File footer
+typedef struct {
+	char     magic[8];
+	uint64_t offset;                  // Index's file offset (it is the end of the records too)
+	uint32_t entries;                 // Number of index entries
+	uint32_t records;                 // Total number of records
+} captFooter_t;
+
+werror captureFile_open   (const char *path, uint32_t ttySpeed, const char *target);
+werror captureFile_add    (uint32_t tstamp, const char *data, uint32_t size);
+werror captureFile_close  ();
+bool   captureFile_isOpen ();
+
+uint8_t varint_put (uint8_t *buff, uint32_t value);
+uint8_t varint_get (const uint8_t *buff, uint64_t size, uint32_t *value);
+
+#endif
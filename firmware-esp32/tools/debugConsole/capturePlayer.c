@@ -0,0 +1,429 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: capturePlayer.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Capture file reader (see captureFile.h for the file layout). The file is mapped in memory (mmap), so opening it
+//	costs the same for a few KB and for several GB: only the header, the footer and the sparse time index are read,
+//	and the records' pages are loaded by the kernel when they are played.
+//	capturePlayer_seek() performs a binary search on the sparse time index, then it scans no more than CAPT_INDEXMS
+//	of records. When the footer is missing (the recording console has been killed) the index is rebuilt by scanning
+//	the records once, and a truncated last record is ignored. The same happens when the index's entries are not
+//	consistent (corrupted file).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <capturePlayer.h>
+
+#define PLAY_INDEXSTEP   1024               // Rebuilt index's growing step (entries)
+
+// Reading position
+typedef struct {
+	uint64_t offset;                  // Next record's offset
+	uint32_t tstamp;                  // Previous record's time-stamp
+} playPos_t;
+
+static uint8_t           *map     = NULL;   // Mapped file
+static uint64_t          mapSize  = 0;
+static uint64_t          recEnd   = 0;      // End of the records
+static const captIndex_t *timeIdx = NULL;   // Sparse time index
+static captIndex_t       *idxBuff = NULL;   // File's index copy (or the rebuilt one, when it is missing or corrupted)
+static uint32_t          entries  = 0;
+static uint32_t          duration = 0;      // Last record's time-stamp
+static playPos_t         pos;
+
+
+static bool recordDecoding (playPos_t *p, uint32_t *tstamp, const uint8_t **data, uint32_t *size) {
+	//
+	// Description:
+	//	It decodes the record at the argument defined position, and it moves the position to the next one
+	//
+	// Returned value:
+	//	false when there are no more (complete) records
+	//
+	uint32_t delta = 0;
+	uint8_t  n1, n2 = 0;
+	bool     flag  = false;
+
+	if ((n1 = varint_get(map + p->offset, recEnd - p->offset, &delta)) > 0 &&
+	    (n2 = varint_get(map + p->offset + n1, recEnd - p->offset - n1, size)) > 0 &&
+	    (p->offset + n1 + n2 + *size) <= recEnd) {
+		*data      = map + p->offset + n1 + n2;
+		*tstamp    = p->tstamp + delta;
+		p->tstamp  = *tstamp;
+		p->offset += n1 + n2 + *size;
+		flag       = true;
+	}
+
+	return(flag);
+}
+
+
+static werror indexRebuilding () {
+	//
+	// Description:
+	//	It scans every record to rebuild the sparse time index (the footer is missing, or the index is corrupted)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror        err = WERRCODE_SUCCESS;
+	playPos_t     p   = pos;
+	uint32_t      tstamp, size, records = 0, maxEntries = 0;
+	const uint8_t *data;
+	uint64_t      offset = p.offset;
+
+	while (err == WERRCODE_SUCCESS && recordDecoding(&p, &tstamp, &data, &size)) {
+		if (entries == 0 || (tstamp - idxBuff[entries - 1].tstamp) >= CAPT_INDEXMS) {
+			if (entries == maxEntries) {
+				captIndex_t *ptr = realloc(idxBuff, (maxEntries + PLAY_INDEXSTEP) * sizeof(captIndex_t));
+
+				if (ptr == NULL) {
+					// ERROR!
+					err = WERRCODE_ERROR_OUTOFMEMORY;
+				} else {
+					idxBuff     = ptr;
+					maxEntries += PLAY_INDEXSTEP;
+				}
+			}
+			if (err == WERRCODE_SUCCESS) {
+				idxBuff[entries].tstamp  = tstamp;
+				idxBuff[entries].records = records;
+				idxBuff[entries].offset  = offset;
+				entries++;
+			}
+		}
+		offset = p.offset;
+		records++;
+	}
+	// A truncated last record is ignored
+	recEnd  = offset;
+	timeIdx = idxBuff;
+
+	return(err);
+}
+
+
+static bool indexLoading (const captFooter_t *ftr, uint16_t hdrSize) {
+	//
+	// Description:
+	//	It copies the file's sparse time index (the mapped one can be unaligned), and it checks its entries: the offsets
+	//	must be increasing and inside the records, the time-stamps must not decrease.
+	//
+	// Returned value:
+	//	false when the index is corrupted (or there is no memory for its copy)
+	//
+	bool flag = (ftr->entries > 0 && (idxBuff = malloc((size_t)ftr->entries * sizeof(captIndex_t))) != NULL);
+
+	if (flag) memcpy(idxBuff, map + ftr->offset, (size_t)ftr->entries * sizeof(captIndex_t));
+
+	for (uint32_t t = 0; flag && t < ftr->entries; t++) {
+		if (idxBuff[t].offset < hdrSize || idxBuff[t].offset >= ftr->offset) flag = false;
+		else if (t > 0 && (idxBuff[t].offset <= idxBuff[t - 1].offset || idxBuff[t].tstamp < idxBuff[t - 1].tstamp)) flag = false;
+	}
+
+	if (flag) {
+		timeIdx = idxBuff;
+		entries = ftr->entries;
+	} else {
+		free(idxBuff);
+		idxBuff = NULL;
+	}
+
+	return(flag);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+werror capturePlayer_open (const char *path, captHeader_t *hdr) {
+	//
+	// Description:
+	//	It maps the argument defined capture file, and it copies its header in the argument defined structure. The
+	//	reading position is set to the first record.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_FILENOTFOUND
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//	WERRCODE_ERROR_INVALIDDATA    It is not a capture file
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror       err = WERRCODE_SUCCESS;
+	struct stat  st;
+	int          fd;
+	captFooter_t ftr;
+	bool         footer;
+
+	capturePlayer_close();
+
+	if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! I cannot open the \"%s\" capture file: %s\n", path, strerror(errno));
+		err = WERRCODE_ERROR_FILENOTFOUND;
+
+	} else if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(captHeader_t)) {
+		// ERROR!
+		fprintf(stderr, "ERROR! \"%s\" is not a capture file\n", path);
+		err = WERRCODE_ERROR_INVALIDDATA;
+
+	} else if ((map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+		// ERROR!
+		fprintf(stderr, "ERROR! mmap() failed: %s\n", strerror(errno));
+		map = NULL;
+		err = WERRCODE_ERROR_IOOPERFAILED;
+
+	} else {
+		memcpy(hdr, map, sizeof(captHeader_t));
+		mapSize = st.st_size;
+
+		if (memcmp(hdr->magic, CAPT_MAGIC, sizeof(CAPT_MAGIC)) != 0 || hdr->version != CAPT_VERSION ||
+		    hdr->hdrSize < sizeof(captHeader_t) || hdr->hdrSize > mapSize) {
+			// ERROR!
+			fprintf(stderr, "ERROR! \"%s\" is not a capture file (or its version is not supported)\n", path);
+			err = WERRCODE_ERROR_INVALIDDATA;
+
+		} else {
+			pos.offset = hdr->hdrSize;
+			pos.tstamp = 0;
+			memset(&ftr, 0, sizeof(captFooter_t));
+			if (mapSize >= hdr->hdrSize + sizeof(captFooter_t)) memcpy(&ftr, map + mapSize - sizeof(captFooter_t), sizeof(captFooter_t));
+
+			footer = (
+				memcmp(ftr.magic, CAPT_IDXMAGIC, sizeof(CAPT_IDXMAGIC)) == 0 && ftr.offset >= hdr->hdrSize &&
+				ftr.offset + (uint64_t)ftr.entries * sizeof(captIndex_t) + sizeof(captFooter_t) == mapSize
+			);
+			recEnd = footer ? ftr.offset : mapSize;
+
+			if (footer == false || indexLoading(&ftr, hdr->hdrSize) == false)
+				// WARNING! Incomplete (or corrupted) capture file
+				err = indexRebuilding();
+		}
+
+		// Duration: the records after the last index entry are scanned
+		if (err == WERRCODE_SUCCESS && entries > 0) {
+			playPos_t     p = pos;
+			const uint8_t *data;
+			uint32_t      size;
+
+			capturePlayer_seek(timeIdx[entries - 1].tstamp);
+			while (recordDecoding(&pos, &duration, &data, &size));
+			pos = p;
+		}
+	}
+
+	if (fd >= 0) close(fd);
+	if (wErrCode_isError(err)) capturePlayer_close();
+
+	return(err);
+}
+
+
+werror capturePlayer_next (uint32_t *tstamp, const uint8_t **data, uint32_t *size) {
+	//
+	// Description:
+	//	It returns the next record (the data are in the mapped file, they are valid until capturePlayer_close())
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   End of the capture
+	//
+	werror err = WERRCODE_WARNING_ITNOTFOUND;
+
+	if (map != NULL && recordDecoding(&pos, tstamp, data, size))
+		err = WERRCODE_SUCCESS;
+
+	return(err);
+}
+
+
+werror capturePlayer_seek (uint32_t tstamp) {
+	//
+	// Description:
+	//	It moves the reading position to the first record whose time-stamp is equal or greater than the argument
+	//	defined one (binary search on the sparse index, then a short scan).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   No records (the position is the capture's end)
+	//
+	werror        err = WERRCODE_WARNING_ITNOTFOUND;
+	uint32_t      lo = 0, hi = entries, delta = 0;
+	playPos_t     p;
+	uint32_t      t, size;
+	const uint8_t *data;
+
+	if (map != NULL && entries > 0) {
+		// Last entry whose time-stamp is not greater than the argument defined one
+		while (hi - lo > 1) {
+			uint32_t mid = (lo + hi) / 2;
+
+			if (timeIdx[mid].tstamp <= tstamp) lo = mid;
+			else                               hi = mid;
+		}
+
+		// The record's delta is relative to the previous record
+		varint_get(map + timeIdx[lo].offset, recEnd - timeIdx[lo].offset, &delta);
+		pos.offset = timeIdx[lo].offset;
+		pos.tstamp = timeIdx[lo].tstamp - delta;
+
+		// Short scan
+		p = pos;
+		while (recordDecoding(&p, &t, &data, &size) && t < tstamp) pos = p;
+		if (pos.offset < recEnd) err = WERRCODE_SUCCESS;
+
+		// The following records' pages are loaded in advance (smooth scrubbing)
+		p.offset = pos.offset & ~(uint64_t)(sysconf(_SC_PAGESIZE) - 1);
+		madvise(map + p.offset, (mapSize - p.offset < PLAY_PREFETCH) ? mapSize - p.offset : PLAY_PREFETCH, MADV_WILLNEED);
+	}
+
+	return(err);
+}
+
+
+void capturePlayer_drop () {
+	//
+	// Description:
+	//	It releases the memory pages of the records already read (they are loaded from the file again if they are
+	//	needed), so a sequential reading of a huge capture uses a constant amount of memory
+	//
+	capturePlayer_release(0, pos.offset);
+
+	return;
+}
+
+
+void capturePlayer_release (uint64_t start, uint64_t end) {
+	//
+	// Description:
+	//	It releases the memory pages between the argument defined offsets (only the whole pages are released, so the
+	//	pages shared with the near chunks are kept)
+	//
+	uint64_t page = sysconf(_SC_PAGESIZE);
+
+	start = (start + page - 1) & ~(page - 1);
+	end   = end & ~(page - 1);
+	if (map != NULL && end > start) madvise(map + start, end - start, MADV_DONTNEED);
+
+	return;
+}
+
+
+uint32_t capturePlayer_split (playChunk_t *chunks, uint32_t max) {
+	//
+	// Description:
+	//	It cuts the records in no more than the argument defined number of chunks. The chunks begin at the sparse
+	//	index's entries, the nearest ones to the equal-size cut points.
+	//
+	// Returned value:
+	//	The number of chunks (zero when there are no records)
+	//
+	uint32_t n = 0, delta, lo, hi;
+	uint64_t start, target;
+
+	for (uint32_t k = 0; map != NULL && k < max && entries > 0; k++) {
+		// First entry whose offset is not less than the cut point
+		start  = timeIdx[0].offset;
+		target = start + (recEnd - start) * k / max;
+		for (lo = 0, hi = entries; lo < hi;) {
+			uint32_t mid = (lo + hi) / 2;
+
+			if (timeIdx[mid].offset < target) lo = mid + 1;
+			else                              hi = mid;
+		}
+
+		if (lo < entries && (n == 0 || timeIdx[lo].offset > chunks[n - 1].offset)) {
+			// The record's delta is relative to the previous record
+			delta = 0;
+			varint_get(map + timeIdx[lo].offset, recEnd - timeIdx[lo].offset, &delta);
+			chunks[n].offset = timeIdx[lo].offset;
+			chunks[n].tstamp = timeIdx[lo].tstamp - delta;
+			if (n > 0) chunks[n - 1].end = chunks[n].offset;
+			n++;
+		}
+	}
+	if (n > 0) chunks[n - 1].end = recEnd;
+
+	return(n);
+}
+
+
+werror capturePlayer_read (playChunk_t *chunk, uint32_t *tstamp, const uint8_t **data, uint32_t *size) {
+	//
+	// Description:
+	//	It returns the argument defined chunk's next record (see capturePlayer_next()). The capture's position is not
+	//	changed, so the function can be called by several threads (a chunk per thread).
+	//	The chunk's end can be moved forward by the caller, to read the beginning of the following chunk.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   End of the chunk
+	//
+	werror    err = WERRCODE_WARNING_ITNOTFOUND;
+	playPos_t p   = { chunk->offset, chunk->tstamp };
+
+	if (map != NULL && chunk->offset < chunk->end && recordDecoding(&p, tstamp, data, size)) {
+		chunk->offset = p.offset;
+		chunk->tstamp = p.tstamp;
+		err           = WERRCODE_SUCCESS;
+	}
+
+	return(err);
+}
+
+
+uint32_t capturePlayer_duration () {
+	//
+	// Description:
+	//	It returns the time-stamp of the capture's last record (ms)
+	//
+	return(duration);
+}
+
+
+void capturePlayer_close () {
+	//
+	// Description:
+	//	It unmaps the capture file
+	//
+	if (map != NULL) munmap(map, mapSize);
+	free(idxBuff);
+	map      = NULL;
+	idxBuff  = NULL;
+	timeIdx  = NULL;
+	mapSize  = recEnd = 0;
+	entries  = duration = 0;
+
+	return;
+}
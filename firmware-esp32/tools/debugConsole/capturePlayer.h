@@ -0,0 +1,65 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: capturePlayer.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Capture file reader (see captureFile.h for the file layout). The file is mapped in memory (mmap), so opening it
+//	costs the same for a few KB and for several GB: only the header, the footer and the sparse time index are read,
+//	and the records' pages are loaded by the kernel when they are played.
+//	capturePlayer_seek() performs a binary search on the sparse time index, then it scans no more than CAPT_INDEXMS
+//	of records. When the footer is missing (the recording console has been killed) the index is rebuilt by scanning
+//	the records once, and a truncated last record is ignored.
+//	capturePlayer_split() cuts the records in chunks at the sparse index's entries (balanced by size): every chunk
+//	has its own reading position, so the chunks can be read by several threads at the same time (see
+//	capturePlayer_read()).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef CAPTUREPLAYER_UT
+#define CAPTUREPLAYER_UT
+
+#include <stdint.h>
+#include <werror.h>
+#include <captureFile.h>
+
+#define PLAY_PREFETCH    (1024 * 1024)      // Bytes the kernel is asked to load after a seek
+
+// Records' chunk
+typedef struct {
+	uint64_t offset;                  // Next record's offset
+	uint64_t end;                     // Chunk's end (first record of the next chunk)
+	uint32_t tstamp;                  // Previous record's time-stamp
+} playChunk_t;
+
+werror   capturePlayer_open     (const char *path, captHeader_t *hdr);
+werror   capturePlayer_next     (uint32_t *tstamp, const uint8_t **data, uint32_t *size);
+werror   capturePlayer_seek     (uint32_t tstamp);
+uint32_t capturePlayer_duration ();
+void     capturePlayer_drop     ();
+uint32_t capturePlayer_split    (playChunk_t *chunks, uint32_t max);
+werror   capturePlayer_read     (playChunk_t *chunk, uint32_t *tstamp, const uint8_t **data, uint32_t *size);
+void     capturePlayer_release  (uint64_t start, uint64_t end);
+void     capturePlayer_close    ();
+
+#endif
@@ -0,0 +1,744 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: captureStats.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Offline capture analyser: it scans a capture file (see captureFile.h) once, and it reports, for every pin, the
+//	toggles count, the high/low duty cycle, the min/max/percentile widths of the low and high pulses, and the bounce
+//	bursts (runs of pulses shorter than the bounce time). The same pass counts the log messages by template (the
+//	message whose numbers have been replaced by '#'). The pins whose switch bounces are listed at the end, so the
+//	flaky switches of the harness can be found in long field recordings.
+//
+//	Use: captureStats [-j <threads>] [-b <bounce time (ms)>] [-n <templates>] [-H] <capture file>
+//		-j   Number of threads (the CPU cores by default, up to STATS_MAXTHREADS)
+//		-b   Pulses shorter than this time are bounces (STATS_BOUNCEMS by default)
+//		-n   Number of the most frequent templates reported (STATS_TOPTMPLS by default)
+//		-H   The pulses' widths histograms are printed too
+//
+//	Multi-threading:
+//		The records are cut in a chunk per thread at the sparse time index's entries (see capturePlayer_split()),
+//		every thread streams its chunk through its own row builder (see stringBuilder_hPut()) and the pin
+//		parser, and it collects a partial result. The partial results are merged in the chunks' order: for every pin
+//		the partial keeps its first and last rows and its first and last transitions, so the pulses across the chunks'
+//		boundaries are completed by the merge.
+//		A row split between two chunks belongs to the first one: a thread completes its last row with the following
+//		chunk's bytes up to the first end of row, and the next thread skips them.
+//		The rows of the symbols map announced by the firmware (see ptsMap.h) are not log messages: every thread keeps
+//		them, and they are passed to ptsCache_row() in the chunks' order by the merge, so the pins are reported by the
+//		firmware's symbols (the table of the local checkout is used when the capture has no announcement).
+//
+//	Pulses' widths histogram:
+//		The widths (ms) lower than STATS_EXACTMS have an exact bucket, the greater ones have STATS_SUBBUCKETS buckets
+//		per power of two. The percentiles are the lower bounds of their buckets (12.5% max error).
+//
+//	Symbols:
+//		STATS_MAXTHREADS   Max number of threads
+//		STATS_BOUNCEMS     Default bounce time (ms)
+//		STATS_TOPTMPLS     Default number of the reported templates
+//		STATS_MAXTMPLS     Templates' hash table size (the messages of the templates that do not fit are "others")
+//		STATS_TMPLSIZE     Max template's length (longer templates are truncated)
+//		STATS_DROPSIZE     Capture's bytes read between two pages releases
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <pinToSymbol.h>
+#include <ptsMap.h>
+#include <ptsCache.h>
+#include <stringBuilder.h>
+#include <captureFile.h>
+#include <capturePlayer.h>
+#include <timeUtils.h>
+
+#define STATS_MAXTHREADS   64
+#define STATS_BOUNCEMS     20
+#define STATS_TOPTMPLS     20
+#define STATS_MAXTMPLS     4096               // It must be a power of two
+#define STATS_TMPLSIZE     96
+#define STATS_DROPSIZE     (16 * 1024 * 1024)
+#define STATS_MAXCHUNK     4096               // Max bytes added to the row builder by a single call
+#define STATS_EXACTMS      64                 // It must be a power of two
+#define STATS_SUBBUCKETS   8                  // It must be a power of two
+#define STATS_EXACTBITS    6                  // log2(STATS_EXACTMS)
+#define STATS_SUBBITS      3                  // log2(STATS_SUBBUCKETS)
+#define STATS_BUCKETS      (STATS_EXACTMS + (32 - STATS_EXACTBITS) * STATS_SUBBUCKETS)
+
+// Pulses' sequence summary (the runs of short pulses are the bounce bursts)
+typedef struct {
+	uint64_t pulses;
+	uint64_t shorts;                  // Pulses shorter than the bounce time
+	uint64_t bursts;                  // Runs of short pulses
+	uint64_t prefix;                  // Short pulses at the sequence's beginning
+	uint64_t suffix;                  // Short pulses at the sequence's end
+	uint64_t longest;                 // Longest run
+} bounceSeq_t;
+
+// Pulses' widths
+typedef struct {
+	uint64_t count;
+	uint32_t min;
+	uint32_t max;
+	uint32_t hist[STATS_BUCKETS];
+} pulseStats_t;
+
+// Pin's statistics (the level is low when the value is zero)
+typedef struct {
+	bool         seen;
+	bool         changed;             // At least a transition has been found
+	bool         wide;                // Values greater than 1 (e.g. ADC channel)
+	uint8_t      firstLev;            // First row's level
+	uint8_t      lastLev;             // Last row's level
+	uint32_t     firstT;              // First row's time
+	uint32_t     lastT;               // Last row's time
+	uint32_t     firstChangeT;        // First transition's time
+	uint32_t     lastChangeT;         // Last transition's time
+	uint32_t     minV;
+	uint32_t     maxV;
+	uint64_t     rows;
+	uint64_t     toggles;
+	uint64_t     levelMs[2];          // Time spent at low/high level
+	pulseStats_t pulses[2];           // Low/high pulses
+	bounceSeq_t  bounces;
+} pinStats_t;
+
+// Log message's template
+typedef struct {
+	uint64_t hash;
+	uint64_t count;
+	char     text[STATS_TMPLSIZE];
+} tmplStats_t;
+
+// Chunk's partial result
+typedef struct {
+	playChunk_t     chunk;
+	bool            skipHead;         // The chunk's first bytes (up to the first end of row) belong to the previous one
+	stringBuilder_t *builder;         // Thread's row builder
+	pinStats_t      *pins;            // PTS_MAXPINID items
+	tmplStats_t     *tmpls;           // STATS_MAXTMPLS items (hash table)
+	uint32_t        tmplsUsed;
+	uint64_t        others;           // Messages whose template has not been stored
+	char            **maps;           // Symbols map announcement's rows
+	uint32_t        mapRows;
+	uint32_t        mapsSize;         // Allocated items of maps
+	uint64_t        pinRows;
+	uint64_t        logRows;
+	uint64_t        bytes;
+	werror          err;
+} partial_t;
+
+// Global vars
+static uint32_t bounceMs = STATS_BOUNCEMS;
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                                  F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+
+uint32_t bucketOf (uint32_t width) {
+	//
+	// Description:
+	//	It returns the histogram's bucket of the argument defined width
+	//
+	uint8_t msb;
+
+	if (width < STATS_EXACTMS) return(width);
+	msb = 31 - __builtin_clz(width);
+
+	return(STATS_EXACTMS + (msb - STATS_EXACTBITS) * STATS_SUBBUCKETS + ((width >> (msb - STATS_SUBBITS)) & (STATS_SUBBUCKETS - 1)));
+}
+
+
+uint32_t bucketLow (uint32_t bucket) {
+	//
+	// Description:
+	//	It returns the lowest width of the argument defined histogram's bucket
+	//
+	uint8_t msb;
+
+	if (bucket < STATS_EXACTMS) return(bucket);
+	msb = STATS_EXACTBITS + (bucket - STATS_EXACTMS) / STATS_SUBBUCKETS;
+
+	return((1u << msb) + (((bucket - STATS_EXACTMS) % STATS_SUBBUCKETS) << (msb - STATS_SUBBITS)));
+}
+
+
+bounceSeq_t seqJoining (bounceSeq_t a, bounceSeq_t b) {
+	//
+	// Description:
+	//	It returns the summary of the a-sequence followed by the b-sequence (the runs at the junction are joined)
+	//
+	bounceSeq_t r;
+
+	if (a.pulses == 0) return(b);
+	if (b.pulses == 0) return(a);
+
+	r.pulses  = a.pulses + b.pulses;
+	r.shorts  = a.shorts + b.shorts;
+	r.bursts  = a.bursts + b.bursts - ((a.suffix > 0 && b.prefix > 0) ? 1 : 0);
+	r.prefix  = (a.prefix == a.pulses) ? a.pulses + b.prefix : a.prefix;
+	r.suffix  = (b.suffix == b.pulses) ? b.pulses + a.suffix : b.suffix;
+	r.longest = (a.longest > b.longest) ? a.longest : b.longest;
+	if (a.suffix + b.prefix > r.longest) r.longest = a.suffix + b.prefix;
+
+	return(r);
+}
+
+
+void pulseAdding (pinStats_t *s, uint8_t level, uint32_t width) {
+	//
+	// Description:
+	//	It adds the argument defined pulse (a level between two transitions) to the pin's statistics
+	//
+	pulseStats_t *p = &s->pulses[level];
+	uint64_t     sh = (width < bounceMs) ? 1 : 0;
+	bounceSeq_t  one = { 1, sh, sh, sh, sh, sh };
+
+	if (p->count == 0 || width < p->min) p->min = width;
+	if (p->count == 0 || width > p->max) p->max = width;
+	p->hist[bucketOf(width)]++;
+	p->count++;
+	s->bounces = seqJoining(s->bounces, one);
+
+	return;
+}
+
+
+void transitionAdding (pinStats_t *s, uint32_t tstamp) {
+	//
+	// Description:
+	//	It records a transition at the argument defined time: the pulse started by the previous transition is
+	//	completed (the pin's last level is the pulse's one)
+	//
+	if (s->changed)
+		pulseAdding(s, s->lastLev, tstamp - s->lastChangeT);
+	else {
+		s->changed      = true;
+		s->firstChangeT = tstamp;
+	}
+	s->lastChangeT = tstamp;
+	s->toggles++;
+
+	return;
+}
+
+
+void rowAdding (pinStats_t *s, uint32_t value, uint32_t tstamp) {
+	//
+	// Description:
+	//	It adds the argument defined pin's row to its statistics
+	//
+	uint8_t level = (value != 0);
+
+	if (s->seen == false) {
+		s->seen     = true;
+		s->firstT   = s->lastT   = tstamp;
+		s->firstLev = s->lastLev = level;
+		s->minV     = s->maxV    = value;
+
+	} else {
+		s->levelMs[s->lastLev] += tstamp - s->lastT;
+		if (level != s->lastLev) transitionAdding(s, tstamp);
+		s->lastT   = tstamp;
+		s->lastLev = level;
+		if (value < s->minV) s->minV = value;
+		if (value > s->maxV) s->maxV = value;
+	}
+	s->wide |= (value > 1);
+	s->rows++;
+
+	return;
+}
+
+
+void pinMerging (pinStats_t *a, const pinStats_t *b) {
+	//
+	// Description:
+	//	It merges the b-statistics (the following chunk's ones) in the a-statistics
+	//
+	if (b->seen == false) return;
+	if (a->seen == false) {
+		*a = *b;
+		return;
+	}
+
+	// From the a's last row to the b's first one, and the transition between them
+	a->levelMs[a->lastLev] += b->firstT - a->lastT;
+	if (b->firstLev != a->lastLev) {
+		transitionAdding(a, b->firstT);
+		a->lastLev = b->firstLev;
+	}
+
+	// The pulse open at the a's end is completed by the b's first transition
+	if (b->changed) {
+		transitionAdding(a, b->firstChangeT);
+		a->toggles--;                               // It is counted by the b's toggles
+		a->lastChangeT = b->lastChangeT;
+
+		for (uint8_t l = 0; l < 2; l++) {
+			pulseStats_t *p = &a->pulses[l];
+			const pulseStats_t *q = &b->pulses[l];
+
+			if (q->count > 0) {
+				if (p->count == 0 || q->min < p->min) p->min = q->min;
+				if (p->count == 0 || q->max > p->max) p->max = q->max;
+				for (uint32_t t = 0; t < STATS_BUCKETS; t++) p->hist[t] += q->hist[t];
+				p->count += q->count;
+			}
+		}
+		a->bounces = seqJoining(a->bounces, b->bounces);
+	}
+
+	a->toggles    += b->toggles;
+	a->levelMs[0] += b->levelMs[0];
+	a->levelMs[1] += b->levelMs[1];
+	a->rows       += b->rows;
+	a->lastT       = b->lastT;
+	a->lastLev     = b->lastLev;
+	a->wide       |= b->wide;
+	if (b->minV < a->minV) a->minV = b->minV;
+	if (b->maxV > a->maxV) a->maxV = b->maxV;
+
+	return;
+}
+
+
+void tmplAdding (partial_t *r, const char *text, uint64_t hash, uint64_t count) {
+	//
+	// Description:
+	//	It adds the argument defined messages count to the template's one (linear probing hash table). When the
+	//	table is 3/4 full, the new templates' messages are counted as "others".
+	//
+	uint32_t slot = hash & (STATS_MAXTMPLS - 1);
+
+	while (r->tmpls[slot].count > 0 && (r->tmpls[slot].hash != hash || strcmp(r->tmpls[slot].text, text) != 0))
+		slot = (slot + 1) & (STATS_MAXTMPLS - 1);
+
+	if (r->tmpls[slot].count > 0)
+		r->tmpls[slot].count += count;
+
+	else if (r->tmplsUsed < STATS_MAXTMPLS / 4 * 3) {
+		r->tmpls[slot].hash  = hash;
+		r->tmpls[slot].count = count;
+		strcpy(r->tmpls[slot].text, text);
+		r->tmplsUsed++;
+
+	} else
+		r->others += count;
+
+	return;
+}
+
+
+void logAdding (partial_t *r, const char *msg) {
+	//
+	// Description:
+	//	It counts the argument defined log message by its template: the decimal and the hexadecimal (0x...)
+	//	numbers are replaced by '#'
+	//
+	char     text[STATS_TMPLSIZE];
+	uint32_t len  = 0;
+	uint64_t hash = 14695981039346656037ULL;               // FNV-1a
+
+	while (*msg != '\0' && len < STATS_TMPLSIZE - 1) {
+		char ch = *msg++;
+
+		if (ch >= '0' && ch <= '9') {
+			if (ch == '0' && *msg == 'x') msg++;
+			while ((*msg >= '0' && *msg <= '9') || (*msg >= 'a' && *msg <= 'f') || (*msg >= 'A' && *msg <= 'F')) msg++;
+			ch = '#';
+		}
+		text[len++] = ch;
+		hash        = (hash ^ (uint8_t)ch) * 1099511628211ULL;
+	}
+	text[len] = '\0';
+	tmplAdding(r, text, hash, 1);
+	r->logRows++;
+
+	return;
+}
+
+
+werror mapRowAdding (partial_t *r, const char *row) {
+	//
+	// Description:
+	//	It keeps the argument defined symbols map announcement's row, it will be passed to ptsCache_row() by the merge
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	char **ptr;
+
+	if (r->mapRows == r->mapsSize) {
+		// The array is full: its size is doubled
+		if ((ptr = realloc(r->maps, ((r->mapsSize == 0) ? 8 : 2 * r->mapsSize) * sizeof(char*))) == NULL)
+			return(WERRCODE_ERROR_OUTOFMEMORY);
+		r->maps     = ptr;
+		r->mapsSize = (r->mapsSize == 0) ? 8 : 2 * r->mapsSize;
+	}
+
+	if ((r->maps[r->mapRows] = strdup(row)) == NULL) return(WERRCODE_ERROR_OUTOFMEMORY);
+	r->mapRows++;
+
+	return(WERRCODE_SUCCESS);
+}
+
+
+werror bytesParsing (partial_t *r, const uint8_t *data, uint32_t size, uint32_t tstamp) {
+	//
+	// Description:
+	//	It streams the argument defined bytes through the thread's row builder, and it adds the completed rows to
+	//	the partial result
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror        err = WERRCODE_SUCCESS;
+	builderView_t row;
+	pinId_t       pin;
+	int           value;
+
+	for (uint32_t done = 0; done < size && err == WERRCODE_SUCCESS; done += STATS_MAXCHUNK) {
+		uint32_t n = (size - done < STATS_MAXCHUNK) ? size - done : STATS_MAXCHUNK;
+
+		if (wErrCode_isError(stringBuilder_hPut(r->builder, (const char*)data + done, n)))
+			// ERROR!
+			err = WERRCODE_ERROR_OUTOFMEMORY;
+
+		// The rows are zero-copy views, valid until the next stringBuilder_hPut() call
+		while (err == WERRCODE_SUCCESS && stringBuilder_hGetView(r->builder, &row) == WERRCODE_SUCCESS) {
+			if (strncmp(row.str, PTSMAP_ROWMARK, sizeof(PTSMAP_ROWMARK) - 1) == 0)
+				err = mapRowAdding(r, row.str);
+			else if (pinDef_get(row.str, &pin, &value) == WERRCODE_SUCCESS && value >= 0) {
+				rowAdding(&r->pins[pin], value, tstamp);
+				r->pinRows++;
+			} else
+				logAdding(r, row.str);
+		}
+	}
+	r->bytes += size;
+
+	return(err);
+}
+
+
+void *chunkScanning (void *arg) {
+	//
+	// Description:
+	//	Thread's body: it scans the argument defined chunk (partial_t), and it completes the chunk's last row with
+	//	the following chunk's first bytes
+	//
+	partial_t     *r      = (partial_t*)arg;
+	uint64_t      dropped = r->chunk.offset;
+	bool          skip    = r->skipHead;
+	uint32_t      tstamp, size;
+	const uint8_t *data, *eol;
+
+	stringBuilder_hClose(r->builder);
+
+	while (r->err == WERRCODE_SUCCESS && capturePlayer_read(&r->chunk, &tstamp, &data, &size) == WERRCODE_SUCCESS) {
+		if (skip) {
+			// The previous chunk's last row
+			if ((eol = memchr(data, BUILDER_ENDOFDATA, size)) == NULL) continue;
+			size -= eol + 1 - data;
+			data  = eol + 1;
+			skip  = false;
+		}
+		r->err = bytesParsing(r, data, size, tstamp);
+
+		// The released pages keep the memory usage constant
+		if (r->chunk.offset - dropped >= STATS_DROPSIZE) {
+			capturePlayer_release(dropped, r->chunk.offset);
+			dropped = r->chunk.offset;
+		}
+	}
+
+	// The last row is completed by the following bytes, up to the first end of row
+	r->chunk.end = UINT64_MAX;
+	eol          = NULL;
+	while (r->err == WERRCODE_SUCCESS && eol == NULL && capturePlayer_read(&r->chunk, &tstamp, &data, &size) == WERRCODE_SUCCESS) {
+		if ((eol = memchr(data, BUILDER_ENDOFDATA, size)) != NULL) size = eol + 1 - data;
+		r->err = bytesParsing(r, data, size, tstamp);
+	}
+	stringBuilder_hClose(r->builder);
+
+	return(NULL);
+}
+
+
+void partialMerging (partial_t *a, partial_t *b) {
+	//
+	// Description:
+	//	It merges the b-partial (the following chunk's one) in the a-partial
+	//
+	for (pinId_t pin = 0; pin < PTS_MAXPINID; pin++) pinMerging(&a->pins[pin], &b->pins[pin]);
+	for (uint32_t t = 0; t < STATS_MAXTMPLS; t++)
+		if (b->tmpls[t].count > 0) tmplAdding(a, b->tmpls[t].text, b->tmpls[t].hash, b->tmpls[t].count);
+
+	a->others  += b->others;
+	a->pinRows += b->pinRows;
+	a->logRows += b->logRows;
+	a->bytes   += b->bytes;
+
+	return;
+}
+
+
+uint32_t percentile (const pulseStats_t *p, uint8_t pc) {
+	//
+	// Description:
+	//	It returns the argument defined percentile of the pulses' widths (the lower bound of its bucket)
+	//
+	uint64_t rank = (p->count * pc + 99) / 100, sum = 0;
+	uint32_t b    = 0;
+
+	if (rank == 0) rank = 1;
+	while (b < STATS_BUCKETS - 1 && (sum += p->hist[b]) < rank) b++;
+	b = bucketLow(b);
+
+	return((b < p->min) ? p->min : (b > p->max) ? p->max : b);
+}
+
+
+void histPrinting (const pinStats_t *s) {
+	//
+	// Description:
+	//	It prints the pulses' widths histogram (low and high pulses, a row per power of two)
+	//
+	uint64_t counts[33] = { 0 }, top = 0;
+	uint32_t low;
+
+	for (uint8_t l = 0; l < 2; l++) {
+		for (uint32_t b = 0; b < STATS_BUCKETS; b++) {
+			low = bucketLow(b);
+			counts[(low == 0) ? 0 : 32 - __builtin_clz(low)] += s->pulses[l].hist[b];
+		}
+	}
+	for (uint8_t t = 0; t < 33; t++) if (counts[t] > top) top = counts[t];
+
+	for (uint8_t t = 0; t < 33; t++) {
+		if (counts[t] > 0) {
+			printf("\t\t%10u - %-10u ms %10lu  ", (t == 0) ? 0 : 1u << (t - 1), (t == 0) ? 0 : (t == 32) ? UINT32_MAX : (1u << t) - 1, (unsigned long)counts[t]);
+			for (uint64_t n = (counts[t] * 40 + top - 1) / top; n > 0; n--) putchar('#');
+			putchar('\n');
+		}
+	}
+
+	return;
+}
+
+
+int tmplComparing (const void *a, const void *b) {
+	const tmplStats_t *x = *(const tmplStats_t**)a, *y = *(const tmplStats_t**)b;
+
+	return((x->count < y->count) - (x->count > y->count));
+}
+
+
+void reportPrinting (const partial_t *r, uint32_t topTmpls, bool hist) {
+	//
+	// Description:
+	//	It prints the per-pin statistics, the bouncing pins and the most frequent log templates
+	//
+	const char        *lev[2] = { "low ", "high" };
+	const char        *name;
+	char              label[PTS_PINLABSIZE];
+	const tmplStats_t **sorted;
+	uint32_t          n = 0;
+
+	printf("PINS (bounce time: %u ms)\n", bounceMs);
+	for (pinId_t pin = 0; pin < PTS_MAXPINID; pin++) {
+		const pinStats_t *s = &r->pins[pin];
+
+		if (s->seen == false) continue;
+		pinId_toLabel(label, pin);
+		if (pinToSymbol_getById(&name, pin) != WERRCODE_SUCCESS) name = label;
+		printf("\t%s (%s): %lu rows", name, label, (unsigned long)s->rows);
+
+		if (s->wide) {
+			printf(", analog values %u..%u\n", s->minV, s->maxV);
+			continue;
+		}
+
+		printf(
+			", %lu toggles, high %.1f%% / low %.1f%%\n", (unsigned long)s->toggles,
+			100.0 * s->levelMs[1] / ((s->levelMs[0] + s->levelMs[1] > 0) ? s->levelMs[0] + s->levelMs[1] : 1),
+			100.0 * s->levelMs[0] / ((s->levelMs[0] + s->levelMs[1] > 0) ? s->levelMs[0] + s->levelMs[1] : 1)
+		);
+		for (uint8_t l = 0; l < 2; l++) {
+			const pulseStats_t *p = &s->pulses[l];
+
+			if (p->count > 0)
+				printf(
+					"\t\t%s pulses: %lu, min %u, p50 %u, p90 %u, p99 %u, max %u ms\n", lev[l], (unsigned long)p->count,
+					p->min, percentile(p, 50), percentile(p, 90), percentile(p, 99), p->max
+				);
+		}
+		if (s->bounces.shorts > 0)
+			printf(
+				"\t\t[!] bounces: %lu pulses in %lu bursts (longest: %lu transitions)\n", (unsigned long)s->bounces.shorts,
+				(unsigned long)s->bounces.bursts, (unsigned long)s->bounces.longest + 1
+			);
+		if (hist) histPrinting(s);
+	}
+
+	printf("BOUNCING PINS\n");
+	for (pinId_t pin = 0; pin < PTS_MAXPINID; pin++) {
+		const pinStats_t *s = &r->pins[pin];
+
+		if (s->seen && s->wide == false && s->bounces.bursts > 0) {
+			pinId_toLabel(label, pin);
+			if (pinToSymbol_getById(&name, pin) != WERRCODE_SUCCESS) name = label;
+			printf("\t%-24s %lu bursts\n", name, (unsigned long)s->bounces.bursts);
+			n++;
+		}
+	}
+	if (n == 0) printf("\tnone\n");
+
+	printf("LOG TEMPLATES (%u templates, %lu messages)\n", r->tmplsUsed, (unsigned long)r->logRows);
+	if ((sorted = malloc(r->tmplsUsed * sizeof(tmplStats_t*) + 1)) != NULL) {
+		n = 0;
+		for (uint32_t t = 0; t < STATS_MAXTMPLS; t++) if (r->tmpls[t].count > 0) sorted[n++] = &r->tmpls[t];
+		qsort(sorted, n, sizeof(tmplStats_t*), tmplComparing);
+		for (uint32_t t = 0; t < n && t < topTmpls; t++) printf("\t%10lu  %s\n", (unsigned long)sorted[t]->count, sorted[t]->text);
+		free(sorted);
+	}
+	if (r->others > 0) printf("\t%10lu  (other templates)\n", (unsigned long)r->others);
+
+	return;
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                                     M A I N
+//------------------------------------------------------------------------------------------------------------------------------
+int main (int argc, char *argv[]) {
+	werror       err     = WERRCODE_SUCCESS;
+	int          opt     = 0;
+	long         threads = sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t     topTmpls = STATS_TOPTMPLS, chunks = 0, created = 0;
+	bool         hist    = false, loaded;
+	captHeader_t hdr;
+	playChunk_t  cuts[STATS_MAXTHREADS];
+	partial_t    parts[STATS_MAXTHREADS];
+	pthread_t    ths[STATS_MAXTHREADS];
+	uint64_t     start   = monotonicMs();
+	double       secs;
+
+	// The default number of threads is limited, the user defined one is checked
+	if (threads < 1)                threads = 1;
+	if (threads > STATS_MAXTHREADS) threads = STATS_MAXTHREADS;
+
+	while ((opt = getopt(argc, argv, "j:b:n:H")) != -1) {
+		switch (opt) {
+			case 'j': threads  = strtol(optarg, NULL, 10);   break;
+			case 'b': bounceMs = strtoul(optarg, NULL, 10);  break;
+			case 'n': topTmpls = strtoul(optarg, NULL, 10);  break;
+			case 'H': hist     = true;                       break;
+			default:  err      = WERRCODE_ERROR_ILLEGALARG;  break;
+		}
+	}
+	memset(parts, 0, sizeof(parts));
+
+	if (err != WERRCODE_SUCCESS || argc - optind != 1) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Use: %s [-j <threads>] [-b <bounce time (ms)>] [-n <templates>] [-H] <capture file>\n", argv[0]);
+		err = WERRCODE_ERROR_MISSINGARG;
+
+	} else if (threads < 1 || threads > STATS_MAXTHREADS) {
+		// ERROR!
+		fprintf(stderr, "ERROR! The number of threads must be between 1 and %u\n", STATS_MAXTHREADS);
+		err = WERRCODE_ERROR_ILLEGALARG;
+
+	} else if (wErrCode_isError(capturePlayer_open(argv[optind], &hdr))) {
+		// ERROR!
+		err = WERRCODE_ERROR_INVALIDDATA;
+
+	} else {
+		chunks = capturePlayer_split(cuts, threads);
+		for (uint32_t t = 0; t < chunks && err == WERRCODE_SUCCESS; t++) {
+			parts[t].chunk    = cuts[t];
+			parts[t].skipHead = (t > 0);
+			parts[t].err      = WERRCODE_SUCCESS;
+			parts[t].builder  = calloc(1, sizeof(stringBuilder_t));
+			parts[t].pins     = calloc(PTS_MAXPINID, sizeof(pinStats_t));
+			parts[t].tmpls    = calloc(STATS_MAXTMPLS, sizeof(tmplStats_t));
+
+			if (parts[t].builder == NULL || parts[t].pins == NULL || parts[t].tmpls == NULL)
+				// ERROR!
+				err = WERRCODE_ERROR_OUTOFMEMORY;
+		}
+
+		for (; created < chunks && err == WERRCODE_SUCCESS; created++) {
+			if (pthread_create(&ths[created], NULL, chunkScanning, &parts[created]) != 0) {
+				// ERROR!
+				fprintf(stderr, "ERROR! I cannot create the scanning thread\n");
+				err = WERRCODE_ERROR_SYSCALL;
+				break;
+			}
+		}
+
+		// The partial results are merged in the chunks' order (only the created threads are joined)
+		for (uint32_t t = 0; t < created; t++) {
+			pthread_join(ths[t], NULL);
+			if (wErrCode_isError(parts[t].err)) err = parts[t].err;
+			for (uint32_t m = 0; m < parts[t].mapRows; m++) ptsCache_row(parts[t].maps[m], &loaded);
+			if (t > 0 && err == WERRCODE_SUCCESS) partialMerging(&parts[0], &parts[t]);
+		}
+
+		if (wErrCode_isError(err)) {
+			// ERROR!
+			fprintf(stderr, "ERROR! The capture scanning failed\n");
+
+		} else if (chunks > 0) {
+			secs = (monotonicMs() - start) / 1000.0;
+			printf(
+				"CAPTURE %s: %.8s target, %u bps, %u ms, %lu pin rows, %lu log messages\n"
+				"\t%.1f MB in %.2f s (%.0f MB/s, %u threads)\n", argv[optind], hdr.target, hdr.ttySpeed,
+				capturePlayer_duration(), (unsigned long)parts[0].pinRows, (unsigned long)parts[0].logRows,
+				parts[0].bytes / 1e6, secs, (secs > 0) ? parts[0].bytes / 1e6 / secs : 0, chunks
+			);
+			reportPrinting(&parts[0], topTmpls, hist);
+		}
+	}
+
+	for (uint32_t t = 0; t < STATS_MAXTHREADS; t++) {
+		free(parts[t].builder);
+		free(parts[t].pins);
+		free(parts[t].tmpls);
+		for (uint32_t m = 0; m < parts[t].mapRows; m++) free(parts[t].maps[m]);
+		free(parts[t].maps);
+	}
+	capturePlayer_close();
+
+	return(wErrCodeToShell(err));
+}
@@ -12,7 +12,11 @@
 // Author: Silvano Catinella <catinella@yahoo.com>
 //
 // Description:
-//	This software allows you to display the console messages and the pin status too
+//	This software allows you to display the console messages and the pin status too.
+//	The serial port is drained and parsed by two threads (see ttyPipeline.h), so a slow terminal cannot cause data
+//	losses. The main thread (renderer) sleeps in the event loop (see eventLoop.h), and it wakes up only when the stores
+//	have been updated, when the keyboard has new data, when a signal is received, or when a postponed screen refresh
+//	is due.
 //
 //	Testing process
 //		In order to test this debug-console you need to creates a virtual serial-ports couple where they are linked to
@@ -20,9 +24,45 @@
 //		To create the ports-couple type the following command: socat -d -d pty,raw,echo=0 pty,raw,echo=0
 //
 //	Symbols description:
-//		TTY_DATACHUNK     Number of bytes the console will try to read on every round
 //		TTY_MAXLOGSIZE    Max length of the log-message to display
-//		TTY_MAXLOGLINES   Max number of lines to show in the console before to drop the oldest logs
+//		CONS_MAXFPS       Max number of screen refreshes per second (only the changed windows are redrawn)
+//
+//	Use: debugConsole [--headless] [-a <rules file>] [-r <capture file>] [-b <socket>] <port> | -c <socket>
+//	     debugConsole [-a <rules file>] <port> <port> ...
+//	     debugConsole [--headless] [-a <rules file>] [-b <socket>] -p <capture file> [-x <speed>|max] [-s <start time (ms)>] [-q]
+//		--headless  No ncurses: the rows are written to stdout as JSON Lines (see jsonOutput.h), the playback
+//		            ends with the capture file
+//		-r          Recording mode: the raw serial stream is recorded in the argument defined capture file (see
+//		            captureFile.h), with the reception time-stamps
+//		-p          Playback mode: the capture file takes the serial port's place (see capturePlayer.h)
+//		-x          Playback speed: 1 = real time (default), N = N times faster, max = as fast as possible
+//		-s          Playback start time
+//		-q          Exit when the whole capture file has been played
+//		-b          Broker mode: the raw stream is served to the clients connected to the argument defined Unix
+//		            domain socket (see broker.h)
+//		-c          Client mode: the stream is received from the argument defined broker's socket
+//		-w          Waveform pane: comma separated list of the displayed pins' symbols or labels (e.g.
+//		            -w i_CLUTCH,i_NEUTRAL,o_ENGINEON). The pane is shown at start (see waveView.h)
+//		-a          Alerting rules file (see rulesEngine.h): the violations are shown in bold in the logs section,
+//		            and the involved pins are highlighted. It can be used in every mode
+//		The pins' symbols are the ones announced by the firmware (see ptsMap.h), cached by map hash: the table built from
+//		the local checkout's main/mbesPinsMap.h is used until the announcement is received.
+//		Several ports (up to DEV_MAXDEVICES) can be monitored at once, every one with its own pins and logs (see
+//		devices.h). The bottom line shows a tab per port: [Tab]/[Shift-Tab] or [1]..[8] switch the displayed one, and
+//		'*' marks the ports with changes not yet displayed.
+//
+//	Keyboard commands (logs section):
+//		Up/Down, PgUp/PgDn  Scrollback
+//		Home/End            Oldest log / follow the new logs
+//		t                   Jump to time (ms)
+//		Left/Right          Playback seek (-/+ CONS_SEEKMS)
+//
+//	Keyboard commands (waveform pane):
+//		w                   Show/hide the pane (without -w, the first pins with a history are displayed)
+//		+/-                 Zoom in/out
+//		[/]                 Pan back/forward by half a pane (it stops the live mode)
+//		,/.                 Cursor left/right (the time axis is relative to the cursor)
+//		l                   Live mode: the pane follows the newest time
 //
 //	[!] Remembe to link the ncurses lib (-lncurses)
 //
@@ -50,8 +90,10 @@
 #include <string.h>
 #include <errno.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/eventfd.h>
 #include <fcntl.h>
 #include <time.h>
 #include <regex.h>
@@ -65,41 +107,371 @@
 #include <stringBuilder.h>
 #include <pinToSymbol.h>
 #include <pinsStorage.h>
+#include <timeUtils.h>
 #include <screenUtils.h>
 #include <logsStorage.h>
+#include <pinsHistory.h>
+#include <eventLoop.h>
+#include <ttyPipeline.h>
+#include <captureFile.h>
+#include <capturePlayer.h>
+#include <jsonOutput.h>
+#include <broker.h>
+#include <waveView.h>
+#include <rulesEngine.h>
+#include <ptsMap.h>
 
-#define TTY_DATACHUNK     16
 #define TTY_MAXLOGSIZE    126
 
 #define CONS_FACILITY     LOG_LOCAL0
+#define CONS_MAXFPS       25                 // Max number of screen refreshes per second
+#define CONS_HDRROWS      3
+#define CONS_TITLE        "D E B U G   C O N S O L E"
+#define CONS_SEEKMS       10000              // Playback's seek step (ms)
+
+#if defined(TARGET_ESP32)
+#define CONS_TARGET       "ESP32"
+#elif defined(TARGET_AVR8)
+#define CONS_TARGET       "AVR8"
+#else
+#define CONS_TARGET       "unknown"
+#endif
 
 #define CONS_KEEPTRACK syslog(LOG_INFO, "------->%s(%d)", __FUNCTION__, __LINE__);
 
 
 // Global vars
-bool loop = true;
+static werror   consErr   = WERRCODE_SUCCESS;   // Error detected by the event handlers
+static bool     winchFlag = true;               // The screen size has changed (SIGWINCH)
+static bool     tmrFlag   = false;              // A postponed screen refresh is pending
+static uint64_t lastFrame = 0;                  // Last screen refresh time (ms)
+static uint32_t frames    = 0;                  // Number of screen refreshes
+static bool     headless  = false;              // JSON Lines output, no ncurses (--headless)
+static bool     quitAtEnd = false;              // Exit when the whole capture file has been played (-q)
+static bool     playing   = false;              // Playback mode (-p)
+
+// Devices (multi-port mode)
+static const char *devNames[DEV_MAXDEVICES];    // Serial ports
+static uint8_t    devCount  = 1;
+static devId_t    activeDev = 0;                // Displayed device
+static uint32_t   unseen    = 0;                // Devices changed since they have been displayed (bitmap)
+static uint32_t   tabsShown = 0;                // unseen's value drawn on the tabs line
+
+// Console's windows
+static WINDOW   *hdrWin = NULL;             // Title
+static WINDOW   *pinWin = NULL;             // Pins grid
+static WINDOW   *wavWin = NULL;             // Waveform pane
+static WINDOW   *logWin = NULL;             // Logs section
+static WINDOW   *ftrWin = NULL;             // Bottom line
+static uint16_t scrRows = 0, scrCols = 0;
+static uint16_t pinRows = 0;                // Rows used by the pins grid
+static uint16_t wavRows = 0;                // Rows used by the waveform pane (0: hidden)
+static uint16_t logRows = 1;                // Rows available for the logs section
+static bool     wavShown = false;           // The waveform pane is displayed
 
 //------------------------------------------------------------------------------------------------------------------------------
 //                                                  F U N C T I O N S
 //------------------------------------------------------------------------------------------------------------------------------
 
+uint16_t waveRows () {
+	//
+	// Description:
+	//	It returns the rows required by the waveform pane (its separator line included)
+	//
+	return(wavShown ? waveView_rows() + 1 : 0);
+}
+
+
+uint32_t waveNow () {
+	//
+	// Description:
+	//	It returns the waveform pane's newest time: the current one, or the played one (playback mode)
+	//
+	uint32_t now = 0;
+
+	if (playing) now = ttyPipeline_position();
+	else         getMyEpoch(&now);
+
+	return(now);
+}
+
+
+void tabsPrinting () {
+	//
+	// Description:
+	//	It draws the devices' tabs on the bottom line (multi-port mode): the displayed device is highlighted, and the
+	//	devices with changes not yet displayed are marked by '*'
+	//
+	werase(ftrWin);
+	linePrinting(ftrWin, '=', scrCols);
+	wmove(ftrWin, 0, 1);
+	for (devId_t d = 0; d < devCount; d++) {
+		const char *name = strrchr(devNames[d], '/');
+
+		if (d == activeDev) wattron(ftrWin, A_REVERSE);
+		wprintw(ftrWin, " %u:%s%c ", d + 1, (name != NULL) ? name + 1 : devNames[d], ((unseen >> d) & 1) ? '*' : ' ');
+		if (d == activeDev) wattroff(ftrWin, A_REVERSE);
+		waddch(ftrWin, '=');
+	}
+	tabsShown = unseen;
+	wnoutrefresh(ftrWin);
+
+	return;
+}
+
+
+void screenLayout () {
+	//
+	// Description:
+	//	It (re)creates the console's windows considering the screen size and the number of monitored pins. The static
+	//	parts (title and bottom line) are drawn here, just once.
+	//
+	uint16_t used;
+
+	if (hdrWin != NULL) delwin(hdrWin);
+	if (pinWin != NULL) delwin(pinWin);
+	if (wavWin != NULL) delwin(wavWin);
+	if (logWin != NULL) delwin(logWin);
+	if (ftrWin != NULL) delwin(ftrWin);
+
+	pinRows = pinsStorage_rows(scrCols);
+	wavRows = waveRows();
+	used    = CONS_HDRROWS + pinRows + 1 + wavRows + 1;
+	logRows = (scrRows > used) ? scrRows - used : 1;
+
+	hdrWin = newwin(CONS_HDRROWS, scrCols, 0, 0);
+	pinWin = newwin(pinRows + 1, scrCols, CONS_HDRROWS, 0);
+	wavWin = (wavRows > 0) ? newwin(wavRows, scrCols, CONS_HDRROWS + pinRows + 1, 0) : NULL;
+	logWin = newwin(logRows, scrCols, CONS_HDRROWS + pinRows + 1 + wavRows, 0);
+	ftrWin = newwin(1, scrCols, CONS_HDRROWS + pinRows + 1 + wavRows + logRows, 0);
+
+	// The keyboard is read through the title window (it is never redrawn)
+	keypad(hdrWin, TRUE);
+	nodelay(hdrWin, TRUE);
+
+	linePrinting(hdrWin, '-', scrCols);
+	titlePrinting(hdrWin, CONS_TITLE, scrCols);
+	linePrinting(hdrWin, '=', scrCols);
+	linePrinting(ftrWin, '=', scrCols);
+
+	clearok(curscr, TRUE);
+	wnoutrefresh(stdscr);
+	wnoutrefresh(hdrWin);
+	wnoutrefresh(ftrWin);
+
+	return;
+}
+
+
+bool screenUpdate (bool force) {
+	//
+	// Description:
+	//	It redraws the dirty windows only (pins grid, waveform pane and/or logs section), and it refreshes the screen
+	//	with a single doupdate() call.
+	//
+	// Returned value:
+	//	true when the screen has been updated
+	//
+	bool flag = false;
+
+	if (force || pinsStorage_isDirty()) {
+		werase(pinWin);
+		wmove(pinWin, 0, 0);
+		pinsStorage_print(pinWin, scrCols);
+		wmove(pinWin, pinRows, 0);
+		linePrinting(pinWin, '-', scrCols);
+		wnoutrefresh(pinWin);
+		flag = true;
+	}
+	if (wavWin != NULL && waveView_print(wavWin, scrCols, waveNow(), force)) {
+		wmove(wavWin, wavRows - 1, 0);
+		linePrinting(wavWin, '-', scrCols);
+		wnoutrefresh(wavWin);
+		flag = true;
+	}
+	if (force || logsStorage_isDirty()) {
+		werase(logWin);
+		wmove(logWin, 0, 0);
+		logsStorage_print(logWin, scrCols, logRows);
+		wnoutrefresh(logWin);
+		flag = true;
+	}
+	if (devCount > 1 && (force || unseen != tabsShown)) {
+		tabsPrinting();
+		flag = true;
+	}
+	if (flag) doupdate();
+
+	return(flag);
+}
+
+
+void timerHandler ();
+
+void screenRefresh () {
+	//
+	// Description:
+	//	It applies the screen size changes, and it redraws the dirty windows. When the last refresh is too recent
+	//	(CONS_MAXFPS), the redraw is postponed by the event loop's timer. The timer redraws the waveform pane also when
+	//	its time advances by a column (live mode).
+	//
+	struct winsize ts;
+	uint64_t       elapsed;
+
+	// The stores cannot be changed by the parser thread during the redraw
+	ttyPipeline_lock();
+	unseen |= ttyPipeline_activity() & ~(1u << activeDev);
+
+	// Screen resizing (SIGWINCH), pins grid growing, or waveform pane showing/hiding
+	if (winchFlag || pinsStorage_rows(scrCols) != pinRows || waveRows() != wavRows) {
+		if (winchFlag && ioctl(STDIN_FILENO, TIOCGWINSZ, &ts) == 0) {
+			scrRows = ts.ws_row;
+			scrCols = ts.ws_col;
+			resizeterm(scrRows, scrCols);
+		}
+		winchFlag = false;
+		screenLayout();
+		lastFrame = 0;
+	}
+
+	// Only the dirty windows are redrawn, and not more than CONS_MAXFPS times per second
+	elapsed = monotonicMs() - lastFrame;
+	if (elapsed >= (1000 / CONS_MAXFPS)) {
+		if (screenUpdate(lastFrame == 0)) {
+			lastFrame = monotonicMs();
+			frames++;
+		}
+
+	} else if (tmrFlag == false && (pinsStorage_isDirty() || logsStorage_isDirty() || unseen != tabsShown)) {
+		tmrFlag = true;
+		eventLoop_timer((1000 / CONS_MAXFPS) - elapsed, timerHandler);
+	}
+
+	// The live waveform pane moves when its time advances by a column
+	if (tmrFlag == false && wavShown && waveView_isLive()) {
+		uint32_t wait = waveView_msPerCol() - waveNow() % waveView_msPerCol();
+
+		tmrFlag = true;
+		eventLoop_timer((wait > (1000 / CONS_MAXFPS)) ? wait : (1000 / CONS_MAXFPS), timerHandler);
+	}
+	ttyPipeline_unlock();
+
+	return;
+}
+
+
+void timerHandler () {
+	//
+	// Description:
+	//	Postponed screen refresh
+	//
+	tmrFlag = false;
+	screenRefresh();
+
+	return;
+}
+
+
 void sigHandler (int signum) {
 	//
-	// Signals handler
+	// Signals handler (called by the event loop, not in the signal context)
 	//
 	switch (signum) {
 		case SIGTERM:
-			loop = false;
+		case SIGINT:
+			eventLoop_stop();
 			break;
 
-		case SIGINT:
-			loop = false;
+		case SIGWINCH:
+			winchFlag = true;
+			screenRefresh();
 			break;
 	}
 	return;
 }
 
 
+void deviceSwitching (devId_t dev) {
+	//
+	// Description:
+	//	It displays the argument defined device (multi-port mode); the whole screen is redrawn by the next refresh
+	//
+	if (dev < devCount && dev != activeDev) {
+		activeDev = dev;
+		unseen   &= ~(1u << dev);
+		ttyPipeline_view(dev);
+		waveView_reset();
+		lastFrame = 0;
+	}
+	return;
+}
+
+
+void keyboardHandler (int fd, void *arg) {
+	//
+	// Description:
+	//	It reads the pressed keys (without waiting for them), it moves the logs section's view and the waveform
+	//	pane's one, and it switches the displayed device (multi-port mode)
+	//
+	int      key;
+	uint16_t pageRows = logRows;
+
+	while ((key = wgetch(hdrWin)) != ERR) {
+		if (key == 't') {
+			char buff[16];
+
+			// Time prompt (blocking, the pipeline goes on storing the new data meanwhile)
+			echo();
+			mvwprintw(logWin, logRows - 1, 0, "Jump to time (ms): ");
+			wclrtoeol(logWin);
+			if (wgetnstr(logWin, buff, sizeof(buff) - 1) == OK) {
+				ttyPipeline_lock();
+				logsStorage_jump(strtoul(buff, NULL, 10));
+				ttyPipeline_unlock();
+			}
+			noecho();
+
+		} else if (key == '\t' || key == KEY_BTAB) {
+			deviceSwitching((activeDev + ((key == '\t') ? 1 : devCount - 1)) % devCount);
+
+		} else if (key >= '1' && key < '1' + devCount) {
+			deviceSwitching(key - '1');
+
+		} else if (key == 'w' || (wavShown && key > 0 && key < 0x80 && strchr("+-[],.l", key) != NULL)) {
+			// The waveform pane's state is used by the renderer only (this thread), the whole screen is redrawn
+			switch (key) {
+				case 'w': wavShown = !wavShown;                                    break;
+				case '+': waveView_zoom(1);                                        break;
+				case '-': waveView_zoom(-1);                                       break;
+				case '[': waveView_pan(-(int32_t)(scrCols - WAVE_LABELCOLS) / 2); break;
+				case ']': waveView_pan((scrCols - WAVE_LABELCOLS) / 2);            break;
+				case ',': waveView_cursor(-1);                                     break;
+				case '.': waveView_cursor(1);                                      break;
+				case 'l': waveView_live();                                         break;
+			}
+			lastFrame = 0;
+
+		} else {
+			ttyPipeline_lock();
+			switch (key) {
+				case KEY_UP:    logsStorage_scroll(-1);                 break;
+				case KEY_DOWN:  logsStorage_scroll(1);                  break;
+				case KEY_PPAGE: logsStorage_scroll(-(int32_t)pageRows); break;
+				case KEY_NPAGE: logsStorage_scroll(pageRows);           break;
+				case KEY_HOME:  logsStorage_scroll(-LOGS_MAXLINES);     break;
+				case KEY_END:   logsStorage_follow();                   break;
+				case KEY_LEFT:  ttyPipeline_seek(-CONS_SEEKMS);         break;
+				case KEY_RIGHT: ttyPipeline_seek(CONS_SEEKMS);          break;
+			}
+			ttyPipeline_unlock();
+		}
+	}
+	screenRefresh();
+
+	return;
+}
+
+
 werror set_ttyAttribs (int fd) {
 	//
 	// Description:
@@ -190,7 +562,7 @@ werror set_ttyAttribs (int fd) {
 		// Terminal special characters array
 		//
 		tty.c_cc[VMIN]  = 0;   // Minimum number of characters for noncanonical read (MIN)
-		tty.c_cc[VTIME] = 5;   // Timeout in deciseconds for noncanonical read (TIME)
+		tty.c_cc[VTIME] = 0;   // No timeout: read() is called only when poll() reports new data
 
 
 		if (tcsetattr (fd, TCSANOW, &tty) < 0) {
@@ -205,148 +577,293 @@ werror set_ttyAttribs (int fd) {
 
 
 
+void pipeHandler (int fd, void *arg) {
+	//
+	// Description:
+	//	The serial pipeline's threads have updated the stores (or they have failed). The errors are reported by
+	//	consErr, and they stop the event loop.
+	//
+	eventfd_t cnt;
+
+	eventfd_read(fd, &cnt);
+
+	if (wErrCode_isError(ttyPipeline_error())) {
+		// ERROR!
+		consErr = ttyPipeline_error();
+		eventLoop_stop();
+
+	} else if (quitAtEnd && ttyPipeline_ended())
+		eventLoop_stop();
+
+	else if (headless == false)
+		screenRefresh();
+
+	return;
+}
+
+
+werror wavesSetting (char *list) {
+	//
+	// Description:
+	//	It adds the argument defined pins (comma separated symbols or labels) to the waveform pane, and it shows it
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG     Unknown pin
+	//	WERRCODE_ERROR_DATAOVERFLOW   Too many pins
+	//
+	werror err = WERRCODE_SUCCESS;
+
+	for (char *name = strtok(list, ","); name != NULL && err == WERRCODE_SUCCESS; name = strtok(NULL, ",")) {
+		if ((err = waveView_trace(name)) == WERRCODE_ERROR_DATAOVERFLOW)
+			// ERROR!
+			fprintf(stderr, "ERROR! Too many waveform pins (max %u)\n", WAVE_MAXTRACES);
+		else if (err != WERRCODE_SUCCESS)
+			// ERROR!
+			fprintf(stderr, "ERROR! \"%s\" is not a known pin symbol or label\n", name);
+	}
+	wavShown = true;
+
+	return(err);
+}
+
+
+werror portsOpening (int *fds) {
+	//
+	// Description:
+	//	It opens and configures the serial ports (devNames), and it stores their fds in the argument defined array.
+	//	Every firmware is asked for its pin-symbol map. When a port cannot be used, the ones already opened are closed.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_FILENOTFOUND
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//	WERRCODE_ERROR_TTYCONFIG
+	//
+	werror      err = WERRCODE_SUCCESS;
+	struct stat buff;
+
+	for (devId_t d = 0; d < devCount && err == WERRCODE_SUCCESS; d++) {
+		if (stat(devNames[d], &buff) < 0) {
+			// ERROR!
+			fprintf(stderr, "ERROR! \"%s\" file not found\n", devNames[d]);
+			err = WERRCODE_ERROR_FILENOTFOUND;
+
+		} else if ((fds[d] = open(devNames[d], O_RDWR | O_NOCTTY | O_SYNC | O_NONBLOCK)) < 0) {
+			// ERROR!
+			fprintf(stderr, "ERROR! I cannot open the \"%s\" file: %s\n", devNames[d], strerror(errno));
+			err = WERRCODE_ERROR_IOOPERFAILED;
+
+		} else if (wErrCode_isError(set_ttyAttribs(fds[d]))) {
+			// ERROR!
+			err = WERRCODE_ERROR_TTYCONFIG;
+
+		} else if (write(fds[d], PTSMAP_REQUEST "\n", sizeof(PTSMAP_REQUEST)) < 0) {
+			// WARNING! The firmware is asked for its symbols map (see ptsMap.h), it is announced at boot anyway
+			fprintf(stderr, "WARNING! I cannot ask \"%s\" for its symbols map: %s\n", devNames[d], strerror(errno));
+		}
+	}
+
+	if (err != WERRCODE_SUCCESS) {
+		for (devId_t d = 0; d < devCount; d++) {
+			if (fds[d] >= 0) close(fds[d]);
+			fds[d] = -1;
+		}
+	}
+	return(err);
+}
+
+
 //------------------------------------------------------------------------------------------------------------------------------
 //                                                     M A I N
 //------------------------------------------------------------------------------------------------------------------------------
 int main (int argc, char *argv[]) {
-	werror      err = 0;
-	struct stat buff;
-	int         ttyFD;
+	werror       err = WERRCODE_SUCCESS;
+	int          ttyFDs[DEV_MAXDEVICES];
+	int          notifyFD = -1;
+	int          opt      = 0;
+	int          ports    = 0;                  // Number of serial ports
+	const char   *capture = NULL;               // Capture file (recording mode)
+	const char   *play    = NULL;               // Capture file (playback mode)
+	const char   *serve   = NULL;               // Broker's socket (fan-out of the stream, see broker.h)
+	const char   *attach  = NULL;               // Broker's socket (client mode)
+	char         *waves   = NULL;               // Waveform pane's pins (comma separated list)
+	const char   *alerts  = NULL;               // Alerting rules file
+	struct option longOpts[] = {
+		{ "headless", no_argument, NULL, 'H' },
+		{ NULL,       0,           NULL, 0   }
+	};
+	uint32_t     speed    = 1;                  // Playback speed (0: max)
+	uint32_t     start    = 0;                  // Playback start time (ms)
+	captHeader_t hdr;
+
+	while ((opt = getopt_long(argc, argv, "r:p:x:s:qb:c:w:a:", longOpts, NULL)) != -1) {
+		switch (opt) {
+			case 'H': headless = quitAtEnd = true;                                             break;
+			case 'q': quitAtEnd = true;                                                        break;
+			case 'r': capture = optarg;                                                        break;
+			case 'p': play    = optarg;                                                        break;
+			case 'x': speed   = (strcmp(optarg, "max") == 0) ? 0 : strtoul(optarg, NULL, 10);  break;
+			case 's': start   = strtoul(optarg, NULL, 10);                                     break;
+			case 'b': serve   = optarg;                                                        break;
+			case 'c': attach  = optarg;                                                        break;
+			case 'w': waves   = optarg;                                                        break;
+			case 'a': alerts  = optarg;                                                        break;
+			default:  err     = WERRCODE_ERROR_ILLEGALARG;                                     break;
+		}
+	}
+	ports    = argc - optind;
+	devCount = (ports > 1) ? ports : 1;
+	devNames[0] = (play != NULL) ? play : (attach != NULL) ? attach : NULL;
+	for (int t = 0; t < DEV_MAXDEVICES; t++) {
+		ttyFDs[t] = -1;
+		if (t < ports) devNames[t] = argv[optind + t];
+	}
 
-	if (argc != 2 || *argv[1] == '\0') {
+	if (
+		err != WERRCODE_SUCCESS || (play == NULL && attach == NULL && (ports == 0 || ports > DEV_MAXDEVICES)) ||
+		((play != NULL || attach != NULL) && ports != 0) || (play != NULL && (capture != NULL || attach != NULL)) ||
+		(ports > 1 && (capture != NULL || serve != NULL || headless))
+	) {
 		// ERROR!
-		fprintf(stderr, "ERROR! port name missing\n");
+		fprintf(stderr, "ERROR! Use: %s [--headless] [-w <pins>] [-a <rules file>] [-r <capture file>] [-b <socket>] <port> | -c <socket>\n", argv[0]);
+		fprintf(stderr, "       %s [-w <pins>] [-a <rules file>] <port> <port> ... (up to %u ports)\n", argv[0], DEV_MAXDEVICES);
+		fprintf(stderr, "       %s [--headless] [-w <pins>] [-a <rules file>] [-b <socket>] -p <capture file> [-x <speed>|max] [-s <start time (ms)>] [-q]\n", argv[0]);
 		err = WERRCODE_ERROR_MISSINGARG;
 
-	} else if (stat(argv[1], &buff) < 0) {
+	} else if (waves != NULL && wErrCode_isError(wavesSetting(waves))) {
+		// ERROR!
+		err = WERRCODE_ERROR_ILLEGALARG;
+
+	} else if (alerts != NULL && wErrCode_isError(ttyPipeline_rules(alerts))) {
+		// ERROR! (the syntax errors are described by rulesEngine_load())
+		err = WERRCODE_ERROR_INVALIDDATA;
+
+	} else if ((playing = (play != NULL)) && wErrCode_isError(capturePlayer_open(play, &hdr))) {
 		// ERROR!
-		fprintf(stderr, "ERROR! \"%s\" file not found\n", argv[1]);
-		err = WERRCODE_ERROR_FILENOTFOUND;
+		err = WERRCODE_ERROR_INVALIDDATA;
 
-	} else if (signal(SIGTERM, sigHandler) == SIG_ERR || signal(SIGINT, sigHandler) == SIG_ERR) {
+	} else if (wErrCode_isError(eventLoop_init(sigHandler))) {
 		// ERROR!
-		fprintf(stderr, "ERROR! I cannot set the signal-handlers: %s\n", strerror(errno));
+		fprintf(stderr, "ERROR! I cannot initialize the event loop\n");
 		err = WERRCODE_ERROR_SYSCALL;
 
-	} else if ((ttyFD = open(argv[1], O_RDWR | O_NOCTTY | O_SYNC)) < 0) {
+	} else if (ports > 0 && wErrCode_isError(err = portsOpening(ttyFDs))) {
 		// ERROR!
-		fprintf(stderr, "ERROR! I cannot open the \"%s\" file: %s\n", argv[1], strerror(errno));
+		eventLoop_close();
+
+	} else if (attach != NULL && wErrCode_isError(broker_connect(attach, &ttyFDs[0]))) {
+		// ERROR! The broker's socket takes the serial port's place
 		err = WERRCODE_ERROR_IOOPERFAILED;
+		eventLoop_close();
 
-	} else if (wErrCode_isError(set_ttyAttribs(ttyFD))) {
+	} else if ((notifyFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
 		// ERROR!
-		err = WERRCODE_ERROR_TTYCONFIG;
+		fprintf(stderr, "ERROR! eventfd() failed: %s\n", strerror(errno));
+		err = WERRCODE_ERROR_SYSCALL;
+		eventLoop_close();
+
+	} else if (capture != NULL && wErrCode_isError(captureFile_open(capture, TTYBPS, CONS_TARGET))) {
+		// ERROR!
+		err = WERRCODE_ERROR_IOOPERFAILED;
+		close(notifyFD);
+		eventLoop_close();
 
 	} else {
-		char     chunk[TTY_DATACHUNK];
-		char     buff[BUILDER_MAXSTRINGSIZE];
-		int      nb       = 0;                // number of received bytes
-		int      value    = 0;                // PIN's value
-		char     pin[PTS_PINLABSIZE];
-		struct winsize ts;
+		uint64_t startTime = monotonicMs();
 		
 		// NCurses initialization
-		initscr();
+		if (headless == false) {
+			initscr();
+			cbreak();
+			noecho();
+			curs_set(0);
+		}
 		
 		// Syslog initiaklization
 		openlog(argv[0], LOG_NDELAY|LOG_PID, CONS_FACILITY);
 		//syslog(LOG_INFO, "------------------------- [DEBUG CONSOLE START] -------------------------");
-		
-		while (loop && wErrCode_isError(err) == false) {
-			memset(chunk, '\0', TTY_DATACHUNK);
-			nb = read(ttyFD, &chunk, (TTY_DATACHUNK * sizeof(char)));
-			
-			if (nb < 0) {
+
+		if (eventLoop_add(notifyFD, pipeHandler, NULL) != WERRCODE_SUCCESS || (headless == false && eventLoop_add(STDIN_FILENO, keyboardHandler, NULL) != WERRCODE_SUCCESS)) {
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! I cannot register the event sources", __LINE__);
+			err = WERRCODE_ERROR_DATAOVERFLOW;
+
+		} else if (headless && wErrCode_isError(jsonOutput_open(STDOUT_FILENO))) {
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! Out of memory", __LINE__);
+			err = WERRCODE_ERROR_OUTOFMEMORY;
+
+		} else if (serve != NULL && wErrCode_isError(broker_start(serve))) {
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! I cannot start the broker on \"%s\"", __LINE__, serve);
+			err = WERRCODE_ERROR_SYSCALL;
+
+		} else if (wErrCode_isError((play == NULL) ? ttyPipeline_startMulti(ttyFDs, devCount, notifyFD) : ttyPipeline_play(notifyFD, speed, start))) {
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! I cannot start the serial pipeline", __LINE__);
+			err = WERRCODE_ERROR_SYSCALL;
+
+		} else {
+			pipeStats_t   stats;
+			brokerStats_t bstats;
+
+			// The serial port is drained by the reader thread (or the capture file is played), while the main thread
+			// (renderer) sleeps until the parser thread, the keyboard, a signal or the refresh timer wake it up
+			if (play != NULL)
+				syslog(
+					LOG_INFO, "Playback of \"%s\": %s target, %u bps, %u ms long", play, hdr.target, hdr.ttySpeed,
+					capturePlayer_duration()
+				);
+			if (headless == false) screenRefresh();
+			err = eventLoop_run();
+			if (wErrCode_isError(consErr)) err = consErr;
+			ttyPipeline_stop();
+			if (wErrCode_isError(jsonOutput_close())) err = WERRCODE_ERROR_IOOPERFAILED;
+			if (wErrCode_isError(captureFile_close())) {
 				// ERROR!
-				syslog(LOG_ERR, "ERROR! data reading operation failed: %s\n", strerror(errno));
+				syslog(LOG_ERR, "ERROR(%d)! The capture file has not been completed", __LINE__);
 				err = WERRCODE_ERROR_IOOPERFAILED;
-				
-			} else if (nb == 0) {
-				// Timeout (NO new messages)
-				//printf("!\n");
-				
-			} else if (wErrCode_isError(stringBuilder_put(chunk, nb))) {
-				// ERROR!
-				syslog(LOG_ERR, "ERROR(%d)! Out of memory", __LINE__);
-				err = 139;
-			
-			} else {
-				//syslog(LOG_INFO, "New data detected");
-				memset((void*)buff,  '\0', BUILDER_MAXSTRINGSIZE * sizeof(char));
-				
-				while (stringBuilder_get(buff) == 1) {
-					//syslog(LOG_INFO, "Acknowledged log: \"%s\"", buff);
-							
-					err = pinDef_get(buff, pin, &value);
-					if (wErrCode_isError(err)) {
-						// ERROR!
-						syslog(LOG_ERR, "ERROR(%d)! checkPinStatus() failed", __LINE__);
-	
-					} else if (err == WERRCODE_SUCCESS) {
-						// Keeping-track info
-						if (wErrCode_isError(pinsStorage_update(pin, value))) {
-							// ERROR!
-							syslog(
-								LOG_ERR, "ERROR(%d)! I cannot add the \"%s\" pin to the moniotored ones",
-								__LINE__, pin
-							);
-						}
-			
-					} else if (err == WERRCODE_WARNING_ITNOTFOUND) {
-						if (wErrCode_isError(logsStorage_add(buff)))
-							// ERROR!
-							syslog(LOG_ERR, "ERROR(%d)! I cannot store further new logs", __LINE__);
-						else {
-							//syslog(LOG_INFO, "OK the log-message has been saved");
-						}
-						
-					} else {
-						// Unknown error!
-						err = WERRCODE_ERROR_GENIRIC;
-					}
-				}	
 			}
 
-			//------------------------------------------
-			// Debug console displaying
-			//------------------------------------------
-			// NCurses display cleaning...
-			if (clear() == OK) {
-				
-				ioctl(0, TIOCGWINSZ, &ts);
-				//printf ("columns %d\n", ts.ws_col);
-
-				linePrinting('-', ts.ws_col);
-				titlePrinting("D E B U G   C O N S O L E", ts.ws_col);
-				
-				linePrinting('=', ts.ws_col);
-
-				pinsStorage_print(ts.ws_col);
-				
-				// Normal log section printing
-				linePrinting('-', ts.ws_col);
-				logsStorage_print(ts.ws_col);
-				
-				linePrinting('=', ts.ws_col);
-				
-				// Display refreshing
-				refresh();
-			
-			} else {
-				// ERROR!
-				syslog(LOG_ERR, "ERROR(%d)! NCurses library operation failed\n", __LINE__);
-				err = WERRCODE_ERROR_FROMEXTLIB;
+			ttyPipeline_stats(&stats);
+			syslog(
+				LOG_INFO, "%lu bytes received, %lu rows parsed, max queue usage %u chunks (full %u times)",
+				(unsigned long)stats.rxBytes, (unsigned long)stats.rows, stats.maxQueue, stats.fullEvents
+			);
+			if (serve != NULL) {
+				broker_stats(&bstats);
+				syslog(
+					LOG_INFO, "Broker: %u clients served (%u dropped), %lu bytes sent, %.1f ms CPU", bstats.accepted,
+					bstats.dropped, (unsigned long)bstats.sent, bstats.cpuUs / 1000.0
+				);
 			}
 		}
+		broker_stop();
 		
-		usleep(500);
-		endwin();
-		stringBuilder_close();
-		pinDef_free();
-		logsStorage_free();
-		close(ttyFD);
+		if (headless == false) {
+			endwin();
+			syslog(LOG_INFO, "%u screen refreshes in %.1f s", frames, (monotonicMs() - startTime) / 1000.0);
+		}
+		eventLoop_close();
+		for (devId_t d = 0; d < devCount; d++) {
+			stringBuilder_select(d);
+			logsStorage_select(d);
+			pinsHistory_select(d);
+			stringBuilder_close();
+			logsStorage_free();
+			pinsHistory_free();
+		}
+		capturePlayer_close();
+		rulesEngine_free();
+		close(notifyFD);
+		for (devId_t d = 0; d < devCount; d++) if (ttyFDs[d] >= 0) close(ttyFDs[d]);
 		closelog();
 	}
+	if (wErrCode_isError(err)) {
+		capturePlayer_close();
+		rulesEngine_free();
+	}
 
 	return(wErrCodeToShell(err));
 }
@@ -0,0 +1,288 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: eventLoop.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Single-threaded event loop of the debugConsole. It waits (poll) on the registered file descriptors (serial port,
+//	keyboard...), on a signalfd for SIGINT/SIGTERM/SIGWINCH and on a one-shot timerfd, so the process wakes up only
+//	when there is work to do. The handlers are called from eventLoop_run(), never from a signal context.
+//
+//	Symbols:
+//		EVLOOP_MAXFDS    Max number of registered file descriptors
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <eventLoop.h>
+
+// Registered file descriptor
+typedef struct {
+	evFdHandler_t handler;
+	void          *arg;
+} evItem_t;
+
+// The first two poll items are the signalfd and the timerfd
+#define EVLOOP_SIGITEM   0
+#define EVLOOP_TMRITEM   1
+#define EVLOOP_FIRSTFD   2
+
+static struct pollfd    pfds[EVLOOP_FIRSTFD + EVLOOP_MAXFDS];
+static evItem_t         items[EVLOOP_FIRSTFD + EVLOOP_MAXFDS];
+static nfds_t           nfds       = 0;
+static evSigHandler_t   sigCb      = NULL;
+static evTimerHandler_t tmrCb      = NULL;
+static bool             runFlag    = false;
+static uint32_t         wakeups    = 0;
+static sigset_t         oldMask;
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+werror eventLoop_init (evSigHandler_t sigHandler) {
+	//
+	// Description:
+	//	It blocks SIGINT, SIGTERM and SIGWINCH (they will be received through the signalfd), and it creates the timer.
+	//	The argument defined handler is called for every received signal.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_SYSCALL
+	//
+	werror   err = WERRCODE_SUCCESS;
+	sigset_t mask;
+	int      sfd = -1, tfd = -1;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGTERM);
+	sigaddset(&mask, SIGWINCH);
+
+	if (sigprocmask(SIG_BLOCK, &mask, &oldMask) < 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! sigprocmask() failed: %s\n", strerror(errno));
+		err = WERRCODE_ERROR_SYSCALL;
+
+	} else if ((sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC)) < 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! signalfd() failed: %s\n", strerror(errno));
+		err = WERRCODE_ERROR_SYSCALL;
+
+	} else if ((tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! timerfd_create() failed: %s\n", strerror(errno));
+		close(sfd);
+		err = WERRCODE_ERROR_SYSCALL;
+
+	} else {
+		pfds[EVLOOP_SIGITEM].fd     = sfd;
+		pfds[EVLOOP_SIGITEM].events = POLLIN;
+		pfds[EVLOOP_TMRITEM].fd     = tfd;
+		pfds[EVLOOP_TMRITEM].events = POLLIN;
+		nfds    = EVLOOP_FIRSTFD;
+		sigCb   = sigHandler;
+		tmrCb   = NULL;
+		wakeups = 0;
+	}
+
+	return(err);
+}
+
+
+werror eventLoop_add (int fd, evFdHandler_t handler, void *arg) {
+	//
+	// Description:
+	//	It registers the argument defined file descriptor: the handler will be called every time the fd is readable
+	//	(or it has been hung up)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_DATAOVERFLOW
+	//
+	werror err = WERRCODE_SUCCESS;
+
+	if (nfds >= EVLOOP_FIRSTFD + EVLOOP_MAXFDS) {
+		// ERROR!
+		err = WERRCODE_ERROR_DATAOVERFLOW;
+
+	} else {
+		pfds[nfds].fd      = fd;
+		pfds[nfds].events  = POLLIN;
+		pfds[nfds].revents = 0;
+		items[nfds].handler = handler;
+		items[nfds].arg     = arg;
+		nfds++;
+	}
+
+	return(err);
+}
+
+
+werror eventLoop_remove (int fd) {
+	//
+	// Description:
+	//	It unregisters the argument defined file descriptor
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND
+	//
+	werror err = WERRCODE_WARNING_ITNOTFOUND;
+
+	for (nfds_t t = EVLOOP_FIRSTFD; t < nfds; t++) {
+		if (pfds[t].fd == fd) {
+			// The last item fills the hole
+			nfds--;
+			pfds[t]  = pfds[nfds];
+			items[t] = items[nfds];
+			err      = WERRCODE_SUCCESS;
+			break;
+		}
+	}
+
+	return(err);
+}
+
+
+werror eventLoop_timer (uint32_t ms, evTimerHandler_t handler) {
+	//
+	// Description:
+	//	It arms the one-shot timer: the handler will be called after the argument defined time. Zero disarms it.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_SYSCALL
+	//
+	werror            err = WERRCODE_SUCCESS;
+	struct itimerspec its;
+
+	memset(&its, 0, sizeof(its));
+	its.it_value.tv_sec  = ms / 1000;
+	its.it_value.tv_nsec = (ms % 1000) * 1000000L;
+
+	if (timerfd_settime(pfds[EVLOOP_TMRITEM].fd, 0, &its, NULL) < 0) {
+		// ERROR!
+		err = WERRCODE_ERROR_SYSCALL;
+	} else
+		tmrCb = handler;
+
+	return(err);
+}
+
+
+werror eventLoop_run () {
+	//
+	// Description:
+	//	It waits for the events and it calls their handlers, until eventLoop_stop() is called
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_SYSCALL
+	//
+	werror err = WERRCODE_SUCCESS;
+
+	runFlag = true;
+	while (runFlag && err == WERRCODE_SUCCESS) {
+		if (poll(pfds, nfds, -1) < 0) {
+			if (errno != EINTR) {
+				// ERROR!
+				fprintf(stderr, "ERROR! poll() failed: %s\n", strerror(errno));
+				err = WERRCODE_ERROR_SYSCALL;
+			}
+
+		} else {
+			wakeups++;
+
+			// Signals
+			if (pfds[EVLOOP_SIGITEM].revents & POLLIN) {
+				struct signalfd_siginfo si;
+
+				while (read(pfds[EVLOOP_SIGITEM].fd, &si, sizeof(si)) == sizeof(si))
+					if (sigCb != NULL) sigCb(si.ssi_signo);
+			}
+
+			// Timer
+			if (pfds[EVLOOP_TMRITEM].revents & POLLIN) {
+				uint64_t         exp;
+				evTimerHandler_t cb = tmrCb;
+
+				if (read(pfds[EVLOOP_TMRITEM].fd, &exp, sizeof(exp)) == sizeof(exp) && cb != NULL)
+					cb();
+			}
+
+			// File descriptors (a handler can remove its fd, so the list is scanned backwards)
+			for (nfds_t t = nfds; t > EVLOOP_FIRSTFD && runFlag; t--) {
+				if (pfds[t - 1].revents & (POLLIN | POLLHUP | POLLERR)) {
+					pfds[t - 1].revents = 0;
+					items[t - 1].handler(pfds[t - 1].fd, items[t - 1].arg);
+				}
+			}
+		}
+	}
+
+	return(err);
+}
+
+
+void eventLoop_stop () {
+	//
+	// Description:
+	//	eventLoop_run() will return after the current event processing
+	//
+	runFlag = false;
+
+	return;
+}
+
+
+uint32_t eventLoop_wakeups () {
+	//
+	// Description:
+	//	It returns the number of poll() wake-ups (it is used to check that there are no useless ones)
+	//
+	return(wakeups);
+}
+
+
+void eventLoop_close () {
+	//
+	// Description:
+	//	It releases the signalfd and the timerfd, and it restores the signals mask
+	//
+	if (nfds >= EVLOOP_FIRSTFD) {
+		close(pfds[EVLOOP_SIGITEM].fd);
+		close(pfds[EVLOOP_TMRITEM].fd);
+		sigprocmask(SIG_SETMASK, &oldMask, NULL);
+	}
+	nfds = 0;
+
+	return;
+}
@@ -0,0 +1,57 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: eventLoop.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Single-threaded event loop of the debugConsole. It waits (poll) on the registered file descriptors (serial port,
+//	keyboard...), on a signalfd for SIGINT/SIGTERM/SIGWINCH and on a one-shot timerfd, so the process wakes up only
+//	when there is work to do. The handlers are called from eventLoop_run(), never from a signal context.
+//
+//	Symbols:
+//		EVLOOP_MAXFDS    Max number of registered file descriptors
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef EVENTLOOP_UT
+#define EVENTLOOP_UT
+
+#include <stdint.h>
+#include <werror.h>
+
+#define EVLOOP_MAXFDS    8
+
+typedef void (*evFdHandler_t)    (int fd, void *arg);
+typedef void (*evSigHandler_t)   (int signum);
+typedef void (*evTimerHandler_t) ();
+
+werror   eventLoop_init     (evSigHandler_t sigHandler);
+werror   eventLoop_add      (int fd, evFdHandler_t handler, void *arg);
+werror   eventLoop_remove   (int fd);
+werror   eventLoop_timer    (uint32_t ms, evTimerHandler_t handler);
+werror   eventLoop_run      ();
+void     eventLoop_stop     ();
+uint32_t eventLoop_wakeups  ();
+void     eventLoop_close    ();
+
+#endif
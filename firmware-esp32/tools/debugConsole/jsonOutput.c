@@ -0,0 +1,261 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: jsonOutput.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	JSON Lines output of the headless mode: every parsed row is written as a JSON object, one per line
+//		{"timestamp":1250,"kind":"pin","pin":"GPIO_NUM_4","symbol":"MBES_LED","value":1}
+//		{"timestamp":1251,"kind":"log","message":"I (1250) MAIN: engine started"}
+//	The symbol is null when the pin has no symbol. The message's control characters, quotes and backslashes are
+//	escaped, and the bytes greater than 0x7F are written as \u00XX (Latin-1), so the output is always valid UTF-8.
+//	The lines are collected in a JSON_BUFFSIZE bytes buffer, that is written when it is full or when jsonOutput_flush()
+//	is called (the parser calls it when the queue is empty, so the output is not delayed at low data rates).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <syslog.h>
+#include <stringBuilder.h>
+#include <jsonOutput.h>
+
+#define JSON_MAXROW      (6 * 1024 + 256)   // Max size of a JSON line (escaped message included)
+
+static int  outFd = -1;
+static char *buff = NULL;
+static int  used  = 0;
+
+
+static char* numPrinting (char *ptr, uint32_t value) {
+	//
+	// Description:
+	//	It writes the argument defined value in decimal format, and it returns the first free position
+	//
+	char     tmp[10];
+	uint8_t  n = 0;
+
+	do {
+		tmp[n++] = '0' + value % 10;
+		value   /= 10;
+	} while (value > 0);
+	while (n > 0) *ptr++ = tmp[--n];
+
+	return(ptr);
+}
+
+
+static char* strPrinting (char *ptr, const char *str, uint16_t size) {
+	//
+	// Description:
+	//	It writes the argument defined string as JSON string (quotes included), and it returns the first free position
+	//
+	static const char hex[] = "0123456789abcdef";
+
+	*ptr++ = '"';
+	for (uint16_t t = 0; t < size; t++) {
+		uint8_t c = str[t];
+
+		if (c == '"' || c == '\\') {
+			*ptr++ = '\\';
+			*ptr++ = c;
+		} else if (c < 0x20 || c > 0x7E) {
+			memcpy(ptr, "\\u00", 4);
+			ptr[4] = hex[c >> 4];
+			ptr[5] = hex[c & 0x0F];
+			ptr   += 6;
+		} else
+			*ptr++ = c;
+	}
+	*ptr++ = '"';
+
+	return(ptr);
+}
+
+
+static werror rowReserving () {
+	//
+	// Description:
+	//	It makes room for a new JSON line
+	//
+	werror err = WERRCODE_SUCCESS;
+
+	if (used + JSON_MAXROW > JSON_BUFFSIZE) err = jsonOutput_flush();
+
+	return(err);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+werror jsonOutput_open (int fd) {
+	//
+	// Description:
+	//	The JSON lines will be written in the argument defined file descriptor
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror err = WERRCODE_SUCCESS;
+
+	if ((buff = malloc(JSON_BUFFSIZE)) == NULL)
+		// ERROR!
+		err = WERRCODE_ERROR_OUTOFMEMORY;
+	else {
+		outFd = fd;
+		used  = 0;
+	}
+
+	return(err);
+}
+
+
+werror jsonOutput_pin (uint32_t tstamp, pinId_t pin, int value) {
+	//
+	// Description:
+	//	It appends a pin-state line
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror     err = rowReserving();
+	char       *ptr = buff + used;
+	char       label[PTS_PINLABSIZE];
+	const char *symbol = NULL;
+
+	if (err == WERRCODE_SUCCESS) {
+		pinId_toLabel(label, pin);
+		pinToSymbol_getById(&symbol, pin);
+
+		memcpy(ptr, "{\"timestamp\":", 13);
+		ptr = numPrinting(ptr + 13, tstamp);
+		memcpy(ptr, ",\"kind\":\"pin\",\"pin\":", 20);
+		ptr = strPrinting(ptr + 20, label, strlen(label));
+		memcpy(ptr, ",\"symbol\":", 10);
+		ptr += 10;
+		if (symbol != NULL)
+			ptr = strPrinting(ptr, symbol, strlen(symbol));
+		else {
+			memcpy(ptr, "null", 4);
+			ptr += 4;
+		}
+		memcpy(ptr, ",\"value\":", 9);
+		if (value < 0) {
+			ptr[9] = '-';
+			ptr    = numPrinting(ptr + 10, -value);
+		} else
+			ptr = numPrinting(ptr + 9, value);
+		memcpy(ptr, "}\n", 2);
+		used = ptr + 2 - buff;
+	}
+
+	return(err);
+}
+
+
+werror jsonOutput_log (uint32_t tstamp, const char *msg, uint16_t size) {
+	//
+	// Description:
+	//	It appends a log message line
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror err  = rowReserving();
+	char   *ptr = buff + used;
+
+	if (size > BUILDER_MAXSTRINGSIZE) size = BUILDER_MAXSTRINGSIZE;
+
+	if (err == WERRCODE_SUCCESS) {
+		memcpy(ptr, "{\"timestamp\":", 13);
+		ptr = numPrinting(ptr + 13, tstamp);
+		memcpy(ptr, ",\"kind\":\"log\",\"message\":", 24);
+		ptr = strPrinting(ptr + 24, msg, size);
+		memcpy(ptr, "}\n", 2);
+		used = ptr + 2 - buff;
+	}
+
+	return(err);
+}
+
+
+werror jsonOutput_flush () {
+	//
+	// Description:
+	//	It writes the buffered lines
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror err = WERRCODE_SUCCESS;
+	int    off = 0;
+
+	while (off < used && err == WERRCODE_SUCCESS) {
+		ssize_t nb = write(outFd, buff + off, used - off);
+
+		if (nb >= 0)
+			off += nb;
+		else if (errno != EINTR) {
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! JSON output writing failed: %s", __LINE__, strerror(errno));
+			err = WERRCODE_ERROR_IOOPERFAILED;
+		}
+	}
+	used = 0;
+
+	return(err);
+}
+
+
+werror jsonOutput_close () {
+	//
+	// Description:
+	//	It writes the buffered lines, and it releases the buffer (the file descriptor is not closed)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror err = WERRCODE_SUCCESS;
+
+	if (buff != NULL) {
+		err = jsonOutput_flush();
+		free(buff);
+		buff  = NULL;
+		outFd = -1;
+	}
+
+	return(err);
+}
+
+
+bool jsonOutput_isOpen () {
+	return(buff != NULL);
+}
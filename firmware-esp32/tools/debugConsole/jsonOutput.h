@@ -0,0 +1,54 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: jsonOutput.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	JSON Lines output of the headless mode: every parsed row is written as a JSON object, one per line
+//		{"timestamp":1250,"kind":"pin","pin":"GPIO_NUM_4","symbol":"MBES_LED","value":1}
+//		{"timestamp":1251,"kind":"log","message":"I (1250) MAIN: engine started"}
+//	The symbol is null when the pin has no symbol. The message's control characters, quotes and backslashes are
+//	escaped, and the bytes greater than 0x7F are written as \u00XX (Latin-1), so the output is always valid UTF-8.
+//	The lines are collected in a JSON_BUFFSIZE bytes buffer, that is written when it is full or when jsonOutput_flush()
+//	is called (the parser calls it when the queue is empty, so the output is not delayed at low data rates).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef JSONOUTPUT_UT
+#define JSONOUTPUT_UT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <werror.h>
+#include <pinToSymbol.h>
+
+#define JSON_BUFFSIZE    (256 * 1024)
+
+werror jsonOutput_open   (int fd);
+werror jsonOutput_pin    (uint32_t tstamp, pinId_t pin, int value);
+werror jsonOutput_log    (uint32_t tstamp, const char *msg, uint16_t size);
+werror jsonOutput_flush  ();
+werror jsonOutput_close  ();
+bool   jsonOutput_isOpen ();
+
+#endif
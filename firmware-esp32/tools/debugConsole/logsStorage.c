@@ -14,6 +14,16 @@
 // Description:
 //	This module provides a ring buffer where you can store the log messages. They will be saved with their time-stamp
 //
+//	Every message is a NUL terminated record written in the arena (a circular byte buffer); the index (a circular
+//	array, too) keeps the record's offset and time-stamp of every line. The lines are numbered from the oldest stored
+//	one (0) to the newest one (logsStorage_count() - 1).
+//		arena: |msg N|msg N+1|...free...|msg 1|msg 2|...|msg N-1|<unused tail>|
+//	A record never crosses the arena's end: when the tail is too short, the record is written from the beginning.
+//	Because the time-stamps are monotonic, the jump-to-time is a binary search on the index.
+//	Every device (see devices.h) has its own arena and view: the functions work on the one selected by
+//	logsStorage_select(). The arenas are allocated by the first stored message.
+//	The alerting rules' messages (see rulesEngine.h) are printed in bold.
+//
 // License:
 //	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
 //
@@ -31,132 +41,242 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
-#include <unistd.h>
-#include <sys/time.h>
 #include <stdlib.h>
 #include <string.h>
-#include <errno.h>
 #include <logsStorage.h>
+#include <rulesEngine.h>
 #include <curses.h>
 
-static logRow *newest = NULL;
-static logRow *oldest = NULL;
+// Index item
+typedef struct {
+	uint32_t offset;     // Record's position in the arena
+	uint32_t tstamp;     // Time-stamp (ms)
+} logIndex_t;
+
+// Device's logs
+typedef struct {
+	char       *arena;
+	logIndex_t *lineIdx;
+	uint32_t   wrPtr;               // Arena's write position
+	uint64_t   first;               // Sequence number of the oldest stored line
+	uint64_t   last;                // Sequence number of the next line
+	uint64_t   viewEnd;             // Sequence number of the last displayed line + 1 (scrollback mode)
+	bool       follow;              // The view shows the newest lines
+	bool       topFlag;             // viewEnd has to be computed from viewTop (jump-to-time)
+	uint64_t   viewTop;             // Sequence number of the first displayed line (jump-to-time)
+	bool       dirty;               // The view has to be redrawn
+} logsDev_t;
+
+static logsDev_t devs[DEV_MAXDEVICES] = { [0 ... DEV_MAXDEVICES - 1] = { .follow = true, .dirty = true } };
+static logsDev_t *cur = &devs[0];                // Selected device (see logsStorage_select())
+
+#define LOGS_ITEM(seq) (cur->lineIdx[(seq) % LOGS_MAXLINES])
 
 
-werror getMyEpoch(uint32_t *tstamp) {
+static void dropOldest () {
 	//
 	// Description:
-	//	It returns a time-stamp in milliseconds
+	//	It removes the oldest line
 	//
-	// Returned value:
-	//	WERRCODE_SUCCESS            Success
-	//	WERRCODE_ERROR_TIMESYNC     gettimeofday() failed
+	cur->first++;
+	if (cur->viewEnd < cur->first) cur->viewEnd = cur->first;
+
+	return;
+}
+
+
+static bool overlapOldest (uint32_t start, uint32_t size) {
 	//
-	werror         err = WERRCODE_SUCCESS;
-	static long int tZero = 0;
-	struct timeval tv = {0, 0};
+	// Description:
+	//	It checks if the argument defined arena's area overlaps the oldest stored record. The records are contiguous,
+	//	so the ones before the write position are newer, and the oldest one overlaps only when it starts in the area.
+	//
+	bool flag = false;
 
-	if (gettimeofday(&tv,NULL) < 0)
-		// ERROR!
-		err = WERRCODE_ERROR_TIMESYNC;
-		
-	else if (tZero == 0) {
-		tZero = tv.tv_sec*1000 + tv.tv_usec/1000;
-		*tstamp = 0;
-		
-	} else 
-		*tstamp = (tv.tv_sec*1000 + tv.tv_usec/1000) - tZero;
-	
-	return(err);
+	if (cur->first < cur->last) {
+		uint32_t o = LOGS_ITEM(cur->first).offset;
+		flag = (o >= start && o < start + size);
+	}
+	return(flag);
 }
 
 
-void printSingleMsg (const logRow *item, uint16_t cols) {
+static void printSingleMsg (WINDOW *win, const char *msg, uint32_t tstamp, uint16_t cols) {
 	//
 	// Description:
 	//	It prints a log message in the console's log-section. But if the message is too much long, then the function
 	//	will trunc the message is a nice way
 	//
-	printw("%5d: ", item->tstamp);
-	if (strlen(item->message) > (cols - 16)) {
-		for (uint16_t x=0; x<(cols - 16); x++) printw("%c", item->message[x]);
-		printw("...\n");
-	} else 
-		printw("%s\n", item->message);
+	bool alert = (strncmp(msg, RULES_ALERTMARK, sizeof(RULES_ALERTMARK) - 1) == 0);
+
+	if (alert) wattron(win, A_BOLD);
+	wprintw(win, "%5d: ", tstamp);
+	if (strlen(msg) > (cols - 16))
+		wprintw(win, "%.*s...\n", (cols - 16), msg);
+	else 
+		wprintw(win, "%s\n", msg);
+	if (alert) wattroff(win, A_BOLD);
 		
 	return;
 }
 
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+void logsStorage_select (devId_t dev) {
+	//
+	// Description:
+	//	It selects the logs of the argument defined device (the device 0 is selected by default)
+	//
+	cur = &devs[(dev < DEV_MAXDEVICES) ? dev : 0];
+
+	return;
+}
+
 
-logRow* new_logRow (logRow *item) {
+werror logsStorage_add (const char *logMsg, uint16_t size, uint32_t tstamp) {
 	//
 	// Description:
-	//	This function creates a new object, links it to the argument defined object, and sets the log timestamp field
+	//	It stores the argument defined message (size = message's length, terminator excluded). When there is no room
+	//	for it, the oldest messages are dropped. The time-stamps have to be monotonic.
 	//
 	// Returned value:
-	//	NULL:         malloc() failed
-	//	<valid addr>: The new-oject's address
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
 	//
-	logRow *newObj = (logRow*)malloc(sizeof(logRow));
+	werror err = WERRCODE_SUCCESS;
+
+	if (cur->arena == NULL) {
+		cur->arena   = (char*)malloc(LOGS_ARENASIZE);
+		cur->lineIdx = (logIndex_t*)malloc(LOGS_MAXLINES * sizeof(logIndex_t));
+	}
+
+	if (cur->arena == NULL || cur->lineIdx == NULL) {
+		// ERROR!
+		fprintf(stderr, "ERROR(%d)! logs arena allocation failed", __LINE__);
+		free(cur->arena);
+		free(cur->lineIdx);
+		cur->arena   = NULL;
+		cur->lineIdx = NULL;
+		err     = WERRCODE_ERROR_OUTOFMEMORY;
 
-	if (newObj != NULL) {
-		// Object creation
-		newObj->message[0] = '\0';
-		newObj->tstamp     = 0;
-		newObj->next       = NULL;
+	} else {
+		// The record does not fit in the arena's tail: it is written from the beginning, and the previous lap's
+		// records still stored in the tail are dropped
+		if (cur->wrPtr + size + 1 > LOGS_ARENASIZE) {
+			while (cur->first < cur->last && LOGS_ITEM(cur->first).offset >= cur->wrPtr) dropOldest();
+			cur->wrPtr = 0;
+		}
+
+		// Room making
+		while (overlapOldest(cur->wrPtr, size + 1)) dropOldest();
+		if (cur->last - cur->first == LOGS_MAXLINES) dropOldest();
+
+		memcpy(cur->arena + cur->wrPtr, logMsg, size);
+		cur->arena[cur->wrPtr + size] = '\0';
 
-		// Object linking
-		if (item != NULL) item->next = newObj;
+		LOGS_ITEM(cur->last).offset = cur->wrPtr;
+		LOGS_ITEM(cur->last).tstamp = tstamp;
+		cur->last++;
+		cur->wrPtr += size + 1;
+		cur->dirty  = true;
 	}
-	
-	return(newObj);
+
+	return(err);
 }
 
-//-----------------------------------------------------------------------------------------------------------------------------
-//                                       P U B L I C   F U N C T I O N S
-//-----------------------------------------------------------------------------------------------------------------------------
-werror logsStorage_add (const char *logMsg) {
+
+werror logsStorage_get (uint32_t line, const char **logMsg, uint32_t *tstamp) {
 	//
 	// Description:
+	//	It returns the argument defined line (0 = the oldest stored one). The message pointer is valid until the next
+	//	logsStorage_add() call.
 	//
 	// Returned value:
 	//	WERRCODE_SUCCESS
-	//	WERRCODE_ERROR_OUTOFMEMORY
+	//	WERRCODE_WARNING_ITNOTFOUND
 	//
-	werror          err = WERRCODE_SUCCESS;
-	static uint16_t logCounter = 0;
-	static bool     ringFlag = false;
-
-	if (logCounter < TTY_MAXLOGLINES) {
-		newest = new_logRow(newest);
-		if (newest == NULL) {
-			// ERROR!
-			err = WERRCODE_ERROR_OUTOFMEMORY;
-			fprintf(stderr, "ERROR(%d)! new_logRow() failed", __LINE__);
-			
-		} else {
-			if (logCounter == 0) oldest = newest;
-			logCounter++;
-		}
+	werror err = WERRCODE_WARNING_ITNOTFOUND;
 
-	} else {
-		// It closes the ring structure
-		if (ringFlag == false) {
-			newest->next = oldest;
-			ringFlag = true;
-		}
-		newest = oldest;
-		oldest = oldest->next ;
+	if (cur->first + line < cur->last) {
+		*logMsg = cur->arena + LOGS_ITEM(cur->first + line).offset;
+		*tstamp = LOGS_ITEM(cur->first + line).tstamp;
+		err     = WERRCODE_SUCCESS;
 	}
-	strcpy(newest->message, logMsg);
-		
-	// Timestamp
-	if (getMyEpoch(&(newest->tstamp)) == 0) {
-		// ERROR!
-		fprintf(stderr, "ERROR! System-time retriving operation failed: %s\n", strerror(errno));
+	return(err);
+}
+
+
+uint32_t logsStorage_count () {
+	//
+	// Description:
+	//	It returns the number of stored lines
+	//
+	return(cur->last - cur->first);
+}
+
+
+uint32_t logsStorage_find (uint32_t tstamp) {
+	//
+	// Description:
+	//	It returns the first line whose time-stamp is equal or greater than the argument defined one (binary search).
+	//	logsStorage_count() is returned when every line is older.
+	//
+	uint64_t lo = cur->first, hi = cur->last;
+
+	while (lo < hi) {
+		uint64_t mid = lo + (hi - lo) / 2;
+		if (LOGS_ITEM(mid).tstamp < tstamp) lo = mid + 1;
+		else                                 hi = mid;
 	}
+	return(lo - cur->first);
+}
 
-	return(err);
+
+void logsStorage_scroll (int32_t lines) {
+	//
+	// Description:
+	//	It moves the view up (lines < 0) or down (lines > 0). The view follows the new lines again when its end
+	//	reaches the newest one.
+	//
+	if (cur->follow) cur->viewEnd = cur->last;
+	cur->topFlag = false;
+
+	if (lines < 0 && (cur->viewEnd - cur->first) <= (uint64_t)(-lines))
+		cur->viewEnd = (cur->first < cur->last) ? cur->first + 1 : cur->first;
+	else
+		cur->viewEnd += lines;
+
+	cur->follow = (cur->viewEnd >= cur->last);
+	cur->dirty  = true;
+
+	return;
+}
+
+
+void logsStorage_jump (uint32_t tstamp) {
+	//
+	// Description:
+	//	It moves the view to the first line logged at the argument defined time (or later)
+	//
+	cur->viewTop = cur->first + logsStorage_find(tstamp);
+	cur->topFlag = true;
+	cur->follow  = (cur->viewTop >= cur->last);
+	cur->dirty   = true;
+
+	return;
+}
+
+
+void logsStorage_follow () {
+	//
+	// Description:
+	//	The view will show the newest lines
+	//
+	cur->follow = true;
+	cur->dirty  = true;
+
+	return;
 }
 
 
@@ -165,33 +285,69 @@ void logsStorage_free() {
 	// Description:
 	//	It release all dinamically allocated memory
 	//
-	logRow *ptr = NULL;
-	while (oldest != newest) {
-		ptr = oldest;
-		oldest = oldest->next;
-		free(ptr);
-	}
-	if (oldest != NULL) free(oldest);
-	
+	free(cur->arena);
+	free(cur->lineIdx);
+	cur->arena   = NULL;
+	cur->lineIdx = NULL;
+	cur->wrPtr   = 0;
+	cur->first   = cur->last = cur->viewEnd = cur->viewTop = 0;
+	cur->follow  = true;
+	cur->topFlag = false;
+	cur->dirty   = true;
+
 	return;
 }
 
 
-void logsStorage_print (uint16_t cols) {
+bool logsStorage_isDirty () {
 	//
 	// Description:
-	//	It prints all the archived logs
+	//	It returns true when the view has changed (new lines, scrolling...) since the last logsStorage_print() call
 	//
-	logRow *ptr = oldest;
-		if (ptr != NULL) {
-		while (ptr != newest) {
-			printSingleMsg(ptr, cols);
-			ptr = ptr->next;
+	return(cur->dirty);
+}
+
+
+void logsStorage_print (WINDOW *win, uint16_t cols, uint16_t rows) {
+	//
+	// Description:
+	//	It prints the last "rows" lines of the view in the argument defined window. In scrollback mode the last row is
+	//	used by the status bar.
+	//
+	uint64_t end, start;
+
+	if (cur->first == cur->last)
+		wprintw(win, "\n\n\n       EMPTY!!\n\n\n");
+
+	else {
+		if (cur->follow == false && rows > 1) rows--;
+
+		// View's end computing (a full page is always displayed)
+		if (cur->topFlag && cur->follow == false) {
+			if (cur->viewTop < cur->first) cur->viewTop = cur->first;
+			end     = (cur->viewTop + rows < cur->last) ? cur->viewTop + rows : cur->last;
+			cur->topFlag = false;
+		} else
+			end = (cur->follow || cur->viewEnd > cur->last) ? cur->last : cur->viewEnd;
+
+		if (end - cur->first < rows) end = (cur->first + rows < cur->last) ? cur->first + rows : cur->last;
+		if (cur->follow == false) cur->viewEnd = end;
+
+		start = (end - cur->first > rows) ? end - rows : cur->first;
+
+		for (uint64_t t = start; t < end; t++)
+			printSingleMsg(win, cur->arena + LOGS_ITEM(t).offset, LOGS_ITEM(t).tstamp, cols);
+
+		if (cur->follow == false) {
+			wattron(win, A_REVERSE);
+			wprintw(
+				win, " SCROLLBACK %u/%u  [PgUp/PgDn/Home] scroll  [t] jump to time  [End] follow ",
+				(uint32_t)(end - cur->first), (uint32_t)(cur->last - cur->first)
+			);
+			wattroff(win, A_REVERSE);
 		}
-		printSingleMsg(newest, cols);
-		
-	} else
-		printw("\n\n\n       EMPTY!!\n\n\n");
-	
+	}
+	cur->dirty = false;
+
 	return;
 }
@@ -12,7 +12,13 @@
 // Author: Silvano Catinella <catinella@yahoo.com>
 //
 // Description:
+//	This module stores the log messages with their time-stamp. The messages are saved as variable-length records in a
+//	contiguous arena, and an offset index allows the random access to every line (scrollback, jump-to-time). When the
+//	arena or the index is full, the oldest messages are dropped.
 //
+//	Symbols:
+//		LOGS_ARENASIZE   Size (bytes) of the messages arena
+//		LOGS_MAXLINES    Max number of stored lines (index size)
 //
 // License:
 //	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
@@ -31,22 +37,26 @@
 #ifndef LOGSSTORAGE_UT
 #define LOGSSTORAGE_UT
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <curses.h>
 #include <werror.h>
-#include <stringBuilder.h>
+#include <devices.h>
 
-#define TTY_MAXLOGLINES   16
+#define LOGS_ARENASIZE   (16 * 1024 * 1024)
+#define LOGS_MAXLINES    (512 * 1024)
 
-// Saved log item
-typedef struct _logRow {
-	char           message[BUILDER_MAXSTRINGSIZE];
-	uint32_t       tstamp;
-	struct _logRow *next;
-} logRow;
 
-
-
-werror logsStorage_add (const char *logMsg);
-void logsStorage_print (uint16_t cols);
-void logsStorage_free  ();
+void     logsStorage_select  (devId_t dev);
+werror   logsStorage_add     (const char *logMsg, uint16_t size, uint32_t tstamp);
+werror   logsStorage_get     (uint32_t line, const char **logMsg, uint32_t *tstamp);
+uint32_t logsStorage_count   ();
+uint32_t logsStorage_find    (uint32_t tstamp);
+void     logsStorage_scroll  (int32_t lines);
+void     logsStorage_jump    (uint32_t tstamp);
+void     logsStorage_follow  ();
+void     logsStorage_print   (WINDOW *win, uint16_t cols, uint16_t rows);
+bool     logsStorage_isDirty ();
+void     logsStorage_free    ();
 
 #endif
@@ -30,306 +30,240 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
-#include <regex.h>
-#include <errno.h>
 #include <string.h>
 #include <ctype.h>
 #include <pinToSymbol.h>
-		
-static ptsDbItem_t ptsDb[PTS_MAXPINS];
-static bool        initFlag = false;
-static regex_t     pinDef_regx;
+#include <pinToSymbol_map.h>                     // Generated from the firmware's header (see pinToSymbol_gen.awk)
 
-	
-werror _iatoi (int *dst, const char *src) {
+static const ptsDbItem_t *devDb[DEV_MAXDEVICES] = { [0 ... DEV_MAXDEVICES - 1] = ptsDb };
+static const ptsDbItem_t **db = &devDb[0];          // Selected device's table (indexed by the numeric pin-ID)
+
+#ifdef TARGET_AVR8
+static const char  pinPorts[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+#elifdef TARGET_ESP32
+static const char  pinPrefix[] = "GPIO_NUM_";
+#endif
+
+#define PTS_ISDIGIT(c) ((c) >= '0' && (c) <= '9')
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P R I V A T E   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+static const char* _pinLabel_scan (const char *str, uint32_t *id, bool *ovf) {
 	//
 	// Description:
-	//	Intelligent atoi() function
-	//
-	// Arguments:
-	//	dst:  the converted number
-	//	src:  the characters string version of the number
+	//	It scans the pin's label at the beginning of the argument defined string, and it computes the numeric pin-ID.
+	//	For AVR8 the ID is a perfect hash of the port-pin couple: (index of the port in pinPorts) * 10 + pin number.
 	//
-	// Returned vale:
-	//	WERRCODE_SUCCESS
-	//	WERRCODE_ERROR_INVALIDDATA
+	// Returned value:
+	//	The pointer to the first character after the label, or NULL when no label has been found. The ovf flag is set
+	//	when the ID is greater than PTS_MAXPINID
 	//
-	werror  err  = WERRCODE_SUCCESS;
-	
-	if (strlen(src) > 0) {
-		uint8_t t    = 0;
-		char    *ptr = (char*)src;
-		
-		// Zero padding removing...
-		while (src[t] == '0' && src[t] != '\0') t++;
-	
-		if (src[t] == '\0')
-			// 00000.. = 0
-			*dst = 0;
-			
-		else {
-			*dst = atoi(ptr);
-	
-			// Checking for atoi() error
-			if (dst == 0)
-				// ERROR!
-				// The string contains not-numeric characters too
-				err = WERRCODE_ERROR_INVALIDDATA; 
+	const char *ptr = NULL;
+
+	*id  = 0;
+	*ovf = false;
+
+#ifdef TARGET_AVR8
+	const char *port = (str[0] != '\0') ? strchr(pinPorts, str[0]) : NULL;
+
+	if (port != NULL && PTS_ISDIGIT(str[1])) {
+		*id = (port - pinPorts) * 10 + (str[1] - '0');
+		ptr = str + 2;
+	}
+
+#elifdef TARGET_ESP32
+	if (strncmp(str, pinPrefix, sizeof(pinPrefix) - 1) == 0 && PTS_ISDIGIT(str[sizeof(pinPrefix) - 1])) {
+		ptr = str + sizeof(pinPrefix) - 1;
+		while (PTS_ISDIGIT(*ptr)) {
+			*id = *id * 10 + (*ptr - '0');
+			if (*id >= PTS_MAXPINID) {
+				*ovf = true;
+				*id  = PTS_MAXPINID;
+			}
+			ptr++;
 		}
-	} else
-		// ERROR!
-		// Empty data is not allowed
-		err = WERRCODE_ERROR_INVALIDDATA;
-		
-	return(err);
+	}
+#endif
+
+	return(ptr);
 }
 
 //-----------------------------------------------------------------------------------------------------------------------------
 //                                       P U B L I C   F U N C T I O N S
 //-----------------------------------------------------------------------------------------------------------------------------
 
-werror pinToSymbol_get (char *symbol, const char *pin) {
+werror pinToSymbol_getById (const char **symbol, pinId_t pin) {
 	//
 	// Description:
-	//	This function find the symbol associated to the argument defined pin and write it in the "symbol" argument.
+	//	This function returns the symbol associated to the argument defined pin. The DB is indexed by the pin-ID, so
+	//	no search is required, and the returned pointer refers to the module's DB (nothing is copied). The DB is the
+	//	table generated at build time, unless the selected device uses another one (see pinToSymbol_use()).
 	//
-	// Arguments:
-	//	symbol:  It is used to store symbol you are looking for
-	// 	pin:     The pin associated to the symbol
-	//	
 	// Returned value:
 	//	WERRCODE_SUCCESS
 	//	WERRCODE_WARNING_ITNOTFOUND
-	//	WERRCODE_ERROR_INITFAILED
 	//
-	werror ecode;
+	werror ecode = WERRCODE_SUCCESS;
 
-	if (initFlag == false)
-		if (wErrCode_isError(pinToSymbol_init(PTS_PINMAPFILE)))
-			// ERROR!
-			ecode = WERRCODE_ERROR_INITFAILED;
-	
-	if (initFlag == true) {
-		uint8_t dbIndex = 0;
-		
+	if (pin >= PTS_MAXPINID || (*db)[pin].symbol[0] == '\0')
 		ecode = WERRCODE_WARNING_ITNOTFOUND;
-		while (ptsDb[dbIndex].pin[0] != '\0' && dbIndex < PTS_MAXPINS) {
-			if (strcmp(ptsDb[dbIndex].pin, pin) == 0) {
-				ecode = WERRCODE_SUCCESS;
-				strcpy(symbol, ptsDb[dbIndex].symbol);
-				break;
-			} else {
-				dbIndex++;
-			}
-		}
-	}
+	else
+		*symbol = (*db)[pin].symbol;
+
 	return(ecode);
 }
 
 
+void pinToSymbol_select (devId_t dev) {
+	//
+	// Description:
+	//	It selects the table of the argument defined device (the device 0 is selected by default)
+	//
+	db = &devDb[(dev < DEV_MAXDEVICES) ? dev : 0];
 
-werror pinToSymbol_init (const char *headerFile) {
+	return;
+}
+
+
+void pinToSymbol_use (const ptsDbItem_t *table) {
 	//
 	// Description:
-	//	Initialization procedure. It reads the mbesPinsMap.h file as a text one, and stores all pin-symbol associations
-	//	inside the module's static array.
+	//	The selected device uses the argument defined table (PTS_MAXPINID items, indexed by pin-ID). It is not
+	//	copied, so it must be valid until it is replaced. NULL restores the table generated at build time.
 	//
+	*db = (table != NULL) ? table : ptsDb;
+
+	return;
+}
+
+
+werror pinToSymbol_get (char *symbol, const char *pin) {
+	//
+	// Description:
+	//	This function find the symbol associated to the argument defined pin and write it in the "symbol" argument.
+	//
+	// Arguments:
+	//	symbol:  It is used to store symbol you are looking for
+	// 	pin:     The pin associated to the symbol
+	//	
 	// Returned value:
 	//	WERRCODE_SUCCESS
-	//	WERRCODE_ERROR_IOOPERFAILED
-	//	WERRCODE_ERROR_REGEXCOMP
+	//	WERRCODE_WARNING_ITNOTFOUND
 	//
-	regex_t reegex_a, reegex_b;
-	int     ea = 0,   eb = 0;     // Regexes error codes
-	 werror ecode = WERRCODE_SUCCESS;
-	
-	// DB cleaning
-	for (uint8_t t=0; t<PTS_MAXPINS; t++) {
-		ptsDb[t].pin[0]    = '\0';
-		ptsDb[t].symbol[0] = '\0';
-	}
-		
-	if (
-		(ea = regcomp(&reegex_a, PTS_DEFAREGEX, 0)) == 0 &&
-		(eb = regcomp(&reegex_b, PTS_DEFBREGEX, 0)) == 0
-	) { 
-		FILE   *FH = NULL;
-			
-		if ((FH = fopen(headerFile, "r")) == NULL) {
-			// ERROR!
-			fprintf(stderr, "ERROR! I cannot open the \"%s\" file: %s\n", headerFile, strerror(errno));
-			ecode = WERRCODE_ERROR_IOOPERFAILED;
-		
-		} else {
-			size_t     size = PTS_ROWMAXSIZE;
-			char       *row = (char*)malloc(size * sizeof(char)); // getline() requires dinamically allocated memory!!
-			regmatch_t pmatch[3]; // Up to 3 sub-expressions
-			char       tmp[PTS_ROWMAXSIZE];
-			uint8_t    t = 0, x = 0, st = 0;
-			uint8_t    dbIndex = 0;
-			
-			if (row == NULL) ecode = 0;
-				
-			while (feof(FH) == 0 && ecode == 1) {
-				if (getline(&row, &size, FH) < 0 && errno != 0) {
-					// ERROR!
-					fprintf(stderr, "ERROR! data readingfailed: %s\n", strerror(errno));
-					ecode = WERRCODE_ERROR_IOOPERFAILED;
-					break;
-						
-				} else if (regexec(&reegex_a, row, 3, pmatch, 0) == 0) {
-					// "#define[ \t]\+" ereasing...
-					strcpy (tmp, (row + pmatch[0].rm_eo));
-					
-					if (regexec(&reegex_b, tmp, 3, pmatch, 0) == 0) {
-						// TODO: inside definition comments deleting
-						//       (#define <pin> /*<comment*/ <symbol>
-						
-						*(tmp+pmatch[0].rm_eo+1) = '\0';
-						t = 0; x = 0; st = 0;
-						
-						while (tmp[t] != '\0') {
-							if (st == 0) {
-								//
-								// Symbol name recording...
-								//
-								if (tmp[t] != ' ' && tmp[t] != '\t') {
-									(ptsDb[dbIndex].symbol)[x] = tmp[t];
-									x++;
-								} else {
-									(ptsDb[dbIndex].symbol)[x] = '\0';
-									//printf("Symbol:%s\n", ptsDb[dbIndex].symbol);
-									st = 1;
-									x = 0;
-								}
-								
-							} else if (st == 1) {
-#ifdef TARGET_AVR8
-									// In AVR8 GPIOs are identified by a two chars string (eg. "A1")
-									if (tmp[t] == '"') st = 2;
-#elifdef TARGET_ESP32
-									// In ESP32 GPIO-ID is a symbol (eg. GPIO_NUM_0)
-									if (isalnum(tmp[t])) {
-										st = 2;
-										(ptsDb[dbIndex].pin)[x] = tmp[t];
-										x++;
-									}
-#endif 
-									
-							} else if (st == 2) {
-								//
-								// PIN name recording...
-								//
-#ifdef TARGET_AVR8
-								if (tmp[t] != '"') {
-#elifdef TARGET_ESP32
-								if (isalnum(tmp[t]) || tmp[t] == '_') {
-#endif
-									ptsDb[dbIndex].pin[x] = tmp[t];
-									x++;
-								} else {
-									ptsDb[dbIndex].pin[x] = '\0';
-									//printf("PIN: %s\n", ptsDb[dbIndex].pin);
-									break;
-								}
-							}
-							t++;
-						}
-						dbIndex++;
-					}
-				}
-
-				// The following lines-code block shows you the ptsDb content  (it is just for debug)
-			//	{
-			//		uint8_t dbIndex = 0;
-			//		while (ptsDb[dbIndex].pin[0] != '\0' && dbIndex < CONS_MAXPINS) {
-			//			printf("%s (%s)\n", ptsDb[dbIndex].symbol, ptsDb[dbIndex].pin);
-			//			dbIndex++;
-			//		}
-			//	}
-			}
-			fclose(FH);
-			free(row);
-			regfree(&reegex_a);
-			regfree(&reegex_b);
-		}
-	} else {
-		// ERROR!
-		char regErrBuff[128];
-		if (ea != 0) {
-			regerror(errno, &reegex_a, regErrBuff, 128);
-			fprintf(stderr, "ERROR! I cannot compile the \"%s\" regex: %s\n", PTS_DEFAREGEX, regErrBuff);
-		}
-		if (eb != 0) {
-			regerror(errno, &reegex_b, regErrBuff, 128);
-			fprintf(stderr, "ERROR! I cannot compile the \"%s\" regex: %s\n", PTS_DEFBREGEX, regErrBuff);
-		}
-		ecode = WERRCODE_ERROR_REGEXCOMP;
+	werror     ecode = WERRCODE_WARNING_ITNOTFOUND;
+	pinId_t    id;
+	const char *ptr   = NULL;
+
+	if (pinId_fromLabel(pin, &id) == WERRCODE_SUCCESS) {
+		ecode = pinToSymbol_getById(&ptr, id);
+		if (ecode == WERRCODE_SUCCESS)
+			strcpy(symbol, ptr);
 	}
-	
-	if (wErrCode_isSuccess(ecode)) initFlag = true;
-	
 	return(ecode);
 }
 
 
 
-werror pinDef_get (const char *log, char *pin, int *value) {
+werror pinDef_get (const char *log, pinId_t *pin, int *value) {
 	//
 	// Description:
 	//	This function checks for special-log syntax inside the argument defined (log) string.
 	//	The special ones are used to keep track of the pins' value, and they have to respect the following syntax:
-	//		<port><pin-number>:<int value> // port=<A-Z>, pin=<0-9>, value=<0..n>
+	//		ESP32: GPIO_NUM_<n>:<int value>
+	//		AVR8:  <port><pin-number>:<int value> // port=<A-Z0-9>, pin=<0-9>, value=<0..n>
+	//	The string is scanned once, and it is never modified.
 	//
 	// Arguments:
 	//	log:    The received log message
-	//	pin:    The memory area where the pin-id will be stored
+	//	pin:    The numeric pin-id (see pinId_toLabel())
 	//	value:  The area where the pin'svalue will be stored. It can be an ADC result, too.
 	//
 	// Returned value:
 	//	WERRCODE_SUCCESS
-	//	WERRCODE_WARNING_ITNOTFOUND
-	//	WERRCODE_ERROR_REGEXCOMP
-	//	WERRCODE_ERROR_INVALIDDATA
+	//	WERRCODE_WARNING_ITNOTFOUND   It is just a normal log message
+	//	WERRCODE_ERROR_INVALIDDATA    Pin-id or value out of range
 	//
-	static bool    initFlag = false;
-	werror         err = WERRCODE_SUCCESS;
-	
-	if (initFlag == false) {
-		if (regcomp(&pinDef_regx, CONS_PINDEMATCH, 0) == 0) {
-			initFlag = true;
-		} else {
-			// ERROR!
-			char regErrBuff[128];
-			regerror(errno, &pinDef_regx, regErrBuff, 128);
-			fprintf(stderr, "ERROR(%d)! I cannot compile the regex: %s", __LINE__, regErrBuff);
-			err = WERRCODE_ERROR_REGEXCOMP;
-		}
-	} 
-	
-	if (initFlag) {
-		regmatch_t pmatch[3];
-		char       strValue[16]; 
-		
-		if (regexec(&pinDef_regx, log, 3, pmatch, 0) == 0) {
-			strcpy(strValue, (strchr(log, ':') + 1));
-			*strchr(log, ':') = '\0';
-			strcpy(pin, log);
-			
-			if (wErrCode_isError(_iatoi(value, strValue))) {
-				// ERROR!
-				err = WERRCODE_ERROR_INVALIDDATA;
+	werror     err = WERRCODE_WARNING_ITNOTFOUND;
+	uint32_t   id   = 0;
+	int64_t    v    = 0;
+	bool       ovf  = false;
+	const char *ptr = _pinLabel_scan(log, &id, &ovf);      // It points to the ':' character when the pin is valid
+
+	if (ptr != NULL && *ptr == ':' && PTS_ISDIGIT(ptr[1])) {
+		ptr++;
+		while (PTS_ISDIGIT(*ptr)) {
+			v = v * 10 + (*ptr - '0');
+			if (v > INT32_MAX) {
+				ovf = true;
+				v   = INT32_MAX;
 			}
-		} else
+			ptr++;
+		}
+
+		if (*ptr != '\0')
 			// It is just a normal log message
 			err = WERRCODE_WARNING_ITNOTFOUND;
+
+		else if (ovf)
+			// ERROR!
+			err = WERRCODE_ERROR_INVALIDDATA;
+
+		else {
+			*pin   = (pinId_t)id;
+			*value = (int)v;
+			err    = WERRCODE_SUCCESS;
+		}
 	}
-	
+
 	return(err);
 }
 
 
-void pinDef_free() {
-	regfree(&pinDef_regx);
-	return;
+werror pinId_fromLabel (const char *label, pinId_t *pin) {
+	//
+	// Description:
+	//	It converts the argument defined pin's label (eg. "GPIO_NUM_12" or "B3") to the numeric pin-ID
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_INVALIDDATA   It is not a pin label, or its ID is out of range
+	//
+	werror     ecode = WERRCODE_ERROR_INVALIDDATA;
+	uint32_t   id;
+	bool       ovf;
+	const char *ptr = _pinLabel_scan(label, &id, &ovf);
+
+	if (ptr != NULL && *ptr == '\0' && ovf == false) {
+		*pin  = (pinId_t)id;
+		ecode = WERRCODE_SUCCESS;
+	}
+	return(ecode);
+}
+
+
+werror pinId_toLabel (char *label, pinId_t pin) {
+	//
+	// Description:
+	//	It writes the argument defined pin's label (eg. "GPIO_NUM_12" or "B3") in the label buffer (PTS_PINLABSIZE)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG    Out of range pin-id
+	//
+	werror ecode = WERRCODE_SUCCESS;
+
+	if (pin >= PTS_MAXPINID)
+		// ERROR!
+		ecode = WERRCODE_ERROR_ILLEGALARG;
+	else {
+#ifdef TARGET_AVR8
+		label[0] = pinPorts[pin / 10];
+		label[1] = '0' + (pin % 10);
+		label[2] = '\0';
+#elifdef TARGET_ESP32
+		sprintf(label, "%s%d", pinPrefix, pin);
+#endif
+	}
+	return(ecode);
 }
@@ -16,15 +16,23 @@
 //	file.	Because the pins labels (they are symbols too) depend by the MCU and the used librarries, you have yo define
 //	the used arch. You can set it using the TARGET_ARCH Make's symbol
 //
+//	The pin-symbol couples of the firmware's header (main/mbesPinsMap.h) are converted into a C-language table at build
+//	time (pinToSymbol_gen.awk generates the pinToSymbol_map.h file), so no file is read at runtime. Every device (see
+//	devices.h) can use another table, e.g. the one announced by its firmware (see ptsCache.h), by pinToSymbol_use().
+//	The functions work on the device selected by pinToSymbol_select().
+//
 //	Symbols description:
-//		[PTS_PINMAPFILE]  Header file where every pin-symbol couple is defined
-//		PTS_MAXPINS       Maximum number of pins defined in the header file
-//		PTS_ROWMAXSIZE    Maximum length of the pin-symbol map file rows
+//		PTS_ROWMAXSIZE    Maximum length of the text rows that contain pin labels (e.g. the rules files ones, see rulesEngine.h)
 //		PTS_MAXSYMSIZE
 //		-------- Platform dependent symbols -------- 
-//		PTS_DEFBREGEX     Regex used to match the pin definition (without ^#define). The pattern depends by the platform
 //		PTS_PINLABSIZE    PIN's label-size. This size depends by the platform's library (avr.h, esp-idf...)
-//		CONS_PINDEMATCH   Regex used to check for pin definiton
+//		PTS_MAXPINID      Number of the valid numeric pin IDs (pinId_t)
+//
+//	Numeric pin IDs:
+//		The pin-tracking logs are parsed by a hand-written scanner, and the pin is returned as a number (pinId_t):
+//			ESP32:  GPIO_NUM_<n>:<value>          ID = n
+//			AVR8:   <port><digit>:<value>         ID = (index of <port> in "A..Z0..9") * 10 + <digit>
+//		Use pinId_toLabel() to get the pin's label back. The pin-symbol DB is indexed by the pin-ID.
 //
 //
 // License:
@@ -46,12 +54,11 @@
 
 #include <stdint.h>
 #include <werror.h>
+#include <devices.h>
 
 //
 // Platform independent symbols
 //
-#define PTS_MAXPINS      32
-#define PTS_DEFAREGEX    "^[ \t]*#define[ \t]\\+"
 #define PTS_ROWMAXSIZE   256
 #define PTS_MAXSYMSIZE   24
 
@@ -60,20 +67,21 @@
 // Platform dependant symbols
 //
 #ifdef TARGET_AVR8
-#define PTS_DEFBREGEX    "^[io]_[A-Z0-9]\\+ \\+\"[A-Z0-9][0-9]\""
-#define CONS_PINDEMATCH   "^[A-Z0-9][0-9]:[0-9]\\+$"
 #define PTS_PINLABSIZE   3
+#define PTS_MAXPINID     360
 
 #elifdef TARGET_ESP32
-#define PTS_DEFBREGEX    "^[io]_[A-Z0-9]\\+ \\+GPIO_NUM_[0-9]\\+"
-#define CONS_PINDEMATCH   "^GPIO_NUM_[0-9]\\+:[0-9]\\+$"
 #define PTS_PINLABSIZE   16
+#define PTS_MAXPINID     256
 
 #else
 #error "ERROR! TARGET_<ARCH> has not been defined or it is an unknown one"
 #endif
 
 
+// Numeric pin ID
+typedef uint16_t pinId_t;
+
 // Pins-Symbols associations DB item
 typedef struct {
 	char pin[PTS_PINLABSIZE];
@@ -83,9 +91,12 @@ typedef struct {
 //------------------------------------------------------------------------------------------------------------------------------
 //                                         P U B L I C   F U N C T I O N S
 //------------------------------------------------------------------------------------------------------------------------------
-werror pinToSymbol_get  (char *symbol, const char *pin);
-werror pinToSymbol_init (const char *headerFile);
-werror pinDef_get       (const char *log, char *pin, int *value);
-void   pinDef_free      ();
+werror pinToSymbol_get     (char *symbol, const char *pin);
+werror pinToSymbol_getById (const char **symbol, pinId_t pin);
+void   pinToSymbol_select  (devId_t dev);
+void   pinToSymbol_use     (const ptsDbItem_t *table);
+werror pinDef_get          (const char *log, pinId_t *pin, int *value);
+werror pinId_fromLabel     (const char *label, pinId_t *pin);
+werror pinId_toLabel       (char *label, pinId_t pin);
 
 #endif
@@ -0,0 +1,89 @@
+#-------------------------------------------------------------------------------------------------------------------------------
+#
+#  __  __       _             _     _ _          _____ _           _        _           _   ____            _
+# |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___ 
+# | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \
+# | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+# |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+#                                                                                                 |___/
+#
+# File:   pinToSymbol_gen.awk
+#
+# Author: Silvano Catinella <catinella@yahoo.com>
+#
+# Description:
+#	It converts the pin-symbol map header (main/mbesPinsMap.h) into the C-language table included by pinToSymbol.c (and
+#	by the firmware's debugConsoleAPI, that announces it, see ptsMap.h). The table is indexed by the numeric pin-ID
+#	(see pinToSymbol.h), so the lookup is a static array access and no file is read at runtime. Only the following definitions are converted (the others, e.g. the ADC channels, are ignored):
+#		ESP32:  #define <[io]_SYMBOL> GPIO_NUM_<n>       ID = n
+#		AVR8:   #define <[io]_SYMBOL> "<port><digit>"    ID = (index of <port> in "A..Z0..9") * 10 + <digit>
+#	Two symbols on the same pin, a symbol longer than PTS_MAXSYMSIZE - 1 characters (see pinToSymbol.h, it could not be
+#	announced, see ptsMap.h), or a file without pin symbols (e.g. a wrong arch), stop the build. A pin-ID out of the table is rejected by the compiler.
+#
+#	Use: awk -v arch={ESP32|AVR8} -f pinToSymbol_gen.awk <header file> > pinToSymbol_map.h
+#
+#
+# License:
+#	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+#
+#	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+#	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+#	version.
+#
+#	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+#	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+#
+#	You should have received a copy of the GNU General Public License along with this program. If not, see
+#		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+#
+BEGIN {
+	ports  = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+	maxsym = 24                                         # PTS_MAXSYMSIZE (see pinToSymbol.h)
+	count  = 0
+	fails  = 0
+	if (arch != "ESP32" && arch != "AVR8") {
+		print "ERROR! arch=ESP32|AVR8 has not been defined" > "/dev/stderr"
+		fails = 1
+		exit 1
+	}
+}
+
+$1 == "#define" && $2 ~ /^[io]_[A-Z0-9]+$/ {
+	id = -1
+	if (arch == "ESP32" && $3 ~ /^GPIO_NUM_[0-9]+$/) {
+		label = $3
+		id    = substr($3, 10) + 0
+	} else if (arch == "AVR8" && $3 ~ /^"[A-Z0-9][0-9]"$/) {
+		label = substr($3, 2, 2)
+		id    = (index(ports, substr(label, 1, 1)) - 1) * 10 + substr(label, 2, 1)
+	}
+
+	if (id < 0) {
+		# Not a pin definition
+	} else if (length($2) >= maxsym) {
+		printf("ERROR! %s:%u: \"%s\" is longer than %u characters\n", FILENAME, FNR, $2, maxsym - 1) > "/dev/stderr"
+		fails = 1
+	} else if (id in symbols) {
+		printf("ERROR! %s:%u: \"%s\" and \"%s\" are both defined as %s\n", FILENAME, FNR, symbols[id], $2, label) > "/dev/stderr"
+		fails = 1
+	} else {
+		symbols[id] = $2
+		labels[id]  = label
+		ids[count++] = id
+	}
+}
+
+END {
+	if (fails) exit 1
+	if (count == 0) {
+		printf("ERROR! No %s pin symbol has been found in %s\n", arch, FILENAME) > "/dev/stderr"
+		exit 1
+	}
+
+	printf("//\n// Generated from %s by pinToSymbol_gen.awk (%s): DO NOT EDIT\n//\n", FILENAME, arch)
+	printf("#define PTS_GENSYMBOLS %u\n\n", count)
+	printf("static const ptsDbItem_t ptsDb[PTS_MAXPINID] = {\n")
+	for (t = 0; t < count; t++)
+		printf("\t[%u] = { \"%s\", \"%s\" },\n", ids[t], labels[ids[t]], symbols[ids[t]])
+	printf("};\n")
+}
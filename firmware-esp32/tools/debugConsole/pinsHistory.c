@@ -0,0 +1,356 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: pinsHistory.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Per-pin history of the pin changes (timelines), with time-indexed queries:
+//		pinsHistory_valueAt()               pin's state at the argument defined time
+//		pinsHistory_seek() + _next()        pin's transitions from the argument defined time on
+//	Only the changes are stored (run-length: a transition starts a run of the same value). Every pin's timeline is a
+//	sequence of HIST_BLOCKSIZE bytes blocks; the index keeps the first transition (time-stamp and value) and the
+//	number of transitions of every block, and the other transitions are delta-encoded in the block:
+//		<(time-stamp delta << 1) | toggle> [<zigzag value delta>]         (LEB128 varints, see captureFile.h)
+//	where toggle = 1 means a 0/1 pin that has flipped (no value delta follows). A binary pin's transition usually
+//	takes 1-2 bytes. The queries are a binary search on the blocks index plus the decoding of a single block, so they
+//	are O(log n).
+//	The time-stamps are expected to be monotonic: an older one is recorded with the last time-stamp.
+//	Every device (see devices.h) has its own history: the functions work on the one selected by
+//	pinsHistory_select().
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include <captureFile.h>
+#include <pinsHistory.h>
+
+#define HIST_MAXENTRY     10          // Max size of an encoded transition (two 32-bits varints)
+#define HIST_MAXDELTA     0x7FFFFFFF  // Max time-stamp delta of an encoded transition
+
+// Block's index item
+typedef struct {
+	uint32_t tstamp;                  // First transition (not encoded)
+	uint32_t value;
+	uint32_t count;                   // Encoded transitions
+} histBlock_t;
+
+// Pin's timeline
+typedef struct {
+	histBlock_t *blocks;              // Blocks index
+	uint8_t     *data;                // Blocks (HIST_BLOCKSIZE bytes each)
+	uint32_t    nBlocks;
+	uint32_t    capacity;             // Allocated blocks
+	uint32_t    used;                 // Bytes used in the last block
+	uint32_t    lastTs;               // Last transition
+	uint32_t    lastValue;
+	uint64_t    count;                // Stored transitions
+} histPin_t;
+
+static histPin_t pins[DEV_MAXDEVICES][PTS_MAXPINID];
+static histPin_t *cur = pins[0];                 // Selected device (see pinsHistory_select())
+
+
+static werror blockAdding (histPin_t *p, uint32_t value, uint32_t tstamp) {
+	//
+	// Description:
+	//	It starts a new block with the argument defined transition (the block's arrays are doubled when full)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror err = WERRCODE_SUCCESS;
+
+	if (p->nBlocks == p->capacity) {
+		uint32_t    capacity = (p->capacity == 0) ? 4 : p->capacity * 2;
+		histBlock_t *blocks  = realloc(p->blocks, capacity * sizeof(histBlock_t));
+		uint8_t     *data    = (blocks != NULL) ? realloc(p->data, (size_t)capacity * HIST_BLOCKSIZE) : NULL;
+
+		if (blocks != NULL) p->blocks = blocks;
+		if (data == NULL) {
+			// ERROR!
+			err = WERRCODE_ERROR_OUTOFMEMORY;
+		} else {
+			p->data     = data;
+			p->capacity = capacity;
+		}
+	}
+
+	if (err == WERRCODE_SUCCESS) {
+		p->blocks[p->nBlocks] = (histBlock_t){ tstamp, value, 0 };
+		p->nBlocks++;
+		p->used = 0;
+	}
+	return(err);
+}
+
+
+static uint32_t blockFinding (const histPin_t *p, uint32_t tstamp) {
+	//
+	// Description:
+	//	It returns the last block whose first transition is not newer than the argument defined time-stamp (0 when
+	//	every block is newer)
+	//
+	uint32_t lo = 0, hi = p->nBlocks;
+
+	// Binary search of the first block newer than tstamp
+	while (lo < hi) {
+		uint32_t mid = (lo + hi) / 2;
+
+		if (p->blocks[mid].tstamp <= tstamp) lo = mid + 1;
+		else                                 hi = mid;
+	}
+	return((lo > 0) ? lo - 1 : 0);
+}
+
+
+static void entryDecoding (const histPin_t *p, histCursor_t *c) {
+	//
+	// Description:
+	//	It decodes the cursor's next encoded transition (the block's first one is in the index)
+	//
+	const uint8_t *ptr = p->data + (size_t)c->block * HIST_BLOCKSIZE + c->offset;
+	uint32_t      word, delta;
+	uint8_t       n    = varint_get(ptr, HIST_BLOCKSIZE - c->offset, &word);
+
+	c->tstamp += word >> 1;
+	if (word & 1)
+		c->value ^= 1;
+	else {
+		n += varint_get(ptr + n, HIST_BLOCKSIZE - c->offset - n, &delta);
+		// Zigzag decoding
+		c->value += (delta >> 1) ^ -(delta & 1);
+	}
+	c->offset += n;
+
+	return;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+void pinsHistory_select (devId_t dev) {
+	//
+	// Description:
+	//	It selects the history of the argument defined device (the device 0 is selected by default)
+	//
+	cur = pins[(dev < DEV_MAXDEVICES) ? dev : 0];
+
+	return;
+}
+
+
+werror pinsHistory_add (pinId_t pin, uint32_t value, uint32_t tstamp) {
+	//
+	// Description:
+	//	It records the argument defined pin's value. Nothing is stored when the value has not changed.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG     Out of range pin-ID
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror    err = WERRCODE_SUCCESS;
+	histPin_t *p  = (pin < PTS_MAXPINID) ? &cur[pin] : NULL;
+
+	if (p == NULL) {
+		// ERROR!
+		err = WERRCODE_ERROR_ILLEGALARG;
+
+	} else if (p->count == 0 || value != p->lastValue) {
+		uint32_t delta = (tstamp > p->lastTs) ? tstamp - p->lastTs : 0;
+
+		if (tstamp < p->lastTs) tstamp = p->lastTs;
+
+		if (p->count == 0 || p->used + HIST_MAXENTRY > HIST_BLOCKSIZE || delta > HIST_MAXDELTA)
+			err = blockAdding(p, value, tstamp);
+
+		else {
+			uint8_t  *ptr = p->data + (size_t)(p->nBlocks - 1) * HIST_BLOCKSIZE + p->used;
+			uint32_t diff = value - p->lastValue;
+
+			if (p->lastValue <= 1 && value == (p->lastValue ^ 1))
+				// 0/1 pin's flip
+				p->used += varint_put(ptr, (delta << 1) | 1);
+			else {
+				p->used += varint_put(ptr, delta << 1);
+				// Zigzag encoding
+				p->used += varint_put(p->data + (size_t)(p->nBlocks - 1) * HIST_BLOCKSIZE + p->used, (diff << 1) ^ -(diff >> 31));
+			}
+			p->blocks[p->nBlocks - 1].count++;
+		}
+
+		if (err == WERRCODE_SUCCESS) {
+			p->lastTs    = tstamp;
+			p->lastValue = value;
+			p->count++;
+		}
+	}
+
+	return(err);
+}
+
+
+werror pinsHistory_valueAt (pinId_t pin, uint32_t tstamp, uint32_t *value) {
+	//
+	// Description:
+	//	It returns the argument defined pin's value at the argument defined time
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   No transitions before that time (or out of range pin-ID)
+	//
+	werror       err = WERRCODE_WARNING_ITNOTFOUND;
+	histPin_t    *p;
+	histCursor_t c;
+
+	if (pin < PTS_MAXPINID && (p = &cur[pin])->count > 0 && p->blocks[0].tstamp <= tstamp) {
+		c.block  = blockFinding(p, tstamp);
+		c.offset = 0;
+		c.tstamp = p->blocks[c.block].tstamp;
+		c.value  = p->blocks[c.block].value;
+		*value   = c.value;
+
+		for (uint32_t t = 0; t < p->blocks[c.block].count; t++) {
+			entryDecoding(p, &c);
+			if (c.tstamp > tstamp) break;
+			*value = c.value;
+		}
+		err = WERRCODE_SUCCESS;
+	}
+
+	return(err);
+}
+
+
+werror pinsHistory_seek (histCursor_t *cursor, pinId_t pin, uint32_t tstamp) {
+	//
+	// Description:
+	//	It sets the argument defined cursor on the pin's first transition not older than the argument defined time.
+	//	The transitions are read by pinsHistory_next(); the cursor is valid until the history changes.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG     Out of range pin-ID
+	//
+	werror       err = WERRCODE_SUCCESS;
+	histCursor_t prev;
+	uint32_t     ts, value;
+
+	if (pin >= PTS_MAXPINID) {
+		// ERROR!
+		err = WERRCODE_ERROR_ILLEGALARG;
+
+	} else {
+		cursor->pin    = pin;
+		// The previous block can end with transitions of the same time (non-monotonic time-stamps are clamped)
+		cursor->block  = (tstamp > 0) ? blockFinding(&cur[pin], tstamp - 1) : 0;
+		cursor->offset = 0;
+		cursor->left   = (cur[pin].count > 0) ? cur[pin].blocks[cursor->block].count + 1 : 0;
+
+		// The older transitions of the block are skipped
+		do {
+			prev = *cursor;
+		} while (pinsHistory_next(cursor, &ts, &value) == WERRCODE_SUCCESS && ts < tstamp);
+		*cursor = prev;
+	}
+
+	return(err);
+}
+
+
+werror pinsHistory_next (histCursor_t *cursor, uint32_t *tstamp, uint32_t *value) {
+	//
+	// Description:
+	//	It returns the cursor's transition, and it moves the cursor to the next one
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   No more transitions
+	//
+	werror    err = WERRCODE_SUCCESS;
+	histPin_t *p  = &cur[cursor->pin];
+
+	if (cursor->left == 0 && cursor->block + 1 < p->nBlocks) {
+		cursor->block++;
+		cursor->offset = 0;
+		cursor->left   = p->blocks[cursor->block].count + 1;
+	}
+
+	if (cursor->left == 0) {
+		err = WERRCODE_WARNING_ITNOTFOUND;
+
+	} else {
+		if (cursor->left == p->blocks[cursor->block].count + 1) {
+			// The block's first transition
+			cursor->tstamp = p->blocks[cursor->block].tstamp;
+			cursor->value  = p->blocks[cursor->block].value;
+		} else
+			entryDecoding(p, cursor);
+
+		cursor->left--;
+		*tstamp = cursor->tstamp;
+		*value  = cursor->value;
+	}
+
+	return(err);
+}
+
+
+uint64_t pinsHistory_count (pinId_t pin) {
+	//
+	// Description:
+	//	It returns the number of stored transitions of the argument defined pin
+	//
+	return((pin < PTS_MAXPINID) ? cur[pin].count : 0);
+}
+
+
+uint64_t pinsHistory_memory () {
+	//
+	// Description:
+	//	It returns the memory (bytes) allocated by the selected device's history
+	//
+	uint64_t size = 0;
+
+	for (pinId_t t = 0; t < PTS_MAXPINID; t++)
+		size += (uint64_t)cur[t].capacity * (sizeof(histBlock_t) + HIST_BLOCKSIZE);
+
+	return(size);
+}
+
+
+void pinsHistory_free () {
+	//
+	// Description:
+	//	It discards the selected device's history
+	//
+	for (pinId_t t = 0; t < PTS_MAXPINID; t++) {
+		free(cur[t].blocks);
+		free(cur[t].data);
+		memset(&cur[t], 0, sizeof(histPin_t));
+	}
+
+	return;
+}
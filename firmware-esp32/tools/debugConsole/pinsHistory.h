@@ -0,0 +1,72 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: pinsHistory.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Per-pin history of the pin changes (timelines), with time-indexed queries:
+//		pinsHistory_valueAt()               pin's state at the argument defined time
+//		pinsHistory_seek() + _next()        pin's transitions from the argument defined time on
+//	Only the changes are stored (run-length: a transition starts a run of the same value). Every pin's timeline is a
+//	sequence of HIST_BLOCKSIZE bytes blocks; the index keeps the first transition (time-stamp and value) and the
+//	number of transitions of every block, and the other transitions are delta-encoded in the block:
+//		<(time-stamp delta << 1) | toggle> [<zigzag value delta>]         (LEB128 varints, see captureFile.h)
+//	where toggle = 1 means a 0/1 pin that has flipped (no value delta follows). A binary pin's transition usually
+//	takes 1-2 bytes. The queries are a binary search on the blocks index plus the decoding of a single block, so they
+//	are O(log n).
+//	The time-stamps are expected to be monotonic: an older one is recorded with the last time-stamp.
+//	Every device (see devices.h) has its own history: the functions work on the one selected by
+//	pinsHistory_select().
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef PINSHISTORY_UT
+#define PINSHISTORY_UT
+
+#include <stdint.h>
+#include <werror.h>
+#include <devices.h>
+#include <pinToSymbol.h>
+
+#define HIST_BLOCKSIZE    128         // Encoded transitions per block (bytes)
+
+// Transitions iterator (see pinsHistory_seek())
+typedef struct {
+	pinId_t  pin;
+	uint32_t block;                   // Current block
+	uint32_t offset;                  // Next transition's offset in the block
+	uint32_t left;                    // Transitions of the block not yet returned
+	uint32_t tstamp;                  // Last returned transition
+	uint32_t value;
+} histCursor_t;
+
+void     pinsHistory_select  (devId_t dev);
+werror   pinsHistory_add     (pinId_t pin, uint32_t value, uint32_t tstamp);
+werror   pinsHistory_valueAt (pinId_t pin, uint32_t tstamp, uint32_t *value);
+werror   pinsHistory_seek    (histCursor_t *cursor, pinId_t pin, uint32_t tstamp);
+werror   pinsHistory_next    (histCursor_t *cursor, uint32_t *tstamp, uint32_t *value);
+uint64_t pinsHistory_count   (pinId_t pin);
+uint64_t pinsHistory_memory  ();
+void     pinsHistory_free    ();
+
+#endif
@@ -12,7 +12,10 @@
 // Author: Silvano Catinella <catinella@yahoo.com>
 //
 // Description:
-//	This module allows you to stores/updates and prints all the monitored pins and their values
+//	This module allows you to stores/updates and prints all the monitored pins and their values.
+//	The DB is indexed by the numeric pin-ID (see pinDef_get()), so every update is O(1). The module keeps track of the
+//	pins changed since the last printing (dirty bitmap) and of the time-stamp of every pin's last change.
+//	Every device (see devices.h) has its own DB: the functions work on the one selected by pinsStorage_select().
 //	
 //	Dependences graph:
 //	                           +------------+
@@ -45,7 +48,6 @@
 //		<https://www.gnu.org/licenses/gpl-3.0.txt>.
 //
 ------------------------------------------------------------------------------------------------------------------------------*/
-#include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -55,16 +57,30 @@
 
 // Pins status DB item
 typedef struct {
-	char     pin[PTS_PINLABSIZE];
-	uint32_t value;
+	char       pin[PTS_PINLABSIZE];
+	const char *symbol;               // Resolved once, when the pin is seen for the first time (NULL: unknown pin)
+	uint32_t   value;
+	uint32_t   tstamp;                // Last change time-stamp (ms)
 } pinsDbItem;
 
+#define PINS_DIRTYWORDS ((PTS_MAXPINID + 63) / 64)
+
+
+// Device's pins DB
+typedef struct {
+	pinsDbItem pinsDb[PTS_MAXPINID];               // Indexed by pin-ID
+	pinId_t    pinsOrder[MBES_MAXNUMOFPINS];       // Pins-ID in arrival order (printing order)
+	uint8_t    counter;
+	uint64_t   dirty[PINS_DIRTYWORDS];             // Pins changed since the last pinsStorage_print() call
+	uint8_t    alerts[PTS_MAXPINID];               // Violated rules that reference the pin
+} pinsDev_t;
+
 
 //
 // Global variables
 //
-static pinsDbItem pinsDb[MBES_MAXNUMOFPINS];
-static uint8_t    counter = 0;
+static pinsDev_t devs[DEV_MAXDEVICES];
+static pinsDev_t *cur = &devs[0];                    // Selected device (see pinsStorage_select())
 
 
 void fillUp (char *string, uint8_t newsz) {
@@ -80,76 +96,179 @@ void fillUp (char *string, uint8_t newsz) {
 	return;
 }
 
+
+static uint8_t pinsPerRow (uint16_t screenCols) {
+	//
+	// Description:
+	//	It returns the number of pins printed in every row
+	//
+	uint16_t n = screenCols / (PTS_MAXSYMSIZE + 6);
+
+	return((n == 0) ? 1 : (n > 255) ? 255 : n);
+}
+
 //-----------------------------------------------------------------------------------------------------------------------------
 //                                       P U B L I C   F U N C T I O N S
 //-----------------------------------------------------------------------------------------------------------------------------
-void pinsStorage_print (uint16_t screenCols) {
+void pinsStorage_select (devId_t dev) {
+	//
+	// Description:
+	//	It selects the DB of the argument defined device (the device 0 is selected by default)
+	//
+	cur = &devs[(dev < DEV_MAXDEVICES) ? dev : 0];
+
+	return;
+}
+
+
+uint16_t pinsStorage_rows (uint16_t screenCols) {
+	//
+	// Description:
+	//	It returns the number of rows required by pinsStorage_print() with the argument defined screen size
+	//
+	uint8_t n = pinsPerRow(screenCols);
+
+	return((cur->counter + n - 1) / n);
+}
+
+
+void pinsStorage_print (WINDOW *win, uint16_t screenCols) {
 	//
 	// Description:
 	//	This function prints every recorded pins and its value formatted by columns considering the argument defined
-	//	screen size
+	//	screen size. The symbols have already been resolved by pinsStorage_update(), so no lookup is performed here.
+	//	The pins changed since the previous call are highlighted, then the dirty bitmap is cleaned. The pins of the
+	//	violated rules are printed in reverse video.
 	//
-	uint8_t t = 0, x = 0;
-	uint8_t cols = roundf(((screenCols) / (PTS_MAXSYMSIZE + 5)) - 1);
-	char    *buff = (char*)malloc(PTS_MAXSYMSIZE+5);
+	uint8_t n = pinsPerRow(screenCols);
+	char    buff[PTS_MAXSYMSIZE + 16];
+	int     y0 = getcury(win);
 	
-	// Minimum setting
-	cols = (cols == 0) ? 1 : cols;
-		
-	for (x = 0; x < counter; x++) {
-			
-		// Symbol retriving
-		if (pinToSymbol_get(buff, pinsDb[x].pin) != 1)
-			strcpy(buff, pinsDb[x].pin);
-				
-		sprintf((buff + strlen(buff)), ":%d", pinsDb[x].value);
+	for (uint8_t x = 0; x < cur->counter; x++) {
+		pinId_t id = cur->pinsOrder[x];
+		bool    changed = (cur->dirty[id / 64] >> (id % 64)) & 1;
+
+		snprintf(buff, sizeof(buff), "%s:%d", cur->pinsDb[id].symbol, cur->pinsDb[id].value);
 		fillUp(buff, PTS_MAXSYMSIZE);
-		printw("%s", buff);
-			
-		if (t == cols) {
-			printw("\n");
-			t = 0;
-		} else {
-			printw("      ");
-			t++;
-		}
+		if (changed)              wattron(win, A_BOLD);
+		if (cur->alerts[id] > 0) wattron(win, A_REVERSE);
+		mvwprintw(win, y0 + x / n, (x % n) * (PTS_MAXSYMSIZE + 6), "%s", buff);
+		wattroff(win, A_BOLD | A_REVERSE);
 	}
-	free(buff);
-	if (t != 0) printw("\n");
-	
+	wmove(win, y0 + (cur->counter + n - 1) / n, 0);
+
+	memset(cur->dirty, 0, sizeof(cur->dirty));
 }
 
-werror pinsStorage_update (const char *pinID, uint32_t value) {
+
+werror pinsStorage_update (pinId_t pin, uint32_t value, uint32_t tstamp) {
 	//
 	// Description:
-	//	This function updates or adds the argument defined pin and its associated value
+	//	This function updates or adds the argument defined pin and its associated value. When a new pin is added,
+	//	its symbol is resolved and cached in the record (the pin's label is used when no symbol has been defined).
+	//	The change time-stamp and the dirty flag are updated only when the value changes.
 	//
 	// Returned value:
 	//	WERRCODE_SUCCESS
-	//	WERRCODE_ERROR_DATAOVERFLOW
+	//	WERRCODE_ERROR_ILLEGALARG     Out of range pin-ID
+	//	WERRCODE_ERROR_DATAOVERFLOW   No more room for new pins (nothing has been written)
 	//
 	werror err = WERRCODE_SUCCESS;
-	uint8_t t = 0;
-	
-	while (t < counter) {
-		if (strcmp(pinID, pinsDb[t].pin) == 0) break;
-		else                                 t++;
-	}
-	
-	if (t == counter) {
-		// New pin adding...
-		strcpy(pinsDb[counter].pin, pinID);
-		pinsDb[counter].value = value;
-		counter++;
 	
-	} else if (t < MBES_MAXNUMOFPINS) {
-		// Updating...
-		pinsDb[t].value = value;
-	
-	} else {
+	if (pin >= PTS_MAXPINID) {
 		// ERROR!
-		err = WERRCODE_ERROR_DATAOVERFLOW;
+		err = WERRCODE_ERROR_ILLEGALARG;
+
+	} else if (cur->pinsDb[pin].symbol == NULL) {
+		if (cur->counter < MBES_MAXNUMOFPINS) {
+			// New pin adding...
+			pinId_toLabel(cur->pinsDb[pin].pin, pin);
+			if (pinToSymbol_getById(&cur->pinsDb[pin].symbol, pin) != WERRCODE_SUCCESS)
+				cur->pinsDb[pin].symbol = cur->pinsDb[pin].pin;
+
+			cur->pinsDb[pin].value       = value;
+			cur->pinsDb[pin].tstamp      = tstamp;
+			cur->pinsOrder[cur->counter] = pin;
+			cur->counter++;
+			cur->dirty[pin / 64] |= (uint64_t)1 << (pin % 64);
+
+		} else {
+			// ERROR!
+			err = WERRCODE_ERROR_DATAOVERFLOW;
+		}
+
+	} else if (cur->pinsDb[pin].value != value) {
+		// Updating...
+		cur->pinsDb[pin].value  = value;
+		cur->pinsDb[pin].tstamp = tstamp;
+		cur->dirty[pin / 64] |= (uint64_t)1 << (pin % 64);
 	}
 	
 	return(err);
 }
+
+
+werror pinsStorage_get (pinId_t pin, uint32_t *value, uint32_t *tstamp) {
+	//
+	// Description:
+	//	It returns the last value of the argument defined pin, and the time-stamp of its last change
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   The pin has never been updated
+	//
+	werror err = WERRCODE_WARNING_ITNOTFOUND;
+
+	if (pin < PTS_MAXPINID && cur->pinsDb[pin].symbol != NULL) {
+		*value  = cur->pinsDb[pin].value;
+		*tstamp = cur->pinsDb[pin].tstamp;
+		err     = WERRCODE_SUCCESS;
+	}
+	return(err);
+}
+
+
+bool pinsStorage_isDirty () {
+	//
+	// Description:
+	//	It returns true when at least one pin has changed since the last pinsStorage_print() call
+	//
+	bool flag = false;
+
+	for (uint8_t t = 0; t < PINS_DIRTYWORDS && flag == false; t++)
+		flag = (cur->dirty[t] != 0);
+
+	return(flag);
+}
+
+
+void pinsStorage_resolve () {
+	//
+	// Description:
+	//	It resolves the symbols of the recorded pins again, and it marks them as changed. It has to be called when the
+	//	pin-symbol table has been replaced (see ptsCache.h).
+	//
+	for (uint8_t x = 0; x < cur->counter; x++) {
+		pinId_t id = cur->pinsOrder[x];
+
+		if (pinToSymbol_getById(&cur->pinsDb[id].symbol, id) != WERRCODE_SUCCESS)
+			cur->pinsDb[id].symbol = cur->pinsDb[id].pin;
+		cur->dirty[id / 64] |= (uint64_t)1 << (id % 64);
+	}
+	return;
+}
+
+
+void pinsStorage_alert (pinId_t pin, bool flag) {
+	//
+	// Description:
+	//	It adds (flag = true) or removes a violated rule to the argument defined pin's ones, and it marks the pin as
+	//	changed, so it is printed again
+	//
+	if (pin < PTS_MAXPINID) {
+		if (flag)                       cur->alerts[pin]++;
+		else if (cur->alerts[pin] > 0) cur->alerts[pin]--;
+		cur->dirty[pin / 64] |= (uint64_t)1 << (pin % 64);
+	}
+	return;
+}
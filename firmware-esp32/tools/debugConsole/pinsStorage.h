@@ -12,7 +12,9 @@
 // Author: Silvano Catinella <catinella@yahoo.com>
 //
 // Description:
-//	This module allows you to stores/updates and prints all the monitored pins and their values
+//	This module allows you to stores/updates and prints all the monitored pins and their values. The pins are
+//	identified by their numeric ID (see pinDef_get()).
+//	The pins referenced by violated alerting rules (see rulesEngine.h) are printed in reverse video.
 //
 //	Symbols:
 //		MBES_MAXNUMOFPINS  The maximuum number of pins you can store in the module's memory
@@ -34,12 +36,22 @@
 #ifndef PINSTORAGE_UT
 #define PINSTORAGE_UT
 
+#include <stdbool.h>
+#include <curses.h>
 #include <werror.h>
+#include <pinToSymbol.h>
+#include <devices.h>
 
 #define MBES_MAXNUMOFPINS 64
 
-void   pinsStorage_print  (uint16_t screenColumns);
-werror pinsStorage_update (const char *pinID, uint32_t value);
+void     pinsStorage_select  (devId_t dev);
+void     pinsStorage_print   (WINDOW *win, uint16_t screenColumns);
+uint16_t pinsStorage_rows    (uint16_t screenColumns);
+werror   pinsStorage_update  (pinId_t pin, uint32_t value, uint32_t tstamp);
+werror   pinsStorage_get     (pinId_t pin, uint32_t *value, uint32_t *tstamp);
+bool     pinsStorage_isDirty ();
+void     pinsStorage_resolve ();
+void     pinsStorage_alert   (pinId_t pin, bool flag);
 
 
 #endif
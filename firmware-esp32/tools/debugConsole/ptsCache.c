@@ -0,0 +1,310 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: ptsCache.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Receiver and disk cache of the pin-symbol maps announced by the firmware (see ptsCache.h)
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <ctype.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <ptsMap.h>
+#include <ptsCache.h>
+
+#define PTSCACHE_IDLE  UINT16_MAX         // No map is being received
+
+// Device's maps
+typedef struct {
+	ptsDbItem_t db[PTS_MAXPINID];         // Used map (see pinToSymbol_use())
+	uint32_t    hash;                     // Used map's hash (0: built-in table)
+	uint16_t    count;                    // Used map's symbols
+	bool        cached;                   // The used map has been read by the cache
+	uint8_t     buf[PTSMAP_MAXSIZE];      // Map being received
+	uint32_t    size;
+	uint32_t    rxHash;
+	uint16_t    rows;
+	uint16_t    next;                     // Next expected row (PTSCACHE_IDLE: none)
+	bool        skip;                     // The announced map is already in use
+} cacheDev_t;
+
+static cacheDev_t devs[DEV_MAXDEVICES];
+static cacheDev_t *cur = &devs[0];        // Selected device (see ptsCache_select())
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                       P R I V A T E   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+static bool cachePath (char *path, uint32_t size, uint32_t hash) {
+	//
+	// Description:
+	//	It writes the cache file's path of the argument defined map (hash = 0: the cache folder's path)
+	//
+	// Returned value:
+	//	false when neither $XDG_CACHE_HOME nor $HOME has been defined
+	//
+	const char *xdg  = getenv("XDG_CACHE_HOME"), *home = getenv("HOME");
+	int        n     = -1;
+
+	if (xdg != NULL && xdg[0] != '\0')
+		n = snprintf(path, size, "%s/" PTSCACHE_DIRNAME, xdg);
+	else if (home != NULL && home[0] != '\0')
+		n = snprintf(path, size, "%s/.cache/" PTSCACHE_DIRNAME, home);
+
+	if (n > 0 && hash != 0) n += snprintf(path + n, size - n, "/%08x.ptsmap", (unsigned)hash);
+
+	return(n > 0 && (uint32_t)n < size);
+}
+
+
+static werror mapDecoding (const uint8_t *map, uint32_t size, uint32_t hash) {
+	//
+	// Description:
+	//	It verifies the argument defined binary map, and the selected device's pins are decoded by it
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_INVALIDDATA
+	//
+	werror   err = WERRCODE_ERROR_INVALIDDATA;
+	uint32_t pos = PTSMAP_HDRSIZE, stored = 0;
+	uint16_t count, t = 0;
+
+	if (size >= PTSMAP_HDRSIZE && memcmp(map, "PTS", 3) == 0 && map[3] == PTSMAP_VERSION) {
+		for (uint8_t b = 0; b < 4; b++) stored |= (uint32_t)map[4 + b] << (8 * b);
+		count = map[8] | (map[9] << 8);
+
+		// Items checking (nothing is changed before the whole map has been verified)
+		if (stored == hash && ptsMap_hash(map + 8, size - 8) == hash) {
+			bool valid = true;
+
+			for (t = 0; t < count && pos + 3 <= size && valid; t++) {
+				pinId_t pin = map[pos] | (map[pos + 1] << 8);
+				uint8_t len = map[pos + 2];
+
+				valid = (pin < PTS_MAXPINID && len > 0 && len < PTS_MAXSYMSIZE && pos + 3 + len <= size);
+				for (uint8_t c = 0; c < len && valid; c++) valid = (isgraph(map[pos + 3 + c]) != 0);
+				pos += 3 + len;
+			}
+			if (valid && t == count && pos == size) err = WERRCODE_SUCCESS;
+		}
+	}
+
+	if (err == WERRCODE_SUCCESS) {
+		memset(cur->db, 0, sizeof(cur->db));
+		for (pos = PTSMAP_HDRSIZE, t = 0; t < count; t++) {
+			pinId_t pin = map[pos] | (map[pos + 1] << 8);
+			uint8_t len = map[pos + 2];
+
+			memcpy(cur->db[pin].symbol, map + pos + 3, len);
+			pinId_toLabel(cur->db[pin].pin, pin);
+			pos += 3 + len;
+		}
+		pinToSymbol_use(cur->db);
+		cur->hash  = hash;
+		cur->count = count;
+	}
+	return(err);
+}
+
+
+static werror cacheReading (uint32_t hash) {
+	//
+	// Description:
+	//	It decodes the selected device's pins by the cached map of the argument defined hash
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   The map has not been cached
+	//	WERRCODE_ERROR_INVALIDDATA    Corrupted cache file
+	//
+	werror  err = WERRCODE_WARNING_ITNOTFOUND;
+	char    path[PATH_MAX];
+	uint8_t map[PTSMAP_MAXSIZE + 1];                  // A longer file is a corrupted one
+	size_t  size;
+	FILE    *fd;
+
+	if (cachePath(path, sizeof(path), hash) && (fd = fopen(path, "r")) != NULL) {
+		size = fread(map, 1, sizeof(map), fd);
+		err  = (ferror(fd) == 0 && size <= PTSMAP_MAXSIZE) ? mapDecoding(map, size, hash) : WERRCODE_ERROR_INVALIDDATA;
+		fclose(fd);
+	}
+	if (err == WERRCODE_ERROR_INVALIDDATA)
+		// WARNING!
+		syslog(LOG_WARNING, "WARNING(%d)! \"%s\" is a corrupted symbols map", __LINE__, path);
+
+	return(err);
+}
+
+
+static werror cacheWriting (const uint8_t *map, uint32_t size, uint32_t hash) {
+	//
+	// Description:
+	//	It stores the argument defined map in the cache (the missing folders are created). The file is written with a
+	//	temporary name and then renamed, so a concurrent console never reads a partial map.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_IOOPERFAILED
+	//
+	werror err = WERRCODE_ERROR_IOOPERFAILED;
+	char   path[PATH_MAX], tmp[PATH_MAX + 16];
+	FILE   *fd;
+
+	if (cachePath(path, sizeof(path), 0)) {
+		for (char *ptr = strchr(path + 1, '/'); ptr != NULL; ptr = strchr(ptr + 1, '/')) {
+			*ptr = '\0';
+			mkdir(path, 0755);
+			*ptr = '/';
+		}
+		mkdir(path, 0755);
+	}
+
+	if (cachePath(path, sizeof(path), hash)) {
+		snprintf(tmp, sizeof(tmp), "%s.%d", path, (int)getpid());
+		if ((fd = fopen(tmp, "w")) != NULL) {
+			if (fwrite(map, 1, size, fd) == size && fclose(fd) == 0 && rename(tmp, path) == 0)
+				err = WERRCODE_SUCCESS;
+			else
+				unlink(tmp);
+		}
+	}
+	if (err != WERRCODE_SUCCESS)
+		// WARNING!
+		syslog(LOG_WARNING, "WARNING(%d)! I cannot cache the %08x symbols map: %s", __LINE__, (unsigned)hash, strerror(errno));
+
+	return(err);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                         P U B L I C   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+void ptsCache_select (devId_t dev) {
+	//
+	// Description:
+	//	It selects the maps of the argument defined device (the device 0 is selected by default). The same device has
+	//	to be selected in pinToSymbol (see pinToSymbol_select()).
+	//
+	cur = &devs[(dev < DEV_MAXDEVICES) ? dev : 0];
+
+	return;
+}
+
+
+werror ptsCache_row (const char *row, bool *loaded) {
+	//
+	// Description:
+	//	It handles the argument defined row when it is an announcement one. The loaded flag is set when the selected
+	//	device's pins are decoded by a new map (the symbols resolved before have to be refreshed).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   It is not an announcement row
+	//	WERRCODE_ERROR_INVALIDDATA    Malformed or out of sequence row (the map being received is discarded)
+	//
+	ptsMapRow_t item;
+	werror      err = ptsMap_parse(row, &item);
+
+	*loaded = false;
+
+	if (err == WERRCODE_SUCCESS && item.index == 0) {
+		// A new announcement: the map is not received again when it is in use or it has been cached
+		cur->rxHash = item.hash;
+		cur->rows   = item.rows;
+		cur->size   = 0;
+		cur->next   = 0;
+		cur->skip   = (item.hash == cur->hash);
+
+		if (cur->skip == false && cacheReading(item.hash) == WERRCODE_SUCCESS) {
+			cur->skip   = true;
+			cur->cached = true;
+			*loaded     = true;
+		}
+	}
+
+	if (err != WERRCODE_SUCCESS) {
+		// Not an announcement (or a malformed one)
+
+	} else if (item.hash == cur->rxHash && cur->skip) {
+		// The map is already in use
+
+	} else if (
+		item.hash != cur->rxHash || item.index != cur->next || item.rows != cur->rows ||
+		(item.index + 1 < item.rows && item.size != PTSMAP_CHUNKSIZE) || cur->size + item.size > PTSMAP_MAXSIZE
+	) {
+		// ERROR! A lost row
+		cur->next = PTSCACHE_IDLE;
+		err       = WERRCODE_ERROR_INVALIDDATA;
+
+	} else {
+		memcpy(cur->buf + cur->size, item.data, item.size);
+		cur->size += item.size;
+
+		if (++cur->next == cur->rows) {
+			// Complete map
+			cur->next = PTSCACHE_IDLE;
+			if ((err = mapDecoding(cur->buf, cur->size, cur->rxHash)) == WERRCODE_SUCCESS) {
+				cacheWriting(cur->buf, cur->size, cur->rxHash);
+				cur->cached = false;
+				*loaded     = true;
+			}
+		}
+	}
+
+	return(err);
+}
+
+
+uint32_t ptsCache_hash () {
+	//
+	// Description:
+	//	It returns the hash of the selected device's map (0: no map has been announced)
+	//
+	return(cur->hash);
+}
+
+
+uint16_t ptsCache_count () {
+	//
+	// Description:
+	//	It returns the number of symbols of the selected device's map
+	//
+	return(cur->count);
+}
+
+
+bool ptsCache_cached () {
+	//
+	// Description:
+	//	It returns true when the selected device's map has been read by the cache
+	//
+	return(cur->cached);
+}
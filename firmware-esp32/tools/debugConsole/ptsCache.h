@@ -0,0 +1,56 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: ptsCache.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Receiver of the pin-symbol maps announced by the firmware (see ptsMap.h). The announcement rows are collected, the
+//	complete map is verified by its hash, and the selected device's pins are decoded with it (see pinToSymbol_use()).
+//	The maps are cached on disk by hash, in the PTSCACHE_DIRNAME folder of $XDG_CACHE_HOME (or of ~/.cache): when the
+//	first row of a known map is received, the cached map is used at once, and the remaining rows are skipped.
+//	Until an announcement is received, the table built from the firmware's header of the local checkout is used.
+//	Every device (see devices.h) has its own map: the functions work on the one selected by ptsCache_select().
+//
+//	Symbols description:
+//		PTSCACHE_DIRNAME  Cache's folder name
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef PTSCACHE_UT
+#define PTSCACHE_UT
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <werror.h>
+#include <devices.h>
+
+#define PTSCACHE_DIRNAME  "debugConsole"
+
+void     ptsCache_select (devId_t dev);
+werror   ptsCache_row    (const char *row, bool *loaded);
+uint32_t ptsCache_hash   ();
+uint16_t ptsCache_count  ();
+bool     ptsCache_cached ();
+
+#endif
@@ -0,0 +1,208 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: ptsMap.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Pin-symbol map announcement's encoding and rows parsing (see ptsMap.h). It is built by the firmware too, so it
+//	uses no dynamic memory and no file.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <ptsMap.h>
+
+static const char hexDigits[] = "0123456789abcdef";
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                       P R I V A T E   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+static int8_t hexValue (char c) {
+	//
+	// Description:
+	//	It returns the value of the argument defined hex digit (lower case), or -1
+	//
+	const char *ptr = (c != '\0') ? strchr(hexDigits, c) : NULL;
+
+	return((ptr != NULL) ? (int8_t)(ptr - hexDigits) : -1);
+}
+
+
+static const char *numParsing (const char *str, uint32_t *value, uint8_t base, uint8_t maxDigits) {
+	//
+	// Description:
+	//	It scans the argument defined unsigned number (1 to maxDigits digits)
+	//
+	// Returned value:
+	//	The pointer to the first character after the number, or NULL when no number has been found
+	//
+	uint8_t n = 0;
+	int8_t  d;
+
+	*value = 0;
+	while (n < maxDigits && (d = hexValue(str[n])) >= 0 && d < base) {
+		*value = *value * base + d;
+		n++;
+	}
+	return((n > 0) ? str + n : NULL);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                         P U B L I C   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+uint32_t ptsMap_hash (const uint8_t *data, uint32_t size) {
+	//
+	// Description:
+	//	FNV-1a hash (32 bits) of the argument defined bytes
+	//
+	uint32_t h = 2166136261u;
+
+	for (uint32_t t = 0; t < size; t++) {
+		h ^= data[t];
+		h *= 16777619u;
+	}
+	return(h);
+}
+
+
+uint32_t ptsMap_encode (uint8_t *map, uint32_t size, const ptsDbItem_t *db, uint16_t items) {
+	//
+	// Description:
+	//	It writes the binary map of the argument defined pin-symbol table (indexed by pin-ID, the items without symbol
+	//	are skipped) in the argument defined buffer.
+	//
+	// Returned value:
+	//	The map's size, 0 when the buffer is too small
+	//
+	uint32_t pos   = PTSMAP_HDRSIZE;
+	uint16_t count = 0;
+
+	if (size < PTSMAP_HDRSIZE) return(0);
+
+	for (uint16_t t = 0; t < items && pos > 0; t++) {
+		uint8_t len = strnlen(db[t].symbol, PTS_MAXSYMSIZE - 1);          // The longer symbols are truncated
+
+		if (len == 0) {
+			// No symbol
+
+		} else if (pos + 3 + len > size) {
+			// ERROR!
+			pos = 0;
+
+		} else {
+			map[pos]     = t & 0xFF;
+			map[pos + 1] = t >> 8;
+			map[pos + 2] = len;
+			memcpy(map + pos + 3, db[t].symbol, len);
+			pos += 3 + len;
+			count++;
+		}
+	}
+
+	if (pos > 0) {
+		uint32_t h;
+
+		memcpy(map, "PTS", 3);
+		map[3] = PTSMAP_VERSION;
+		map[8] = count & 0xFF;
+		map[9] = count >> 8;
+		h      = ptsMap_hash(map + 8, pos - 8);
+		for (uint8_t t = 0; t < 4; t++) map[4 + t] = (h >> (8 * t)) & 0xFF;
+	}
+	return(pos);
+}
+
+
+uint16_t ptsMap_rows (uint32_t mapSize) {
+	//
+	// Description:
+	//	It returns the number of rows required to send a map of the argument defined size
+	//
+	return((mapSize + PTSMAP_CHUNKSIZE - 1) / PTSMAP_CHUNKSIZE);
+}
+
+
+uint16_t ptsMap_row (char *row, const uint8_t *map, uint32_t mapSize, uint16_t index) {
+	//
+	// Description:
+	//	It writes the argument defined announcement row (without the end of line) in the row buffer, that must be
+	//	PTSMAP_ROWSIZE bytes at least. The map's hash is read by its header.
+	//
+	// Returned value:
+	//	The row's length, 0 when the index is out of range
+	//
+	uint32_t start = (uint32_t)index * PTSMAP_CHUNKSIZE, hash = 0;
+	uint16_t len   = 0;
+
+	if (mapSize >= PTSMAP_HDRSIZE && start < mapSize) {
+		for (uint8_t t = 0; t < 4; t++) hash |= (uint32_t)map[4 + t] << (8 * t);
+		len = sprintf(row, PTSMAP_ROWMARK "%08x %u/%u ", (unsigned)hash, index, ptsMap_rows(mapSize));
+
+		for (uint32_t t = start; t < mapSize && t < start + PTSMAP_CHUNKSIZE; t++) {
+			row[len++] = hexDigits[map[t] >> 4];
+			row[len++] = hexDigits[map[t] & 0x0F];
+		}
+		row[len] = '\0';
+	}
+	return(len);
+}
+
+
+werror ptsMap_parse (const char *row, ptsMapRow_t *item) {
+	//
+	// Description:
+	//	It parses the argument defined announcement row (the carriage returns around it are ignored)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND   It is not an announcement row
+	//	WERRCODE_ERROR_INVALIDDATA    Malformed row
+	//
+	werror   err = WERRCODE_ERROR_INVALIDDATA;
+	uint32_t index, rows;
+	int8_t   hi, lo;
+
+	while (*row == '\r') row++;
+
+	if (strncmp(row, PTSMAP_ROWMARK, sizeof(PTSMAP_ROWMARK) - 1) != 0) {
+		err = WERRCODE_WARNING_ITNOTFOUND;
+
+	} else if (
+		(row = numParsing(row + sizeof(PTSMAP_ROWMARK) - 1, &item->hash, 16, 8)) != NULL && *row == ' ' &&
+		(row = numParsing(row + 1, &index, 10, 5)) != NULL && *row == '/' &&
+		(row = numParsing(row + 1, &rows, 10, 5)) != NULL && *row == ' ' && index < rows &&
+		rows <= ptsMap_rows(PTSMAP_MAXSIZE)
+	) {
+		item->index = index;
+		item->rows  = rows;
+		item->size  = 0;
+		for (row++; item->size < PTSMAP_CHUNKSIZE && (hi = hexValue(row[0])) >= 0 && (lo = hexValue(row[1])) >= 0; row += 2)
+			item->data[item->size++] = (hi << 4) | lo;
+
+		while (*row == '\r') row++;
+		if (*row == '\0' && item->size > 0) err = WERRCODE_SUCCESS;
+	}
+	return(err);
+}
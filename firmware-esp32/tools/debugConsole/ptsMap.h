@@ -0,0 +1,84 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: ptsMap.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Pin-symbol map announcement: the firmware sends its own pin-symbol table over the debug serial link, so the
+//	debugConsole decodes the pins with the right symbols even when it has been built from a different checkout. This
+//	module is shared by the firmware (debugConsoleAPI, encoding side) and by the debugConsole (see ptsCache.h).
+//
+//	Binary map (little endian integers):
+//		offset 0   "PTS" + version (PTSMAP_VERSION)
+//		offset 4   uint32 map hash: FNV-1a of the bytes from offset 8 to the end (it identifies the firmware's map)
+//		offset 8   uint16 number of items
+//		offset 10  items: uint16 pin-ID, uint8 symbol length (< PTS_MAXSYMSIZE), symbol characters (no terminator)
+//
+//	The map is sent as text rows, so it goes through the pipeline, the capture files and the broker like any log:
+//		PTSMAP <hash> <index>/<rows> <hex data>
+//	e.g.	PTSMAP 5d1c3b2a 0/3 50545301...
+//	The rows are sent in order, every one carries up to PTSMAP_CHUNKSIZE bytes of the map. The firmware sends them
+//	at boot, and when it receives a PTSMAP_REQUEST row (the debugConsole sends it when it opens a serial port).
+//
+//	Symbols description:
+//		PTSMAP_VERSION    Binary map's format version
+//		PTSMAP_MAXSIZE    Max size of the binary map
+//		PTSMAP_CHUNKSIZE  Map's bytes per row
+//		PTSMAP_ROWSIZE    Max length of a row (terminator included)
+//		PTSMAP_ROWMARK    Announcement rows' prefix
+//		PTSMAP_REQUEST    Row that asks the firmware for its map
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef PTSMAP_UT
+#define PTSMAP_UT
+
+#include <stdint.h>
+#include <werror.h>
+#include <pinToSymbol.h>
+
+#define PTSMAP_VERSION    1
+#define PTSMAP_HDRSIZE    10
+#define PTSMAP_MAXSIZE    2048
+#define PTSMAP_CHUNKSIZE  48
+#define PTSMAP_ROWSIZE    (sizeof(PTSMAP_ROWMARK) + 8 + 12 + 2 * PTSMAP_CHUNKSIZE + 1)
+#define PTSMAP_ROWMARK    "PTSMAP "
+#define PTSMAP_REQUEST    "PTSMAP?"
+
+// Parsed announcement row
+typedef struct {
+	uint32_t hash;
+	uint16_t index;
+	uint16_t rows;
+	uint8_t  size;                    // Chunk's bytes
+	uint8_t  data[PTSMAP_CHUNKSIZE];
+} ptsMapRow_t;
+
+uint32_t ptsMap_hash   (const uint8_t *data, uint32_t size);
+uint32_t ptsMap_encode (uint8_t *map, uint32_t size, const ptsDbItem_t *db, uint16_t items);
+uint16_t ptsMap_rows   (uint32_t mapSize);
+uint16_t ptsMap_row    (char *row, const uint8_t *map, uint32_t mapSize, uint16_t index);
+werror   ptsMap_parse  (const char *row, ptsMapRow_t *item);
+
+#endif
@@ -0,0 +1,641 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: rulesEngine.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Live alerting rules: rules file compiler, pin-indexed predicates and violations tracking (see rulesEngine.h)
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <rulesEngine.h>
+
+#define RULES_MAXTOKENS   (RULES_MAXCONDS * 3 + 8)
+#define RULES_STATESIZE   32
+#define RULES_ANYSTATE    -1                 // The rule is true in every state
+#define RULES_NOSTATE     -2                 // A state not referenced by the rules
+#define RULES_UNKNOWN     2                  // Level of a pin without rows
+
+typedef enum {
+	RULE_LEVEL,
+	RULE_TOGGLING
+} ruleKind_t;
+
+// Compiled rule
+typedef struct {
+	char       text[RULES_TEXTSIZE];
+	uint16_t   line;
+	ruleKind_t kind;
+	uint8_t    conds;                         // Number of pins
+	pinId_t    pin[RULES_MAXCONDS];
+	uint8_t    level[RULES_MAXCONDS];         // Conditions' levels (level rules)
+	uint32_t   forMs;                         // The conditions must be true for more than this time (0: at once)
+	int16_t    state;                         // RULES_ANYSTATE or the states' table index
+} rule_t;
+
+// Pin's reference: the rule and the level of its condition
+typedef struct {
+	uint16_t rule;
+	uint8_t  level;
+} ruleRef_t;
+
+// Firmware's state
+typedef struct {
+	char name[RULES_STATESIZE];
+	char text[RULES_TEXTSIZE];                // Messages that contain this text set the state ("" : bare name only)
+} ruleState_t;
+
+// Device's runtime
+typedef struct {
+	uint8_t  level[PTS_MAXPINID];             // Pins' levels (RULES_UNKNOWN before the first row)
+	int16_t  state;
+	uint8_t  *satisfied;                      // Rule's true conditions
+	bool     *active;                         // The rule is violated
+	uint32_t *deadline;                       // Timed and toggling rules' deadline (RULES_NODEADLINE: none)
+	uint32_t nextDeadline;                    // Nearest deadline
+	uint16_t actives;
+} rulesDev_t;
+
+//
+// Global variables
+//
+static rule_t         *rules     = NULL;
+static uint16_t       nRules     = 0;
+static ruleState_t    states[RULES_MAXSTATES];
+static uint16_t       nStates    = 0;
+static uint32_t       refStart[PTS_MAXPINID + 1];     // Pin's references: refs[refStart[pin]] .. refs[refStart[pin + 1] - 1]
+static ruleRef_t      *refs      = NULL;
+static uint16_t       stateStart[RULES_MAXSTATES + 1]; // State's rules: stRules[stateStart[s]] .. stRules[stateStart[s + 1] - 1]
+static uint16_t       *stRules   = NULL;
+static rulesHandler_t handler    = NULL;
+static rulesDev_t     devs[DEV_MAXDEVICES];
+static rulesDev_t     *cur       = &devs[0];           // Selected device (see rulesEngine_select())
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                       P R I V A T E   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+static werror pinFinding (const char *name, pinId_t *pin) {
+	//
+	// Description:
+	//	It converts the argument defined pin's symbol (or label) to the pin-ID
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG     Unknown pin
+	//
+	werror     err = WERRCODE_ERROR_ILLEGALARG;
+	const char *symbol;
+
+	for (pinId_t t = 0; t < PTS_MAXPINID && err != WERRCODE_SUCCESS; t++) {
+		if (pinToSymbol_getById(&symbol, t) == WERRCODE_SUCCESS && strcmp(symbol, name) == 0) {
+			*pin = t;
+			err  = WERRCODE_SUCCESS;
+		}
+	}
+	if (err != WERRCODE_SUCCESS && pinId_fromLabel(name, pin) == WERRCODE_SUCCESS)
+		err = WERRCODE_SUCCESS;
+
+	return(err);
+}
+
+
+static int16_t stateFinding (const char *name, bool adding) {
+	//
+	// Description:
+	//	It returns the states' table index of the argument defined state (it is added when required)
+	//
+	// Returned value:
+	//	RULES_NOSTATE   Unknown state (or the table is full)
+	//
+	int16_t s = RULES_NOSTATE;
+
+	for (uint16_t t = 0; t < nStates && s == RULES_NOSTATE; t++)
+		if (strcmp(states[t].name, name) == 0) s = t;
+
+	if (s == RULES_NOSTATE && adding && nStates < RULES_MAXSTATES && strlen(name) < RULES_STATESIZE) {
+		strcpy(states[nStates].name, name);
+		states[nStates].text[0] = '\0';
+		s = nStates++;
+	}
+	return(s);
+}
+
+
+static bool levelParsing (const char *token, uint8_t *level) {
+	//
+	// Description:
+	//	It converts "high" and "low" tokens to the level
+	//
+	bool flag = true;
+
+	if      (strcmp(token, "high") == 0) *level = 1;
+	else if (strcmp(token, "low")  == 0) *level = 0;
+	else                                 flag   = false;
+
+	return(flag);
+}
+
+
+static const char *ruleCompiling (char *row, rule_t *r) {
+	//
+	// Description:
+	//	It compiles the argument defined rule's row (comments and blank characters have already been removed)
+	//
+	// Returned value:
+	//	NULL when the rule is valid, the error's description otherwise
+	//
+	const char *err = NULL;
+	char       *tk[RULES_MAXTOKENS + 1], *save = NULL, *unit;
+	uint8_t    n = 0, i = 1;
+
+	for (char *p = strtok_r(row, " \t", &save); p != NULL; p = strtok_r(NULL, " \t", &save))
+		if (n < RULES_MAXTOKENS) tk[n++] = p;
+		else                     err = "too long rule";
+	tk[n] = NULL;
+
+	r->conds = 0;
+	r->forMs = 0;
+	r->state = RULES_ANYSTATE;
+
+	if (err != NULL) {
+		// ERROR!
+
+	} else if (pinFinding(tk[0], &r->pin[0]) != WERRCODE_SUCCESS)
+		err = "unknown pin";
+
+	else if (i < n && levelParsing(tk[i], &r->level[0])) {
+		// <pin> high|low [and|while <pin> high|low ...]
+		r->kind  = RULE_LEVEL;
+		r->conds = 1;
+		for (i++; err == NULL && i < n && (strcmp(tk[i], "and") == 0 || strcmp(tk[i], "while") == 0); i += 3) {
+			if (r->conds == RULES_MAXCONDS)
+				err = "too many conditions";
+			else if (tk[i + 1] == NULL || pinFinding(tk[i + 1], &r->pin[r->conds]) != WERRCODE_SUCCESS)
+				err = "unknown pin";
+			else if (tk[i + 2] == NULL || levelParsing(tk[i + 2], &r->level[r->conds]) == false)
+				err = "\"high\" or \"low\" expected";
+			else
+				r->conds++;
+		}
+
+		// [for > <n> s|ms]
+		if (err == NULL && i < n && strcmp(tk[i], "for") == 0) {
+			if (i + 2 >= n || strcmp(tk[i + 1], ">") != 0) {
+				err = "\"for > <time> s|ms\" expected";
+			} else {
+				r->forMs = strtoul(tk[i + 2], &unit, 10);
+				if (*unit == '\0' && i + 3 < n) unit = tk[i++ + 3];
+
+				if      (strcmp(unit, "s") == 0)  r->forMs *= 1000;
+				else if (strcmp(unit, "ms") != 0) err = "\"s\" or \"ms\" expected";
+				i += 3;
+			}
+		}
+
+	} else {
+		// <pin> [and <pin> ...] toggling
+		r->kind  = RULE_TOGGLING;
+		r->conds = 1;
+		for (; err == NULL && i < n && strcmp(tk[i], "and") == 0; i += 2) {
+			if (r->conds == RULES_MAXCONDS)
+				err = "too many pins";
+			else if (tk[i + 1] == NULL || pinFinding(tk[i + 1], &r->pin[r->conds]) != WERRCODE_SUCCESS)
+				err = "unknown pin";
+			else
+				r->conds++;
+		}
+		if (err == NULL && (i >= n || strcmp(tk[i++], "toggling") != 0))
+			err = "\"high\", \"low\" or \"toggling\" expected";
+	}
+
+	// [in <STATE>]
+	if (err == NULL && i < n && strcmp(tk[i], "in") == 0) {
+		if (i + 1 >= n || (r->state = stateFinding(tk[i + 1], true)) == RULES_NOSTATE)
+			err = "missing state (or too many states)";
+		i += 2;
+	}
+	if (err == NULL && i < n)
+		err = "unexpected words at the end of the rule";
+
+	return(err);
+}
+
+
+static werror indexBuilding () {
+	//
+	// Description:
+	//	It builds the pin-to-rules and the state-to-rules indexes (compressed arrays, every item is a reference)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror   err   = WERRCODE_SUCCESS;
+	uint32_t total = 0;
+	uint32_t fill[PTS_MAXPINID];
+	uint16_t sFill[RULES_MAXSTATES];
+
+	// Counting (refStart[pin + 1] and stateStart[state + 1] are the counters)
+	memset(refStart, 0, sizeof(refStart));
+	memset(stateStart, 0, sizeof(stateStart));
+	for (uint16_t r = 0; r < nRules; r++) {
+		for (uint8_t c = 0; c < rules[r].conds; c++) refStart[rules[r].pin[c] + 1]++;
+		if (rules[r].state >= 0) stateStart[rules[r].state + 1]++;
+		total += rules[r].conds;
+	}
+	for (pinId_t p = 0; p < PTS_MAXPINID; p++)    refStart[p + 1]   += refStart[p];
+	for (uint16_t s = 0; s < RULES_MAXSTATES; s++) stateStart[s + 1] += stateStart[s];
+
+	if ((refs = malloc(total * sizeof(ruleRef_t) + 1)) == NULL || (stRules = malloc(nRules * sizeof(uint16_t) + 1)) == NULL) {
+		// ERROR!
+		err = WERRCODE_ERROR_OUTOFMEMORY;
+
+	} else {
+		memcpy(fill, refStart, sizeof(fill));
+		memcpy(sFill, stateStart, sizeof(sFill));
+		for (uint16_t r = 0; r < nRules; r++) {
+			for (uint8_t c = 0; c < rules[r].conds; c++)
+				refs[fill[rules[r].pin[c]]++] = (ruleRef_t){ r, rules[r].level[c] };
+			if (rules[r].state >= 0) stRules[sFill[rules[r].state]++] = r;
+		}
+	}
+
+	return(err);
+}
+
+
+static void alerting (uint16_t r, bool active, uint32_t tstamp) {
+	//
+	// Description:
+	//	It changes the rule's violation status, and it calls the handler
+	//
+	ruleAlert_t alert = { r, rules[r].line, rules[r].text, active, tstamp, rules[r].conds, rules[r].pin };
+
+	if (cur->active[r] != active) {
+		cur->active[r] = active;
+		if (active) cur->actives++;
+		else        cur->actives--;
+		if (handler != NULL) handler(&alert);
+	}
+	return;
+}
+
+
+static void deadlineSetting (uint16_t r, uint32_t deadline) {
+	//
+	// Description:
+	//	It sets the rule's deadline (see rulesEngine_tick())
+	//
+	cur->deadline[r] = deadline;
+	if (deadline < cur->nextDeadline) cur->nextDeadline = deadline;
+
+	return;
+}
+
+
+static void truthChanging (uint16_t r, bool flag, uint32_t tstamp) {
+	//
+	// Description:
+	//	It handles the change of the level rule's truth: the timed rules are violated by rulesEngine_tick(), when the
+	//	conditions have been true for more than their time
+	//
+	if (flag == false) {
+		cur->deadline[r] = RULES_NODEADLINE;
+		alerting(r, false, tstamp);
+	} else if (rules[r].forMs == 0)
+		alerting(r, true, tstamp);
+	else
+		deadlineSetting(r, tstamp + rules[r].forMs + 1);
+
+	return;
+}
+
+
+static void stateSetting (int16_t state, uint32_t tstamp) {
+	//
+	// Description:
+	//	It changes the device's state: only the rules bound to the old and to the new state are evaluated
+	//
+	int16_t old = cur->state;
+
+	if (state == old) return;
+
+	for (uint16_t t = (old >= 0) ? stateStart[old] : 0; old >= 0 && t < stateStart[old + 1]; t++) {
+		uint16_t r = stRules[t];
+
+		if (rules[r].kind == RULE_TOGGLING) {
+			cur->deadline[r] = RULES_NODEADLINE;
+			alerting(r, false, tstamp);
+		} else if (cur->satisfied[r] == rules[r].conds)
+			truthChanging(r, false, tstamp);
+	}
+
+	cur->state = state;
+	for (uint16_t t = (state >= 0) ? stateStart[state] : 0; state >= 0 && t < stateStart[state + 1]; t++) {
+		uint16_t r = stRules[t];
+
+		if (rules[r].kind == RULE_LEVEL && cur->satisfied[r] == rules[r].conds) truthChanging(r, true, tstamp);
+	}
+
+	return;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+//                                         P U B L I C   F U N C T I O N S
+//------------------------------------------------------------------------------------------------------------------------------
+werror rulesEngine_load (const char *path, rulesHandler_t alertHandler) {
+	//
+	// Description:
+	//	It compiles the argument defined rules file, and it builds the indexes. The handler is called by the
+	//	functions that cause a rule's violation or clearing (the caller's thread).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_FILENOTFOUND
+	//	WERRCODE_ERROR_INVALIDDATA    Syntax error (described on stderr)
+	//	WERRCODE_ERROR_DATAOVERFLOW   Too many rules
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror   err  = WERRCODE_SUCCESS;
+	FILE     *fd;
+	char     row[PTS_ROWMAXSIZE], *ptr, *end;
+	uint16_t line = 0;
+
+	rulesEngine_free();
+
+	if ((fd = fopen(path, "r")) == NULL) {
+		// ERROR!
+		fprintf(stderr, "ERROR! I cannot open the \"%s\" rules file\n", path);
+		err = WERRCODE_ERROR_FILENOTFOUND;
+
+	} else if ((rules = malloc(RULES_MAXRULES * sizeof(rule_t))) == NULL) {
+		// ERROR!
+		err = WERRCODE_ERROR_OUTOFMEMORY;
+
+	} else {
+		while (err == WERRCODE_SUCCESS && fgets(row, sizeof(row), fd) != NULL) {
+			line++;
+			if ((ptr = strchr(row, '#')) != NULL) *ptr = '\0';
+			for (ptr = row; *ptr == ' ' || *ptr == '\t'; ptr++);
+			for (end = ptr + strlen(ptr); end > ptr && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n' || end[-1] == '\r'); end--);
+			*end = '\0';
+
+			if (*ptr == '\0') {
+				// Blank row
+
+			} else if (strncmp(ptr, "state", 5) == 0 && (ptr[5] == ' ' || ptr[5] == '\t')) {
+				// state <STATE> <message text>
+				char    *name = ptr + 6, *text;
+				int16_t s;
+
+				while (*name == ' ' || *name == '\t') name++;
+				for (text = name; *text != '\0' && *text != ' ' && *text != '\t'; text++);
+				if (*text != '\0') *text++ = '\0';
+				while (*text == ' ' || *text == '\t') text++;
+
+				if (*text == '\0' || (s = stateFinding(name, true)) == RULES_NOSTATE || strlen(text) >= RULES_TEXTSIZE) {
+					// ERROR!
+					fprintf(stderr, "ERROR! %s:%u: invalid state definition\n", path, line);
+					err = WERRCODE_ERROR_INVALIDDATA;
+				} else
+					strcpy(states[s].text, text);
+
+			} else if (nRules == RULES_MAXRULES) {
+				// ERROR!
+				fprintf(stderr, "ERROR! %s:%u: too many rules (max %u)\n", path, line, RULES_MAXRULES);
+				err = WERRCODE_ERROR_DATAOVERFLOW;
+
+			} else {
+				rule_t     *r = &rules[nRules];
+				const char *msg;
+
+				snprintf(r->text, RULES_TEXTSIZE, "%s", ptr);
+				r->line = line;
+				if ((msg = ruleCompiling(ptr, r)) != NULL) {
+					// ERROR!
+					fprintf(stderr, "ERROR! %s:%u: %s (\"%s\")\n", path, line, msg, r->text);
+					err = WERRCODE_ERROR_INVALIDDATA;
+				} else
+					nRules++;
+			}
+		}
+
+		if (err == WERRCODE_SUCCESS) err = indexBuilding();
+
+		// Devices' runtime
+		for (devId_t d = 0; d < DEV_MAXDEVICES && err == WERRCODE_SUCCESS; d++) {
+			memset(devs[d].level, RULES_UNKNOWN, sizeof(devs[d].level));
+			devs[d].state        = RULES_NOSTATE;
+			devs[d].nextDeadline = RULES_NODEADLINE;
+			devs[d].actives      = 0;
+			devs[d].satisfied    = calloc(nRules + 1, sizeof(uint8_t));
+			devs[d].active       = calloc(nRules + 1, sizeof(bool));
+			devs[d].deadline     = malloc((nRules + 1) * sizeof(uint32_t));
+
+			if (devs[d].satisfied == NULL || devs[d].active == NULL || devs[d].deadline == NULL)
+				// ERROR!
+				err = WERRCODE_ERROR_OUTOFMEMORY;
+			else
+				for (uint16_t r = 0; r < nRules; r++) devs[d].deadline[r] = RULES_NODEADLINE;
+		}
+		handler = alertHandler;
+	}
+
+	if (fd != NULL) fclose(fd);
+	if (err != WERRCODE_SUCCESS) rulesEngine_free();
+
+	return(err);
+}
+
+
+bool rulesEngine_isOn () {
+	//
+	// Description:
+	//	It returns true when a rules file has been loaded
+	//
+	return(rules != NULL);
+}
+
+
+void rulesEngine_select (devId_t dev) {
+	//
+	// Description:
+	//	It selects the runtime of the argument defined device (the device 0 is selected by default)
+	//
+	cur = &devs[(dev < DEV_MAXDEVICES) ? dev : 0];
+
+	return;
+}
+
+
+void rulesEngine_update (pinId_t pin, uint32_t value, uint32_t tstamp) {
+	//
+	// Description:
+	//	It updates the argument defined pin's level: only the rules that reference the pin are considered, and their
+	//	true conditions counter is adjusted
+	//
+	uint8_t level = (value != 0), old;
+
+	if (rules == NULL || pin >= PTS_MAXPINID) return;
+	rulesEngine_tick(tstamp);
+
+	if ((old = cur->level[pin]) == level) return;
+	cur->level[pin] = level;
+
+	for (uint32_t t = refStart[pin]; t < refStart[pin + 1]; t++) {
+		uint16_t     r     = refs[t].rule;
+		const rule_t *rule = &rules[r];
+		bool         inState = (rule->state == RULES_ANYSTATE || rule->state == cur->state);
+
+		if (rule->kind == RULE_TOGGLING) {
+			if (old != RULES_UNKNOWN && inState) {
+				alerting(r, true, tstamp);
+				deadlineSetting(r, tstamp + RULES_TOGGLEMS);
+			}
+
+		} else {
+			bool wasTrue = (cur->satisfied[r] == rule->conds);
+
+			if (old   == refs[t].level) cur->satisfied[r]--;
+			if (level == refs[t].level) cur->satisfied[r]++;
+			if (inState && wasTrue != (cur->satisfied[r] == rule->conds)) truthChanging(r, !wasTrue, tstamp);
+		}
+	}
+
+	return;
+}
+
+
+void rulesEngine_log (const char *msg, uint32_t tstamp) {
+	//
+	// Description:
+	//	It looks for the firmware's state in the argument defined log message. The ESP-IDF prefix ("I (1234) TAG: ")
+	//	is skipped, then the message sets the state when it contains a "state" line's text, or when it is a bare
+	//	upper case identifier (a state not referenced by the rules is a generic "other" state).
+	//
+	const char *body = msg, *ptr;
+	char       name[RULES_STATESIZE];
+	int16_t    state = RULES_ANYSTATE;               // No state change
+	uint8_t    len   = 0;
+
+	if (rules == NULL) return;
+	rulesEngine_tick(tstamp);
+
+	if (msg[0] != '\0' && msg[1] == ' ' && msg[2] == '(' && (ptr = strstr(msg, ": ")) != NULL) body = ptr + 2;
+
+	for (uint16_t s = 0; s < nStates && state == RULES_ANYSTATE; s++)
+		if (states[s].text[0] != '\0' && strstr(body, states[s].text) != NULL) state = s;
+
+	if (state == RULES_ANYSTATE && *body >= 'A' && *body <= 'Z') {
+		for (ptr = body; ((*ptr >= 'A' && *ptr <= 'Z') || (*ptr >= '0' && *ptr <= '9') || *ptr == '_') && len < RULES_STATESIZE - 1; ptr++)
+			name[len++] = *ptr;
+		name[len] = '\0';
+
+		// Trailing blank characters are allowed
+		while (*ptr == ' ' || *ptr == '\r') ptr++;
+		if (*ptr == '\0') state = stateFinding(name, false);
+	}
+
+	if (state != RULES_ANYSTATE) stateSetting(state, tstamp);
+
+	return;
+}
+
+
+void rulesEngine_tick (uint32_t tstamp) {
+	//
+	// Description:
+	//	It handles the expired deadlines: the timed rules whose conditions are still true are violated, and the
+	//	toggling rules whose pins have been stable are cleared. Nothing is done before the nearest deadline.
+	//
+	if (rules == NULL || tstamp < cur->nextDeadline) return;
+
+	cur->nextDeadline = RULES_NODEADLINE;
+	for (uint16_t r = 0; r < nRules; r++) {
+		if (cur->deadline[r] <= tstamp) {
+			cur->deadline[r] = RULES_NODEADLINE;
+			alerting(r, rules[r].kind == RULE_LEVEL, tstamp);
+
+		} else if (cur->deadline[r] < cur->nextDeadline)
+			cur->nextDeadline = cur->deadline[r];
+	}
+
+	return;
+}
+
+
+uint32_t rulesEngine_nextDeadline () {
+	//
+	// Description:
+	//	It returns the selected device's nearest deadline (RULES_NODEADLINE: none), so the caller can call
+	//	rulesEngine_tick() in time when no pin update arrives (e.g. the serial link is quiet)
+	//
+	return((rules == NULL) ? RULES_NODEADLINE : cur->nextDeadline);
+}
+
+
+uint16_t rulesEngine_count () {
+	//
+	// Description:
+	//	It returns the number of the loaded rules
+	//
+	return(nRules);
+}
+
+
+uint16_t rulesEngine_active () {
+	//
+	// Description:
+	//	It returns the number of the selected device's violated rules
+	//
+	return(cur->actives);
+}
+
+
+void rulesEngine_free () {
+	//
+	// Description:
+	//	It releases the rules and the devices' runtime
+	//
+	for (devId_t d = 0; d < DEV_MAXDEVICES; d++) {
+		free(devs[d].satisfied);
+		free(devs[d].active);
+		free(devs[d].deadline);
+		devs[d].satisfied = NULL;
+		devs[d].active    = NULL;
+		devs[d].deadline  = NULL;
+	}
+	free(rules);
+	free(refs);
+	free(stRules);
+	rules   = NULL;
+	refs    = NULL;
+	stRules = NULL;
+	nRules  = nStates = 0;
+	handler = NULL;
+
+	return;
+}
@@ -0,0 +1,105 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: rulesEngine.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Live alerting rules on the pins' levels. The rules file has a rule per line ('#' starts a comment):
+//
+//		<pin> high|low [and|while <pin> high|low ...] [for > <n> s|ms] [in <STATE>]
+//		<pin> [and <pin> ...] toggling [in <STATE>]
+//		state <STATE> <message text>
+//
+//	e.g.	o_STARTENGINE high for > 5 s
+//		o_ENGINEON high while i_BIKESTAND low and i_NEUTRAL low
+//		o_LEFTARROW and o_RIGHTARROW toggling in HW_FAILURE
+//		state HW_FAILURE *** HARDWARE FAILURE ***
+//
+//	The pins are defined by their symbols or by their labels, and a pin is high when its value is not zero.
+//	A level rule is violated when all its conditions are true (for more than the defined time, when "for" is used).
+//	A toggling rule is violated when one of its pins changes, and it is cleared when they are stable for
+//	RULES_TOGGLEMS. The firmware's state is the last log message that is a bare upper case identifier (e.g.
+//	"MTB_WFR_ST"), or that contains the text of a "state" line; a rule with "in <STATE>" is true only in that state.
+//
+//	The rules are compiled to predicates indexed by pin: every rule keeps the number of its true conditions, so a pin
+//	update changes the counters of the rules that reference the pin only, and no rule is evaluated again from
+//	scratch. The timed rules are checked by rulesEngine_tick() only when the nearest deadline has expired, and
+//	rulesEngine_nextDeadline() returns it, so the rules expire in time when no row arrives.
+//	The handler is called when a rule is violated and when it is cleared (see ruleAlert_t). Every device (see
+//	devices.h) has its own levels, state and violations: the functions work on the one selected by
+//	rulesEngine_select().
+//
+//	Symbols:
+//		RULES_MAXRULES    Max number of rules
+//		RULES_MAXCONDS    Max number of pins of a rule
+//		RULES_MAXSTATES   Max number of states referenced by the rules
+//		RULES_TEXTSIZE    Max length of the rule's text (reported by the alerts)
+//		RULES_TOGGLEMS    A toggling rule is cleared when its pins are stable for this time (ms)
+//		RULES_ALERTMARK   Prefix of the alert log messages
+//		RULES_NODEADLINE  No pending deadline (see rulesEngine_nextDeadline())
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef RULESENGINE_UT
+#define RULESENGINE_UT
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <werror.h>
+#include <pinToSymbol.h>
+#include <devices.h>
+
+#define RULES_MAXRULES    1024
+#define RULES_MAXCONDS    8
+#define RULES_MAXSTATES   64
+#define RULES_TEXTSIZE    96
+#define RULES_TOGGLEMS    1000
+#define RULES_ALERTMARK   "ALERT!"
+#define RULES_NODEADLINE  UINT32_MAX
+
+// Rule's violation (or clearing) event
+typedef struct {
+	uint16_t      rule;               // Rule's index (file order)
+	uint16_t      line;               // Rule's line in the rules file
+	const char    *text;              // Rule's text
+	bool          active;             // true: violated, false: cleared
+	uint32_t      tstamp;             // Event's time (ms)
+	uint8_t       pins;               // Number of the rule's pins
+	const pinId_t *pin;               // Rule's pins
+} ruleAlert_t;
+
+typedef void (*rulesHandler_t)(const ruleAlert_t *alert);
+
+werror   rulesEngine_load         (const char *path, rulesHandler_t handler);
+bool     rulesEngine_isOn         ();
+void     rulesEngine_select       (devId_t dev);
+void     rulesEngine_update       (pinId_t pin, uint32_t value, uint32_t tstamp);
+void     rulesEngine_log          (const char *msg, uint32_t tstamp);
+void     rulesEngine_tick         (uint32_t tstamp);
+uint32_t rulesEngine_nextDeadline ();
+uint16_t rulesEngine_count        ();
+uint16_t rulesEngine_active       ();
+void     rulesEngine_free         ();
+
+#endif
@@ -34,24 +34,28 @@
 #include <screenUtils.h>
 #include <curses.h>
 	
-void linePrinting (char pattern, uint16_t colums) {
+void linePrinting (WINDOW *win, char pattern, uint16_t colums) {
 	//
 	// Description:
-	//	It prints a line on the screen
+	//	It prints a line in the argument defined window, and it moves the cursor to the next row
 	//
-	for (uint16_t t=0; t<colums; t++) printw("%c", pattern);
-	printw("\n");
+	int y = getcury(win);
+
+	mvwhline(win, y, 0, pattern, colums);
+	wmove(win, y + 1, 0);
 	return;
 }
 	
 				
-void titlePrinting (const char *title, uint16_t colums) {
+void titlePrinting (WINDOW *win, const char *title, uint16_t colums) {
 	//
 	// Description:
-	//	It prints a central justified text
+	//	It prints a central justified text in the argument defined window
 	//
-	uint16_t padSize = (colums - strlen(title))/2;
-	for (uint16_t t=0; t<padSize; t++) printw(" ");
-	printw("%s\n", title);
+	uint16_t padSize = (colums > strlen(title)) ? (colums - strlen(title))/2 : 0;
+	int      y       = getcury(win);
+
+	mvwprintw(win, y, padSize, "%s", title);
+	wmove(win, y + 1, 0);
 	return;
 }
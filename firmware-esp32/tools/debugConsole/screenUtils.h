@@ -32,8 +32,9 @@
 #define ASCIISCREENUTILS
 
 #include <stdint.h>
+#include <curses.h>
 
-void linePrinting  (char pattern, uint16_t colums);
-void titlePrinting (const char *title, uint16_t colums);
+void linePrinting  (WINDOW *win, char pattern, uint16_t colums);
+void titlePrinting (WINDOW *win, const char *title, uint16_t colums);
 
 #endif
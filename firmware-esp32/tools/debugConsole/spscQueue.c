@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: spscQueue.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Lock-free single-producer/single-consumer queue of data chunks. It is used to move the serial port's data from the
+//	reader thread to the parser thread. The chunks are written and read in place (zero copy): the producer reserves a
+//	slot, fills it and commits it; the consumer gets the oldest slot and releases it.
+//
+//	Symbols:
+//		SPSC_SLOTS       Number of chunks in the queue (it must be a power of 2)
+//		SPSC_CHUNKSIZE   Max size of a single chunk
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdatomic.h>
+#include <stddef.h>
+#include <spscQueue.h>
+
+static spscChunk_t      slots[SPSC_SLOTS];
+static _Atomic uint32_t head = 0;      // Next slot to write (producer)
+static _Atomic uint32_t tail = 0;      // Next slot to read (consumer)
+
+#if (SPSC_SLOTS & (SPSC_SLOTS - 1)) != 0
+#error "SPSC_SLOTS must be a power of 2"
+#endif
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+spscChunk_t* spscQueue_reserve () {
+	//
+	// Description:
+	//	(Producer) It returns the slot to fill, or NULL when the queue is full. The slot is not visible to the consumer
+	//	until spscQueue_commit() is called.
+	//
+	uint32_t    h   = atomic_load_explicit(&head, memory_order_relaxed);
+	spscChunk_t *ptr = NULL;
+
+	if (h - atomic_load_explicit(&tail, memory_order_acquire) < SPSC_SLOTS)
+		ptr = &slots[h % SPSC_SLOTS];
+
+	return(ptr);
+}
+
+
+void spscQueue_commit () {
+	//
+	// Description:
+	//	(Producer) It publishes the slot returned by spscQueue_reserve()
+	//
+	atomic_store_explicit(&head, atomic_load_explicit(&head, memory_order_relaxed) + 1, memory_order_release);
+
+	return;
+}
+
+
+spscChunk_t* spscQueue_front () {
+	//
+	// Description:
+	//	(Consumer) It returns the oldest chunk, or NULL when the queue is empty
+	//
+	uint32_t    t   = atomic_load_explicit(&tail, memory_order_relaxed);
+	spscChunk_t *ptr = NULL;
+
+	if (t != atomic_load_explicit(&head, memory_order_acquire))
+		ptr = &slots[t % SPSC_SLOTS];
+
+	return(ptr);
+}
+
+
+void spscQueue_release () {
+	//
+	// Description:
+	//	(Consumer) It gives the chunk returned by spscQueue_front() back to the producer
+	//
+	atomic_store_explicit(&tail, atomic_load_explicit(&tail, memory_order_relaxed) + 1, memory_order_release);
+
+	return;
+}
+
+
+uint32_t spscQueue_used () {
+	//
+	// Description:
+	//	It returns the number of chunks in the queue (it is just a snapshot)
+	//
+	return(atomic_load_explicit(&head, memory_order_acquire) - atomic_load_explicit(&tail, memory_order_acquire));
+}
@@ -0,0 +1,61 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: spscQueue.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Lock-free single-producer/single-consumer queue of data chunks. It is used to move the serial port's data from the
+//	reader thread to the parser thread. The chunks are written and read in place (zero copy): the producer reserves a
+//	slot, fills it and commits it; the consumer gets the oldest slot and releases it.
+//
+//	Symbols:
+//		SPSC_SLOTS       Number of chunks in the queue (it must be a power of 2)
+//		SPSC_CHUNKSIZE   Max size of a single chunk
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef SPSCQUEUE_UT
+#define SPSCQUEUE_UT
+
+#include <stdint.h>
+#include <werror.h>
+#include <devices.h>
+
+#define SPSC_SLOTS       1024
+#define SPSC_CHUNKSIZE   4096
+
+// Queue's item
+typedef struct {
+	uint32_t tstamp;                  // Reception time-stamp (ms)
+	uint32_t size;                    // Number of valid bytes
+	devId_t  dev;                     // Source device (serial port)
+	char     data[SPSC_CHUNKSIZE];
+} spscChunk_t;
+
+spscChunk_t* spscQueue_reserve ();
+void         spscQueue_commit  ();
+spscChunk_t* spscQueue_front   ();
+void         spscQueue_release ();
+uint32_t     spscQueue_used    ();
+
+#endif
@@ -14,6 +14,8 @@
 // Description:
 //	This module allows you to receive partial strings and collect them to build a sequence of single strings
 //	Each string is limited by the BUILDER_ENDOFDATA character
+//	Every device (see devices.h) has its own ring: the functions work on the one selected by stringBuilder_select().
+//	The stringBuilder_h*() functions work on a caller's builder instead (e.g. a builder per thread).
 //
 //
 // License:
@@ -30,89 +32,132 @@
 //		<https://www.gnu.org/licenses/gpl-3.0.txt>.
 //
 ------------------------------------------------------------------------------------------------------------------------------*/
-#include <stdio.h>
 #include <stdbool.h>
-#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stringBuilder.h>
 
+#define BUILDER_HDRSIZE   sizeof(buffSize_t)
+#define BUILDER_WRAPMARK  0xFFFF                                   // Header value: the next row is at the ring's start
+#define BUILDER_MAXROWLEN (BUILDER_MAXSTRINGSIZE - 2)              // Longer rows are truncated
+#define BUILDER_ROWSPACE  (BUILDER_HDRSIZE + BUILDER_MAXSTRINGSIZE) // Space reserved for a new row
 
-typedef struct _logsSetItem_t {
-	char buffer[BUILDER_MAXSTRINGSIZE];
-	struct _logsSetItem_t  *next;
-} logsSetItem_t;
-
-typedef enum {
-	BUILDER_NORMAL,
-	BUILDER_OVRFLOW,
-	BUILDER_ESCSEQ
-} parser_FSM_t;
-
-static logsSetItem_t *oldest = NULL;
-static logsSetItem_t *newest = NULL;
+static stringBuilder_t devs[DEV_MAXDEVICES];    // Zero: empty ring, BUILDER_NORMAL state
+static stringBuilder_t *cur = &devs[0];         // Selected device (see stringBuilder_select())
 
 //------------------------------------------------------------------------------------------------------------------------------
 //                                       P R I V A T E   F U N C T I O N S
 //------------------------------------------------------------------------------------------------------------------------------
-/*
-static void partPrint (const char *string, uint16_t size) {
+static werror rowBegin (stringBuilder_t *b) {
 	//
 	// Description:
-	//	It prints the argument defined part of the string. (IT IS JUST A DEBUG TOOL)
+	//	It reserves the space for a new row (BUILDER_ROWSPACE contiguous bytes), wrapping to the ring's start when the
+	//	space at the end is not enough.
 	//
-	for (uint16_t t=0; t<size; t++) printw("%c", string[t]);
-	printw("\n");
-	return;
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY   The not yet read rows fill the ring
+	//
+	werror ecode = WERRCODE_SUCCESS;
+
+	if (b->rowsNumb == 0) {
+		// Everything has been read: the ring is restarted
+		b->head = 0;
+		b->tail = 0;
+
+	} else if (b->tail > b->head) {
+		if ((BUILDER_RINGSIZE - b->tail) < BUILDER_ROWSPACE) {
+			if (b->head <= BUILDER_ROWSPACE)
+				// ERROR!
+				ecode = WERRCODE_ERROR_OUTOFMEMORY;
+			else {
+				if ((BUILDER_RINGSIZE - b->tail) >= BUILDER_HDRSIZE) {
+					buffSize_t mark = BUILDER_WRAPMARK;
+					memcpy(b->ring + b->tail, &mark, BUILDER_HDRSIZE);
+				}
+				b->tail = 0;
+			}
+		}
+
+	} else if ((b->head - b->tail) <= BUILDER_ROWSPACE)
+		// ERROR!
+		ecode = WERRCODE_ERROR_OUTOFMEMORY;
+
+	if (ecode == WERRCODE_SUCCESS) {
+		b->rowOpen  = true;
+		b->rowValid = false;
+		b->rowLen   = 0;
+	}
+	return(ecode);
 }
-*/
 
 
-static bool checkForValidData (const char *string) {
+static void rowAppend (stringBuilder_t *b, const char *data, buffSize_t size) {
 	//
 	// Description:
-	//	It is used to prevent empty chasracters string
+	//	It appends the argument defined characters to the open row (the caller checks the row's size)
 	//
-	// Returned value:
-	//	TRUE   OK! The string is valid
-	//	TALSE  WARNING! It is an empty string
-	//
-	uint8_t size  = strlen(string);
-	bool    valid = false;
-		
-	for (uint8_t t=0; t<size; t++) {
-		if (string[t] != ' ') {
-			valid = true;
-			break;
+	char *dst = b->ring + b->tail + BUILDER_HDRSIZE + b->rowLen;
+
+	memcpy(dst, data, size);
+	if (b->rowValid == false) {
+		// Blank rows are not stored
+		for (buffSize_t t=0; t<size; t++) {
+			if (dst[t] != ' ') {
+				b->rowValid = true;
+				break;
+			}
 		}
 	}
-	return(valid);
+	b->rowLen += size;
+	return;
 }
 
 
-#if BUILDER_NOSCAPECODES == 1
-static bool chInSet (char ch, const char set[]) {
+static void rowEnd (stringBuilder_t *b) {
 	//
 	// Description:
-	//	It returns true value if the argument defined character belongs to the other arg specified set
+	//	It closes the open row. The blank rows are dropped.
 	//
-	bool    out = false;
-	uint8_t t = 0;
-	while (set[t] != '\0' && out == false) {
-		if (set[t] == ch) out = true;
-		t++;
+	if (b->rowValid) {
+		memcpy(b->ring + b->tail, &b->rowLen, BUILDER_HDRSIZE);
+		b->ring[b->tail + BUILDER_HDRSIZE + b->rowLen] = '\0';
+		b->tail += BUILDER_HDRSIZE + b->rowLen + 1;
+		b->rowsNumb++;
 	}
-	return(out);
+	b->rowOpen = false;
+	return;
+}
+
+
+#if BUILDER_NOSCAPECODES == 1
+static inline bool escSeqChar (char ch) {
+	//
+	// Description:
+	//	It returns true value if the argument defined character belongs to an escape sequence
+	//
+	return(isdigit(ch) || ch == ';' || ch == '[' || ch == ']' || ch == 'm');
 }
 #endif
 //------------------------------------------------------------------------------------------------------------------------------
 //                                        P U B L I C   F U N C T I O N S 
 //------------------------------------------------------------------------------------------------------------------------------
-werror stringBuilder_put(const char *data, buffSize_t size) {
+void stringBuilder_select (devId_t dev) {
+	//
+	// Description:
+	//	It selects the ring of the argument defined device (the device 0 is selected by default)
+	//
+	cur = &devs[(dev < DEV_MAXDEVICES) ? dev : 0];
+
+	return;
+}
+
+
+werror stringBuilder_hPut (stringBuilder_t *b, const char *data, buffSize_t size) {
 	//
 	// Decription:
-	//	Use this function to store/parse new characters stream. It can contains many strings definitions or no one
-	//	if it is just a part of a string
+	//	Use this function to store/parse new characters stream in the argument defined builder. It can contains many strings definitions or no one
+	//	if it is just a part of a string. The rows are searched by memchr() and copied by blocks.
 	//
 	// Arguments:
 	//	data:   characters stream
@@ -120,105 +165,81 @@ werror stringBuilder_put(const char *data, buffSize_t size) {
 	//
 	// Returned value
 	//	WERRCODE_SUCCESS
-	//	WERRCODE_ERROR_OUTOFMEMORY
-	//
-	werror              ecode = WERRCODE_SUCCESS;
-	bool                eolFlag = false;
-	static buffSize_t   bufferSize = 0;  // The buffesr size of the newest's item or 0 if the log-item is completed
-	static parser_FSM_t fsm = BUILDER_NORMAL;
-	
-	if (oldest == NULL) {
-		oldest = (logsSetItem_t*)malloc(sizeof(logsSetItem_t));
-		memset(oldest->buffer, '\0', sizeof(oldest->buffer));
-		if (oldest == NULL)
-			// ERROR!
-			ecode = WERRCODE_ERROR_OUTOFMEMORY;
-			
-		else {
-			*(oldest->buffer) = '\0';
-			newest = oldest;
-			newest->next = NULL;
-		}
-	}
-	if (ecode) {
-		uint16_t     t = 0, x = 0;
-		
-		while (t < size) {
-			if (fsm == BUILDER_NORMAL) {
-				//
-				// Row assembling....
-				//
-				if (data[t] == '\n') {
-					*(newest->buffer + bufferSize + x) = '\0';
-					eolFlag = true;
+	//	WERRCODE_ERROR_OUTOFMEMORY   The ring is full (the rows have not been read)
+	//
+	werror     ecode = WERRCODE_SUCCESS;
+	buffSize_t t     = 0;
+
+	while (t < size && ecode == WERRCODE_SUCCESS) {
+		if (b->fsm == BUILDER_OVRFLOW) {
+			//
+			// Size overflow even detected I wait for the end of the row
+			//
+			const char *eol = memchr(data + t, BUILDER_ENDOFDATA, size - t);
+			if (eol == NULL)
+				t = size;
+			else {
+				t   = (eol - data) + 1;
+				b->fsm = BUILDER_NORMAL;
+			}
+
 #if BUILDER_NOSCAPECODES == 1
-				} else if (data[t] == 27  ) {
-					fsm = BUILDER_ESCSEQ;
+		} else if (b->fsm == BUILDER_ESCSEQ) {
+			//
+			// Escape char has been detected, I wait for the end of sequence
+			//
+			if (escSeqChar(data[t]))
+				t++;
+			else
+				b->fsm = BUILDER_NORMAL;
 #endif
-				} else if ((bufferSize + x) > (BUILDER_MAXSTRINGSIZE - 3)) {
-					fsm = BUILDER_OVRFLOW;
-					*(newest->buffer + bufferSize + x) = '\0';
-					eolFlag = true;
-					
-				} else {
-					// Adding a char to the buffer line
-					*(newest->buffer + bufferSize + x) = data[t];
-					//partPrint(newest->buffer, (bufferSize+x+1));
-					x++;
-				}
-		
-		
-			} else if (fsm == BUILDER_OVRFLOW) {
-				//
-				// Size overflow even detected I wait for the end of the row
-				//
-				if (data[t] == '\n') fsm = BUILDER_NORMAL;
-				
-		
+
+		} else if (b->rowOpen == false) {
+			ecode = rowBegin(b);
+
+		} else {
+			//
+			// Row assembling....
+			//
+			const char *eol  = memchr(data + t, BUILDER_ENDOFDATA, size - t);
+			buffSize_t  sEnd = (eol == NULL) ? size : (eol - data);
+			buffSize_t  room = BUILDER_MAXROWLEN - b->rowLen;
 #if BUILDER_NOSCAPECODES == 1
-			} else if (fsm == BUILDER_ESCSEQ) {
-				//
-				// Escape char has been detected, I wait for the end of sequence
-				//
-				if (isdigit(data[t]) == 0 && chInSet(data[t], ";[]m") == false) {
-					fsm = BUILDER_NORMAL;
-					t--;
-				}
+			const char *esc  = memchr(data + t, 27, sEnd - t);
+			if (esc != NULL) sEnd = esc - data;
 #endif
-			}
-	
-			
-			if (eolFlag) {
-				if (checkForValidData(newest->buffer)) {
-					newest->next = (logsSetItem_t*)malloc(sizeof(logsSetItem_t));
-					if (newest->next == NULL) {
-						// ERROR!
-						ecode = WERRCODE_ERROR_OUTOFMEMORY;
-						break;
-					} else
-						newest = newest->next;
+			if ((sEnd - t) > room) {
+				// The row is truncated, the rest is skipped
+				rowAppend(b, data + t, room);
+				rowEnd(b);
+				t  += room;
+				b->fsm = BUILDER_OVRFLOW;
+
+			} else {
+				rowAppend(b, data + t, sEnd - t);
+				t = sEnd;
+				if (t < size) {
+					if (data[t] == BUILDER_ENDOFDATA)
+						rowEnd(b);
+#if BUILDER_NOSCAPECODES == 1
+					else
+						b->fsm = BUILDER_ESCSEQ;
+#endif
+					t++;
 				}
-				memset(newest->buffer, '\0', sizeof(newest->buffer));
-				eolFlag = false;
-				newest->next = NULL;
-				bufferSize = 0;
-				x = 0;
 			}
-			
-			t++;
 		}
-		bufferSize += x;
-		*(newest->buffer + bufferSize) = '\0';
 	}
-	
+
 	return(ecode);
 }
 
 
-werror stringBuilder_get(char *data) {
+werror stringBuilder_hGetView (stringBuilder_t *b, builderView_t *view) {
 	//
 	// Decription:
-	//	This function allows you to retrive the strings defined in the previousely added chras streams
+	//	This function allows you to retrive the strings defined in the previousely added chras streams, without any
+	//	copy. The view is valid until the next stringBuilder_hPut() call on the argument defined builder
 	//	
 	// Returned value:
 	//	WERRCODE_SUCCESS
@@ -226,28 +247,85 @@ werror stringBuilder_get(char *data) {
 	//
 	werror ecode = WERRCODE_WARNING_EMPTYLIST;
 
-	if (oldest != NULL && oldest != newest) {
-		logsSetItem_t *ptr = oldest;
-		strcpy(data, oldest->buffer);
-		oldest = oldest->next;
-		free(ptr);
+	if (b->rowsNumb > 0) {
+		buffSize_t len;
+
+		if ((BUILDER_RINGSIZE - b->head) < BUILDER_HDRSIZE)
+			b->head = 0;
+		memcpy(&len, b->ring + b->head, BUILDER_HDRSIZE);
+		if (len == BUILDER_WRAPMARK) {
+			b->head = 0;
+			memcpy(&len, b->ring, BUILDER_HDRSIZE);
+		}
+
+		view->str  = b->ring + b->head + BUILDER_HDRSIZE;
+		view->size = len;
+		b->head += BUILDER_HDRSIZE + len + 1;
+		b->rowsNumb--;
 		ecode = WERRCODE_SUCCESS;
 	}
-	
+
 	return(ecode);
 }
 
-void stringBuilder_close() {
+
+werror stringBuilder_get(char *data) {
+	//
+	// Decription:
+	//	Copying version of stringBuilder_getView(). The argument defined buffer must be BUILDER_MAXSTRINGSIZE bytes
+	//	long, at least.
+	//	
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_EMPTYLIST
+	//
+	builderView_t view;
+	werror        ecode = stringBuilder_hGetView(cur, &view);
+
+	if (ecode == WERRCODE_SUCCESS)
+		memcpy(data, view.str, view.size + 1);
+
+	return(ecode);
+}
+
+
+void stringBuilder_hClose (stringBuilder_t *b) {
 	//
 	// Description:
-	//	It releases all in-use system resources
+	//	It discards all the argument defined builder's stored rows and the open one
 	//
-	logsSetItem_t *ptr = oldest;
-	while (ptr != NULL) {
-		ptr = ptr->next;
-		free(oldest);
-		oldest = ptr;
-	}
+	b->head     = 0;
+	b->tail     = 0;
+	b->rowsNumb = 0;
+	b->rowOpen  = false;
+	b->fsm      = BUILDER_NORMAL;
+	return;
+}
+
+
+werror stringBuilder_put (const char *data, buffSize_t size) {
+	//
+	// Description:
+	//	stringBuilder_hPut() on the selected device's builder
+	//
+	return(stringBuilder_hPut(cur, data, size));
+}
+
+
+werror stringBuilder_getView (builderView_t *view) {
+	//
+	// Description:
+	//	stringBuilder_hGetView() on the selected device's builder
+	//
+	return(stringBuilder_hGetView(cur, view));
+}
+
+
+void stringBuilder_close () {
+	//
+	// Description:
+	//	stringBuilder_hClose() on the selected device's builder
+	//
+	stringBuilder_hClose(cur);
 	return;
 }
-	
@@ -12,12 +12,17 @@
 // Author: Silvano Catinella <catinella@yahoo.com>
 //
 // Description:
-//
+//	The completed rows are stored in a fixed-capacity bytes ring (no allocation for every row), and they are handed out
+//	as zero-copy views. Every row is stored as a 2-bytes length header followed by the '\0' terminated characters, so
+//	a view is a normal C string too. A view is valid until the next stringBuilder_put() call.
+//	The stringBuilder_h*() functions work on the argument defined builder, instead of the selected device's one: a
+//	zeroed stringBuilder_t is an empty builder (see stringBuilder_hClose() too).
 //
 //	Symbols:
 //		BUILDER_MAXSTRINGSIZE   The maximum size of every single row
 //		BUILDER_ENDOFDATA       The character used to mark the end of the row
 //		BUILDER_NOSCAPECODES    If it is set to 1 then all the escape codes will be skipped
+//		BUILDER_RINGSIZE        The ring's size (bytes). It must be greater than the double of the biggest chunk
 //
 //
 // License:
@@ -37,8 +42,10 @@
 #ifndef MBES_BUILDER
 #define MBES_BUILDER
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <werror.h>
+#include <devices.h>
 
 #define BUILDER_MAXSTRINGSIZE 1024
 #define BUILDER_ENDOFDATA     '\n'
@@ -47,10 +54,43 @@
 #define BUILDER_NOSCAPECODES 0
 #endif
 
+#ifndef BUILDER_RINGSIZE
+#define BUILDER_RINGSIZE (256 * 1024)
+#endif
+
 typedef uint16_t buffSize_t;
 
-werror stringBuilder_put(const char *data, buffSize_t size);
-werror stringBuilder_get(char *data);
-void    stringBuilder_close();
+typedef struct {
+	const char *str;     // '\0' terminated row
+	buffSize_t size;     // Row's length (terminator excluded)
+} builderView_t;
+
+typedef enum {
+	BUILDER_NORMAL,
+	BUILDER_OVRFLOW,
+	BUILDER_ESCSEQ
+} parser_FSM_t;
+
+// Row builder
+typedef struct {
+	char         ring[BUILDER_RINGSIZE];
+	uint32_t     head;                      // Oldest not yet read row
+	uint32_t     tail;                      // End of the completed rows (the open row starts here)
+	uint32_t     rowsNumb;                  // Completed and not yet read rows
+	bool         rowOpen;
+	bool         rowValid;                  // The open row contains at least a not-blank character
+	buffSize_t   rowLen;
+	parser_FSM_t fsm;
+} stringBuilder_t;
+
+void   stringBuilder_select   (devId_t dev);
+werror stringBuilder_put      (const char *data, buffSize_t size);
+werror stringBuilder_getView  (builderView_t *view);
+werror stringBuilder_get      (char *data);
+void   stringBuilder_close    ();
+
+werror stringBuilder_hPut     (stringBuilder_t *b, const char *data, buffSize_t size);
+werror stringBuilder_hGetView (stringBuilder_t *b, builderView_t *view);
+void   stringBuilder_hClose   (stringBuilder_t *b);
 
 #endif
@@ -0,0 +1,232 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: broker_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Fan-out test of the broker (see broker.h): a child process feeds a pty pair at TEST_BPS bytes per second, and it
+//	receives the stream from TEST_CLIENTS clients connected to the broker's socket, plus a client that never reads.
+//	Every reading client has to receive the whole stream (byte count and hash), and the stalled one has to be dropped
+//	without slowing down the others. The broker's process (reader, parser and broker threads) CPU usage is reported.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <termios.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <ttyPipeline.h>
+#include <broker.h>
+#include "testUtils.h"
+
+#define TEST_SOCKET     "/tmp/broker_test.sock"
+#define TEST_CLIENTS    32
+#define TEST_BPS        600000    // ~6 Mbaud
+#define TEST_SECONDS    3
+#define TEST_DRAINMS    2000      // Max time to receive the stream's tail
+
+
+static int              master, slave;
+static _Atomic bool     sending = false;
+static uint64_t         sent    = 0;      // Bytes accepted by the pty
+static uint64_t         hash    = 0;      // Hash of the accepted bytes
+
+
+static uint64_t fnv (uint64_t h, const char *data, size_t size) {
+	// FNV-1a
+	for (size_t t = 0; t < size; t++) h = (h ^ (uint8_t)data[t]) * 0x100000001b3ULL;
+	return(h);
+}
+
+
+static void* sender (void *arg) {
+	//
+	// Description:
+	//	It sends TEST_BPS bytes per second for TEST_SECONDS seconds. The refused bytes are not counted (the pty's
+	//	buffer is drained by the broker's reader thread)
+	//
+	char     line[128];
+	uint64_t start = nowUs(), now, tried = 0;
+	uint32_t n = 0;
+
+	hash = 0xcbf29ce484222325ULL;
+	while ((now = nowUs()) - start < TEST_SECONDS * 1000000ULL) {
+		while (tried < (now - start) * TEST_BPS / 1000000) {
+			int     size = sprintf(line, "I (%llu) MAIN: seq %u the quick brown fox jumps over the lazy dog\n", (unsigned long long)now / 1000, n++);
+			ssize_t nb   = write(master, line, size);
+
+			if (nb > 0) {
+				hash  = fnv(hash, line, nb);
+				sent += nb;
+			}
+			tried += size;
+		}
+		usleep(1000);
+	}
+	sending = false;
+
+	return(NULL);
+}
+
+
+static int clients (int syncFd) {
+	//
+	// Description:
+	//	Child process: feeder and clients. It returns the number of failed checks.
+	//	The broker is started by the parent process, that writes a byte on syncFd when its socket is ready.
+	//
+	int           fds[TEST_CLIENTS], slow, fails = 0;
+	uint64_t      rx[TEST_CLIENTS], rxHash[TEST_CLIENTS];
+	struct pollfd pfds[TEST_CLIENTS];
+	char          buff[65536];
+	pthread_t     th;
+	uint64_t      deadline = 0, start;
+	bool          done = false, whole = true, eof = false;
+	ssize_t       nb;
+
+	if (read(syncFd, buff, 1) != 1) fails++;
+	for (int t = 0; t < TEST_CLIENTS; t++) {
+		broker_connect(TEST_SOCKET, &fds[t]);
+		rx[t]     = 0;
+		rxHash[t] = 0xcbf29ce484222325ULL;
+		pfds[t]   = (struct pollfd){ fds[t], POLLIN, 0 };
+	}
+	broker_connect(TEST_SOCKET, &slow);
+	CHECK(slow >= 0 && fds[TEST_CLIENTS - 1] >= 0, "clients connection");
+	// The broker has to accept them before the first byte
+	usleep(200000);
+
+	sending = true;
+	pthread_create(&th, NULL, sender, NULL);
+	start = nowUs();
+	while (done == false) {
+		poll(pfds, TEST_CLIENTS, 10);
+		for (int t = 0; t < TEST_CLIENTS; t++) {
+			while ((nb = read(fds[t], buff, sizeof(buff))) > 0) {
+				rxHash[t] = fnv(rxHash[t], buff, nb);
+				rx[t]    += nb;
+			}
+		}
+		if (sending == false) {
+			if (deadline == 0) deadline = nowUs() + TEST_DRAINMS * 1000;
+			done = true;
+			for (int t = 0; t < TEST_CLIENTS; t++) done = done && (rx[t] == sent);
+			if (nowUs() > deadline) done = true;
+		}
+	}
+	pthread_join(th, NULL);
+	printf("       %d clients: %.1f KB/s each, %llu bytes sent\n", TEST_CLIENTS, sent / 1024.0 / ((nowUs() - start) / 1e6), (unsigned long long)sent);
+
+	for (int t = 0; t < TEST_CLIENTS; t++) whole = whole && rx[t] == sent && rxHash[t] == hash;
+	CHECK(whole, "every client has received the whole stream, in order");
+
+	// The stalled client finds the end of the stream after its buffered data
+	fcntl(slow, F_SETFL, 0);
+	while ((nb = read(slow, buff, sizeof(buff))) > 0);
+	eof = (nb == 0);
+	CHECK(eof, "the stalled client has been dropped");
+
+	for (int t = 0; t < TEST_CLIENTS; t++) close(fds[t]);
+	close(slow);
+
+	return(fails);
+}
+
+
+int main () {
+	int            notifyFD, fails = 0, status = 0, sync[2];
+	struct termios tio;
+	struct rusage  ru0, ru1;
+	brokerStats_t  bstats;
+	pipeStats_t    stats;
+	uint64_t       start;
+	double         elapsed, cpu;
+	pid_t          pid;
+
+	master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 || (slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0) {
+		// ERROR!
+		perror("ERROR! pty pair creation failed");
+		return(1);
+	}
+	tcgetattr(slave, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(slave, TCSANOW, &tio);
+
+	// The child is created before the threads
+	fflush(stdout);
+	pipe(sync);
+	if ((pid = fork()) == 0) {
+		close(slave);
+		fails = clients(sync[0]);
+		fflush(stdout);
+		_exit(fails);
+	}
+	// The master side is kept open until the pipeline stops: the child's exit must not hang up the slave
+
+	notifyFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	CHECK(broker_start(TEST_SOCKET) == WERRCODE_SUCCESS, "broker_start()");
+	CHECK(ttyPipeline_start(slave, notifyFD) == WERRCODE_SUCCESS, "ttyPipeline_start()");
+	fflush(stdout);
+	write(sync[1], "s", 1);
+
+	getrusage(RUSAGE_SELF, &ru0);
+	start = nowUs();
+	waitpid(pid, &status, 0);
+	elapsed = (nowUs() - start) / 1e6;
+	getrusage(RUSAGE_SELF, &ru1);
+	broker_stats(&bstats);
+	ttyPipeline_stats(&stats);
+
+	cpu = (ru1.ru_utime.tv_sec - ru0.ru_utime.tv_sec) + (ru1.ru_utime.tv_usec - ru0.ru_utime.tv_usec) / 1e6 +
+	      (ru1.ru_stime.tv_sec - ru0.ru_stime.tv_sec) + (ru1.ru_stime.tv_usec - ru0.ru_stime.tv_usec) / 1e6;
+	printf("       broker process: %.1f%% CPU (broker thread %.1f%%), %llu bytes fanned out\n", 100.0 * cpu / elapsed,
+	       100.0 * bstats.cpuUs / 1e6 / elapsed, (unsigned long long)bstats.sent);
+
+	fails += (WIFEXITED(status)) ? WEXITSTATUS(status) : 1;
+	CHECK(ttyPipeline_error() == WERRCODE_SUCCESS, "no pipeline errors");
+	CHECK(bstats.accepted == TEST_CLIENTS + 1 && bstats.dropped == 1, "only the stalled client has been dropped");
+	CHECK(bstats.published == stats.rxBytes, "every received byte has been published");
+
+	ttyPipeline_stop();
+	broker_stop();
+	CHECK(access(TEST_SOCKET, F_OK) != 0, "socket removal");
+	close(notifyFD);
+	close(master);
+	close(slave);
+
+	return(fails);
+}
@@ -0,0 +1,259 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: capture2vcd_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	capture2vcd round trip: a synthetic capture (pin rows split among the records, repeated values, log messages, a
+//	12 bits pin) is converted by ../capture2vcd, and the VCD file's declarations, value changes and times are compared
+//	with the generated ones. A capture with a symbols map announcement must be declared by the announced symbols.
+//	Then a TEST_BIGSIZE bytes capture is converted to measure the throughput and the memory
+//	usage (it must not depend on the capture's size).
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <pinToSymbol.h>
+#include <captureFile.h>
+#include <ptsMap.h>
+#include <ptsCache.h>
+#include "testUtils.h"
+
+#define TEST_TOOLDIR    ".."
+#define TEST_TOOL       "./capture2vcd"
+#define TEST_FILE       "/tmp/capture2vcd_test.cap"
+#define TEST_VCD        "/tmp/capture2vcd_test.vcd"
+#define TEST_ROWS       200000
+#define TEST_PINS       4
+#define TEST_WIDEPIN    3          // Index of the 12 bits pin
+#define TEST_BIGSIZE    (256 * 1024 * 1024)
+#define TEST_CACHEHOME  "/tmp/capture2vcd_test"
+#define TEST_SYMBOL     "o_ANNOUNCED"      // Announced symbol of the labels[0] pin
+
+
+static const char *labels[TEST_PINS] = { "GPIO_NUM_11", "GPIO_NUM_4", "GPIO_NUM_9", "GPIO_NUM_20" };
+
+
+static int converting (const char *capture, const char *vcd, long *maxRss) {
+	// It runs the converter, and it returns its exit code (its max RSS in KB too)
+	struct rusage ru;
+	int           status = -1;
+	pid_t         pid = fork();
+
+	if (pid == 0) {
+		// The tool is run from its directory
+		if (freopen("/dev/null", "w", stderr) == NULL || chdir(TEST_TOOLDIR) < 0) _exit(126);
+		execl(TEST_TOOL, TEST_TOOL, capture, vcd, NULL);
+		_exit(127);
+	} else if (pid > 0 && wait4(pid, &status, 0, &ru) == pid) {
+		*maxRss = ru.ru_maxrss;
+		status  = WEXITSTATUS(status);
+	}
+	return(status);
+}
+
+
+static bool generating (const char *path, uint64_t size, uint32_t *changes, uint32_t *last, uint32_t *tEnd) {
+	// Synthetic capture: the rows are written in records of random size, so they are split among the records
+	char     buff[256 * 1024], line[64];
+	uint32_t used = 0, tstamp = 0, value[TEST_PINS], row = 0;
+	uint64_t total = 0;
+	bool     known[TEST_PINS] = { false };
+	bool     flag = (captureFile_open(path, 115200, "ESP32") == WERRCODE_SUCCESS);
+
+	memset(value, 0, sizeof(value));
+	while (flag && (size > 0 ? total < size : row < TEST_ROWS)) {
+		uint32_t p = xorshift() % (TEST_PINS + 1), n;
+
+		if (p == TEST_PINS)
+			n = sprintf(line, "I (%u) MAIN: log message number %u\n", tstamp, row);
+		else {
+			uint32_t v = (p == TEST_WIDEPIN) ? xorshift() % 4096 : (xorshift() % 3 == 0) ? value[p] : value[p] ^ 1;
+
+			if (changes != NULL && (known[p] == false || v != value[p])) changes[p]++;
+			known[p] = true;
+			value[p] = v;
+			n = sprintf(line, "%s:%u\n", labels[p], v);
+		}
+		memcpy(buff + used, line, n);
+		used += n;
+		row++;
+
+		// A record every few rows
+		if (used > sizeof(buff) - 64 || xorshift() % 4 == 0) {
+			uint32_t cut = (used > 8) ? used - xorshift() % 8 : used;
+
+			flag    = (captureFile_add(tstamp, buff, cut) == WERRCODE_SUCCESS);
+			memmove(buff, buff + cut, used - cut);
+			total  += cut;
+			used   -= cut;
+			tstamp += xorshift() % 3;
+		}
+	}
+	if (flag && used > 0) flag = (captureFile_add(tstamp, buff, used) == WERRCODE_SUCCESS);
+	if (last != NULL) memcpy(last, value, sizeof(value));
+	if (tEnd != NULL) *tEnd = tstamp;
+
+	return(captureFile_close() == WERRCODE_SUCCESS && flag);
+}
+
+
+static bool mapGenerating (const char *path, char *cacheFile) {
+	// Capture with a symbols map announcement (labels[0] is renamed), followed by the pins' rows
+	ptsDbItem_t db[PTS_MAXPINID];
+	uint8_t     map[PTSMAP_MAXSIZE];
+	uint32_t    size;
+	char        row[PTSMAP_ROWSIZE + 1];
+	pinId_t     pin;
+	bool        flag = (captureFile_open(path, 115200, "ESP32") == WERRCODE_SUCCESS);
+
+	memset(db, 0, sizeof(db));
+	pinId_fromLabel(labels[0], &pin);
+	strcpy(db[pin].symbol, TEST_SYMBOL);
+	size = ptsMap_encode(map, sizeof(map), db, PTS_MAXPINID);
+	sprintf(cacheFile, TEST_CACHEHOME "/" PTSCACHE_DIRNAME "/%08x.ptsmap", (unsigned)ptsMap_hash(map + 8, size - 8));
+	unlink(cacheFile);
+
+	for (uint16_t t = 0; t < ptsMap_rows(size) && flag; t++) {
+		ptsMap_row(row, map, size, t);
+		strcat(row, "\n");
+		flag = (captureFile_add(0, row, strlen(row)) == WERRCODE_SUCCESS);
+	}
+	for (uint8_t p = 0; p < TEST_PINS && flag; p++) {
+		sprintf(row, "%s:1\n", labels[p]);
+		flag = (captureFile_add(10 + p, row, strlen(row)) == WERRCODE_SUCCESS);
+	}
+
+	return(captureFile_close() == WERRCODE_SUCCESS && flag);
+}
+
+
+int main () {
+	uint32_t   changes[TEST_PINS] = { 0 }, last[TEST_PINS], tEnd;
+	uint32_t   found[TEST_PINS] = { 0 }, value[TEST_PINS] = { 0 };
+	char       ids[TEST_PINS][8], line[256], name[64], id[8], type[8], msg[128], cacheFile[256];
+	bool       names = true, types = true, monotonic = true, counts = true, values = true, body = false, announced = false;
+	int64_t    time = -1;
+	int        width, fails = 0;
+	long       rss;
+	double     start, secs;
+	FILE       *fd;
+	const char *symbol;
+
+	if (access(TEST_TOOLDIR "/" TEST_TOOL, X_OK) != 0) {
+		printf("[SKIP] %s/%s not found (build the tools first)\n", TEST_TOOLDIR, TEST_TOOL);
+		return(0);
+	}
+	memset(ids, 0, sizeof(ids));
+
+	// Round trip
+	CHECK(generating(TEST_FILE, 0, changes, last, &tEnd), "synthetic capture writing");
+	CHECK(converting(TEST_FILE, TEST_VCD, &rss) == 0, "conversion");
+
+	if ((fd = fopen(TEST_VCD, "r")) != NULL) {
+		while (fgets(line, sizeof(line), fd) != NULL) {
+			if (sscanf(line, "$var %7s %d %7s %63s $end", type, &width, id, name) == 4) {
+				// Declaration: symbol (or label) and width
+				for (uint8_t p = 0; p < TEST_PINS; p++) {
+					pinId_t pin;
+
+					pinId_fromLabel(labels[p], &pin);
+					if (pinToSymbol_getById(&symbol, pin) != WERRCODE_SUCCESS) symbol = labels[p];
+					if (strcmp(name, symbol) == 0) {
+						strcpy(ids[p], id);
+						types &= (p == TEST_WIDEPIN) ? (width == 32 && strcmp(type, "reg") == 0) : (width == 1 && strcmp(type, "wire") == 0);
+					}
+				}
+			} else if (strncmp(line, "$dumpvars", 9) == 0) {
+				body = true;
+
+			} else if (body && line[0] == '#') {
+				int64_t t = strtoll(line + 1, NULL, 10);
+
+				monotonic &= (t > time);
+				time       = t;
+
+			} else if (body && (line[0] == '0' || line[0] == '1' || (line[0] == 'b' && line[1] != 'x'))) {
+				uint32_t v = (line[0] == 'b') ? strtoul(line + 1, NULL, 2) : (uint32_t)(line[0] - '0');
+				char     *ptr = (line[0] == 'b') ? strchr(line, ' ') + 1 : line + 1;
+
+				ptr[strcspn(ptr, "\n")] = '\0';
+				for (uint8_t p = 0; p < TEST_PINS; p++) {
+					if (strcmp(ptr, ids[p]) == 0) {
+						found[p]++;
+						value[p] = v;
+					}
+				}
+			}
+		}
+		fclose(fd);
+	}
+
+	for (uint8_t p = 0; p < TEST_PINS; p++) {
+		names  &= (ids[p][0] != '\0');
+		counts &= (found[p] == changes[p]);
+		values &= (value[p] == last[p]);
+	}
+	CHECK(names, "every pin is declared by its symbol (or label)");
+	CHECK(types, "1 bit wires and 32 bits registers");
+	CHECK(monotonic && time <= tEnd, "increasing times");
+	sprintf(msg, "value changes count (%u/%u %u/%u %u/%u %u/%u)", found[0], changes[0], found[1], changes[1], found[2], changes[2], found[3], changes[3]);
+	CHECK(counts, msg);
+	CHECK(values, "last values");
+
+	// Symbols map announcement
+	setenv("XDG_CACHE_HOME", TEST_CACHEHOME, 1);
+	CHECK(mapGenerating(TEST_FILE, cacheFile), "announced map's capture writing");
+	CHECK(converting(TEST_FILE, TEST_VCD, &rss) == 0, "announced map's capture conversion");
+	if ((fd = fopen(TEST_VCD, "r")) != NULL) {
+		while (fgets(line, sizeof(line), fd) != NULL)
+			if (sscanf(line, "$var %7s %d %7s %63s $end", type, &width, id, name) == 4) announced |= (strcmp(name, TEST_SYMBOL) == 0);
+		fclose(fd);
+	}
+	CHECK(announced, "pin declared by the announced symbol");
+	unlink(cacheFile);
+	rmdir(TEST_CACHEHOME "/" PTSCACHE_DIRNAME);
+	rmdir(TEST_CACHEHOME);
+
+	// Throughput and memory usage
+	CHECK(generating(TEST_FILE, TEST_BIGSIZE, NULL, NULL, NULL), "big capture writing");
+	start = now();
+	CHECK(converting(TEST_FILE, "/dev/null", &rss) == 0, "big capture conversion");
+	secs  = now() - start;
+	sprintf(msg, "%u MB converted in %.2f s (%.0f MB/s), max RSS %.1f MB", TEST_BIGSIZE >> 20, secs, (TEST_BIGSIZE >> 20) / secs, rss / 1024.0);
+	CHECK(rss * 1024L < TEST_BIGSIZE / 4, msg);
+
+	unlink(TEST_FILE);
+	unlink(TEST_VCD);
+
+	return(fails);
+}
@@ -0,0 +1,150 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: captureFile_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	captureFile module's test. It records a known sequence of chunks (one of them bigger than the records buffer), it
+//	decodes the file again and it checks the header, every record, the sparse time index and the footer. Finally it
+//	measures the recording throughput.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <captureFile.h>
+#include "testUtils.h"
+
+#define TEST_FILE       "/tmp/captureFile_test.cap"
+#define TEST_RECORDS    200
+#define TEST_STEPMS     37                     // Time distance between two records
+#define TEST_BIGREC     100                    // Index of the record bigger than CAPT_BUFFSIZE
+#define TEST_BIGSIZE    (CAPT_BUFFSIZE + 4000)
+#define TEST_BENCHMB    256
+
+
+static uint32_t recSize (uint32_t rec) {
+	return((rec == TEST_BIGREC) ? TEST_BIGSIZE : 1 + (rec * 97) % 4096);
+}
+
+
+static uint32_t varintGet (const uint8_t **ptr) {
+	uint32_t value = 0;
+	uint8_t  shift = 0;
+
+	do {
+		value |= (uint32_t)(**ptr & 0x7F) << shift;
+		shift += 7;
+	} while (*(*ptr)++ & 0x80);
+
+	return(value);
+}
+
+
+int main () {
+	static char    data[TEST_BIGSIZE];
+	int            fails = 0;
+	FILE           *fh;
+	long           fsize;
+	uint8_t        *file;
+	const uint8_t  *ptr;
+	captHeader_t   *hdr;
+	captFooter_t   *ftr;
+	captIndex_t    *idx;
+	uint32_t       tstamp = 0, rec = 0;
+	uint64_t       offsets[TEST_RECORDS];
+	bool           flag = true;
+	struct timespec t0, t1;
+
+	CHECK(captureFile_add(0, "x", 1) == WERRCODE_SUCCESS && captureFile_isOpen() == false, "no recording without a capture file");
+	CHECK(captureFile_open(TEST_FILE, 115200, "ESP32") == WERRCODE_SUCCESS, "captureFile_open()");
+
+	for (rec = 0; rec < TEST_RECORDS && flag; rec++) {
+		for (uint32_t t = 0; t < recSize(rec); t++) data[t] = rec + t;
+		flag = (captureFile_add(rec * TEST_STEPMS, data, recSize(rec)) == WERRCODE_SUCCESS);
+	}
+	CHECK(flag, "captureFile_add()");
+	CHECK(captureFile_close() == WERRCODE_SUCCESS, "captureFile_close()");
+
+	// File loading
+	fh = fopen(TEST_FILE, "r");
+	fseek(fh, 0, SEEK_END);
+	fsize = ftell(fh);
+	rewind(fh);
+	file = malloc(fsize);
+	if (fread(file, 1, fsize, fh) != (size_t)fsize) fails++;
+	fclose(fh);
+
+	hdr = (captHeader_t*)file;
+	CHECK(
+		strcmp(hdr->magic, CAPT_MAGIC) == 0 && hdr->version == CAPT_VERSION && hdr->hdrSize == sizeof(captHeader_t) &&
+		hdr->ttySpeed == 115200 && strcmp(hdr->target, "ESP32") == 0,
+		"header"
+	);
+
+	ftr = (captFooter_t*)(file + fsize - sizeof(captFooter_t));
+	CHECK(strcmp(ftr->magic, CAPT_IDXMAGIC) == 0 && ftr->records == TEST_RECORDS, "footer");
+	CHECK(ftr->offset + ftr->entries * sizeof(captIndex_t) + sizeof(captFooter_t) == (uint64_t)fsize, "index position");
+
+	// Records decoding
+	flag = true;
+	ptr  = file + hdr->hdrSize;
+	for (rec = 0; rec < TEST_RECORDS && flag; rec++) {
+		uint32_t size;
+
+		offsets[rec] = ptr - file;
+		tstamp += varintGet(&ptr);
+		size    = varintGet(&ptr);
+		flag    = (tstamp == rec * TEST_STEPMS && size == recSize(rec));
+		for (uint32_t t = 0; t < size && flag; t++) flag = (ptr[t] == (uint8_t)(rec + t));
+		ptr += size;
+	}
+	CHECK(flag && (uint64_t)(ptr - file) == ftr->offset, "every record (time-stamp, size, data)");
+
+	// Sparse time index
+	idx  = (captIndex_t*)(file + ftr->offset);
+	flag = (ftr->entries == (TEST_RECORDS - 1) * TEST_STEPMS / CAPT_INDEXMS + 1);
+	for (uint32_t t = 0; t < ftr->entries && flag; t++) {
+		flag = (idx[t].records < TEST_RECORDS && idx[t].offset == offsets[idx[t].records] && idx[t].tstamp == idx[t].records * TEST_STEPMS);
+		if (t > 0)
+			flag = flag && (idx[t].tstamp - idx[t - 1].tstamp) >= CAPT_INDEXMS && (idx[t].tstamp - idx[t - 1].tstamp) < CAPT_INDEXMS + TEST_STEPMS;
+	}
+	CHECK(flag, "sparse time index");
+	free(file);
+
+	// Throughput
+	captureFile_open(TEST_FILE, 115200, "ESP32");
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (rec = 0; rec < TEST_BENCHMB * 256; rec++) captureFile_add(rec / 1000, data, 4096);
+	captureFile_close();
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	printf("       recording: %.0f MB/s (4 KB chunks)\n", TEST_BENCHMB / ((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9));
+
+	unlink(TEST_FILE);
+	return((fails == 0) ? 0 : 1);
+}
@@ -0,0 +1,158 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: capturePlayer_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	capturePlayer module's test. It records a capture file (TEST_RECORDS records, one every TEST_STEPMS ms), then it
+//	checks the sequential playback, the seek (random time-stamps, compared with a linear search) and the opening of an
+//	incomplete capture file (killed recording: no footer and a truncated last record) and of a corrupted one (an index
+//	entry out of the records, a wrong header size). It reports the opening and the average seek times.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <captureFile.h>
+#include <capturePlayer.h>
+#include "testUtils.h"
+
+#define TEST_FILE       "/tmp/capturePlayer_test.cap"
+#define TEST_CUTFILE    "/tmp/capturePlayer_test_cut.cap"
+#define TEST_RECORDS    200000
+#define TEST_STEPMS     3
+#define TEST_SEEKS      10000
+
+
+static uint32_t recSize (uint32_t rec) {
+	return(1 + (rec * 31) % 200);
+}
+
+
+static bool recordCheck (uint32_t rec, uint32_t tstamp, const uint8_t *data, uint32_t size) {
+	bool flag = (tstamp == rec * TEST_STEPMS && size == recSize(rec));
+
+	for (uint32_t t = 0; t < size && flag; t++) flag = (data[t] == (uint8_t)(rec + t));
+
+	return(flag);
+}
+
+
+int main () {
+	char          data[256];
+	int           fails = 0;
+	captHeader_t  hdr;
+	uint32_t      tstamp, size, rec;
+	const uint8_t *ptr;
+	bool          flag = true;
+	uint64_t      t0, openUs, seekUs = 0;
+	FILE          *fi, *fo;
+	long          cut;
+
+	// Capture file creation
+	captureFile_open(TEST_FILE, 921600, "AVR8");
+	for (rec = 0; rec < TEST_RECORDS; rec++) {
+		for (uint32_t t = 0; t < recSize(rec); t++) data[t] = rec + t;
+		captureFile_add(rec * TEST_STEPMS, data, recSize(rec));
+	}
+	captureFile_close();
+
+	t0 = nowUs();
+	CHECK(capturePlayer_open(TEST_FILE, &hdr) == WERRCODE_SUCCESS, "capturePlayer_open()");
+	openUs = nowUs() - t0;
+	CHECK(hdr.ttySpeed == 921600 && strcmp(hdr.target, "AVR8") == 0, "header");
+	CHECK(capturePlayer_duration() == (TEST_RECORDS - 1) * TEST_STEPMS, "duration");
+
+	// Sequential playback
+	for (rec = 0; flag && capturePlayer_next(&tstamp, &ptr, &size) == WERRCODE_SUCCESS; rec++)
+		flag = recordCheck(rec, tstamp, ptr, size);
+	CHECK(flag && rec == TEST_RECORDS, "sequential playback");
+
+	// Seek
+	srand(1);
+	for (uint32_t t = 0; t < TEST_SEEKS && flag; t++) {
+		uint32_t target = rand() % (TEST_RECORDS * TEST_STEPMS);
+
+		t0 = nowUs();
+		capturePlayer_seek(target);
+		seekUs += nowUs() - t0;
+
+		rec  = (target + TEST_STEPMS - 1) / TEST_STEPMS;
+		flag = (capturePlayer_next(&tstamp, &ptr, &size) == WERRCODE_SUCCESS && recordCheck(rec, tstamp, ptr, size));
+		if (flag && rec + 1 < TEST_RECORDS)
+			flag = (capturePlayer_next(&tstamp, &ptr, &size) == WERRCODE_SUCCESS && recordCheck(rec + 1, tstamp, ptr, size));
+	}
+	CHECK(flag, "seek (first record at or after the requested time)");
+	CHECK(capturePlayer_seek(TEST_RECORDS * TEST_STEPMS) == WERRCODE_WARNING_ITNOTFOUND, "seek after the end");
+	printf("       open: %llu us, seek: %.2f us on average\n", (unsigned long long)openUs, (double)seekUs / TEST_SEEKS);
+	capturePlayer_close();
+
+	// Killed recording: the footer, the index and a part of the last record are missing
+	fi = fopen(TEST_FILE, "r");
+	fo = fopen(TEST_CUTFILE, "w");
+	fseek(fi, 0, SEEK_END);
+	cut = ftell(fi) - sizeof(captFooter_t) - sizeof(captIndex_t) * ((TEST_RECORDS - 1) * TEST_STEPMS / CAPT_INDEXMS + 1) - 2;
+	rewind(fi);
+	for (long t = 0; t < cut; t++) fputc(fgetc(fi), fo);
+	fclose(fi);
+	fclose(fo);
+
+	flag = (capturePlayer_open(TEST_CUTFILE, &hdr) == WERRCODE_SUCCESS);
+	for (rec = 0; flag && capturePlayer_next(&tstamp, &ptr, &size) == WERRCODE_SUCCESS; rec++)
+		flag = recordCheck(rec, tstamp, ptr, size);
+	CHECK(flag && rec == TEST_RECORDS - 1, "incomplete capture file (index rebuilt)");
+	flag = (capturePlayer_seek(TEST_STEPMS * 1000) == WERRCODE_SUCCESS && capturePlayer_next(&tstamp, &ptr, &size) == WERRCODE_SUCCESS);
+	CHECK(flag && recordCheck(1000, tstamp, ptr, size), "incomplete capture file seek");
+	capturePlayer_close();
+
+	// Corrupted index: the last entry's offset is out of the records
+	fi = fopen(TEST_FILE, "r+");
+	fseek(fi, -(long)(sizeof(captFooter_t) + sizeof(captIndex_t) - offsetof(captIndex_t, offset)), SEEK_END);
+	fwrite(&(uint64_t){ UINT64_MAX / 2 }, sizeof(uint64_t), 1, fi);
+	fclose(fi);
+
+	flag = (capturePlayer_open(TEST_FILE, &hdr) == WERRCODE_SUCCESS);
+	for (rec = 0; flag && capturePlayer_next(&tstamp, &ptr, &size) == WERRCODE_SUCCESS; rec++)
+		flag = recordCheck(rec, tstamp, ptr, size);
+	CHECK(flag && rec == TEST_RECORDS, "corrupted index (index rebuilt)");
+	flag = (capturePlayer_seek((TEST_RECORDS - 1) * TEST_STEPMS) == WERRCODE_SUCCESS && capturePlayer_next(&tstamp, &ptr, &size) == WERRCODE_SUCCESS);
+	CHECK(flag && recordCheck(TEST_RECORDS - 1, tstamp, ptr, size), "corrupted index seek");
+	capturePlayer_close();
+
+	// Corrupted header: its size is smaller than the header's structure
+	fi = fopen(TEST_FILE, "r+");
+	fseek(fi, offsetof(captHeader_t, hdrSize), SEEK_SET);
+	fwrite(&(uint16_t){ 4 }, sizeof(uint16_t), 1, fi);
+	fclose(fi);
+	CHECK(capturePlayer_open(TEST_FILE, &hdr) == WERRCODE_ERROR_INVALIDDATA, "wrong header size");
+
+	unlink(TEST_FILE);
+	unlink(TEST_CUTFILE);
+	return((fails == 0) ? 0 : 1);
+}
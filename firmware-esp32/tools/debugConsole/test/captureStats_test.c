@@ -0,0 +1,301 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: captureStats_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	captureStats check: a synthetic capture (a clean switch, a bouncing switch, log messages, rows split among the
+//	records, the symbols map announced twice) is analysed by ../captureStats with one thread and with several ones. The toggles, the pulses' min/max
+//	widths, the bounces and the templates' counts are compared with the generated ones, and the two reports must be
+//	the same (the partial results' merge must not change anything). The pins must be reported by the announced
+//	symbols, and the map's rows must not be counted as log messages.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <captureFile.h>
+#include <ptsMap.h>
+#include <ptsCache.h>
+#include "testUtils.h"
+
+#define TEST_TOOLDIR    ".."
+#define TEST_TOOL       "./captureStats"
+#define TEST_FILE       "/tmp/captureStats_test.cap"
+#define TEST_REPORT1    "/tmp/captureStats_test.1.txt"
+#define TEST_REPORTN    "/tmp/captureStats_test.N.txt"
+#define TEST_CACHEHOME  "/tmp/captureStats_test"
+#define TEST_DURATION   (1800 * 1000)      // Capture's length (ms)
+#define TEST_BOUNCEMS   "20"
+#define TEST_PINS       2                  // Clean and bouncing switches
+
+
+static const char *labels[TEST_PINS]  = { "GPIO_NUM_4", "GPIO_NUM_9" };
+static const char *symbols[TEST_PINS] = { "i_CLEANSWITCH", "i_BOUNCINGSWITCH" };    // Announced by the capture
+static ptsDbItem_t db[PTS_MAXPINID];
+static uint8_t    map[PTSMAP_MAXSIZE];
+static uint32_t   mapSize;
+
+// Expected statistics
+typedef struct {
+	uint32_t level;
+	uint32_t toggles;
+	int64_t  lastChange;
+	uint32_t min, max;
+	uint32_t shorts, bursts;
+	bool     inBurst;
+} expect_t;
+
+
+static bool rowWriting (uint32_t tstamp, const char *line) {
+	// A row out of three is split in two records (same time-stamp)
+	uint32_t len = strlen(line), cut = (xorshift() % 3 == 0) ? 1 + xorshift() % (len - 1) : len;
+	bool     flag = (captureFile_add(tstamp, line, cut) == WERRCODE_SUCCESS);
+
+	if (flag && cut < len) flag = (captureFile_add(tstamp, line + cut, len - cut) == WERRCODE_SUCCESS);
+	return(flag);
+}
+
+
+static bool mapWriting (uint32_t tstamp) {
+	// The symbols map announcement (a row per record, as the firmware sends them)
+	char     row[PTSMAP_ROWSIZE + 1];
+	bool     flag = true;
+
+	for (uint16_t t = 0; t < ptsMap_rows(mapSize) && flag; t++) {
+		ptsMap_row(row, map, mapSize, t);
+		strcat(row, "\n");
+		flag = (captureFile_add(tstamp, row, strlen(row)) == WERRCODE_SUCCESS);
+	}
+	return(flag);
+}
+
+
+static void expecting (expect_t *e, uint32_t tstamp, uint32_t level) {
+	// It updates the expected statistics (a pulse is the time between two transitions)
+	if (level == e->level) return;
+	if (e->lastChange >= 0) {
+		uint32_t w = tstamp - e->lastChange;
+
+		if (w < e->min) e->min = w;
+		if (w > e->max) e->max = w;
+		if (w < atoi(TEST_BOUNCEMS)) {
+			e->shorts++;
+			if (e->inBurst == false) e->bursts++;
+			e->inBurst = true;
+		} else
+			e->inBurst = false;
+	}
+	e->lastChange = tstamp;
+	e->level      = level;
+	e->toggles++;
+	return;
+}
+
+
+static bool generating (expect_t *exp, uint32_t *logs) {
+	// Pins' events (the bouncing switch adds a burst of short pulses to some transitions) and log messages
+	char     line[128];
+	uint32_t next[TEST_PINS] = { 0, 0 }, nextLog = 0, t = 0;
+	uint32_t bounce = 0, pending = 0;                       // Bouncing switch: pending short pulses
+	bool     flag = (captureFile_open(TEST_FILE, 115200, "ESP32") == WERRCODE_SUCCESS);
+
+	for (uint8_t p = 0; p < TEST_PINS; p++) {
+		memset(&exp[p], 0, sizeof(expect_t));
+		exp[p].lastChange = -1;
+		exp[p].min        = UINT32_MAX;
+	}
+	*logs = 0;
+
+	while (flag && t < TEST_DURATION) {
+		// The map is announced at the beginning, and again after a firmware's reboot
+		if (t == 0 || t == TEST_DURATION / 2) flag = mapWriting(t);
+
+		for (uint8_t p = 0; p < TEST_PINS && flag; p++) {
+			if (t == next[p]) {
+				uint32_t level = exp[p].level ^ 1;
+
+				if (t == 0) level = 0;
+				expecting(&exp[p], t, level);
+				exp[p].level = level;
+				sprintf(line, "%s:%u\n", labels[p], level);
+				flag = rowWriting(t, line);
+
+				if (p == 1 && pending > 0) {
+					next[p] = t + 1 + xorshift() % (atoi(TEST_BOUNCEMS) - 1);
+					pending--;
+				} else {
+					next[p] = t + 50 + xorshift() % 950;
+					if (p == 1 && xorshift() % 4 == 0) {
+						// Bounce burst: an odd number of short pulses, so the level changes
+						pending = 1 + 2 * (xorshift() % 3);
+						bounce++;
+					}
+				}
+			}
+		}
+		if (flag && t == nextLog) {
+			if (xorshift() % 2)
+				sprintf(line, "I (%u) MAIN: battery %u mV\n", t, 11000 + xorshift() % 3000);
+			else
+				sprintf(line, "W (%u) RPM: register 0x%x\n", t, xorshift());
+			flag     = rowWriting(t, line);
+			nextLog += 1 + xorshift() % 200;
+			(*logs)++;
+		}
+		t++;
+	}
+
+	return(captureFile_close() == WERRCODE_SUCCESS && flag);
+}
+
+
+static int analysing (const char *threads, const char *report) {
+	// It runs the analyser, and it returns its exit code (the report is written in the argument defined file)
+	int   status = -1;
+	pid_t pid;
+
+	fflush(stdout);
+	if ((pid = fork()) == 0) {
+		// The tool is run from its directory
+		if (freopen(report, "w", stdout) == NULL || freopen("/dev/null", "w", stderr) == NULL || chdir(TEST_TOOLDIR) < 0) _exit(126);
+		execl(TEST_TOOL, TEST_TOOL, "-j", threads, "-b", TEST_BOUNCEMS, TEST_FILE, NULL);
+		_exit(127);
+	} else if (pid > 0 && waitpid(pid, &status, 0) == pid) {
+		status = WEXITSTATUS(status);
+	}
+	return(status);
+}
+
+
+static bool reportsComparing (const char *a, const char *b) {
+	// The reports must be equal (but the throughput's row)
+	FILE *fa = fopen(a, "r"), *fb = fopen(b, "r");
+	char la[512], lb[512];
+	bool flag = (fa != NULL && fb != NULL);
+
+	while (flag) {
+		char *ra = fgets(la, sizeof(la), fa), *rb = fgets(lb, sizeof(lb), fb);
+
+		if (ra == NULL || rb == NULL) {
+			flag = (ra == rb);
+			break;
+		}
+		if (strstr(la, "MB/s") == NULL) flag = (strcmp(la, lb) == 0);
+	}
+	if (fa != NULL) fclose(fa);
+	if (fb != NULL) fclose(fb);
+	return(flag);
+}
+
+
+int main () {
+	expect_t exp[TEST_PINS];
+	uint32_t logs, count, v1, v2, tmplCount = 0, pin = TEST_PINS;
+	char     line[512], lev[8], msg[256], *ptr;
+	bool     found[TEST_PINS] = { false }, named[TEST_PINS] = { false }, toggles = true, widths = true, bounces = true;
+	bool     burstsFound = false, mapRows = false;
+	int      fails = 0;
+	FILE     *fd;
+
+	if (access(TEST_TOOLDIR "/" TEST_TOOL, X_OK) != 0) {
+		printf("[SKIP] %s/%s not found (build the tools first)\n", TEST_TOOLDIR, TEST_TOOL);
+		return(0);
+	}
+
+	// Announced map: the pins' symbols are not the ones of the local checkout
+	memset(db, 0, sizeof(db));
+	for (uint8_t p = 0; p < TEST_PINS; p++) {
+		pinId_t pin;
+
+		pinId_fromLabel(labels[p], &pin);
+		strcpy(db[pin].symbol, symbols[p]);
+	}
+	mapSize = ptsMap_encode(map, sizeof(map), db, PTS_MAXPINID);
+	setenv("XDG_CACHE_HOME", TEST_CACHEHOME, 1);
+	sprintf(line, TEST_CACHEHOME "/" PTSCACHE_DIRNAME "/%08x.ptsmap", (unsigned)ptsMap_hash(map + 8, mapSize - 8));
+	unlink(line);
+
+	CHECK(generating(exp, &logs), "synthetic capture writing");
+	CHECK(analysing("1", TEST_REPORT1) == 0, "single thread analysis");
+	CHECK(analysing("16", TEST_REPORTN) == 0, "multi-thread analysis");
+	CHECK(reportsComparing(TEST_REPORT1, TEST_REPORTN), "single and multi-thread reports are the same");
+
+	if ((fd = fopen(TEST_REPORTN, "r")) != NULL) {
+		while (fgets(line, sizeof(line), fd) != NULL) {
+			if (line[0] != '\t') {
+				pin = TEST_PINS;
+				continue;
+			}
+			for (uint8_t p = 0; p < TEST_PINS; p++) {
+				sprintf(msg, "(%s): ", labels[p]);
+				if ((ptr = strstr(line, msg)) != NULL && sscanf(ptr + strlen(msg), "%*u rows, %u toggles", &count) == 1) {
+					pin      = p;
+					found[p] = true;
+					toggles &= (count == exp[p].toggles);
+					sprintf(msg, "\t%s (%s): ", symbols[p], labels[p]);
+					named[p] = (strncmp(line, msg, strlen(msg)) == 0);
+				}
+			}
+			if (pin < TEST_PINS && sscanf(line, " %7s pulses: %u, min %u, %*[^x]x %u", lev, &count, &v1, &v2) == 4) {
+				// Low and high pulses: the min and max widths must belong to the expected range
+				widths &= (v1 >= exp[pin].min && v2 <= exp[pin].max);
+			}
+			if (pin < TEST_PINS && sscanf(line, " [!] bounces: %u pulses in %u bursts", &v1, &v2) == 2) {
+				bounces    &= (v1 == exp[pin].shorts && v2 == exp[pin].bursts);
+				burstsFound = true;
+			}
+
+			if (strstr(line, "MAIN: battery # mV") != NULL || strstr(line, "RPM: register #") != NULL)
+				tmplCount += strtoul(line, NULL, 10);
+			mapRows |= (strstr(line, "PTSMAP") != NULL);
+		}
+		fclose(fd);
+	}
+
+	CHECK(found[0] && found[1], "every pin is reported");
+	CHECK(toggles, "toggles count");
+	CHECK(widths, "pulses' widths range");
+	sprintf(msg, "bounces count (%u pulses in %u bursts)", exp[1].shorts, exp[1].bursts);
+	CHECK(bounces && burstsFound && exp[0].shorts == 0 && exp[1].bursts > 0, msg);
+	sprintf(msg, "log messages by template (%u/%u)", tmplCount, logs);
+	CHECK(tmplCount == logs, msg);
+	CHECK(named[0] && named[1], "pins reported by the announced symbols");
+	CHECK(mapRows == false, "the map's rows are not log messages");
+
+	unlink(TEST_FILE);
+	unlink(TEST_REPORT1);
+	unlink(TEST_REPORTN);
+	sprintf(line, TEST_CACHEHOME "/" PTSCACHE_DIRNAME "/%08x.ptsmap", (unsigned)ptsMap_hash(map + 8, mapSize - 8));
+	unlink(line);
+	rmdir(TEST_CACHEHOME "/" PTSCACHE_DIRNAME);
+	rmdir(TEST_CACHEHOME);
+
+	return(fails);
+}
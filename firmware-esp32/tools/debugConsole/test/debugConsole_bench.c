@@ -0,0 +1,154 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: debugConsole_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Rendering cost of the debugConsole under a synthetic 5000 lines/s feed. The console (../debugConsole or the
+//	argument defined executable) runs on a pseudo-terminal, and it reads a pty pair where this program writes the
+//	log lines (10% of them are pin-state rows). It reports the console's CPU usage, the terminal output rate and the
+//	screen refreshes per second. The console logs its refreshes count by syslog, so they are estimated here as the
+//	feeder's ticks with some terminal output (a tick is shorter than the console's frame period).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <pty.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "testUtils.h"
+
+#define BENCH_CONSOLE   "../debugConsole"
+#define BENCH_SECONDS   5
+#define BENCH_RATE      5000      // Lines per second
+#define BENCH_TICKMS    10
+
+
+static size_t drain (int fd, char *tail, size_t tailSize) {
+	// It reads the console's output, and it keeps its last bytes
+	char    buff[65536];
+	ssize_t nb;
+	size_t  tot = 0;
+
+	while ((nb = read(fd, buff, sizeof(buff))) > 0) {
+		size_t k = ((size_t)nb < tailSize - 1) ? (size_t)nb : tailSize - 1;
+		size_t l = strlen(tail);
+
+		if (l + k >= tailSize) {
+			memmove(tail, tail + (l + k - (tailSize - 1)), tailSize - 1 - k);
+			l = tailSize - 1 - k;
+		}
+		memcpy(tail + l, buff + nb - k, k);
+		tail[l + k] = '\0';
+		tot += nb;
+	}
+	return(tot);
+}
+
+
+int main (int argc, char *argv[]) {
+	const char     *console = (argc > 1) ? argv[1] : BENCH_CONSOLE;
+	struct winsize ws = { 40, 120, 0, 0 };
+	struct rusage  ru;
+	char           tail[4096] = "";
+	char           line[128];
+	size_t         outBytes = 0, nb;
+	uint32_t       lines = 0, dropped = 0, frames = 0;
+	double         start, elapsed, cpu;
+	int            serial, screen, status;
+	pid_t          pid;
+
+	if (access(console, X_OK) != 0) {
+		printf("[SKIP] %s not found (build the console first)\n", console);
+		return(0);
+	}
+
+	// Serial port emulation
+	if ((serial = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(serial) < 0 || unlockpt(serial) < 0) {
+		// ERROR!
+		perror("ERROR! posix_openpt()");
+		return(1);
+	}
+
+	if ((pid = forkpty(&screen, NULL, NULL, &ws)) < 0) {
+		// ERROR!
+		perror("ERROR! forkpty()");
+		return(1);
+
+	} else if (pid == 0) {
+		setenv("TERM", "xterm", 1);
+		execl(console, console, ptsname(serial), NULL);
+		_exit(127);
+	}
+	// Nothing has to block the feeder: the lines the console cannot receive are counted as dropped
+	fcntl(screen, F_SETFL, O_NONBLOCK);
+	fcntl(serial, F_SETFL, O_NONBLOCK);
+	usleep(300000);
+	drain(screen, tail, sizeof(tail));
+
+	// Feeding
+	start = now();
+	while ((elapsed = now() - start) < BENCH_SECONDS) {
+		while (lines < elapsed * BENCH_RATE) {
+			int n = (lines % 10 == 0) ?
+				sprintf(line, "GPIO_NUM_%u:%u\r\n", lines % 40, lines % 2) :
+				sprintf(line, "I (%u) MAIN: synthetic log line number %u\r\n", lines, lines);
+			if (write(serial, line, n) != n) dropped++;
+			lines++;
+		}
+		if ((nb = drain(screen, tail, sizeof(tail))) > 0) frames++;
+		outBytes += nb;
+		usleep(BENCH_TICKMS * 1000);
+	}
+
+	// Console closing
+	kill(pid, SIGTERM);
+	for (uint8_t t=0; t<100 && waitpid(pid, &status, WNOHANG) == 0; t++) {
+		outBytes += drain(screen, tail, sizeof(tail));
+		usleep(20000);
+		if (t == 99) {
+			kill(pid, SIGKILL);
+			waitpid(pid, &status, 0);
+		}
+	}
+	drain(screen, tail, sizeof(tail));
+	getrusage(RUSAGE_CHILDREN, &ru);
+	cpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+
+	printf("feed:     %u lines in %.1f s (%.0f lines/s, %u dropped)\n", lines, elapsed, lines / elapsed, dropped);
+	printf("console:  %5.1f%% CPU   %8.1f KB/s terminal output\n", 100.0 * cpu / elapsed, outBytes / 1024.0 / elapsed);
+	printf("redraws:  %5.1f/s (estimated)\n", frames / elapsed);
+
+	close(screen);
+	close(serial);
+	return(0);
+}
@@ -0,0 +1,159 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: eventLoop_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	eventLoop test on a Linux pty pair: a scripted sender (child process) writes time-stamped lines on the master
+//	side, then it stays idle, then it sends SIGWINCH and SIGTERM to the test process. The test checks that every line
+//	is delivered with low latency, that the loop does not wake up when there is nothing to do, and that the signals
+//	and the timer are handled by the loop.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <eventLoop.h>
+#include "testUtils.h"
+
+#define TEST_LINES      20
+#define TEST_GAPMS      50
+#define TEST_IDLEMS     500
+#define TEST_TIMERMS    100
+#define TEST_MAXLATUS   20000     // Max accepted delivery latency (us)
+
+
+static uint32_t lines = 0, winch = 0, timers = 0;
+static uint64_t maxLat = 0;
+static char     rxBuff[4096];
+static size_t   rxLen = 0;
+
+
+static void rxHandler (int fd, void *arg) {
+	ssize_t nb = read(fd, rxBuff + rxLen, sizeof(rxBuff) - rxLen - 1);
+	char    *eol;
+
+	if (nb > 0) {
+		uint64_t now = nowUs();
+
+		rxLen += nb;
+		rxBuff[rxLen] = '\0';
+		while ((eol = strchr(rxBuff, '\n')) != NULL) {
+			uint64_t sent = strtoull(rxBuff, NULL, 10);
+
+			if (now - sent > maxLat) maxLat = now - sent;
+			lines++;
+			rxLen -= (eol + 1 - rxBuff);
+			memmove(rxBuff, eol + 1, rxLen + 1);
+		}
+	}
+}
+
+
+static void sigHandler (int signum) {
+	if (signum == SIGWINCH) winch++;
+	else                    eventLoop_stop();
+}
+
+
+static void tmrHandler () {
+	timers++;
+}
+
+
+static void sender (int master, pid_t parent) {
+	// Scripted sender
+	char line[64];
+
+	usleep(100000);
+	for (uint8_t t=0; t<TEST_LINES; t++) {
+		int n = sprintf(line, "%llu MAIN: line %u\n", (unsigned long long)nowUs(), t);
+		if (write(master, line, n) != n) _exit(1);
+		usleep(TEST_GAPMS * 1000);
+	}
+	usleep(TEST_IDLEMS * 1000);
+	kill(parent, SIGWINCH);
+	usleep(50000);
+	kill(parent, SIGTERM);
+	_exit(0);
+}
+
+
+int main () {
+	int            master, slave, status, fails = 0;
+	struct termios tio;
+	pid_t          pid;
+	uint64_t       start;
+	uint32_t       wakeups;
+
+	if (eventLoop_init(sigHandler) != WERRCODE_SUCCESS) {
+		// ERROR!
+		printf("[FAIL] eventLoop_init()\n");
+		return(1);
+	}
+
+	// Pty pair (raw mode)
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 || (slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0) {
+		// ERROR!
+		perror("ERROR! pty pair creation failed");
+		return(1);
+	}
+	tcgetattr(slave, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(slave, TCSANOW, &tio);
+
+	if ((pid = fork()) == 0)
+		sender(master, getppid());
+
+	eventLoop_add(slave, rxHandler, NULL);
+	eventLoop_timer(TEST_TIMERMS, tmrHandler);
+
+	start = nowUs();
+	CHECK(eventLoop_run() == WERRCODE_SUCCESS, "eventLoop_run() stopped by SIGTERM");
+	wakeups = eventLoop_wakeups();
+	waitpid(pid, &status, 0);
+
+	printf("       %u lines, max latency %llu us, %u wake-ups in %.2f s\n", lines, (unsigned long long)maxLat, wakeups, (nowUs() - start) / 1e6);
+	CHECK(lines == TEST_LINES, "every line has been received");
+	CHECK(maxLat < TEST_MAXLATUS, "delivery latency");
+	CHECK(timers == 1, "one-shot timer");
+	CHECK(winch == 1, "SIGWINCH received through the signalfd");
+	CHECK(wakeups <= TEST_LINES + 3 + 2, "no wake-ups without events (idle phase included)");
+	CHECK(eventLoop_remove(slave) == WERRCODE_SUCCESS && eventLoop_remove(slave) == WERRCODE_WARNING_ITNOTFOUND, "fd removal");
+
+	eventLoop_close();
+	close(slave);
+	close(master);
+	return((fails == 0) ? 0 : 1);
+}
@@ -0,0 +1,135 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: headless_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Sustained parsing rate of the headless mode (JSON Lines to /dev/null) compared with the ncurses path. A capture
+//	file with BENCH_LINES rows (10% of them are pin-states) is created, then it is played at max speed by the console
+//	(../debugConsole, or the argument defined executable relative to "..") in both modes, with the exit at the end of the playback (-q).
+//	The ncurses console runs on a pseudo-terminal whose output is drained by this program.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pty.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <captureFile.h>
+#include "testUtils.h"
+
+#define BENCH_CONSOLEDIR ".."      // The console looks for the pins map relatively to its directory
+#define BENCH_CONSOLE    "./debugConsole"
+#define BENCH_FILE       "/tmp/headless_bench.cap"  // Absolute path (see BENCH_CONSOLEDIR)
+#define BENCH_LINES      2000000
+#define BENCH_CHUNK      4000      // Bytes per record
+
+
+static void captureCreating () {
+	char     chunk[BENCH_CHUNK + 128];
+	uint32_t size = 0;
+
+	captureFile_open(BENCH_FILE, 115200, "ESP32");
+	for (uint32_t line = 0; line < BENCH_LINES; line++) {
+		size += (line % 10 == 0) ?
+			sprintf(chunk + size, "GPIO_NUM_%u:%u\n", line % 40, line % 2) :
+			sprintf(chunk + size, "I (%u) MAIN: synthetic log line number %u\n", line, line);
+		if (size >= BENCH_CHUNK) {
+			captureFile_add(line / 1000, chunk, size);
+			size = 0;
+		}
+	}
+	captureFile_add(BENCH_LINES / 1000, chunk, size);
+	captureFile_close();
+}
+
+
+static void report (const char *mode, pid_t pid, int screen, double start) {
+	//
+	// Description:
+	//	It waits for the console (draining its terminal, if any), and it prints the rate
+	//
+	struct rusage ru;
+	char          buff[65536];
+	int           status;
+	double        elapsed, cpu;
+
+	if (screen >= 0)
+		while (read(screen, buff, sizeof(buff)) > 0);
+
+	wait4(pid, &status, 0, &ru);
+	elapsed = now() - start;
+	cpu     = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+
+	printf(
+		"%-9s %u lines in %.2f s: %6.2f M lines/s (%.2f CPU s)%s\n", mode, BENCH_LINES, elapsed, BENCH_LINES / elapsed / 1e6, cpu,
+		(WIFEXITED(status) && WEXITSTATUS(status) == 0) ? "" : " [console failure]"
+	);
+}
+
+
+int main (int argc, char *argv[]) {
+	const char     *console = (argc > 1) ? argv[1] : BENCH_CONSOLE;
+	struct winsize ws = { 40, 120, 0, 0 };
+	int            screen;
+	double         start;
+	pid_t          pid;
+
+	if (chdir(BENCH_CONSOLEDIR) != 0 || access(console, X_OK) != 0) {
+		printf("[SKIP] %s not found (build the console first)\n", console);
+		return(0);
+	}
+	captureCreating();
+
+	// Headless mode, JSON Lines to /dev/null
+	start = now();
+	if ((pid = fork()) == 0) {
+		int fd = open("/dev/null", O_WRONLY);
+
+		dup2(fd, STDOUT_FILENO);
+		execl(console, console, "--headless", "-p", BENCH_FILE, "-x", "max", NULL);
+		_exit(127);
+	}
+	report("headless:", pid, -1, start);
+
+	// Ncurses mode
+	start = now();
+	if ((pid = forkpty(&screen, NULL, NULL, &ws)) == 0) {
+		setenv("TERM", "xterm", 1);
+		execl(console, console, "-p", BENCH_FILE, "-x", "max", "-q", NULL);
+		_exit(127);
+	}
+	report("ncurses:", pid, screen, start);
+	close(screen);
+
+	unlink(BENCH_FILE);
+	return(0);
+}
@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: jsonOutput_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	jsonOutput module's test: it writes a few pin-states and log messages (special characters included) and it
+//	compares the produced JSON lines with the expected ones.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <jsonOutput.h>
+#include "testUtils.h"
+
+#define TEST_FILE  "/tmp/jsonOutput_test.jsonl"
+#define TEST_MSG   "q\"uote b\\ack tab\t esc\033[0m hi\xe8"
+
+
+static const char *expected =
+	"{\"timestamp\":0,\"kind\":\"pin\",\"pin\":\"GPIO_NUM_8\",\"symbol\":\"i_LEFTARROW\",\"value\":1}\n"
+	"{\"timestamp\":12,\"kind\":\"pin\",\"pin\":\"GPIO_NUM_2\",\"symbol\":null,\"value\":-3}\n"
+	"{\"timestamp\":4294967295,\"kind\":\"log\",\"message\":\"I (5) MAIN: plain\"}\n"
+	"{\"timestamp\":7,\"kind\":\"log\",\"message\":\"q\\\"uote b\\\\ack tab\\u0009 esc\\u001b[0m hi\\u00e8\"}\n";
+
+
+int main () {
+	int     fails = 0;
+	FILE    *fh   = fopen(TEST_FILE, "w+");
+	char    result[1024];
+	pinId_t pin8, pin2;
+	size_t  n;
+
+	pinId_fromLabel("GPIO_NUM_8", &pin8);
+	pinId_fromLabel("GPIO_NUM_2", &pin2);
+
+	CHECK(jsonOutput_isOpen() == false && jsonOutput_open(fileno(fh)) == WERRCODE_SUCCESS && jsonOutput_isOpen(), "jsonOutput_open()");
+	CHECK(
+		jsonOutput_pin(0, pin8, 1) == WERRCODE_SUCCESS &&
+		jsonOutput_pin(12, pin2, -3) == WERRCODE_SUCCESS &&
+		jsonOutput_log(0xFFFFFFFF, "I (5) MAIN: plain", 17) == WERRCODE_SUCCESS &&
+		jsonOutput_log(7, TEST_MSG, strlen(TEST_MSG)) == WERRCODE_SUCCESS,
+		"lines writing"
+	);
+	CHECK(jsonOutput_close() == WERRCODE_SUCCESS && jsonOutput_isOpen() == false, "jsonOutput_close()");
+
+	rewind(fh);
+	n = fread(result, 1, sizeof(result) - 1, fh);
+	result[n] = '\0';
+	CHECK(strcmp(result, expected) == 0, "JSON lines (escaping included)");
+	if (strcmp(result, expected) != 0) printf("%s", result);
+
+	fclose(fh);
+	unlink(TEST_FILE);
+	return((fails == 0) ? 0 : 1);
+}
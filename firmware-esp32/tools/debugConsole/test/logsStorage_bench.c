@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: logsStorage_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Log store benchmark: insertion throughput and memory per stored line of the arena based logsStorage, compared
+//	with the legacy one (16 lines ring of malloc-ed 1 KB items). The stored lines, their order and the jump-to-time
+//	search are verified after several arena laps.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <logsStorage.h>
+#include <logsStorage_legacy.h>
+#include <timeUtils.h>
+#include "testUtils.h"
+
+#define BENCH_LINES    2000000
+#define BENCH_ROWSIZE  96
+#define BENCH_SAMPLES  4096       // Pre-built lines (the line building is not measured)
+
+
+static uint16_t mkLine (char *buff, uint32_t n) {
+	// Realistic ESP-IDF log lines (variable length)
+	static const char *tags[] = { "MAIN", "ADCSCHED", "BATTMON", "RPMMETER", "GPIOEXT" };
+	return(sprintf(buff, "I (%u) %s: event %u%.*s", n, tags[n % 5], n * 7, (int)(n % 32), "................................"));
+}
+
+
+int main () {
+	char     (*lines)[BENCH_ROWSIZE] = malloc(BENCH_SAMPLES * BENCH_ROWSIZE);
+	uint16_t sizes[BENCH_SAMPLES];
+	uint64_t bytes = 0;
+	uint32_t tstamp, count;
+	double   lTime, sTime, start;
+	int      err = 0;
+
+	if (lines == NULL) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Out of memory\n");
+		return(1);
+	}
+	for (uint32_t t=0; t<BENCH_SAMPLES; t++)
+		sizes[t] = mkLine(lines[t], t);
+
+	// Legacy store
+	start = now();
+	for (uint32_t t=0; t<BENCH_LINES; t++)
+		logsStorageLegacy_add(lines[t % BENCH_SAMPLES]);
+	lTime = now() - start;
+	logsStorageLegacy_free();
+
+	// Arena store (time-stamp = line number, like debugConsole it is read from getMyEpoch(), too)
+	start = now();
+	for (uint32_t t=0; t<BENCH_LINES; t++) {
+		getMyEpoch(&tstamp);
+		if (logsStorage_add(lines[t % BENCH_SAMPLES], sizes[t % BENCH_SAMPLES], t) != WERRCODE_SUCCESS) err++;
+		bytes += sizes[t % BENCH_SAMPLES];
+	}
+	sTime = now() - start;
+	count = logsStorage_count();
+
+	// Content check: the stored lines have to be the newest ones, in order
+	for (uint32_t t=0; t<count; t++) {
+		const char *msg;
+		uint32_t   n = BENCH_LINES - count + t;
+
+		if (logsStorage_get(t, &msg, &tstamp) != WERRCODE_SUCCESS || tstamp != n || strcmp(msg, lines[n % BENCH_SAMPLES]) != 0) {
+			err++;
+			break;
+		}
+	}
+	if (logsStorage_find(BENCH_LINES - count / 2) != count - count / 2 || logsStorage_find(0) != 0 || logsStorage_find(BENCH_LINES) != count)
+		err++;
+
+	printf("legacy: %10.0f lines/s   %4u lines stored   %6.1f bytes/line\n",
+	       BENCH_LINES / lTime, LEGACY_MAXLOGLINES, (double)sizeof(legacyLogRow));
+	printf("arena:  %10.0f lines/s   %u lines stored   %6.1f bytes/line (%.1f average message length)   (x%.1f)\n",
+	       BENCH_LINES / sTime, count, (double)(LOGS_ARENASIZE + LOGS_MAXLINES * 8) / count, (double)bytes / BENCH_LINES,
+	       lTime / sTime);
+	printf("%s stored lines and jump-to-time check\n", (err == 0) ? "[ OK ]" : "[FAIL]");
+
+	logsStorage_free();
+	free(lines);
+	return((err == 0) ? 0 : 1);
+}
@@ -0,0 +1,133 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: logsStorage_legacy.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Legacy version of logsStorage (16 lines ring of malloc-ed 1 KB items). It is kept just as reference for the
+//	logsStorage benchmark.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <logsStorage_legacy.h>
+#include <timeUtils.h>
+
+static legacyLogRow *newest = NULL;
+static legacyLogRow *oldest = NULL;
+
+
+static legacyLogRow* new_legacyLogRow (legacyLogRow *item) {
+	//
+	// Description:
+	//	This function creates a new object, links it to the argument defined object, and sets the log timestamp field
+	//
+	// Returned value:
+	//	NULL:         malloc() failed
+	//	<valid addr>: The new-oject's address
+	//
+	legacyLogRow *newObj = (legacyLogRow*)malloc(sizeof(legacyLogRow));
+
+	if (newObj != NULL) {
+		// Object creation
+		newObj->message[0] = '\0';
+		newObj->tstamp     = 0;
+		newObj->next       = NULL;
+
+		// Object linking
+		if (item != NULL) item->next = newObj;
+	}
+	
+	return(newObj);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+werror logsStorageLegacy_add (const char *logMsg) {
+	//
+	// Description:
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_OUTOFMEMORY
+	//
+	werror          err = WERRCODE_SUCCESS;
+	static uint16_t logCounter = 0;
+	static bool     ringFlag = false;
+
+	if (logCounter < LEGACY_MAXLOGLINES) {
+		newest = new_legacyLogRow(newest);
+		if (newest == NULL) {
+			// ERROR!
+			err = WERRCODE_ERROR_OUTOFMEMORY;
+			fprintf(stderr, "ERROR(%d)! new_legacyLogRow() failed", __LINE__);
+			
+		} else {
+			if (logCounter == 0) oldest = newest;
+			logCounter++;
+		}
+
+	} else {
+		// It closes the ring structure
+		if (ringFlag == false) {
+			newest->next = oldest;
+			ringFlag = true;
+		}
+		newest = oldest;
+		oldest = oldest->next ;
+	}
+	strcpy(newest->message, logMsg);
+		
+	// Timestamp
+	if (getMyEpoch(&(newest->tstamp)) == 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! System-time retriving operation failed: %s\n", strerror(errno));
+	}
+
+	return(err);
+}
+
+
+void logsStorageLegacy_free() {
+	//
+	// Description:
+	//	It release all dinamically allocated memory
+	//
+	legacyLogRow *ptr = NULL;
+	while (oldest != newest) {
+		ptr = oldest;
+		oldest = oldest->next;
+		free(ptr);
+	}
+	if (oldest != NULL) free(oldest);
+	
+	return;
+}
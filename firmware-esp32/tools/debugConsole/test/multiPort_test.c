@@ -0,0 +1,191 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: multiPort_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Multi-port test of the serial pipeline (see ttyPipeline_startMulti()): a child process drives 1, 2, 4 and then 8
+//	pty pairs with synthetic generators (TEST_RATE lines per second each, a pin-state every TEST_PINEVERY lines), while
+//	this process parses them. Every device has to store all its lines and only its pins, and the pipeline's CPU usage
+//	per device is reported for every devices number (it should stay flat).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <ttyPipeline.h>
+#include <logsStorage.h>
+#include <pinsStorage.h>
+#include <pinToSymbol.h>
+#include "testUtils.h"
+
+#define TEST_RATE       5000      // Lines per second per device
+#define TEST_SECONDS    1
+#define TEST_PINEVERY   10
+#define TEST_PINBASE    4         // Device d's pin: GPIO_NUM_<TEST_PINBASE + d>
+
+
+static int masters[DEV_MAXDEVICES], slaves[DEV_MAXDEVICES];
+
+
+static int generators (uint8_t devs) {
+	//
+	// Description:
+	//	Child process: it writes TEST_RATE lines per second on every device for TEST_SECONDS seconds. It returns the
+	//	number of bytes refused by the ptys (they must be 0).
+	//
+	char     line[128];
+	uint64_t start = nowUs(), due;
+	uint32_t n     = 0;
+	int      lost  = 0;
+
+	while (n < TEST_SECONDS * TEST_RATE) {
+		due = (nowUs() - start) * TEST_RATE / 1000000;
+		for (; n < due && n < TEST_SECONDS * TEST_RATE; n++) {
+			for (uint8_t d = 0; d < devs; d++) {
+				int size = ((n + 1) % TEST_PINEVERY == 0) ?
+					sprintf(line, "GPIO_NUM_%u:%u\n", TEST_PINBASE + d, (n / TEST_PINEVERY) % 2) :
+					sprintf(line, "I (%u) DEV%u: synthetic log line number %u\n", n, d, n);
+
+				if (write(masters[d], line, size) != size) lost++;
+			}
+		}
+		usleep(1000);
+	}
+	return(lost);
+}
+
+
+static int run (uint8_t devs, uint32_t *cpuPerDev) {
+	//
+	// Description:
+	//	It monitors the argument defined number of devices, and it returns the number of failed checks
+	//
+	int            notifyFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	int            fails = 0, status = 0;
+	uint32_t       logs = (TEST_SECONDS * TEST_RATE) - (TEST_SECONDS * TEST_RATE) / TEST_PINEVERY;
+	bool           stored = true, separated = true;
+	struct rusage  ru0, ru1;
+	pipeStats_t    stats;
+	uint64_t       start, expected = 0;
+	double         cpu;
+	pid_t          pid;
+
+	for (devId_t d = 0; d < devs; d++) {
+		// The previous run's logs are discarded
+		logsStorage_select(d);
+		logsStorage_free();
+	}
+
+	fflush(stdout);
+	if ((pid = fork()) == 0) _exit(generators(devs));
+
+	getrusage(RUSAGE_SELF, &ru0);
+	start = nowUs();
+	if (ttyPipeline_startMulti(slaves, devs, notifyFD) != WERRCODE_SUCCESS) fails++;
+	waitpid(pid, &status, 0);
+
+	// The tail of the stream has to be parsed
+	expected = (uint64_t)TEST_SECONDS * TEST_RATE * devs;
+	do {
+		usleep(1000);
+		ttyPipeline_stats(&stats);
+	} while (stats.rows < expected && nowUs() - start < (TEST_SECONDS + 2) * 1000000ULL);
+	getrusage(RUSAGE_SELF, &ru1);
+	cpu = (ru1.ru_utime.tv_sec - ru0.ru_utime.tv_sec) + (ru1.ru_utime.tv_usec - ru0.ru_utime.tv_usec) / 1e6 +
+	      (ru1.ru_stime.tv_sec - ru0.ru_stime.tv_sec) + (ru1.ru_stime.tv_usec - ru0.ru_stime.tv_usec) / 1e6;
+	*cpuPerDev = 1000000.0 * cpu / TEST_SECONDS / devs;
+
+	for (devId_t d = 0; d < devs; d++) {
+		uint32_t    value, tstamp;
+		const char  *msg;
+		char        tag[16];
+
+		ttyPipeline_view(d);
+		ttyPipeline_lock();
+		sprintf(tag, "DEV%u:", d);
+		stored = stored && logsStorage_count() == logs;
+		for (uint32_t l = 0; l < logsStorage_count(); l += logs / 8) {
+			logsStorage_get(l, &msg, &tstamp);
+			separated = separated && strstr(msg, tag) != NULL;
+		}
+		for (devId_t o = 0; o < DEV_MAXDEVICES; o++)
+			separated = separated && (pinsStorage_get(TEST_PINBASE + o, &value, &tstamp) == WERRCODE_SUCCESS) == (o == d);
+		ttyPipeline_unlock();
+	}
+	ttyPipeline_view(0);
+	ttyPipeline_stop();
+
+	printf("       %u devices: %6.2f%% CPU per device (%llu rows, %u max queue usage)\n", devs, *cpuPerDev / 10000.0,
+	       (unsigned long long)stats.rows, stats.maxQueue);
+	if (WIFEXITED(status) == false || WEXITSTATUS(status) != 0) fails++;
+	if (ttyPipeline_error() != WERRCODE_SUCCESS) fails++;
+	if (stored == false || separated == false) fails++;
+	close(notifyFD);
+
+	return(fails);
+}
+
+
+int main () {
+	int            fails = 0, runFails = 0;
+	uint32_t       cpu[4];
+	struct termios tio;
+
+	for (devId_t d = 0; d < DEV_MAXDEVICES; d++) {
+		masters[d] = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+		if (masters[d] < 0 || grantpt(masters[d]) < 0 || unlockpt(masters[d]) < 0 || (slaves[d] = open(ptsname(masters[d]), O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0) {
+			// ERROR!
+			perror("ERROR! pty pair creation failed");
+			return(1);
+		}
+		tcgetattr(slaves[d], &tio);
+		cfmakeraw(&tio);
+		tcsetattr(slaves[d], TCSANOW, &tio);
+	}
+
+	for (uint8_t t = 0; t < 4; t++) runFails += run(1 << t, &cpu[t]);
+	CHECK(runFails == 0, "every device stores all its lines and only its pins (1, 2, 4, 8 devices)");
+	// Flat cost: 8 devices cannot cost (per device) more than twice the single one
+	CHECK(cpu[3] <= 2 * cpu[0] + 1000, "flat CPU usage per device");
+	CHECK(ttyPipeline_startMulti(slaves, DEV_MAXDEVICES + 1, -1) == WERRCODE_ERROR_ILLEGALARG, "too many devices refused");
+
+	for (devId_t d = 0; d < DEV_MAXDEVICES; d++) {
+		logsStorage_select(d);
+		logsStorage_free();
+		close(masters[d]);
+		close(slaves[d]);
+	}
+	return(fails);
+}
@@ -0,0 +1,97 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   pinDef_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	pinDef_get() benchmark: it measures the parsed rows per second of the hand-written scanner and of the legacy regex
+//	based parser, on a stream of pin definitions and normal logs. The legacy parser writes into the row, so it works on
+//	a copy of every row.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pinToSymbol.h>
+#include <pinDef_legacy.h>
+#include "testUtils.h"
+
+#define BENCH_ROWS    200000
+#define BENCH_ROUNDS  10
+#define BENCH_ROWSIZE 64
+
+
+int main () {
+	char     (*rows)[BENCH_ROWSIZE] = malloc(BENCH_ROWS * BENCH_ROWSIZE);
+	char     tmp[BENCH_ROWSIZE], pin[BENCH_ROWSIZE];
+	uint64_t lPins = 0, sPins = 0;
+	double   lTime, sTime, start;
+
+	if (rows == NULL) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Out of memory\n");
+		return(1);
+	}
+
+	for (uint32_t t=0; t<BENCH_ROWS; t++) {
+		if (t % 2)
+			sprintf(rows[t], "I (%u) MAIN: MTB_RUNNIG_ST", t);
+		else
+#ifdef TARGET_AVR8
+			sprintf(rows[t], "%c%u:%u", 'A' + t % 4, t % 8, t % 1024);
+#elifdef TARGET_ESP32
+			sprintf(rows[t], "GPIO_NUM_%u:%u", t % 47, t % 2);
+#endif
+	}
+
+	start = now();
+	for (uint8_t r=0; r<BENCH_ROUNDS; r++) {
+		for (uint32_t t=0; t<BENCH_ROWS; t++) {
+			int value;
+			strcpy(tmp, rows[t]);
+			if (pinDefLegacy_get(tmp, pin, &value) == WERRCODE_SUCCESS) lPins++;
+		}
+	}
+	lTime = now() - start;
+
+	start = now();
+	for (uint8_t r=0; r<BENCH_ROUNDS; r++) {
+		for (uint32_t t=0; t<BENCH_ROWS; t++) {
+			pinId_t id;
+			int     value;
+			if (pinDef_get(rows[t], &id, &value) == WERRCODE_SUCCESS) sPins++;
+		}
+	}
+	sTime = now() - start;
+
+	printf("legacy (regex):  %10.0f rows/s\n", (BENCH_ROWS * BENCH_ROUNDS) / lTime);
+	printf("scanner:         %10.0f rows/s   (x%.1f)\n", (BENCH_ROWS * BENCH_ROUNDS) / sTime, lTime / sTime);
+	printf("%s pin definitions: %lu/%lu\n", (lPins == sPins) ? "[ OK ]" : "[FAIL]", (unsigned long)lPins, (unsigned long)sPins);
+
+	pinDefLegacy_free();
+	free(rows);
+	return((lPins == sPins) ? 0 : 1);
+}
@@ -0,0 +1,150 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: pinDef_legacy.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Legacy (regex based) version of pinDef_get(). It is kept just as reference for the pinDef test and benchmark, and
+//	it must not be modified. [!] Like the original one, it writes into the argument defined log string.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <regex.h>
+#include <errno.h>
+#include <string.h>
+#include <pinDef_legacy.h>
+
+#ifdef TARGET_AVR8
+#define CONS_PINDEMATCH   "^[A-Z0-9][0-9]:[0-9]\\+$"
+#elifdef TARGET_ESP32
+#define CONS_PINDEMATCH   "^GPIO_NUM_[0-9]\\+:[0-9]\\+$"
+#endif
+
+static regex_t     pinDef_regx;
+
+
+static werror _iatoi (int *dst, const char *src) {
+	//
+	// Description:
+	//	Intelligent atoi() function
+	//
+	// Arguments:
+	//	dst:  the converted number
+	//	src:  the characters string version of the number
+	//
+	// Returned vale:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_INVALIDDATA
+	//
+	werror  err  = WERRCODE_SUCCESS;
+	
+	if (strlen(src) > 0) {
+		uint8_t t    = 0;
+		char    *ptr = (char*)src;
+		
+		// Zero padding removing...
+		while (src[t] == '0' && src[t] != '\0') t++;
+	
+		if (src[t] == '\0')
+			// 00000.. = 0
+			*dst = 0;
+			
+		else {
+			*dst = atoi(ptr);
+	
+			// Checking for atoi() error
+			if (dst == 0)
+				// ERROR!
+				// The string contains not-numeric characters too
+				err = WERRCODE_ERROR_INVALIDDATA; 
+		}
+	} else
+		// ERROR!
+		// Empty data is not allowed
+		err = WERRCODE_ERROR_INVALIDDATA;
+		
+	return(err);
+}
+
+werror pinDefLegacy_get (const char *log, char *pin, int *value) {
+	//
+	// Description:
+	//	This function checks for special-log syntax inside the argument defined (log) string.
+	//	The special ones are used to keep track of the pins' value, and they have to respect the following syntax:
+	//		<port><pin-number>:<int value> // port=<A-Z>, pin=<0-9>, value=<0..n>
+	//
+	// Arguments:
+	//	log:    The received log message
+	//	pin:    The memory area where the pin-id will be stored
+	//	value:  The area where the pin'svalue will be stored. It can be an ADC result, too.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_WARNING_ITNOTFOUND
+	//	WERRCODE_ERROR_REGEXCOMP
+	//	WERRCODE_ERROR_INVALIDDATA
+	//
+	static bool    initFlag = false;
+	werror         err = WERRCODE_SUCCESS;
+	
+	if (initFlag == false) {
+		if (regcomp(&pinDef_regx, CONS_PINDEMATCH, 0) == 0) {
+			initFlag = true;
+		} else {
+			// ERROR!
+			char regErrBuff[128];
+			regerror(errno, &pinDef_regx, regErrBuff, 128);
+			fprintf(stderr, "ERROR(%d)! I cannot compile the regex: %s", __LINE__, regErrBuff);
+			err = WERRCODE_ERROR_REGEXCOMP;
+		}
+	} 
+	
+	if (initFlag) {
+		regmatch_t pmatch[3];
+		char       strValue[16]; 
+		
+		if (regexec(&pinDef_regx, log, 3, pmatch, 0) == 0) {
+			strcpy(strValue, (strchr(log, ':') + 1));
+			*strchr(log, ':') = '\0';
+			strcpy(pin, log);
+			
+			if (wErrCode_isError(_iatoi(value, strValue))) {
+				// ERROR!
+				err = WERRCODE_ERROR_INVALIDDATA;
+			}
+		} else
+			// It is just a normal log message
+			err = WERRCODE_WARNING_ITNOTFOUND;
+	}
+	
+	return(err);
+}
+
+
+void pinDefLegacy_free() {
+	regfree(&pinDef_regx);
+	return;
+}
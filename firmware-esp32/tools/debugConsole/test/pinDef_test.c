@@ -0,0 +1,153 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   pinDef_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Differential test of pinDef_get(): randomly generated rows (valid pin definitions, mutated ones and normal logs) are
+//	parsed by the scanner and by the legacy regex based parser, and the results are compared. It checks the scanner
+//	never modifies the input row, and the pin-id to label conversion, too.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pinToSymbol.h>
+#include <pinDef_legacy.h>
+
+#define TEST_ROWS    1000000
+#define TEST_ROWSIZE 64
+
+static const char charset[] = "GPIO_NUM_0123456789:ABCZ abc\r-+x";
+
+
+static void rowGenerate (char *row) {
+	//
+	// Description:
+	//	It writes a random row in the argument defined buffer: a valid pin definition, a mutated one or a normal log
+	//
+	int  kind = rand() % 10;
+	int  len;
+
+	if (kind < 6) {
+		// Pin definition (sometimes with zero padding)
+#ifdef TARGET_AVR8
+		len = sprintf(row, "%c%d:%s%d", "ABCDEFGHXYZ0129"[rand() % 15], rand() % 10, (rand() % 8) ? "" : "00", rand() % 100000);
+#elifdef TARGET_ESP32
+		len = sprintf(row, "GPIO_NUM_%s%d:%s%d", (rand() % 8) ? "" : "0", rand() % 300, (rand() % 8) ? "" : "00", rand() % 100000);
+#endif
+		if (kind >= 3) {
+			// Mutations: replaced, inserted or removed characters
+			int pos = rand() % len;
+			switch (rand() % 3) {
+				case 0:
+					row[pos] = charset[rand() % (sizeof(charset) - 1)];
+					break;
+				case 1:
+					memmove(row + pos + 1, row + pos, len - pos + 1);
+					row[pos] = charset[rand() % (sizeof(charset) - 1)];
+					break;
+				default:
+					memmove(row + pos, row + pos + 1, len - pos);
+			}
+		}
+	} else if (kind < 8)
+		sprintf(row, "I (%d) MAIN: MTB_RUNNIG_ST", rand());
+	else if (kind < 9)
+		// Very big value
+		sprintf(row, "%s:%d%d", (rand() % 2) ? "GPIO_NUM_3" : "B3", rand(), rand());
+	else
+		row[0] = '\0';
+
+	return;
+}
+
+
+static bool outOfRange (const char *label, const char *row) {
+	//
+	// Description:
+	//	It returns true when the legacy parser accepted a row with a pin-id or a value the scanner does not represent
+	//
+	unsigned long long value = strtoull(strchr(row, ':') + 1, NULL, 10);
+#ifdef TARGET_ESP32
+	if (strtoull(label + 9, NULL, 10) >= PTS_MAXPINID) return(true);
+#endif
+	return(value > INT32_MAX);
+}
+
+
+int main () {
+	char     row[TEST_ROWSIZE], copy[TEST_ROWSIZE], legacyRow[TEST_ROWSIZE];
+	char     label[PTS_PINLABSIZE], legacyPin[TEST_ROWSIZE];
+	uint32_t mismatches = 0, mutations = 0, matches = 0;
+	int      err = 0;
+
+	srand(1);
+	for (uint32_t t=0; t<TEST_ROWS; t++) {
+		pinId_t id;
+		int     value = 0, legacyValue = 0;
+		werror  ec, lec;
+
+		rowGenerate(row);
+		strcpy(copy, row);
+		strcpy(legacyRow, row);
+
+		ec  = pinDef_get(row, &id, &value);
+		lec = pinDefLegacy_get(legacyRow, legacyPin, &legacyValue);
+
+		if (strcmp(copy, row) != 0) mutations++;
+
+		if (lec == WERRCODE_SUCCESS && outOfRange(legacyPin, copy)) {
+			if (ec != WERRCODE_ERROR_INVALIDDATA) mismatches++;
+
+		} else if (lec != ec)
+			mismatches++;
+
+		else if (ec == WERRCODE_SUCCESS) {
+			pinId_toLabel(label, id);
+#ifdef TARGET_ESP32
+			// The label is normalized (no zero padding)
+			if (value != legacyValue || (pinId_t)atoi(legacyPin + 9) != id || strncmp(label, "GPIO_NUM_", 9) != 0)
+#else
+			if (value != legacyValue || strcmp(label, legacyPin) != 0)
+#endif
+				mismatches++;
+			matches++;
+		}
+
+		if (mismatches == 1 && err == 0) {
+			printf("[FAIL] first mismatch: \"%s\" (scanner=%d, legacy=%d)\n", copy, ec, lec);
+			err = 1;
+		}
+	}
+
+	printf("%d rows, %lu pin definitions\n", TEST_ROWS, (unsigned long)matches);
+	printf("%s mismatches: %lu\n", (mismatches == 0) ? "[ OK ]" : "[FAIL]", (unsigned long)mismatches);
+	printf("%s modified input rows: %lu\n", (mutations == 0) ? "[ OK ]" : "[FAIL]", (unsigned long)mutations);
+	if (mutations) err = 1;
+
+	pinDefLegacy_free();
+	return(err);
+}
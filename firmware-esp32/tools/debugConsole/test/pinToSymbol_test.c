@@ -90,9 +90,13 @@ int main (int argc, char *argv[]) {
 				}
 			}
 			if (*string != '\0') {
-				wecode = pinDef_get(string, pinid, &value);
-				if (wErrCode_isSuccess(wecode))
-					printf("The string contained the \"%s\"-pin definition (value=%d)\n", pinid, value);
+				pinId_t id = 0;
+
+				wecode = pinDef_get(string, &id, &value);
+				if (wErrCode_isSuccess(wecode)) {
+					pinId_toLabel(pinid, id);
+					printf("The string contained the \"%s\"-pin (id=%d) definition (value=%d)\n", pinid, id, value);
+				}
 
 				else if (wecode == WERRCODE_WARNING_ITNOTFOUND)
 					printf("The typed string does not containe a valid pin definition\n");
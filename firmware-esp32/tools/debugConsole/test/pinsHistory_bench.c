@@ -0,0 +1,186 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: pinsHistory_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Pins history benchmark: insertion throughput, memory per transition and query latency of pinsHistory over
+//	BENCH_TRANSITIONS transitions of BENCH_PINS pins (a few hours of 1-3 ms spaced changes; the last BENCH_ANALOG pins
+//	are not binary). The state-at-time latency is measured after 1/10 of the transitions too (it has to grow as
+//	log n), and it is compared with a linear scan of a plain array. The answers of both queries are verified on a
+//	binary and on an analog pin.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pinsHistory.h>
+#include "testUtils.h"
+
+#define BENCH_TRANSITIONS  10000000
+#define BENCH_PINS         16
+#define BENCH_ANALOG       4          // Pins with 12 bits values
+#define BENCH_QUERIES      1000000
+#define BENCH_RANGES       100000
+#define BENCH_RANGEMS      1000       // Range queries' window
+#define BENCH_SCANS        200        // Linear scan queries (reference)
+
+#define BENCH_BINPIN       0          // Verified pins
+#define BENCH_ANAPIN       (BENCH_PINS - 1)
+
+// Reference timeline (plain array)
+typedef struct {
+	uint32_t tstamp;
+	uint32_t value;
+} refItem_t;
+
+static refItem_t *refs[2];
+static uint32_t  refCount[2] = { 0, 0 };
+static volatile uint32_t sink;            // The queries' results are used
+
+
+static int refValueAt (uint8_t r, uint32_t tstamp, uint32_t *value) {
+	// Linear scan of the reference timeline (it returns 0 when there is no transition before tstamp)
+	int found = 0;
+
+	for (uint32_t t = 0; t < refCount[r] && refs[r][t].tstamp <= tstamp; t++) {
+		*value = refs[r][t].value;
+		found  = 1;
+	}
+	return(found);
+}
+
+
+static double valueAtLatency (uint32_t lastTs) {
+	// Random state-at-time queries (ns/query)
+	uint32_t value, sum = 0;
+	double   start = now();
+
+	for (uint32_t t = 0; t < BENCH_QUERIES; t++)
+		if (pinsHistory_valueAt(xorshift() % BENCH_PINS, xorshift() % lastTs, &value) == WERRCODE_SUCCESS) sum += value;
+
+	sink = sum;
+	return((now() - start) * 1e9 / BENCH_QUERIES);
+}
+
+
+int main () {
+	uint32_t     last[BENCH_PINS], tstamp = 0, lastTs, value, ts, ts1 = 0;
+	double       start, addTime, q1 = 0, q10, scan, range;
+	uint64_t     found = 0;
+	histCursor_t cursor;
+	int          err = 0;
+
+	refs[0] = malloc(BENCH_TRANSITIONS * sizeof(refItem_t) / BENCH_PINS * 2);
+	refs[1] = malloc(BENCH_TRANSITIONS * sizeof(refItem_t) / BENCH_PINS * 2);
+	if (refs[0] == NULL || refs[1] == NULL) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Out of memory\n");
+		return(1);
+	}
+	memset(last, 0, sizeof(last));
+
+	// Insertion (every add is a real change)
+	start = now();
+	for (uint32_t t = 0; t < BENCH_TRANSITIONS; t++) {
+		uint32_t pin = xorshift() % BENCH_PINS;
+
+		tstamp += 1 + xorshift() % 3;
+		if (pin < BENCH_PINS - BENCH_ANALOG)
+			value = last[pin] ^ 1;
+		else
+			while ((value = xorshift() % 4096) == last[pin]);
+		last[pin] = value;
+
+		if (pinsHistory_add(pin, value, tstamp) != WERRCODE_SUCCESS) err++;
+
+		if (pin == BENCH_BINPIN || pin == BENCH_ANAPIN) {
+			uint8_t r = (pin == BENCH_BINPIN) ? 0 : 1;
+			refs[r][refCount[r]++] = (refItem_t){ tstamp, value };
+		}
+		if (t == BENCH_TRANSITIONS / 10 - 1) {
+			// Query latency with 1/10 of the transitions (it is not part of the insertion time)
+			addTime = now() - start;
+			ts1     = tstamp;
+			q1      = valueAtLatency(ts1);
+			start   = now() - addTime;
+		}
+	}
+	addTime = now() - start;
+	lastTs  = tstamp;
+	q10     = valueAtLatency(lastTs);
+
+	// Linear scan (reference)
+	start = now();
+	for (uint32_t t = 0; t < BENCH_SCANS; t++) found += refValueAt(0, xorshift() % lastTs, &value);
+	scan = (now() - start) * 1e9 / BENCH_SCANS;
+
+	// Range queries: all the transitions in [t0, t0 + BENCH_RANGEMS]
+	found = 0;
+	start = now();
+	for (uint32_t t = 0; t < BENCH_RANGES; t++) {
+		uint32_t t0 = xorshift() % lastTs;
+
+		pinsHistory_seek(&cursor, xorshift() % BENCH_PINS, t0);
+		while (pinsHistory_next(&cursor, &ts, &value) == WERRCODE_SUCCESS && ts <= t0 + BENCH_RANGEMS) found++;
+	}
+	range = (now() - start) * 1e9 / BENCH_RANGES;
+
+	// Answers check
+	for (uint8_t r = 0; r < 2; r++) {
+		pinId_t pin = (r == 0) ? BENCH_BINPIN : BENCH_ANAPIN;
+
+		if (pinsHistory_count(pin) != refCount[r]) err++;
+		for (uint32_t t = 0; t < 100; t++) {
+			uint32_t q = xorshift() % lastTs, v1 = 0, v2 = 0, n = 0, i = 0;
+			int      f = refValueAt(r, q, &v2);
+
+			if ((pinsHistory_valueAt(pin, q, &v1) == WERRCODE_SUCCESS) != f || v1 != v2) err++;
+
+			// Range: the reference's transitions in [q, q + BENCH_RANGEMS]
+			while (i < refCount[r] && refs[r][i].tstamp < q) i++;
+			pinsHistory_seek(&cursor, pin, q);
+			while (pinsHistory_next(&cursor, &ts, &value) == WERRCODE_SUCCESS && ts <= q + BENCH_RANGEMS) {
+				if (i + n >= refCount[r] || refs[r][i + n].tstamp != ts || refs[r][i + n].value != value) err++;
+				n++;
+			}
+			if (i + n < refCount[r] && refs[r][i + n].tstamp <= q + BENCH_RANGEMS) err++;
+		}
+	}
+	if (pinsHistory_valueAt(BENCH_BINPIN, 0, &value) != WERRCODE_WARNING_ITNOTFOUND) err++;
+
+	printf("insert:    %10.0f transitions/s   %.2f bytes/transition (raw: %u)   %.1f h of data\n",
+	       BENCH_TRANSITIONS / addTime, (double)pinsHistory_memory() / BENCH_TRANSITIONS, (unsigned)sizeof(refItem_t),
+	       lastTs / 3600000.0);
+	printf("value-at:  %8.0f ns/query (%u transitions)   %8.0f ns/query (%u transitions)   linear scan: %.0f ns (x%.0f)\n",
+	       q1, BENCH_TRANSITIONS / 10, q10, BENCH_TRANSITIONS, scan, scan / q10);
+	printf("range:     %8.0f ns/query (%.1f transitions per %u ms window)\n", range, (double)found / BENCH_RANGES, BENCH_RANGEMS);
+	printf("%s values and transitions check\n", (err == 0) ? "[ OK ]" : "[FAIL]");
+
+	pinsHistory_free();
+	free(refs[0]);
+	free(refs[1]);
+	return((err == 0) ? 0 : 1);
+}
@@ -0,0 +1,166 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: pinsStorage_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Screen refresh cost with 64 monitored pins: the legacy rendering (linear symbol lookup and copy for every pin) is
+//	compared with pinsStorage_print(), that uses the symbols cached by pinsStorage_update(). The ncurses output is
+//	sent to /dev/null, so the terminal speed does not affect the result.
+//	The update throughput (legacy strcmp scan vs pin-ID indexed DB) is measured, too, and it is reported as CPU load
+//	for a 100k updates/s pin-state stream.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ncurses.h>
+#include <pinToSymbol.h>
+#include <pinsStorage.h>
+#include <pinsStorage_legacy.h>
+#include "testUtils.h"
+#include "pinsStorage_benchMap.h"                // 64 pins table, generated by the Makefile (see pinToSymbol_gen.awk)
+
+#define BENCH_PINS     64
+#define BENCH_REFRESH  20000
+#define BENCH_COLS     160
+#define BENCH_UPDATES  10000000
+#define BENCH_RATE     100000     // Updates per second of the simulated stream
+
+
+int main () {
+	char   pin[BENCH_PINS][PTS_PINLABSIZE];
+	pinId_t id[BENCH_PINS];
+	uint8_t *seq = malloc(BENCH_UPDATES);
+	char   symbol[PTS_MAXSYMSIZE];
+	SCREEN *scr;
+	double lTime, sTime, luTime, suTime, start;
+	int    err = 0;
+
+	if (seq == NULL || PTS_GENSYMBOLS != BENCH_PINS) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Out of memory (or the generated table has not %u pins)\n", BENCH_PINS);
+		return(1);
+	}
+
+	// The same pins are monitored by the legacy DB
+	for (uint8_t t=0; t<BENCH_PINS; t++) {
+#ifdef TARGET_AVR8
+		sprintf(pin[t], "%c%u", 'A' + t / 8, t % 8);
+#elifdef TARGET_ESP32
+		sprintf(pin[t], "GPIO_NUM_%u", t);
+#endif
+		sprintf(symbol, "o_SYMBOL%u", t);
+		pinToSymbolLegacy_add(pin[t], symbol);
+	}
+	pinToSymbol_use(benchDb);
+
+	for (uint8_t t=0; t<BENCH_PINS; t++) {
+		pinId_fromLabel(pin[t], &id[t]);
+		pinsStorageLegacy_update(pin[t], t);
+		pinsStorage_update(id[t], t, 0);
+	}
+
+	scr = newterm("vt100", fopen("/dev/null", "w"), stdin);
+	if (scr == NULL) {
+		// ERROR!
+		fprintf(stderr, "ERROR! ncurses initialization failed\n");
+		return(1);
+	}
+
+	start = now();
+	for (uint32_t t=0; t<BENCH_REFRESH; t++) {
+		erase();
+		pinsStorageLegacy_print(BENCH_COLS);
+	}
+	lTime = now() - start;
+
+	start = now();
+	for (uint32_t t=0; t<BENCH_REFRESH; t++) {
+		erase();
+		pinsStorage_print(stdscr, BENCH_COLS);
+	}
+	sTime = now() - start;
+
+	endwin();
+	delscreen(scr);
+
+	// Update throughput (pseudo-random pins sequence)
+	for (uint32_t t=0, r=1; t<BENCH_UPDATES; t++) {
+		r = r * 1103515245 + 12345;
+		seq[t] = (r >> 16) % BENCH_PINS;
+	}
+
+	start = now();
+	for (uint32_t t=0; t<BENCH_UPDATES; t++)
+		pinsStorageLegacy_update(pin[seq[t]], t & 1);
+	luTime = now() - start;
+
+	start = now();
+	for (uint32_t t=0; t<BENCH_UPDATES; t++)
+		pinsStorage_update(id[seq[t]], t & 1, t / (BENCH_RATE / 1000));
+	suTime = now() - start;
+
+	// The last value and change time of every pin must be stored
+	{
+		bool seen[BENCH_PINS] = {false};
+
+		for (uint32_t t=BENCH_UPDATES, done=0; t>0 && done < BENCH_PINS; t--) {
+			uint32_t value, tstamp;
+
+			if (seen[seq[t-1]] == false) {
+				pinsStorage_get(id[seq[t-1]], &value, &tstamp);
+				if (value != ((t-1) & 1) || tstamp > (t-1) / (BENCH_RATE / 1000)) err++;
+				seen[seq[t-1]] = true;
+				done++;
+			}
+		}
+	}
+
+	// Overflow: the 65th pin must be refused
+	if (pinsStorage_update(200, 1, 0) != WERRCODE_ERROR_DATAOVERFLOW)
+		err++;
+
+	// Every pin must be resolved by the indexed table
+	for (uint8_t t=0; t<BENCH_PINS; t++) {
+		pinId_t    id;
+		const char *sym;
+		sprintf(symbol, "o_SYMBOL%u", t);
+		if (pinId_fromLabel(pin[t], &id) != WERRCODE_SUCCESS || pinToSymbol_getById(&sym, id) != WERRCODE_SUCCESS || strcmp(sym, symbol) != 0)
+			err++;
+	}
+
+	printf("legacy (lookup per pin):  %8.2f us/refresh\n", lTime * 1e6 / BENCH_REFRESH);
+	printf("cached symbols:           %8.2f us/refresh   (x%.1f)\n", sTime * 1e6 / BENCH_REFRESH, lTime / sTime);
+	printf("legacy update (strcmp):   %10.0f updates/s   (%5.2f%% CPU at %u updates/s)\n",
+	       BENCH_UPDATES / luTime, 100.0 * BENCH_RATE * luTime / BENCH_UPDATES, BENCH_RATE);
+	printf("indexed update:           %10.0f updates/s   (%5.2f%% CPU at %u updates/s, x%.1f)\n",
+	       BENCH_UPDATES / suTime, 100.0 * BENCH_RATE * suTime / BENCH_UPDATES, BENCH_RATE, luTime / suTime);
+	printf("%s pins symbols, values and overflow checks\n", (err == 0) ? "[ OK ]" : "[FAIL]");
+
+	free(seq);
+	return((err == 0) ? 0 : 1);
+}
@@ -0,0 +1,136 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: pinsStorage_legacy.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Legacy version of the pins' rendering: the symbols DB is scanned (strcmp) and the symbol is copied (strcpy) for
+//	every pin, at every screen refresh. It is kept just as reference for the pinsStorage benchmark.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ncurses.h>
+#include <pinsStorage_legacy.h>
+
+static ptsDbItem_t ptsDb[LEGACY_MAXPINS];
+static uint8_t     ptsCounter = 0;
+
+static struct {
+	char     pin[PTS_PINLABSIZE];
+	uint32_t value;
+} pinsDb[LEGACY_MAXPINS];
+static uint8_t counter = 0;
+
+
+static werror pinToSymbolLegacy_get (char *symbol, const char *pin) {
+	werror  ecode = WERRCODE_WARNING_ITNOTFOUND;
+	uint8_t dbIndex = 0;
+
+	while (dbIndex < ptsCounter && ptsDb[dbIndex].pin[0] != '\0') {
+		if (strcmp(ptsDb[dbIndex].pin, pin) == 0) {
+			ecode = WERRCODE_SUCCESS;
+			strcpy(symbol, ptsDb[dbIndex].symbol);
+			break;
+		} else {
+			dbIndex++;
+		}
+	}
+	return(ecode);
+}
+
+
+static void fillUp (char *string, uint8_t newsz) {
+	uint8_t t = 0;
+	for (t = strlen(string); t < newsz; t++) string[t] = ' ';
+	string[t] = '\0';
+}
+
+
+werror pinToSymbolLegacy_add (const char *pin, const char *symbol) {
+	werror ecode = WERRCODE_ERROR_DATAOVERFLOW;
+
+	if (ptsCounter < LEGACY_MAXPINS) {
+		strcpy(ptsDb[ptsCounter].pin, pin);
+		strcpy(ptsDb[ptsCounter].symbol, symbol);
+		ptsCounter++;
+		ecode = WERRCODE_SUCCESS;
+	}
+	return(ecode);
+}
+
+
+void pinsStorageLegacy_print (uint16_t screenCols) {
+	uint8_t t = 0, x = 0;
+	uint8_t cols = roundf(((screenCols) / (PTS_MAXSYMSIZE + 5)) - 1);
+	char    *buff = (char*)malloc(PTS_MAXSYMSIZE+5);
+
+	cols = (cols == 0) ? 1 : cols;
+
+	for (x = 0; x < counter; x++) {
+		if (pinToSymbolLegacy_get(buff, pinsDb[x].pin) != 1)
+			strcpy(buff, pinsDb[x].pin);
+
+		sprintf((buff + strlen(buff)), ":%d", pinsDb[x].value);
+		fillUp(buff, PTS_MAXSYMSIZE);
+		printw("%s", buff);
+
+		if (t == cols) {
+			printw("\n");
+			t = 0;
+		} else {
+			printw("      ");
+			t++;
+		}
+	}
+	free(buff);
+	if (t != 0) printw("\n");
+}
+
+
+werror pinsStorageLegacy_update (const char *pinID, uint32_t value) {
+	werror  err = WERRCODE_SUCCESS;
+	uint8_t t = 0;
+
+	while (t < counter) {
+		if (strcmp(pinID, pinsDb[t].pin) == 0) break;
+		else                                 t++;
+	}
+
+	if (t < counter) {
+		pinsDb[t].value = value;
+
+	} else if (counter < LEGACY_MAXPINS) {
+		strcpy(pinsDb[counter].pin, pinID);
+		pinsDb[counter].value = value;
+		counter++;
+
+	} else {
+		// ERROR!
+		err = WERRCODE_ERROR_DATAOVERFLOW;
+	}
+	return(err);
+}
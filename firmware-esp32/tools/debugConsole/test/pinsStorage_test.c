@@ -33,9 +33,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 #include <sys/ioctl.h>
 #include <screenUtils.h>
 #include <pinsStorage.h>
+#include <timeUtils.h>
 
 
 int main() {
@@ -48,11 +50,11 @@ int main() {
 		system("clear");
 		ioctl(0, TIOCGWINSZ, &ts);
 		
-		linePrinting('-', ts.ws_col);
-		titlePrinting("PIDs CONSOLE", ts.ws_col);
-		linePrinting('-', ts.ws_col);
-		pinsStorage_print(ts.ws_col);
-		linePrinting('=', ts.ws_col);
+		linePrinting(stdscr, '-', ts.ws_col);
+		titlePrinting(stdscr, "PIDs CONSOLE", ts.ws_col);
+		linePrinting(stdscr, '-', ts.ws_col);
+		pinsStorage_print(stdscr, ts.ws_col);
+		linePrinting(stdscr, '=', ts.ws_col);
 		printf("\n\n");
 		
 		memset(pinid,    '0', sizeof(pinid));
@@ -62,9 +64,17 @@ int main() {
 			loop = false;
 			
 		} else {
+			pinId_t  id;
+			uint32_t tstamp = 0;
+
 			memset(pinvalue, '0', sizeof(pinvalue));
 			printf("PIN's value > "); scanf("%s", pinvalue);
-			if (wErrCode_isError(pinsStorage_update(pinid, atoi(pinvalue)))) {
+			getMyEpoch(&tstamp);
+			if (pinId_fromLabel(pinid, &id) != WERRCODE_SUCCESS) {
+				printf("WARNING! \"%s\" is not a valid pin\n", pinid);
+				sleep(1);
+
+			} else if (wErrCode_isError(pinsStorage_update(id, atoi(pinvalue), tstamp))) {
 				// ERROR!
 				err = 1;
 				loop = false;
@@ -0,0 +1,149 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: ptsCache_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Symbols map announcement check: a map is encoded and split in rows as the firmware does (see ptsMap.h), then it is
+//	received by ptsCache on a device. The pins must be decoded by the announced symbols, and the map must be cached:
+//	another device loads it by the first row only. Lost rows, corrupted rows and normal logs must leave the used map
+//	as it is. The cache is written in a temporary folder ($XDG_CACHE_HOME).
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ptsMap.h>
+#include <ptsCache.h>
+#include "testUtils.h"
+
+#define TEST_CACHEHOME  "/tmp/ptsCache_test"
+#define TEST_PIN        40                 // Pin with another symbol in the announced map
+#define TEST_SYMBOL     "o_ANNOUNCED"
+#define TEST_MAXROWS    (PTSMAP_MAXSIZE / PTSMAP_CHUNKSIZE + 1)
+
+
+static ptsDbItem_t db[PTS_MAXPINID];
+static char        rows[TEST_MAXROWS][PTSMAP_ROWSIZE];
+
+
+static bool symbolIs (pinId_t pin, const char *expected) {
+	// The pin's symbol (NULL: no symbol) must be the expected one
+	const char *symbol;
+	werror     err = pinToSymbol_getById(&symbol, pin);
+
+	return((expected == NULL) ? (err == WERRCODE_WARNING_ITNOTFOUND) : (err == WERRCODE_SUCCESS && strcmp(symbol, expected) == 0));
+}
+
+
+static void selecting (devId_t dev) {
+	pinToSymbol_select(dev);
+	ptsCache_select(dev);
+	return;
+}
+
+
+static uint16_t announcing (devId_t dev, uint16_t first, uint16_t count, uint16_t skip, werror *lastErr, bool *loaded) {
+	// It sends the rows [first, first + count) to the argument defined device (the "skip" row is lost), and it
+	// returns the number of rows consumed as announcement rows
+	uint16_t consumed = 0;
+	bool     flag;
+
+	*loaded = false;
+	selecting(dev);
+	for (uint16_t t = first; t < first + count; t++) {
+		if (t == skip) continue;
+		*lastErr = ptsCache_row(rows[t], &flag);
+		if (*lastErr != WERRCODE_WARNING_ITNOTFOUND) consumed++;
+		*loaded |= flag;
+	}
+	return(consumed);
+}
+
+
+int main () {
+	uint8_t  map[PTSMAP_MAXSIZE];
+	uint32_t size;
+	uint16_t n;
+	char     path[256], bad[PTSMAP_ROWSIZE];
+	werror   err = WERRCODE_SUCCESS;
+	bool     loaded;
+	int      fails = 0;
+
+	// Announced map: many long symbols (several rows), TEST_PIN renamed, the GPIO_NUM_0 symbol removed
+	memset(db, 0, sizeof(db));
+	for (pinId_t p = 1; p < 100; p++) sprintf(db[p].symbol, "o_SYMBOL%u", p);
+	strcpy(db[TEST_PIN].symbol, TEST_SYMBOL);
+
+	size = ptsMap_encode(map, sizeof(map), db, PTS_MAXPINID);
+	n    = ptsMap_rows(size);
+	for (uint16_t t = 0; t < n; t++) ptsMap_row(rows[t], map, size, t);
+	rows[1][strlen(rows[1])] = '\r';                                 // The carriage return (firmware's "\n\r")
+	CHECK(size > 0 && n > 2, "map encoding");
+
+	setenv("XDG_CACHE_HOME", TEST_CACHEHOME, 1);
+	sprintf(path, TEST_CACHEHOME "/" PTSCACHE_DIRNAME "/%08x.ptsmap", (unsigned)ptsMap_hash(map + 8, size - 8));
+	unlink(path);
+
+	// Before the announcement the built-in table is used
+	selecting(0);
+	CHECK(symbolIs(TEST_PIN, "o_STARTENGINE") && symbolIs(0, "i_STARTBUTTON"), "built-in table before the announcement");
+	CHECK(ptsCache_row("I (10) MAIN: MTB_WFR_ST", &loaded) == WERRCODE_WARNING_ITNOTFOUND && loaded == false, "normal logs are not consumed");
+
+	// Device 0: the whole map is received
+	CHECK(announcing(0, 0, n, UINT16_MAX, &err, &loaded) == n && err == WERRCODE_SUCCESS && loaded, "map receiving");
+	CHECK(symbolIs(TEST_PIN, TEST_SYMBOL) && symbolIs(0, NULL) && symbolIs(99, "o_SYMBOL99"), "pins decoded by the announced map");
+	CHECK(ptsCache_count() == 99 && ptsCache_cached() == false, "announced map's info");
+	CHECK(access(path, R_OK) == 0, "map cached by hash");
+
+	// Device 1: the cached map is used at the first row, the other ones are skipped
+	CHECK(announcing(1, 0, 1, UINT16_MAX, &err, &loaded) == 1 && loaded && ptsCache_cached(), "cached map loaded by the first row");
+	CHECK(symbolIs(TEST_PIN, TEST_SYMBOL), "device 1 decoded by the cached map");
+	CHECK(announcing(1, 1, n - 1, UINT16_MAX, &err, &loaded) == n - 1 && err == WERRCODE_SUCCESS && loaded == false, "remaining rows skipped");
+
+	// Device 2 (no cached map): a lost row, then a corrupted one
+	unlink(path);
+	announcing(2, 0, n, 1, &err, &loaded);
+	CHECK(err == WERRCODE_ERROR_INVALIDDATA && loaded == false && symbolIs(TEST_PIN, "o_STARTENGINE"), "lost row: map discarded");
+	strcpy(bad, rows[n - 1]);
+	bad[strlen(bad) - 1] = (bad[strlen(bad) - 1] == '0') ? '1' : '0';
+	strcpy(rows[n - 1], bad);
+	announcing(2, 0, n, UINT16_MAX, &err, &loaded);
+	CHECK(err == WERRCODE_ERROR_INVALIDDATA && loaded == false && symbolIs(TEST_PIN, "o_STARTENGINE"), "corrupted map discarded (hash)");
+	CHECK(ptsCache_row(PTSMAP_ROWMARK "zz 0/1 00", &loaded) == WERRCODE_ERROR_INVALIDDATA, "malformed row");
+
+	// Device 0 is not changed by the others
+	selecting(0);
+	CHECK(symbolIs(TEST_PIN, TEST_SYMBOL) && ptsCache_hash() != 0, "devices' maps are independent");
+
+	unlink(path);
+	rmdir(TEST_CACHEHOME "/" PTSCACHE_DIRNAME);
+	rmdir(TEST_CACHEHOME);
+
+	return(fails);
+}
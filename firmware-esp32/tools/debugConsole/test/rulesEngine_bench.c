@@ -0,0 +1,253 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: rulesEngine_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Alerting rules benchmark: pin updates per second of rulesEngine with BENCH_FEWRULES and with BENCH_MANYRULES
+//	random rules (levels, "for", "in <STATE>" and toggling ones) over BENCH_PINS pins, and of a reference evaluator
+//	that checks every rule from scratch at every update. The violations and clearings raised by the engine are
+//	compared with the reference's ones (rule, status and time-stamp), so the pin index and the deadlines must not
+//	change the rules' meaning.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <rulesEngine.h>
+#include "testUtils.h"
+
+#define BENCH_UPDATES      2000000
+#define BENCH_FEWRULES     10
+#define BENCH_MANYRULES    300
+#define BENCH_PINS         40
+#define BENCH_STATES       4
+#define BENCH_STATEEVERY   500        // A log message (state change) every N updates
+#define BENCH_TARGET       100000     // Min updates/s with BENCH_MANYRULES rules
+#define BENCH_FILE         "/tmp/rulesEngine_bench.rules"
+#define BENCH_UNKNOWN      2          // Level of a pin without updates
+
+// Reference rule
+typedef struct {
+	uint8_t  toggling;
+	uint8_t  conds;
+	uint8_t  pin[RULES_MAXCONDS];
+	uint8_t  level[RULES_MAXCONDS];
+	uint32_t forMs;
+	int8_t   state;                   // -1: any state
+	uint8_t  truth;                   // Reference's runtime
+	uint8_t  active;
+	uint32_t since;
+} refRule_t;
+
+static refRule_t refRules[BENCH_MANYRULES];
+static uint8_t   refLevel[BENCH_PINS];
+static int8_t    refState;               // -2: a state not used by the rules
+static uint64_t  engineSum, refSum;       // Order-independent fingerprints of the alerts
+static uint32_t  engineCount, refCount;
+
+
+static uint64_t fingerprint (uint16_t rule, uint8_t active, uint32_t tstamp) {
+	uint64_t h = ((uint64_t)tstamp << 17) ^ ((uint64_t)rule << 1) ^ active;
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return(h);
+}
+
+
+static void handler (const ruleAlert_t *alert) {
+	engineSum += fingerprint(alert->rule, alert->active, alert->tstamp);
+	engineCount++;
+	return;
+}
+
+
+static int rulesWriting (uint16_t n) {
+	// Random rules, written in the rules file and in the reference's table
+	FILE *fd = fopen(BENCH_FILE, "w");
+
+	if (fd == NULL) return(0);
+	for (uint8_t s = 0; s < BENCH_STATES; s++) fprintf(fd, "state ST_%u entering state %u\n", s, s);
+
+	for (uint16_t r = 0; r < n; r++) {
+		refRule_t *rule = &refRules[r];
+		uint8_t   used[BENCH_PINS] = { 0 };
+
+		memset(rule, 0, sizeof(refRule_t));
+		rule->toggling = (xorshift() % 5 == 0);
+		rule->conds    = 1 + xorshift() % 3;
+		rule->state    = (xorshift() % 3 == 0) ? (int8_t)(xorshift() % BENCH_STATES) : -1;
+		for (uint8_t c = 0; c < rule->conds; c++) {
+			do rule->pin[c] = xorshift() % BENCH_PINS; while (used[rule->pin[c]]);
+			used[rule->pin[c]] = 1;
+			rule->level[c]     = xorshift() % 2;
+
+			if (rule->toggling)
+				fprintf(fd, "%sGPIO_NUM_%u", (c == 0) ? "" : " and ", rule->pin[c]);
+			else
+				fprintf(fd, "%sGPIO_NUM_%u %s", (c == 0) ? "" : (c == 1) ? " while " : " and ", rule->pin[c], rule->level[c] ? "high" : "low");
+		}
+		if (rule->toggling) {
+			fprintf(fd, " toggling");
+		} else if (xorshift() % 2) {
+			rule->forMs = 1 + xorshift() % 200;
+			fprintf(fd, " for > %u ms", rule->forMs);
+		}
+		if (rule->state >= 0) fprintf(fd, " in ST_%u", rule->state);
+		fprintf(fd, "\n");
+	}
+
+	return(fclose(fd) == 0);
+}
+
+
+static void refAlerting (uint16_t r, uint8_t active, uint32_t tstamp) {
+	if (refRules[r].active != active) {
+		refRules[r].active = active;
+		refSum += fingerprint(r, active, tstamp);
+		refCount++;
+	}
+	return;
+}
+
+
+static void refEvaluating (uint16_t n, int pin, uint8_t old, uint32_t tstamp) {
+	// Every rule is evaluated from scratch (pin < 0: state change)
+	for (uint16_t r = 0; r < n; r++) {
+		refRule_t *rule    = &refRules[r];
+		uint8_t   inState  = (rule->state < 0 || rule->state == refState), truth = inState;
+
+		if (rule->toggling) {
+			for (uint8_t c = 0; c < rule->conds; c++) {
+				if (rule->pin[c] == pin && inState && old != BENCH_UNKNOWN) {
+					refAlerting(r, 1, tstamp);
+					rule->since = tstamp;
+				}
+			}
+			if (inState == 0) refAlerting(r, 0, tstamp);
+
+		} else {
+			for (uint8_t c = 0; c < rule->conds && truth; c++) truth = (refLevel[rule->pin[c]] == rule->level[c]);
+			if (truth && rule->truth == 0) rule->since = tstamp;
+			if (truth == 0) refAlerting(r, 0, tstamp);
+			else if (rule->forMs == 0) refAlerting(r, 1, tstamp);
+			rule->truth = truth;
+		}
+	}
+	return;
+}
+
+
+static void refTicking (uint16_t n, uint32_t tstamp) {
+	// Expired times (before the event)
+	for (uint16_t r = 0; r < n; r++) {
+		refRule_t *rule = &refRules[r];
+
+		if (rule->toggling && rule->active && tstamp >= rule->since + RULES_TOGGLEMS) refAlerting(r, 0, tstamp);
+		if (rule->toggling == 0 && rule->truth && rule->forMs > 0 && tstamp > rule->since + rule->forMs) refAlerting(r, 1, tstamp);
+	}
+	return;
+}
+
+
+static double running (uint16_t n, int reference) {
+	// Pseudo-random updates (the same sequence for the engine and the reference), it returns the updates/s
+	uint32_t tstamp = 0, seed = rnd;
+	char     msg[64];
+	double   start;
+
+	memset(refLevel, BENCH_UNKNOWN, sizeof(refLevel));
+	refState = -2;
+	rulesEngine_select(0);
+
+	start = now();
+	for (uint32_t t = 0; t < BENCH_UPDATES; t++) {
+		uint8_t  pin   = xorshift() % BENCH_PINS;
+		uint8_t  value = xorshift() % 2;
+
+		tstamp += xorshift() % 4;
+		if (t % BENCH_STATEEVERY == 0) {
+			uint8_t s = xorshift() % (BENCH_STATES + 1);      // BENCH_STATES: a state not used by the rules
+
+			sprintf(msg, (s < BENCH_STATES) ? "I (%u) MAIN: entering state %u" : "I (%u) MAIN: OTHER_ST", tstamp, s);
+			if (reference) {
+				refTicking(n, tstamp);
+				refState = (s < BENCH_STATES) ? s : -2;
+				refEvaluating(n, -1, 0, tstamp);
+			} else
+				rulesEngine_log(msg, tstamp);
+		}
+
+		if (reference) {
+			uint8_t old = refLevel[pin];
+
+			refTicking(n, tstamp);
+			refLevel[pin] = value;
+			if (old != value) refEvaluating(n, pin, old, tstamp);
+		} else
+			rulesEngine_update(pin, value, tstamp);
+	}
+
+	rnd = seed;
+	return(BENCH_UPDATES / (now() - start));
+}
+
+
+static int comparing (uint16_t n, double *engine, double *reference) {
+	// It runs the engine and the reference on the same updates, and it compares their alerts
+	int ok = rulesWriting(n) && rulesEngine_load(BENCH_FILE, handler) == WERRCODE_SUCCESS && rulesEngine_count() == n;
+
+	engineSum = refSum = 0;
+	engineCount = refCount = 0;
+	if (ok) {
+		*engine    = running(n, 0);
+		*reference = running(n, 1);
+		ok         = (engineSum == refSum && engineCount == refCount && engineCount > 0);
+	}
+	printf("%4u rules: %10.0f updates/s   reference: %10.0f updates/s (x%.1f)   %u alerts (reference: %u)\n",
+	       n, *engine, *reference, *engine / *reference, engineCount, refCount);
+
+	rulesEngine_free();
+	return(ok);
+}
+
+
+int main () {
+	double e1 = 0, r1 = 0, e2 = 0, r2 = 0;
+	int    ok;
+
+	ok  = comparing(BENCH_FEWRULES, &e1, &r1);
+	ok &= comparing(BENCH_MANYRULES, &e2, &r2);
+	unlink(BENCH_FILE);
+
+	printf("%s engine and reference raise the same alerts\n", ok ? "[ OK ]" : "[FAIL]");
+	printf("%s %u rules: %.0f updates/s (target: %u), %.0f%% of the %u rules' throughput\n", (e2 >= BENCH_TARGET) ? "[ OK ]" : "[FAIL]",
+	       BENCH_MANYRULES, e2, BENCH_TARGET, 100 * e2 / e1, BENCH_FEWRULES);
+
+	return((ok && e2 >= BENCH_TARGET) ? 0 : 1);
+}
@@ -0,0 +1,180 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File:   stringBuilder_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	stringBuilder throughput benchmark. A synthetic log stream (colored ESP-IDF logs, pin tracking rows, blank rows
+//	and too long rows) is parsed by the legacy builder (malloc-per-row list) and by the ring-buffer one, using the
+//	console's chunk size and a bigger one. The rows produced by the two builders are compared (hash and number).
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stringBuilder.h>
+#include <stringBuilder_legacy.h>
+#include "testUtils.h"
+
+#define BENCH_STREAMSIZE (16 * 1024 * 1024)
+#define BENCH_ROUNDS     4
+
+typedef struct {
+	uint64_t hash;
+	uint64_t rows;
+} rowsDigest_t;
+
+
+static void digestAdd (rowsDigest_t *d, const char *row, size_t size) {
+	//
+	// Description:
+	//	FNV-1a hash of all the rows (the row separator is included)
+	//
+	for (size_t t=0; t<=size; t++) {
+		d->hash ^= (uint8_t)row[t];
+		d->hash *= 0x100000001b3ULL;
+	}
+	d->rows++;
+	return;
+}
+
+
+static size_t streamBuild (char *stream, size_t size) {
+	//
+	// Description:
+	//	It fills the argument defined buffer with the synthetic log stream, and it returns the used bytes
+	//
+	size_t   len = 0;
+	uint32_t t   = 0;
+	char     row[2048];
+
+	while (1) {
+		int n;
+		switch (t % 8) {
+			case 0:
+			case 1:
+			case 2:
+				n = sprintf(row, "\033[0;32mI (%u) MAIN: MTB_RUNNIG_ST\033[0m\n", t);
+				break;
+			case 3:
+			case 4:
+				n = sprintf(row, "GPIO_NUM_%u:%u\n", t % 47, t % 2);
+				break;
+			case 5:
+				n = sprintf(row, "\033[0;33mW (%u) MAIN: WARNING! battery: %u mV, %u shed loads\033[0m\n", t, 11000 + t % 1000, t % 3);
+				break;
+			case 6:
+				n = sprintf(row, "    \n");
+				break;
+			default:
+				if ((t % 64) == 7) {
+					// Too long row (it is truncated)
+					memset(row, 'x', 1500);
+					row[1500] = '\n';
+					n = 1501;
+				} else
+					n = sprintf(row, "I (%u) keepTrack: output pins refreshed\n", t);
+		}
+		if ((len + n) > size) break;
+		memcpy(stream + len, row, n);
+		len += n;
+		t++;
+	}
+	return(len);
+}
+
+
+static double runLegacy (const char *stream, size_t len, buffSize_t chunk, rowsDigest_t *d) {
+	char   row[BUILDER_MAXSTRINGSIZE];
+	double start = now();
+
+	for (size_t t=0; t<len; t+=chunk) {
+		buffSize_t n = ((len - t) < chunk) ? (len - t) : chunk;
+		if (stringBuilderLegacy_put(stream + t, n) != WERRCODE_SUCCESS) {
+			fprintf(stderr, "ERROR! legacy builder failed\n");
+			exit(1);
+		}
+		while (stringBuilderLegacy_get(row) == WERRCODE_SUCCESS)
+			digestAdd(d, row, strlen(row));
+	}
+	return(now() - start);
+}
+
+
+static double runRing (const char *stream, size_t len, buffSize_t chunk, rowsDigest_t *d) {
+	builderView_t row;
+	double        start = now();
+
+	for (size_t t=0; t<len; t+=chunk) {
+		buffSize_t n = ((len - t) < chunk) ? (len - t) : chunk;
+		if (stringBuilder_put(stream + t, n) != WERRCODE_SUCCESS) {
+			fprintf(stderr, "ERROR! ring builder failed\n");
+			exit(1);
+		}
+		while (stringBuilder_getView(&row) == WERRCODE_SUCCESS)
+			digestAdd(d, row.str, row.size);
+	}
+	return(now() - start);
+}
+
+
+int main () {
+	int        err = 0;
+	char       *stream = malloc(BENCH_STREAMSIZE);
+	size_t     len;
+	buffSize_t chunks[] = { 16, 4096 };
+
+	if (stream == NULL) {
+		// ERROR!
+		fprintf(stderr, "ERROR! Out of memory\n");
+		return(1);
+	}
+	len = streamBuild(stream, BENCH_STREAMSIZE);
+	printf("Stream: %zu bytes, BUILDER_NOSCAPECODES=%d\n", len, BUILDER_NOSCAPECODES);
+
+	for (uint8_t c=0; c<sizeof(chunks)/sizeof(buffSize_t); c++) {
+		rowsDigest_t dl = { 0xcbf29ce484222325ULL, 0 }, dr = { 0xcbf29ce484222325ULL, 0 };
+		double       tl = 0, tr = 0;
+
+		for (uint8_t r=0; r<BENCH_ROUNDS; r++) {
+			tl += runLegacy(stream, len, chunks[c], &dl);
+			tr += runRing(stream, len, chunks[c], &dr);
+		}
+
+		printf("chunk=%5d  legacy: %8.1f MB/s   ring: %8.1f MB/s   (x%.1f)   rows: %lu/%lu %s\n",
+			chunks[c],
+			(len * BENCH_ROUNDS) / tl / 1e6, (len * BENCH_ROUNDS) / tr / 1e6, tl / tr,
+			(unsigned long)dl.rows, (unsigned long)dr.rows,
+			(dl.hash == dr.hash && dl.rows == dr.rows) ? "[ OK ]" : "[FAIL]"
+		);
+		if (dl.hash != dr.hash || dl.rows != dr.rows) err = 1;
+	}
+
+	stringBuilderLegacy_close();
+	stringBuilder_close();
+	free(stream);
+	return(err);
+}
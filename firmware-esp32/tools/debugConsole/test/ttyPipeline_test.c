@@ -0,0 +1,327 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: ttyPipeline_test.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Stress test of the serial pipeline (see ttyPipeline.h). A sender thread writes numbered log lines and pin-states into
+//	a pty pair at TEST_BPS bytes per second, without ever waiting (the bytes refused by the pty are counted as
+//	overruns), while the main thread simulates a slow terminal: it holds the stores' lock for TEST_RENDERMS every
+//	TEST_PERIODMS. The same traffic is sent to a single-threaded reader (the previous design) as reference.
+//	The test fails when a byte is lost, or when a log line is missing or out of order.
+//	Then, a capture file is played (see capturePlayer.h) at TEST_PLAYSPEED and at max speed, and a seek is checked.
+//	Finally, a timed alerting rule (see rulesEngine.h) must be violated while the serial link is quiet.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <termios.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <ttyPipeline.h>
+#include <logsStorage.h>
+#include <pinsStorage.h>
+#include <pinToSymbol.h>
+#include <stringBuilder.h>
+#include <captureFile.h>
+#include <capturePlayer.h>
+#include <rulesEngine.h>
+#include "testUtils.h"
+
+#define TEST_BPS        400000    // ~4 Mbaud
+#define TEST_SECONDS    2
+#define TEST_RENDERMS   200       // Simulated (slow) screen refresh
+#define TEST_PERIODMS   250
+#define TEST_PINEVERY   16        // A pin-state every TEST_PINEVERY lines
+#define TEST_PINLABEL   "GPIO_NUM_4"
+
+#define TEST_CAPFILE    "/tmp/ttyPipeline_test.cap"
+#define TEST_PLAYLINES  500
+#define TEST_PLAYSTEP   2         // Time distance between two recorded lines (ms)
+#define TEST_PLAYSPEED  4
+
+#define TEST_RULESFILE  "/tmp/ttyPipeline_test.rules"
+#define TEST_RULEPIN    "GPIO_NUM_5"
+#define TEST_RULEMS     200       // The rule's pin can be high for this time
+
+
+static int              master, slave;
+static _Atomic bool     sending  = false;
+static uint64_t         sent     = 0;     // Bytes accepted by the pty
+static uint64_t         overruns = 0;     // Bytes refused by the pty
+static uint32_t         seqs     = 0;     // Log lines sent
+static uint32_t         pinValue = 0;     // Last sent pin value
+
+
+static void* sender (void *arg) {
+	//
+	// Description:
+	//	It sends TEST_BPS bytes per second for TEST_SECONDS seconds. A real UART cannot wait for the receiver, so the
+	//	refused bytes are lost
+	//
+	char     line[128];
+	uint64_t start = nowUs(), now;
+	uint32_t n = 0;
+
+	sent = overruns = 0;
+	seqs = pinValue = 0;
+	while ((now = nowUs()) - start < TEST_SECONDS * 1000000ULL) {
+		while ((sent + overruns) < (now - start) * TEST_BPS / 1000000) {
+			int     size;
+			ssize_t nb;
+
+			if ((++n % TEST_PINEVERY) == 0) {
+				pinValue = !pinValue;
+				size = sprintf(line, "%s:%u\n", TEST_PINLABEL, pinValue);
+			} else
+				size = sprintf(line, "I (%llu) MAIN: seq %u the quick brown fox jumps over the lazy dog\n", (unsigned long long)now / 1000, seqs++);
+
+			nb = write(master, line, size);
+			if (nb < 0) nb = 0;
+			sent     += nb;
+			overruns += size - nb;
+		}
+		usleep(1000);
+	}
+	sending = false;
+
+	return(NULL);
+}
+
+
+static bool ptyOpen () {
+	struct termios tio;
+	bool           flag = true;
+
+	master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 || (slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0) {
+		// ERROR!
+		perror("ERROR! pty pair creation failed");
+		flag = false;
+	} else {
+		tcgetattr(slave, &tio);
+		cfmakeraw(&tio);
+		tcsetattr(slave, TCSANOW, &tio);
+	}
+	return(flag);
+}
+
+
+static void reference () {
+	//
+	// Description:
+	//	Single-threaded reader: the serial port is not drained while the screen is refreshed
+	//
+	pthread_t th;
+	char      buff[4096];
+	uint64_t  rx = 0;
+
+	sending = true;
+	pthread_create(&th, NULL, sender, NULL);
+	while (sending) {
+		uint64_t t0 = nowUs();
+		ssize_t  nb;
+
+		while ((nb = read(slave, buff, sizeof(buff))) > 0) rx += nb;
+		usleep(TEST_RENDERMS * 1000);
+		while (nowUs() - t0 < TEST_PERIODMS * 1000) {
+			while ((nb = read(slave, buff, sizeof(buff))) > 0) rx += nb;
+			usleep(1000);
+		}
+	}
+	pthread_join(th, NULL);
+	printf("       reference: %llu bytes sent, %llu bytes lost (%.1f%%)\n", (unsigned long long)sent, (unsigned long long)overruns, 100.0 * overruns / (sent + overruns));
+
+	return;
+}
+
+
+static uint32_t playback (uint32_t expected, uint32_t *firstTime) {
+	//
+	// Description:
+	//	It plays the test capture file, and it returns the time (ms) needed to store the expected number of lines
+	//
+	uint64_t start = nowUs();
+	uint32_t count = 0;
+
+	while (count != expected && nowUs() - start < 3000000) {
+		usleep(1000);
+		ttyPipeline_lock();
+		count = logsStorage_count();
+		if (count > 0) {
+			const char *msg;
+			logsStorage_get(0, &msg, firstTime);
+		}
+		ttyPipeline_unlock();
+	}
+	return((count == expected) ? (nowUs() - start) / 1000 : 0xFFFFFFFF);
+}
+
+
+int main () {
+	int         notifyFD, fails = 0;
+	pthread_t   th;
+	pipeStats_t stats;
+	uint64_t    start;
+	uint32_t    renders = 0, count, expected = 0, value = 0, tstamp;
+	bool        ordered = true;
+	pinId_t     pin;
+	FILE        *fi;
+
+	if (ptyOpen() == false || (notifyFD = eventfd(0, EFD_NONBLOCK)) < 0) {
+		// ERROR!
+		printf("[FAIL] initialization\n");
+		return(1);
+	}
+
+	reference();
+	close(slave);
+	close(master);
+	if (ptyOpen() == false) return(1);
+
+	CHECK(ttyPipeline_start(slave, notifyFD) == WERRCODE_SUCCESS, "ttyPipeline_start()");
+	sending = true;
+	start   = nowUs();
+	pthread_create(&th, NULL, sender, NULL);
+
+	// Slow renderer
+	while (sending) {
+		ttyPipeline_lock();
+		usleep(TEST_RENDERMS * 1000);
+		ttyPipeline_unlock();
+		renders++;
+		usleep((TEST_PERIODMS - TEST_RENDERMS) * 1000);
+	}
+	pthread_join(th, NULL);
+
+	// Pipeline draining
+	do {
+		usleep(10000);
+		ttyPipeline_stats(&stats);
+		ttyPipeline_lock();
+		count = logsStorage_count();
+		ttyPipeline_unlock();
+	} while ((stats.rxBytes < sent || count < seqs) && nowUs() - start < (TEST_SECONDS + 2) * 1000000ULL);
+	ttyPipeline_stop();
+	ttyPipeline_stats(&stats);
+
+	printf(
+		"       pipeline:  %llu bytes sent, %llu bytes lost, %llu rows, %u renders, max queue %u chunks\n",
+		(unsigned long long)sent, (unsigned long long)overruns, (unsigned long long)stats.rows, renders, stats.maxQueue
+	);
+	CHECK(ttyPipeline_error() == WERRCODE_SUCCESS, "no pipeline errors");
+	CHECK(overruns == 0, "no overruns with slow rendering");
+	CHECK(stats.rxBytes == sent, "every sent byte has been read");
+
+	count = logsStorage_count();
+	for (uint32_t t = 0; t < count; t++) {
+		const char *msg;
+		uint32_t   seq;
+
+		if (logsStorage_get(t, &msg, &tstamp) != WERRCODE_SUCCESS || sscanf(msg, "I (%*u) MAIN: seq %u", &seq) != 1 || seq != expected++)
+			ordered = false;
+	}
+	CHECK(count == seqs && ordered, "every log line is stored, in order");
+	CHECK(
+		pinId_fromLabel(TEST_PINLABEL, &pin) == WERRCODE_SUCCESS && pinsStorage_get(pin, &value, &tstamp) == WERRCODE_SUCCESS && value == pinValue,
+		"last pin-state stored"
+	);
+
+	logsStorage_free();
+	stringBuilder_close();
+
+	// Playback: real time x TEST_PLAYSPEED, seek, max speed
+	captureFile_open(TEST_CAPFILE, 115200, "ESP32");
+	for (uint32_t t = 0; t < TEST_PLAYLINES; t++) {
+		char line[64];
+		captureFile_add(t * TEST_PLAYSTEP, line, sprintf(line, "I (%u) MAIN: seq %u\n", t * TEST_PLAYSTEP, t));
+	}
+	captureFile_close();
+
+	if (capturePlayer_open(TEST_CAPFILE, &(captHeader_t){}) == WERRCODE_SUCCESS && ttyPipeline_play(notifyFD, TEST_PLAYSPEED, 0) == WERRCODE_SUCCESS) {
+		uint32_t ms = playback(TEST_PLAYLINES, &tstamp);
+		uint32_t exp = (TEST_PLAYLINES - 1) * TEST_PLAYSTEP / TEST_PLAYSPEED;
+
+		printf("       playback x%u: %u ms (%u ms expected)\n", TEST_PLAYSPEED, ms, exp);
+		CHECK(ms >= exp && ms < exp + 100, "playback speed");
+
+		ttyPipeline_seek(-(int32_t)(ttyPipeline_position() - TEST_PLAYLINES * TEST_PLAYSTEP / 2));
+		ms = playback(TEST_PLAYLINES / 2, &tstamp);
+		CHECK(ms != 0xFFFFFFFF && tstamp == TEST_PLAYLINES * TEST_PLAYSTEP / 2, "playback seek (the previous logs are discarded)");
+		ttyPipeline_stop();
+		logsStorage_free();
+		stringBuilder_close();
+
+		ttyPipeline_play(notifyFD, 0, 0);
+		ms = playback(TEST_PLAYLINES, &tstamp);
+		printf("       playback at max speed: %u ms\n", ms);
+		CHECK(ms < exp / 2, "playback at max speed");
+		ttyPipeline_stop();
+	} else
+		CHECK(false, "playback start");
+
+	capturePlayer_close();
+	unlink(TEST_CAPFILE);
+	logsStorage_free();
+	stringBuilder_close();
+
+	// Timed rule on a quiet link: the pin goes high, then nothing is received
+	if ((fi = fopen(TEST_RULESFILE, "w")) != NULL) {
+		fprintf(fi, "%s high for > %u ms\n", TEST_RULEPIN, TEST_RULEMS);
+		fclose(fi);
+	}
+	CHECK(ttyPipeline_rules(TEST_RULESFILE) == WERRCODE_SUCCESS && ttyPipeline_start(slave, notifyFD) == WERRCODE_SUCCESS, "rules loading");
+	write(master, TEST_RULEPIN ":1\n", strlen(TEST_RULEPIN ":1\n"));
+	start = nowUs();
+	for (count = 0; count == 0 && nowUs() - start < TEST_RULEMS * 5000ULL;) {
+		usleep(10000);
+		ttyPipeline_lock();
+		for (uint32_t t = 0; t < logsStorage_count(); t++) {
+			const char *msg;
+
+			if (logsStorage_get(t, &msg, &tstamp) == WERRCODE_SUCCESS && strstr(msg, RULES_ALERTMARK) != NULL) count++;
+		}
+		ttyPipeline_unlock();
+	}
+	printf("       quiet link alert after %llu ms\n", (unsigned long long)(nowUs() - start) / 1000);
+	CHECK(count == 1 && nowUs() - start >= TEST_RULEMS * 1000ULL, "timed rule violated on a quiet link");
+	ttyPipeline_stop();
+	rulesEngine_free();
+	unlink(TEST_RULESFILE);
+
+	close(notifyFD);
+	close(slave);
+	close(master);
+	return((fails == 0) ? 0 : 1);
+}
@@ -0,0 +1,136 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: waveView_bench.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Waveform pane benchmark: a live session of BENCH_TRANSITIONS transitions of BENCH_TRACES pins (a change per ms,
+//	stamped up to BENCH_LATENCY ms late as the reader would do) is drawn at 25 frames per second, with the columns'
+//	cache (incremental rendering) and with a whole window computing per frame. Every BENCH_CHECKEVERY frames the
+//	incrementally drawn pane is compared with a fully computed one.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ncurses.h>
+#include <pinToSymbol.h>
+#include <pinsHistory.h>
+#include <waveView.h>
+#include "testUtils.h"
+
+#define BENCH_TRANSITIONS  1000000
+#define BENCH_TRACES       8
+#define BENCH_FRAMEMS      40         // 25 fps
+#define BENCH_LATENCY      30         // Max reception delay of a transition (ms)
+#define BENCH_COLS         200        // Screen width
+#define BENCH_CHECKEVERY   500
+#define BENCH_FRAMES       (BENCH_TRANSITIONS / BENCH_FRAMEMS)
+
+
+static void paneReading (WINDOW *win, chtype *buff) {
+	// It copies the pane's contents
+	for (uint16_t r = 0; r < BENCH_TRACES + 2; r++)
+		mvwinchnstr(win, r, 0, buff + r * (BENCH_COLS + 1), BENCH_COLS);
+	return;
+}
+
+
+static double session (WINDOW *win, bool full, uint32_t *checks, uint32_t *errors) {
+	// Live session: the history grows while the pane is drawn. It returns the drawing time per frame (us).
+	static chtype a[(BENCH_TRACES + 2) * (BENCH_COLS + 1)], b[(BENCH_TRACES + 2) * (BENCH_COLS + 1)];
+	uint32_t      values[BENCH_TRACES], frames = 0;
+	double        spent = 0, start;
+
+	rnd = 2463534242;
+	memset(values, 0, sizeof(values));
+	pinsHistory_free();
+	waveView_reset();
+
+	for (uint32_t ms = 1; ms <= BENCH_TRANSITIONS; ms++) {
+		uint32_t pin  = xorshift() % BENCH_TRACES;
+		uint32_t late = xorshift() % BENCH_LATENCY;
+
+		values[pin] ^= 1;
+		pinsHistory_add(pin, values[pin], (ms > late) ? ms - late : 0);
+
+		if (ms % BENCH_FRAMEMS == 0) {
+			if (full) waveView_reset();
+			start = now();
+			waveView_print(win, BENCH_COLS, ms, false);
+			spent += now() - start;
+			frames++;
+
+			if (checks != NULL && frames % BENCH_CHECKEVERY == 0) {
+				paneReading(win, a);
+				waveView_reset();
+				waveView_print(win, BENCH_COLS, ms, true);
+				paneReading(win, b);
+				if (memcmp(a, b, sizeof(a)) != 0) (*errors)++;
+				(*checks)++;
+			}
+		}
+	}
+
+	return(spent * 1e6 / frames);
+}
+
+
+int main () {
+	SCREEN   *scr = newterm("vt100", fopen("/dev/null", "w"), stdin);
+	WINDOW   *win;
+	uint64_t incCols, fullCols;
+	uint32_t checks = 0, errors = 0;
+	double   inc, full;
+	int      err = 0;
+
+	if (scr == NULL || (win = newwin(BENCH_TRACES + 2, BENCH_COLS, 0, 0)) == NULL) {
+		// ERROR!
+		fprintf(stderr, "ERROR! ncurses initialization failed\n");
+		return(1);
+	}
+	for (uint8_t t = 0; t < BENCH_TRACES; t++) {
+		char label[PTS_PINLABSIZE];
+
+		pinId_toLabel(label, t);
+		if (waveView_trace(label) != WERRCODE_SUCCESS) err = 1;
+	}
+
+	inc      = session(win, false, &checks, &errors);
+	incCols  = waveView_computed();
+	full     = session(win, true, NULL, NULL);
+	fullCols = waveView_computed() - incCols;
+	endwin();
+	delscreen(scr);
+
+	printf("[%s] %u traces: %u incremental frames compared with the fully computed ones, %u differences\n", (err || errors) ? "FAIL" : " OK ", BENCH_TRACES, checks, errors);
+	printf("incremental:  %7.1f us/frame   %6.1f columns computed per frame\n", inc, (double)incCols / BENCH_FRAMES);
+	printf("full window:  %7.1f us/frame   %6.1f columns computed per frame\n", full, (double)fullCols / BENCH_FRAMES);
+	printf("speed-up:     %7.1fx\n", full / inc);
+	pinsHistory_free();
+
+	return(err || errors);
+}
@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: timeUtils.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Time related helpers shared by the debugConsole's modules
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stddef.h>
+#include <time.h>
+#include <timeUtils.h>
+
+
+werror getMyEpoch(uint32_t *tstamp) {
+	//
+	// Description:
+	//	It returns a time-stamp in milliseconds, the first call is the time zero. The CLOCK_MONOTONIC clock is used,
+	//	so the time-stamps never go back (e.g. NTP adjustments)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS            Success
+	//	WERRCODE_ERROR_TIMESYNC     clock_gettime() failed
+	//
+	werror          err = WERRCODE_SUCCESS;
+	static uint64_t tZero = 0;
+	struct timespec ts = {0, 0};
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		// ERROR!
+		err = WERRCODE_ERROR_TIMESYNC;
+		
+	else if (tZero == 0) {
+		tZero = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+		*tstamp = 0;
+		
+	} else 
+		*tstamp = ((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000) - tZero;
+	
+	return(err);
+}
+
+
+uint64_t monotonicMs () {
+	//
+	// Description:
+	//	It returns the CLOCK_MONOTONIC time in milliseconds (it is not affected by the system-time changes)
+	//
+	struct timespec ts = {0, 0};
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
@@ -0,0 +1,793 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: ttyPipeline.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Serial data pipeline of the debugConsole. It runs two threads:
+//		reader:  it drains the serial port into the SPSC queue (see spscQueue.h), it never waits for the others
+//		parser:  it records the chunks (when a capture file has been opened, see captureFile.h), it splits them in
+//		         rows, and it updates pinsStorage and logsStorage
+//	The renderer (the main thread) is notified through the argument defined eventfd when the stores have changed, and
+//	it has to hold the pipeline's lock (ttyPipeline_lock()) while it reads them. A slow terminal can only delay the
+//	parser, while the reader goes on draining the serial port, so the kernel's tty buffer never overruns.
+//	In playback mode (ttyPipeline_play()) the reader is replaced by the player thread, that feeds the capture file's
+//	records (see capturePlayer.h) to the parser at the requested speed.
+//	Several serial ports can be monitored (ttyPipeline_startMulti()): the reader serves them with a single poll(),
+//	the chunks carry their device, and the parser updates the stores instance of that device (see devices.h).
+//	In headless mode (jsonOutput_open() called before the start) the parser writes the rows as JSON lines in place
+//	of updating the stores.
+//	When the broker has been started (see broker.h) the parser forwards every raw chunk to its clients too.
+//	The pin-symbol maps announced by the firmware are collected by the parser too, every device has its own (see
+//	ptsCache.h).
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <syslog.h>
+#include <sys/eventfd.h>
+#include <spscQueue.h>
+#include <stringBuilder.h>
+#include <pinToSymbol.h>
+#include <pinsStorage.h>
+#include <logsStorage.h>
+#include <pinsHistory.h>
+#include <timeUtils.h>
+#include <captureFile.h>
+#include <capturePlayer.h>
+#include <jsonOutput.h>
+#include <rulesEngine.h>
+#include <ptsCache.h>
+#include <broker.h>
+#include <ttyPipeline.h>
+
+#define PIPE_FULLWAITUS  1000            // Reader's wait time when the queue is full
+#define PIPE_PLAYTICKMS  50              // Player's max wait time (seek requests polling)
+#define PIPE_MAXWAITMS   60000           // Parser's max wait time for a rules' deadline
+
+static pthread_t        readerTh, parserTh;
+static pthread_mutex_t  storesMtx = PTHREAD_MUTEX_INITIALIZER;
+static int              ttyFds[DEV_MAXDEVICES];
+static uint8_t          devices   = 1;      // Number of serial ports
+static bool             live      = true;   // Serial ports' data (false: capture playback)
+static devId_t          viewDev   = 0;      // Device whose stores are selected by ttyPipeline_lock()
+static _Atomic uint32_t activity  = 0;      // Devices whose stores have changed (bitmap, see ttyPipeline_activity())
+static int              notifyFd  = -1;     // Renderer's eventfd
+static int              parseFd   = -1;     // Parser's eventfd (new chunks)
+static int              stopFd    = -1;     // Threads' stop request
+static _Atomic werror   pipeErr   = WERRCODE_SUCCESS;
+static _Atomic uint64_t rxBytes   = 0;
+static _Atomic uint64_t rows      = 0;
+static _Atomic uint32_t maxQueue  = 0;
+static _Atomic uint32_t fullCnt   = 0;
+static uint32_t         playSpeed = 1;      // Playback speed (0: max speed)
+static _Atomic uint32_t playPos   = 0;      // Time-stamp of the last played record
+static _Atomic int64_t  seekReq   = -1;     // Playback's seek request (time-stamp)
+static _Atomic bool     playEnd   = false;  // The whole capture file has been played
+
+
+static void pipeFailure (werror err) {
+	//
+	// Description:
+	//	It records the first error, and it wakes the renderer up
+	//
+	werror expected = WERRCODE_SUCCESS;
+
+	atomic_compare_exchange_strong(&pipeErr, &expected, err);
+	eventfd_write(notifyFd, 1);
+
+	return;
+}
+
+
+static void alertHandler (const ruleAlert_t *alert) {
+	//
+	// Description:
+	//	Alerting rules' handler: the violations (and their clearing) are stored as log messages, and the rule's pins
+	//	are highlighted (headless mode: the message is written as JSON line). It is called by rowParsing(), so the
+	//	stores are already locked and selected.
+	//
+	char msg[RULES_TEXTSIZE + 64];
+	int  n = snprintf(
+		msg, sizeof(msg), "%s rule at line %u %s: %s", alert->active ? RULES_ALERTMARK : "[ OK ]", alert->line,
+		alert->active ? "violated" : "cleared", alert->text
+	);
+
+	if (jsonOutput_isOpen()) {
+		if (wErrCode_isError(jsonOutput_log(alert->tstamp, msg, n))) pipeFailure(WERRCODE_ERROR_IOOPERFAILED);
+
+	} else {
+		if (wErrCode_isError(logsStorage_add(msg, n, alert->tstamp)))
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! I cannot store further new logs", __LINE__);
+		for (uint8_t t = 0; t < alert->pins; t++) pinsStorage_alert(alert->pin[t], alert->active);
+	}
+	return;
+}
+
+
+static void mapLoading (uint32_t tstamp) {
+	//
+	// Description:
+	//	The firmware has announced its pin-symbol map (see ptsCache.h): the pins already shown are resolved again, and
+	//	the event is reported as log message (headless mode: as JSON line). The caller has to hold storesMtx.
+	//
+	char msg[64];
+	int  n = snprintf(
+		msg, sizeof(msg), "Symbols map %08x: %u symbols%s", (unsigned)ptsCache_hash(), ptsCache_count(),
+		ptsCache_cached() ? " (cached)" : ""
+	);
+
+	if (jsonOutput_isOpen()) {
+		if (wErrCode_isError(jsonOutput_log(tstamp, msg, n))) pipeFailure(WERRCODE_ERROR_IOOPERFAILED);
+
+	} else {
+		pinsStorage_resolve();
+		if (wErrCode_isError(logsStorage_add(msg, n, tstamp)))
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! I cannot store further new logs", __LINE__);
+	}
+	return;
+}
+
+
+static void rowParsing (const builderView_t *row, uint32_t tstamp) {
+	//
+	// Description:
+	//	It stores the argument defined row as pin-state or as log message (headless mode: it is written as JSON line).
+	//	The symbols map announcement's rows are not stored (see ptsCache.h). The caller has to hold storesMtx.
+	//
+	int     value = 0;                // PIN's value
+	pinId_t pinId = 0;                // Numeric pin-ID
+	char    pin[PTS_PINLABSIZE];
+	bool    isPin, loaded;
+	werror  err   = ptsCache_row(row->str, &loaded);
+
+	if (err != WERRCODE_WARNING_ITNOTFOUND) {
+		// Symbols map announcement
+		if (err == WERRCODE_ERROR_INVALIDDATA)
+			// WARNING!
+			syslog(LOG_WARNING, "WARNING(%d)! Invalid symbols map row: \"%s\"", __LINE__, row->str);
+		else if (loaded)
+			mapLoading(tstamp);
+		rows++;
+		return;
+	}
+
+	err = pinDef_get(row->str, &pinId, &value);
+	if (err == WERRCODE_ERROR_INVALIDDATA) {
+		// WARNING! Out of range pin or value: the row is shown as a normal log
+		syslog(LOG_WARNING, "WARNING(%d)! Invalid pin definition: \"%s\"", __LINE__, row->str);
+		err = WERRCODE_WARNING_ITNOTFOUND;
+	}
+	isPin = (err == WERRCODE_SUCCESS);
+
+	if (jsonOutput_isOpen()) {
+		// Headless mode
+		if (err == WERRCODE_SUCCESS)
+			err = jsonOutput_pin(tstamp, pinId, value);
+		else if (err == WERRCODE_WARNING_ITNOTFOUND)
+			err = jsonOutput_log(tstamp, row->str, row->size);
+
+		if (wErrCode_isError(err)) pipeFailure(err);
+
+	} else if (err == WERRCODE_SUCCESS) {
+		// Keeping-track info
+		if (wErrCode_isError(pinsStorage_update(pinId, value, tstamp))) {
+			// ERROR!
+			pinId_toLabel(pin, pinId);
+			syslog(LOG_ERR, "ERROR(%d)! I cannot add the \"%s\" pin to the moniotored ones", __LINE__, pin);
+
+		} else if (wErrCode_isError(pinsHistory_add(pinId, value, tstamp))) {
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! I cannot store further pin changes", __LINE__);
+		}
+
+	} else if (err == WERRCODE_WARNING_ITNOTFOUND) {
+		if (wErrCode_isError(logsStorage_add(row->str, row->size, tstamp)))
+			// ERROR!
+			syslog(LOG_ERR, "ERROR(%d)! I cannot store further new logs", __LINE__);
+
+	} else {
+		// ERROR!
+		syslog(LOG_ERR, "ERROR(%d)! pinDef_get() failed", __LINE__);
+	}
+
+	// Alerting rules (the violations are reported by alertHandler())
+	if (isPin) rulesEngine_update(pinId, value, tstamp);
+	else       rulesEngine_log(row->str, tstamp);
+	rows++;
+
+	return;
+}
+
+
+static void storesSelecting (devId_t dev) {
+	//
+	// Description:
+	//	It selects the stores of the argument defined device. The caller has to hold storesMtx.
+	//
+	stringBuilder_select(dev);
+	pinsStorage_select(dev);
+	pinsHistory_select(dev);
+	logsStorage_select(dev);
+	rulesEngine_select(dev);
+	pinToSymbol_select(dev);
+	ptsCache_select(dev);
+
+	return;
+}
+
+
+static void chunkCommitting (uint32_t size) {
+	//
+	// Description:
+	//	It makes the reserved chunk available to the parser, and it wakes the parser up
+	//
+	uint32_t used;
+
+	spscQueue_commit();
+	rxBytes += size;
+
+	used = spscQueue_used();
+	if (used > maxQueue) maxQueue = used;
+	eventfd_write(parseFd, 1);
+
+	return;
+}
+
+
+static void* readerThread (void *arg) {
+	//
+	// Description:
+	//	It moves the serial ports' data into the queue, as soon as they are received. All the devices are served by
+	//	a single poll() call. A device whose source has been closed is excluded, and the pipeline fails when there are
+	//	no more devices.
+	//
+	struct pollfd pfds[DEV_MAXDEVICES + 1];
+	uint8_t       alive = devices;
+	bool          loop  = true;
+
+	pfds[0] = (struct pollfd){ stopFd, POLLIN, 0 };
+	for (devId_t d = 0; d < devices; d++) pfds[d + 1] = (struct pollfd){ ttyFds[d], POLLIN, 0 };
+
+	while (loop) {
+		if (poll(pfds, devices + 1, -1) < 0) {
+			if (errno != EINTR) {
+				// ERROR!
+				syslog(LOG_ERR, "ERROR(%d)! poll() failed: %s", __LINE__, strerror(errno));
+				pipeFailure(WERRCODE_ERROR_SYSCALL);
+				loop = false;
+			}
+
+		} else if (pfds[0].revents & POLLIN) {
+			loop = false;
+
+		} else {
+			for (devId_t d = 0; d < devices && loop; d++) {
+				spscChunk_t *chunk;
+				ssize_t     nb;
+
+				if (pfds[d + 1].revents == 0) {
+					// Nothing to read
+
+				} else if ((chunk = spscQueue_reserve()) == NULL) {
+					// WARNING! The parser is late (the queue is full): the device will be read after the next poll()
+					fullCnt++;
+					usleep(PIPE_FULLWAITUS);
+
+				} else if (
+					((nb = read(pfds[d + 1].fd, chunk->data, SPSC_CHUNKSIZE)) < 0 && errno != EAGAIN && errno != EINTR) ||
+					(nb == 0 && (pfds[d + 1].revents & POLLHUP))
+				) {
+					// ERROR! Reading failure, or the peer has gone (e.g. broker closed)
+					syslog(LOG_ERR, "ERROR(%d)! device %u: the data source has been closed (%s)", __LINE__, d, (nb < 0) ? strerror(errno) : "EOF");
+					pfds[d + 1].fd = -1;
+					if (--alive == 0) {
+						pipeFailure(WERRCODE_ERROR_IOOPERFAILED);
+						loop = false;
+					}
+
+				} else if (nb > 0) {
+					chunk->size = nb;
+					chunk->dev  = d;
+					getMyEpoch(&chunk->tstamp);
+					chunkCommitting(nb);
+				}
+			}
+		}
+	}
+
+	return(NULL);
+}
+
+
+static void* playerThread (void *arg) {
+	//
+	// Description:
+	//	It moves the capture file's records into the queue, at the original pace multiplied by playSpeed (0: max
+	//	speed). The chunks keep the recorded time-stamps. After a seek request, an empty chunk tells the parser to
+	//	discard the stored logs and the open row.
+	//
+	struct pollfd pfd    = { stopFd, POLLIN, 0 };
+	const uint8_t *data  = NULL;
+	uint32_t      tstamp = 0, size = 0;
+	uint32_t      done   = 0;                // Bytes of the current record already queued
+	uint32_t      base   = playPos;          // Capture's time played at t0
+	uint64_t      t0     = monotonicMs();
+	bool          reset  = false;
+	bool          loop   = true;
+
+	capturePlayer_seek(base);
+	while (loop) {
+		int64_t     req  = atomic_exchange(&seekReq, -1);
+		int         wait = PIPE_PLAYTICKMS;
+		spscChunk_t *chunk;
+
+		if (req >= 0) {
+			playEnd = false;
+			capturePlayer_seek(req);
+			base    = playPos = req;
+			t0      = monotonicMs();
+			data    = NULL;
+			done    = 0;
+			reset   = true;
+		}
+
+		if (data == NULL && reset == false && capturePlayer_next(&tstamp, &data, &size) != WERRCODE_SUCCESS) {
+			// End of the capture: the player waits for a seek or for the stop request. The renderer is notified
+			// when the parser has processed every chunk.
+			data = NULL;
+			if (playEnd == false && spscQueue_used() == 0) {
+				playEnd = true;
+				eventfd_write(notifyFd, 1);
+			}
+
+		} else if (playSpeed != 0 && reset == false && tstamp > base && t0 + (tstamp - base) / playSpeed > monotonicMs()) {
+			// Pacing
+			wait = t0 + (tstamp - base) / playSpeed - monotonicMs();
+			if (wait > PIPE_PLAYTICKMS) wait = PIPE_PLAYTICKMS;
+
+		} else if ((chunk = spscQueue_reserve()) == NULL) {
+			// WARNING! The parser is late (the queue is full)
+			fullCnt++;
+			wait = 1;
+
+		} else if (reset) {
+			chunk->size   = 0;
+			chunk->dev    = 0;
+			chunk->tstamp = base;
+			chunkCommitting(0);
+			reset = false;
+			wait  = 0;
+
+		} else {
+			// The records bigger than a chunk are split
+			chunk->size   = (size - done > SPSC_CHUNKSIZE) ? SPSC_CHUNKSIZE : size - done;
+			chunk->dev    = 0;
+			chunk->tstamp = tstamp;
+			memcpy(chunk->data, data + done, chunk->size);
+			chunkCommitting(chunk->size);
+
+			done += chunk->size;
+			if (done == size) {
+				data = NULL;
+				done = 0;
+			}
+			playPos = tstamp;
+			wait    = 0;
+		}
+
+		if (poll(&pfd, 1, wait) > 0) loop = false;
+	}
+
+	return(NULL);
+}
+
+
+static int rulesTimeout () {
+	//
+	// Description:
+	//	It returns the time (ms) up to the devices' nearest rules deadline (-1: no deadline). The playback's rules
+	//	are checked by the records' time-stamps only.
+	//
+	uint32_t next = RULES_NODEADLINE, now;
+
+	if (live == false || rulesEngine_isOn() == false) return(-1);
+
+	pthread_mutex_lock(&storesMtx);
+	for (devId_t d = 0; d < devices; d++) {
+		rulesEngine_select(d);
+		if (rulesEngine_nextDeadline() < next) next = rulesEngine_nextDeadline();
+	}
+	rulesEngine_select(viewDev);
+	pthread_mutex_unlock(&storesMtx);
+
+	if (next == RULES_NODEADLINE || getMyEpoch(&now) != WERRCODE_SUCCESS) return(-1);
+	if (next <= now) return(0);
+
+	return((next - now > PIPE_MAXWAITMS) ? PIPE_MAXWAITMS : next - now);
+}
+
+
+static void rulesTicking () {
+	//
+	// Description:
+	//	The expired rules' deadlines of the devices are handled by the current time, so a quiet serial link does not
+	//	delay the alerts (e.g. a pin stuck high while the firmware is hung). The queued chunks have to be parsed
+	//	before, their time-stamps are older.
+	//
+	uint32_t now;
+	bool     ticked = false;
+
+	if (live == false || rulesEngine_isOn() == false || getMyEpoch(&now) != WERRCODE_SUCCESS) return;
+
+	pthread_mutex_lock(&storesMtx);
+	for (devId_t d = 0; d < devices; d++) {
+		rulesEngine_select(d);
+		if (rulesEngine_nextDeadline() <= now) {
+			storesSelecting(d);
+			rulesEngine_tick(now);
+			ticked = true;
+		}
+	}
+	storesSelecting(viewDev);
+	pthread_mutex_unlock(&storesMtx);
+
+	if (ticked) {
+		if (jsonOutput_isOpen() && wErrCode_isError(jsonOutput_flush())) pipeFailure(WERRCODE_ERROR_IOOPERFAILED);
+		eventfd_write(notifyFd, 1);
+	}
+
+	return;
+}
+
+
+static void* parserThread (void *arg) {
+	//
+	// Description:
+	//	It splits the queued chunks in rows, and it updates the stores. While the serial links are quiet, it wakes up
+	//	at the rules' nearest deadline.
+	//
+	struct pollfd pfds[2] = { { parseFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+	bool          loop    = true;
+	int           n;
+
+	while (loop) {
+		if ((n = poll(pfds, 2, rulesTimeout())) < 0 && errno != EINTR) {
+			// ERROR!
+			pipeFailure(WERRCODE_ERROR_SYSCALL);
+			loop = false;
+
+		} else if (n == 0) {
+			// Timeout: a rules' deadline has expired (no chunk is pending)
+			if (spscQueue_front() == NULL) rulesTicking();
+
+		} else if (pfds[1].revents & POLLIN) {
+			loop = false;
+
+		} else if (pfds[0].revents & POLLIN) {
+			spscChunk_t *chunk;
+			eventfd_t   cnt;
+			bool        changed = false;
+
+			eventfd_read(parseFd, &cnt);
+
+			while ((chunk = spscQueue_front()) != NULL) {
+				builderView_t row;
+
+				if (chunk->size == 0) {
+					// Playback's seek: the logs and the pins' history of the previous position and the open row are
+					// discarded (the pins keep their last values)
+					pthread_mutex_lock(&storesMtx);
+					storesSelecting(chunk->dev);
+					stringBuilder_close();
+					logsStorage_free();
+					pinsHistory_free();
+					pthread_mutex_unlock(&storesMtx);
+					changed = true;
+				}
+
+				// Recording (the capture file is written by this thread, so the reader is never slowed down)
+				if (wErrCode_isError(captureFile_add(chunk->tstamp, chunk->data, chunk->size))) {
+					// ERROR!
+					syslog(LOG_ERR, "ERROR(%d)! Capture file writing failed", __LINE__);
+					pipeFailure(WERRCODE_ERROR_IOOPERFAILED);
+					loop = false;
+				}
+
+				// Fan-out to the broker's clients (it never waits for them)
+				broker_publish(chunk->data, chunk->size);
+
+				pthread_mutex_lock(&storesMtx);
+				storesSelecting(chunk->dev);
+				if (wErrCode_isError(stringBuilder_put(chunk->data, chunk->size))) {
+					// ERROR!
+					syslog(LOG_ERR, "ERROR(%d)! Out of memory", __LINE__);
+					pipeFailure(WERRCODE_ERROR_OUTOFMEMORY);
+					loop = false;
+				}
+				// The timed rules are checked even when the chunk completes no row
+				rulesEngine_tick(chunk->tstamp);
+
+				// The rows are zero-copy views, valid until the next stringBuilder_put() call
+				while (stringBuilder_getView(&row) == WERRCODE_SUCCESS) {
+					rowParsing(&row, chunk->tstamp);
+					changed   = true;
+					activity |= 1u << chunk->dev;
+				}
+				storesSelecting(viewDev);
+				pthread_mutex_unlock(&storesMtx);
+				spscQueue_release();
+			}
+			// The other devices' links can be quiet
+			rulesTicking();
+
+			if (jsonOutput_isOpen() && wErrCode_isError(jsonOutput_flush())) {
+				// ERROR!
+				pipeFailure(WERRCODE_ERROR_IOOPERFAILED);
+				loop = false;
+			}
+			if (changed) eventfd_write(notifyFd, 1);
+		}
+	}
+
+	return(NULL);
+}
+
+static werror pipelineStarting (void* (*feeder)(void*), int notifyFD) {
+	//
+	// Description:
+	//	It starts the parser thread and the argument defined feeder thread (serial port reader or capture player)
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_SYSCALL
+	//
+	werror   err = WERRCODE_SUCCESS;
+	uint32_t tstamp;
+
+	notifyFd = notifyFD;
+	pipeErr  = WERRCODE_SUCCESS;
+	rxBytes  = rows = 0;
+	maxQueue = fullCnt = 0;
+	seekReq  = -1;
+	playEnd  = false;
+	activity = 0;
+
+	// The time zero has to be set before the threads start
+	getMyEpoch(&tstamp);
+
+	if ((parseFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0 || (stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! eventfd() failed: %s\n", strerror(errno));
+		err = WERRCODE_ERROR_SYSCALL;
+
+	} else if (pthread_create(&parserTh, NULL, parserThread, NULL) != 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! I cannot create the parser thread\n");
+		err = WERRCODE_ERROR_SYSCALL;
+
+	} else if (pthread_create(&readerTh, NULL, feeder, NULL) != 0) {
+		// ERROR!
+		fprintf(stderr, "ERROR! I cannot create the reader thread\n");
+		eventfd_write(stopFd, 1);
+		pthread_join(parserTh, NULL);
+		err = WERRCODE_ERROR_SYSCALL;
+	}
+
+	return(err);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+werror ttyPipeline_rules (const char *path) {
+	//
+	// Description:
+	//	It loads the argument defined alerting rules file (see rulesEngine.h): the parser checks them on every row, and
+	//	the violations are reported in the logs section (headless mode: as JSON lines). It must be called before the
+	//	pipeline's start.
+	//
+	// Returned value:
+	//	see rulesEngine_load()
+	//
+	return(rulesEngine_load(path, alertHandler));
+}
+
+
+werror ttyPipeline_start (int ttyFD, int notifyFD) {
+	//
+	// Description:
+	//	It starts the reader and the parser threads. The serial port's fd should be non-blocking.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_SYSCALL
+	//
+	return(ttyPipeline_startMulti(&ttyFD, 1, notifyFD));
+}
+
+
+werror ttyPipeline_startMulti (const int *ttyFDs, uint8_t devs, int notifyFD) {
+	//
+	// Description:
+	//	It starts the reader and the parser threads for the argument defined serial ports (non-blocking fds). The
+	//	data of the n-th port update the stores of the n-th device (see devices.h).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG     No devices, or too many devices
+	//	WERRCODE_ERROR_SYSCALL
+	//
+	werror err = WERRCODE_ERROR_ILLEGALARG;
+
+	if (devs > 0 && devs <= DEV_MAXDEVICES) {
+		memcpy(ttyFds, ttyFDs, devs * sizeof(int));
+		devices = devs;
+		live    = true;
+		err     = pipelineStarting(readerThread, notifyFD);
+	}
+
+	return(err);
+}
+
+
+werror ttyPipeline_play (int notifyFD, uint32_t speed, uint32_t start) {
+	//
+	// Description:
+	//	It starts the player and the parser threads. The capture file has to be opened by capturePlayer_open(), and
+	//	it is played from the argument defined time-stamp (ms), at the argument defined speed (1 = real time, N = N
+	//	times faster, 0 = max speed).
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_SYSCALL
+	//
+	playSpeed = speed;
+	playPos   = start;
+	devices   = 1;
+	live      = false;
+
+	return(pipelineStarting(playerThread, notifyFD));
+}
+
+
+void ttyPipeline_seek (int32_t delta) {
+	//
+	// Description:
+	//	It moves the playback position by the argument defined time (ms)
+	//
+	int64_t req = (int64_t)playPos + delta;
+
+	seekReq = (req < 0) ? 0 : req;
+
+	return;
+}
+
+
+bool ttyPipeline_ended () {
+	//
+	// Description:
+	//	It returns true when the whole capture file has been played and parsed
+	//
+	return(playEnd);
+}
+
+
+uint32_t ttyPipeline_position () {
+	//
+	// Description:
+	//	It returns the time-stamp of the last played record (ms)
+	//
+	return(playPos);
+}
+
+
+void ttyPipeline_stop () {
+	//
+	// Description:
+	//	It stops the threads and it waits for them. The data still in the queue are dropped.
+	//
+	eventfd_write(stopFd, 1);
+	pthread_join(readerTh, NULL);
+	pthread_join(parserTh, NULL);
+	close(parseFd);
+	close(stopFd);
+
+	while (spscQueue_front() != NULL) spscQueue_release();
+
+	return;
+}
+
+
+werror ttyPipeline_error () {
+	//
+	// Description:
+	//	It returns the first error detected by the threads (WERRCODE_SUCCESS when everything is fine)
+	//
+	return(pipeErr);
+}
+
+
+void ttyPipeline_lock () {
+	//
+	// Description:
+	//	The stores (pinsStorage, logsStorage) cannot be modified until ttyPipeline_unlock() is called. The stores of
+	//	the viewed device (see ttyPipeline_view()) are selected.
+	//
+	pthread_mutex_lock(&storesMtx);
+	storesSelecting(viewDev);
+
+	return;
+}
+
+
+void ttyPipeline_unlock () {
+	pthread_mutex_unlock(&storesMtx);
+
+	return;
+}
+
+
+void ttyPipeline_view (devId_t dev) {
+	//
+	// Description:
+	//	It sets the device whose stores are selected by ttyPipeline_lock() (the device 0 by default)
+	//
+	pthread_mutex_lock(&storesMtx);
+	viewDev = (dev < DEV_MAXDEVICES) ? dev : 0;
+	pthread_mutex_unlock(&storesMtx);
+
+	return;
+}
+
+
+uint32_t ttyPipeline_activity () {
+	//
+	// Description:
+	//	It returns the devices (bitmap) whose stores have been changed since the previous call
+	//
+	return(atomic_exchange(&activity, 0));
+}
+
+
+void ttyPipeline_stats (pipeStats_t *stats) {
+	//
+	// Description:
+	//	It returns the pipeline's counters
+	//
+	stats->rxBytes    = rxBytes;
+	stats->rows       = rows;
+	stats->maxQueue   = maxQueue;
+	stats->fullEvents = fullCnt;
+
+	return;
+}
@@ -0,0 +1,71 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: ttyPipeline.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Serial data pipeline of the debugConsole. It runs two threads:
+//		reader:  it drains the serial port into the SPSC queue (see spscQueue.h), it never waits for the others
+//		parser:  it records the chunks (when a capture file has been opened, see captureFile.h), it splits them in
+//		         rows, and it updates pinsStorage and logsStorage
+//	The renderer (the main thread) is notified through the argument defined eventfd when the stores have changed, and
+//	it has to hold the pipeline's lock (ttyPipeline_lock()) while it reads them. A slow terminal can only delay the
+//	parser, while the reader goes on draining the serial port, so the kernel's tty buffer never overruns.
+//	In playback mode (ttyPipeline_play()) the reader is replaced by the player thread, that feeds the capture file's
+//	records (see capturePlayer.h) to the parser at the requested speed.
+//	In headless mode (jsonOutput_open() called before the start) the parser writes the rows as JSON lines in place
+//	of updating the stores.
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef TTYPIPELINE_UT
+#define TTYPIPELINE_UT
+
+#include <stdint.h>
+#include <werror.h>
+#include <devices.h>
+
+// Pipeline's counters
+typedef struct {
+	uint64_t rxBytes;                 // Bytes read from the serial port
+	uint64_t rows;                    // Parsed rows
+	uint32_t maxQueue;                // Max number of chunks in the queue
+	uint32_t fullEvents;              // Number of times the reader found the queue full
+} pipeStats_t;
+
+werror   ttyPipeline_rules      (const char *path);
+werror   ttyPipeline_start      (int ttyFD, int notifyFD);
+werror   ttyPipeline_startMulti (const int *ttyFDs, uint8_t devs, int notifyFD);
+werror   ttyPipeline_play       (int notifyFD, uint32_t speed, uint32_t start);
+void     ttyPipeline_seek       (int32_t delta);
+uint32_t ttyPipeline_position   ();
+bool     ttyPipeline_ended      ();
+void     ttyPipeline_stop       ();
+werror   ttyPipeline_error      ();
+void     ttyPipeline_lock       ();
+void     ttyPipeline_unlock     ();
+void     ttyPipeline_view       (devId_t dev);
+uint32_t ttyPipeline_activity   ();
+void     ttyPipeline_stats      (pipeStats_t *stats);
+
+#endif
@@ -0,0 +1,444 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: waveView.c
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Logic-analyzer style pane (see waveView.h). The pins' values are read from the displayed device's history
+//	(pinsHistory.h), so the caller has to hold the pipeline's lock (ttyPipeline_lock()) while it calls this module.
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <pinToSymbol.h>
+#include <pinsHistory.h>
+#include <waveView.h>
+
+#define WAVE_MINZOOM     1            // Min ms per column
+#define WAVE_MAXZOOM     60000        // Max ms per column
+#define WAVE_DEFZOOM     10
+#define WAVE_TICKCOLS    10           // Time axis' ticks distance (columns)
+
+// Column's level
+typedef enum {
+	WAVE_NONE = 0,                    // No samples yet
+	WAVE_LOW,
+	WAVE_HIGH,
+	WAVE_EDGE,                        // A single transition
+	WAVE_MULTI                        // Several transitions
+} waveLevel_t;
+
+// Displayed pin
+typedef struct {
+	pinId_t  pin;
+	char     label[32];
+	uint64_t count;                   // History's transitions when the columns were computed
+	uint32_t lastTs;                  // Newest transition read by the columns computing
+	uint8_t  cols[WAVE_MAXCOLS];      // Columns' levels cache (waveLevel_t)
+} waveTrace_t;
+
+static waveTrace_t traces[WAVE_MAXTRACES];
+static uint8_t     nTraces  = 0;
+static bool        autoPins = true;            // No waveView_trace() calls: the first pins with a history are shown
+static uint32_t    msPerCol = WAVE_DEFZOOM;
+static bool        live     = true;            // The view follows the newest time
+static uint32_t    viewEnd  = 0;               // Right edge's time (exclusive, multiple of msPerCol)
+static uint16_t    width    = 0;               // Cached columns (0: the cache has to be computed again)
+static uint16_t    curOff   = 0;               // Cursor's distance from the right edge (columns)
+static uint64_t    computed = 0;               // Computed columns (statistics)
+
+
+static void traceSetting (waveTrace_t *tr, pinId_t pin) {
+	//
+	// Description:
+	//	It initializes the argument defined trace with the pin's symbol (or its label when no symbol is defined)
+	//
+	const char *symbol;
+
+	memset(tr, 0, sizeof(waveTrace_t));
+	tr->pin = pin;
+	if (pinToSymbol_getById(&symbol, pin) == WERRCODE_SUCCESS)
+		snprintf(tr->label, sizeof(tr->label), "%s", symbol);
+	else if (pinId_toLabel(tr->label, pin) != WERRCODE_SUCCESS)
+		snprintf(tr->label, sizeof(tr->label), "#%u", pin);
+
+	return;
+}
+
+
+static void tracesFinding () {
+	//
+	// Description:
+	//	Auto mode: the traces are the first pins (by ID) with a history. The cache is invalidated when they change.
+	//
+	pinId_t found[WAVE_MAXTRACES];
+	uint8_t n = 0;
+
+	for (pinId_t pin = 0; pin < PTS_MAXPINID && n < WAVE_MAXTRACES; pin++)
+		if (pinsHistory_count(pin) > 0) found[n++] = pin;
+
+	for (uint8_t t = 0; t < n && n == nTraces; t++)
+		if (traces[t].pin != found[t]) nTraces = 0;
+
+	if (n != nTraces) {
+		for (uint8_t t = 0; t < n; t++) traceSetting(&traces[t], found[t]);
+		nTraces = n;
+		width   = 0;
+	}
+	return;
+}
+
+
+static void columnsComputing (waveTrace_t *tr, uint16_t first, uint16_t last, int64_t start) {
+	//
+	// Description:
+	//	It computes the levels of the argument defined columns range (first..last-1). The start argument is the
+	//	time of the column 0 (it is negative when the view begins before the time zero). The pin's value before the
+	//	range is read by a single query, then the range's transitions are walked by a history cursor.
+	//
+	histCursor_t c;
+	int64_t      t0    = start + (int64_t)first * msPerCol;
+	uint32_t     value = 0, ts = 0, v = 0;
+	bool         known, more;
+
+	known = (t0 > 0 && pinsHistory_valueAt(tr->pin, (uint32_t)t0 - 1, &value) == WERRCODE_SUCCESS);
+	pinsHistory_seek(&c, tr->pin, (t0 > 0) ? (uint32_t)t0 : 0);
+	more  = (pinsHistory_next(&c, &ts, &v) == WERRCODE_SUCCESS);
+
+	for (uint16_t col = first; col < last; col++, t0 += msPerCol) {
+		bool     before = known;
+		uint32_t n      = 0;
+
+		while (more && (int64_t)ts < t0 + msPerCol) {
+			value      = v;
+			known      = true;
+			tr->lastTs = ts;
+			n++;
+			more = (pinsHistory_next(&c, &ts, &v) == WERRCODE_SUCCESS);
+		}
+
+		if (n > 1)                tr->cols[col] = WAVE_MULTI;
+		else if (n == 1 && before) tr->cols[col] = WAVE_EDGE;
+		else if (known)           tr->cols[col] = (value != 0) ? WAVE_HIGH : WAVE_LOW;
+		else                      tr->cols[col] = WAVE_NONE;
+	}
+	tr->count  = pinsHistory_count(tr->pin);
+	computed  += last - first;
+
+	return;
+}
+
+
+static void timePrinting (char *buff, size_t size, int64_t ms) {
+	//
+	// Description:
+	//	It writes the argument defined time distance in a short human readable format (e.g. -250ms, +1.5s, +2.0m)
+	//
+	int64_t abs = (ms < 0) ? -ms : ms;
+
+	if (abs < 1000)
+		snprintf(buff, size, "%+ldms", (long)ms);
+	else if (abs < 60000)
+		snprintf(buff, size, "%+.1fs", ms / 1000.0);
+	else
+		snprintf(buff, size, "%+.1fm", ms / 60000.0);
+
+	return;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+//                                       P U B L I C   F U N C T I O N S
+//-----------------------------------------------------------------------------------------------------------------------------
+werror waveView_trace (const char *name) {
+	//
+	// Description:
+	//	It adds the argument defined pin to the displayed ones. The pin can be defined by its symbol (e.g.
+	//	i_CLUTCH) or by its label (e.g. GPIO_NUM_8). The first call disables the auto mode.
+	//
+	// Returned value:
+	//	WERRCODE_SUCCESS
+	//	WERRCODE_ERROR_ILLEGALARG     Unknown pin
+	//	WERRCODE_ERROR_DATAOVERFLOW   Too many pins (WAVE_MAXTRACES)
+	//
+	werror     err   = WERRCODE_ERROR_ILLEGALARG;
+	const char *symbol;
+	pinId_t    pin   = 0;
+
+	if (autoPins) {
+		autoPins = false;
+		nTraces  = 0;
+	}
+
+	for (pinId_t t = 0; t < PTS_MAXPINID && err != WERRCODE_SUCCESS; t++) {
+		if (pinToSymbol_getById(&symbol, t) == WERRCODE_SUCCESS && strcmp(symbol, name) == 0) {
+			pin = t;
+			err = WERRCODE_SUCCESS;
+		}
+	}
+	if (err != WERRCODE_SUCCESS && pinId_fromLabel(name, &pin) == WERRCODE_SUCCESS)
+		err = WERRCODE_SUCCESS;
+
+	if (err == WERRCODE_SUCCESS && nTraces == WAVE_MAXTRACES)
+		// ERROR!
+		err = WERRCODE_ERROR_DATAOVERFLOW;
+
+	if (err == WERRCODE_SUCCESS) {
+		traceSetting(&traces[nTraces++], pin);
+		width = 0;
+	}
+
+	return(err);
+}
+
+
+uint16_t waveView_rows () {
+	//
+	// Description:
+	//	It returns the number of rows used by the pane: a row per trace, the time axis and the info line
+	//
+	if (autoPins) tracesFinding();
+
+	return(nTraces + 2);
+}
+
+
+bool waveView_print (WINDOW *win, uint16_t cols, uint32_t now, bool force) {
+	//
+	// Description:
+	//	It updates the columns' cache to the argument defined time (live mode), and it draws the pane. When the time
+	//	has advanced by k columns, the cache is shifted and the last k+1 columns only are computed; the columns of a
+	//	trace are computed again from its newest known transition when new ones have been recorded.
+	//
+	// Returned value:
+	//	true when the pane has been drawn (the caller refreshes the window), false when nothing has changed
+	//
+	uint16_t w       = (cols > WAVE_LABELCOLS) ? cols - WAVE_LABELCOLS : 1;
+	uint32_t end     = viewEnd;
+	uint16_t shift   = 0;
+	bool     changed = force;
+	int64_t  start, tCur;
+	char     axis[WAVE_MAXCOLS + 1], buff[32];
+	chtype   line[WAVE_MAXCOLS];
+
+	if (w > WAVE_MAXCOLS) w = WAVE_MAXCOLS;
+	if (autoPins) tracesFinding();
+	if (live) end = (now / msPerCol + 1) * msPerCol;
+
+	// Cache updating
+	if (width != w || end < viewEnd || (uint64_t)(end - viewEnd) / msPerCol >= w) {
+		width   = w;
+		viewEnd = end;
+		start   = (int64_t)viewEnd - (int64_t)w * msPerCol;
+		for (uint8_t t = 0; t < nTraces; t++) columnsComputing(&traces[t], 0, w, start);
+		changed = true;
+
+	} else {
+		shift   = (end - viewEnd) / msPerCol;
+		viewEnd = end;
+		start   = (int64_t)viewEnd - (int64_t)w * msPerCol;
+		for (uint8_t t = 0; t < nTraces; t++) {
+			waveTrace_t *tr   = &traces[t];
+			uint64_t    count = pinsHistory_count(tr->pin);
+			uint16_t    first = w - shift - 1;
+
+			if (count < tr->count) {
+				// The history has been discarded (playback's seek)
+				first = 0;
+
+			} else if (count > tr->count && tr->lastTs < viewEnd) {
+				int64_t col = ((int64_t)tr->lastTs - start) / (int64_t)msPerCol;
+
+				if (col < first) first = (col > 0) ? col : 0;
+			}
+
+			if (shift > 0) memmove(tr->cols, tr->cols + shift, w - shift);
+			if (shift > 0 || count != tr->count) {
+				columnsComputing(tr, first, w, start);
+				changed = true;
+			}
+		}
+		if (shift > 0) changed = true;
+	}
+	if (curOff >= w) curOff = w - 1;
+
+	if (changed) {
+		uint16_t cur = w - 1 - curOff;
+
+		tCur = start + (int64_t)cur * msPerCol;
+		werase(win);
+
+		// Waveforms
+		for (uint8_t t = 0; t < nTraces; t++) {
+			uint32_t value;
+
+			if (pinsHistory_valueAt(traces[t].pin, (tCur > 0) ? tCur : 0, &value) == WERRCODE_SUCCESS)
+				snprintf(buff, sizeof(buff), "%u", value);
+			else
+				strcpy(buff, "?");
+			mvwprintw(win, t, 0, "%-*.*s %4s |", WAVE_LABELCOLS - 7, WAVE_LABELCOLS - 7, traces[t].label, buff);
+
+			for (uint16_t col = 0; col < w; col++) {
+				switch (traces[t].cols[col]) {
+					case WAVE_LOW:   line[col] = ACS_S9;    break;
+					case WAVE_HIGH:  line[col] = ACS_S1;    break;
+					case WAVE_EDGE:  line[col] = ACS_VLINE; break;
+					case WAVE_MULTI: line[col] = 'X';       break;
+					default:         line[col] = ' ';       break;
+				}
+			}
+			line[cur] |= A_REVERSE;
+			waddchnstr(win, line, w);
+		}
+
+		// Time axis: the labels are relative to the cursor
+		for (uint16_t col = 0; col < w; col++)
+			axis[col] = (col == cur) ? '^' : ((col - cur) % WAVE_TICKCOLS == 0) ? '+' : '-';
+		axis[w] = '\0';
+		for (int32_t col = cur % (2 * WAVE_TICKCOLS), next = 0; col < w; col += 2 * WAVE_TICKCOLS) {
+			int n;
+
+			if (col == cur) continue;
+			timePrinting(buff, sizeof(buff), ((int64_t)col - cur) * msPerCol);
+			n = strlen(buff);
+			if (col + 1 >= next && col + 1 + n < w) {
+				memcpy(axis + col + 1, buff, n);
+				next = col + 2 + n;
+			}
+		}
+		mvwprintw(win, nTraces, 0, "%*s|%s", WAVE_LABELCOLS - 1, "cursor ", axis);
+
+		// Info line
+		mvwprintw(
+			win, nTraces + 1, 0, " %u ms/col   cursor: %ld ms   %s   [+/-] zoom   [[/]] pan   [,/.] cursor   [l] live   [w] hide",
+			msPerCol, (long)((tCur > 0) ? tCur : 0), live ? "LIVE" : "PAUSED"
+		);
+	}
+
+	return(changed);
+}
+
+
+void waveView_zoom (int8_t dir) {
+	//
+	// Description:
+	//	It halves (dir > 0, zoom in) or doubles (dir < 0, zoom out) the time covered by a column. Out of the live
+	//	mode, the cursor's time is kept.
+	//
+	int64_t tCur = (int64_t)viewEnd - (int64_t)(curOff + 1) * msPerCol;
+
+	if (dir > 0 && msPerCol > WAVE_MINZOOM) msPerCol /= 2;
+	if (dir < 0 && msPerCol < WAVE_MAXZOOM) msPerCol *= 2;
+
+	if (live == false) {
+		int64_t end = (tCur / msPerCol + 1 + curOff) * msPerCol;
+
+		viewEnd = (end > 0) ? end : msPerCol;
+	}
+	width = 0;
+
+	return;
+}
+
+
+void waveView_pan (int32_t cols) {
+	//
+	// Description:
+	//	It moves the view by the argument defined number of columns (negative: back in time), and it leaves the live
+	//	mode
+	//
+	int64_t end = (int64_t)viewEnd + (int64_t)cols * msPerCol;
+
+	live    = false;
+	viewEnd = (end > msPerCol) ? end : msPerCol;
+	width   = 0;
+
+	return;
+}
+
+
+void waveView_cursor (int32_t cols) {
+	//
+	// Description:
+	//	It moves the cursor by the argument defined number of columns (positive: right). The columns' cache is still
+	//	valid, the caller has to force the pane's redraw.
+	//
+	int32_t off = (int32_t)curOff - cols;
+
+	curOff = (off < 0) ? 0 : (width > 0 && off >= width) ? width - 1 : off;
+
+	return;
+}
+
+
+void waveView_live () {
+	//
+	// Description:
+	//	It moves the view back to the newest time, and it follows it
+	//
+	live  = true;
+	width = 0;
+
+	return;
+}
+
+
+bool waveView_isLive () {
+	//
+	// Description:
+	//	It returns true when the view follows the newest time (it has to be redrawn every msPerCol ms)
+	//
+	return(live);
+}
+
+
+uint32_t waveView_msPerCol () {
+	//
+	// Description:
+	//	It returns the time (ms) covered by a column
+	//
+	return(msPerCol);
+}
+
+
+void waveView_reset () {
+	//
+	// Description:
+	//	It discards the columns' cache (e.g. the displayed device has changed): the next waveView_print() call
+	//	computes the whole window
+	//
+	width = 0;
+	if (autoPins) nTraces = 0;
+
+	return;
+}
+
+
+uint64_t waveView_computed () {
+	//
+	// Description:
+	//	It returns the number of columns computed since the start (incremental rendering statistics)
+	//
+	return(computed);
+}
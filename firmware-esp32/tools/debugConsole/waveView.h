@@ -0,0 +1,72 @@
+/*------------------------------------------------------------------------------------------------------------------------------
+//
+//   __  __       _             _     _ _          _____ _           _        _           _   ____            _                 
+// |  \/  | ___ | |_ ___  _ __| |__ (_) | _____  | ____| | ___  ___| |_ _ __(_) ___ __ _| | / ___| _   _ ___| |_ ___ _ __ ___  
+// | |\/| |/ _ \| __/ _ \| '__| '_ \| | |/ / _ \ |  _| | |/ _ \/ __| __| '__| |/ __/ _` | | \___ \| | | / __| __/ _ \ '_ ` _ \ 
+// | |  | | (_) | || (_) | |  | |_) | |   <  __/ | |___| |  __/ (__| |_| |  | | (_| (_| | |  ___) | |_| \__ \ ||  __/ | | | | |
+// |_|  |_|\___/ \__\___/|_|  |_.__/|_|_|\_\___| |_____|_|\___|\___|\__|_|  |_|\___\__,_|_| |____/ \__, |___/\__\___|_| |_| |_|
+//                                                                                                 |___/                       
+//
+// File: waveView.h
+//
+// Author: Silvano Catinella <catinella@yahoo.com>
+//
+// Description:
+//	Logic-analyzer style pane: the recent history of the selected pins (see pinsHistory.h) is drawn as digital
+//	waveforms, one row per pin, with a time axis and a cursor. Every screen column covers msPerCol milliseconds
+//	(zoom), and the view follows the newest time (live mode) until it is panned.
+//	The columns' levels are cached: when the time advances by k columns, the cache is shifted and only the last k+1
+//	columns are computed again (the whole window is computed after a zoom, a pan, a resize or waveView_reset()).
+//
+//	Column's levels:
+//		'_'   The pin has been low for the whole column
+//		'-'   The pin has been high for the whole column
+//		'|'   A single transition
+//		'X'   Several transitions (zoom in to see them)
+//		' '   No samples yet
+//
+//	Symbols:
+//		WAVE_MAXTRACES   Max number of displayed pins
+//		WAVE_MAXCOLS     Max number of waveform columns
+//		WAVE_LABELCOLS   Columns of the pin's name and value (at the cursor)
+//
+//
+// License:
+//	Copyright (C) 2023 Silvano Catinella <catinella@yahoo.com>
+//
+//	This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public
+//	License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+//	version.
+//
+//	This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+//	warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with this program. If not, see
+//		<https://www.gnu.org/licenses/gpl-3.0.txt>.
+//
+------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef WAVEVIEW_UT
+#define WAVEVIEW_UT
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <ncurses.h>
+#include <werror.h>
+
+#define WAVE_MAXTRACES   8
+#define WAVE_MAXCOLS     512
+#define WAVE_LABELCOLS   22
+
+werror   waveView_trace    (const char *name);
+uint16_t waveView_rows     ();
+bool     waveView_print    (WINDOW *win, uint16_t cols, uint32_t now, bool force);
+void     waveView_zoom     (int8_t dir);
+void     waveView_pan      (int32_t cols);
+void     waveView_cursor   (int32_t cols);
+void     waveView_live     ();
+bool     waveView_isLive   ();
+uint32_t waveView_msPerCol ();
+void     waveView_reset    ();
+uint64_t waveView_computed ();
+
+#endif